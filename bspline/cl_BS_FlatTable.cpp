@@ -0,0 +1,526 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cl_BS_FlatTable.hpp"
+#include "meshtools.hpp"
+
+namespace belfem
+{
+    namespace bspline
+    {
+//------------------------------------------------------------------------------
+
+        // identifies a compiled table file
+        const char gFlatTableMagic[ 9 ] = "BELFEMBS" ;
+
+        // detects if a table was written with different byte order
+        const uint32_t gFlatTableEndian = 0x01020304 ;
+
+        /**
+         * header of the binary table format. It is followed by the field
+         * labels and the node values, which start at DataOffset.
+         */
+        struct FlatTableHeader
+        {
+            char     Magic[ 8 ];
+            uint32_t Version ;
+            uint32_t Endian ;
+            uint32_t RealSize ;
+            uint32_t NumberOfDimensions ;
+            uint32_t Order ;
+            uint32_t Padding ;
+            uint64_t NumberOfElements[ 3 ];
+            double   Min[ 3 ];
+            double   Max[ 3 ];
+            uint64_t LabelOffset ;
+            uint64_t LabelSize ;
+            uint64_t DataOffset ;
+            uint64_t DataSize ;
+            uint64_t SourceSize ;
+            int64_t  SourceTime ;
+        };
+//------------------------------------------------------------------------------
+
+        FlatTable::FlatTable( Mesh & aMesh ) :
+            mNumberOfDimensions( aMesh.number_of_dimensions() )
+        {
+            // number of nodes per element
+            mNumberOfNodesPerElement = mesh::number_of_nodes( aMesh.block( 1 )->element_type() );
+
+            // the order follows from ( p + 1 )^d nodes per element
+            mNumberOfNodesPerDirection = std::round( std::pow(
+                    ( real ) mNumberOfNodesPerElement, 1.0 / ( ( real ) mNumberOfDimensions ) ) );
+
+            mOrder = mNumberOfNodesPerDirection - 1 ;
+
+            BELFEM_ERROR( mOrder > 0 && mOrder <= BELFEM_BSPLINE_MAX_ORDER,
+                          "invalid interpolation order of table: %u",
+                          ( unsigned int ) mOrder );
+
+            // read the globals
+            mNumberOfElementsPerDirection.set_size( mNumberOfDimensions );
+            mPmin.set_size( mNumberOfDimensions );
+            mPmax.set_size( mNumberOfDimensions );
+
+            mNumberOfElementsPerDirection( 0 ) = ( index_t ) aMesh.global_variable_data( "numElemsX" );
+            mPmin( 0 ) = aMesh.global_variable_data( "Xmin" );
+            mPmax( 0 ) = aMesh.global_variable_data( "Xmax" );
+
+            if( mNumberOfDimensions > 1 )
+            {
+                mNumberOfElementsPerDirection( 1 ) = ( index_t ) aMesh.global_variable_data( "numElemsY" );
+                mPmin( 1 ) = aMesh.global_variable_data( "Ymin" );
+                mPmax( 1 ) = aMesh.global_variable_data( "Ymax" );
+
+                if( mNumberOfDimensions > 2 )
+                {
+                    mNumberOfElementsPerDirection( 2 ) = ( index_t ) aMesh.global_variable_data( "numElemsZ" );
+                    mPmin( 2 ) = aMesh.global_variable_data( "Zmin" );
+                    mPmax( 2 ) = aMesh.global_variable_data( "Zmax" );
+                }
+            }
+
+            // get the field labels
+            uint tNumFields = aMesh.number_of_fields() ;
+            mFieldLabels.set_size( tNumFields, "" );
+            for( uint f=0; f<tNumFields; ++f )
+            {
+                mFieldLabels( f ) = aMesh.field( f )->label() ;
+            }
+
+            this->create_field_map() ;
+            this->compute_geometry() ;
+            this->compute_coefficients() ;
+            this->collect_values( aMesh );
+        }
+
+//------------------------------------------------------------------------------
+
+        FlatTable::FlatTable( const string & aPath )
+        {
+            int tFile = open( aPath.c_str(), O_RDONLY );
+
+            BELFEM_ERROR( tFile >= 0, "could not open table %s", aPath.c_str() );
+
+            struct stat tStat ;
+            if( fstat( tFile, &tStat ) != 0 )
+            {
+                close( tFile );
+                BELFEM_ERROR( false, "could not stat table %s", aPath.c_str() );
+            }
+            mMappedSize = tStat.st_size ;
+
+            if( mMappedSize < sizeof( FlatTableHeader ) )
+            {
+                close( tFile );
+                BELFEM_ERROR( false, "file %s is not a compiled table", aPath.c_str() );
+            }
+
+            // shared mapping: all processes use the same physical pages
+            mMappedMemory = mmap( nullptr, mMappedSize, PROT_READ, MAP_SHARED, tFile, 0 );
+
+            // the mapping stays valid after the file is closed
+            close( tFile );
+
+            BELFEM_ERROR( mMappedMemory != MAP_FAILED, "could not map table %s", aPath.c_str() );
+
+            const char * tMemory = reinterpret_cast< const char * >( mMappedMemory );
+            const FlatTableHeader * tHeader = reinterpret_cast< const FlatTableHeader * >( tMemory );
+
+            BELFEM_ERROR( std::strncmp( tHeader->Magic, gFlatTableMagic, 8 ) == 0,
+                          "file %s is not a compiled table", aPath.c_str() );
+
+            // the version can only be read if the byte order matches
+            BELFEM_ERROR( tHeader->Endian == gFlatTableEndian && tHeader->RealSize == sizeof( real ),
+                          "table %s was written on an incompatible platform", aPath.c_str() );
+
+            BELFEM_ERROR( tHeader->Version == BELFEM_BSPLINE_TABLE_VERSION,
+                          "table %s has version %u, but version %u is expected",
+                          aPath.c_str(),
+                          ( unsigned int ) tHeader->Version,
+                          ( unsigned int ) BELFEM_BSPLINE_TABLE_VERSION );
+
+            BELFEM_ERROR( tHeader->NumberOfDimensions >= 1 && tHeader->NumberOfDimensions <= 3
+                       && tHeader->Order >= 1 && tHeader->Order <= BELFEM_BSPLINE_MAX_ORDER,
+                          "table %s has an invalid dimension or order", aPath.c_str() );
+
+            mNumberOfDimensions = tHeader->NumberOfDimensions ;
+            mOrder = tHeader->Order ;
+
+            mNumberOfNodesPerDirection = mOrder + 1 ;
+            mNumberOfNodesPerElement   = std::pow( mNumberOfNodesPerDirection, mNumberOfDimensions );
+
+            mNumberOfElementsPerDirection.set_size( mNumberOfDimensions );
+            mPmin.set_size( mNumberOfDimensions );
+            mPmax.set_size( mNumberOfDimensions );
+
+            for( uint i=0; i<mNumberOfDimensions; ++i )
+            {
+                mNumberOfElementsPerDirection( i ) = tHeader->NumberOfElements[ i ];
+                mPmin( i ) = tHeader->Min[ i ];
+                mPmax( i ) = tHeader->Max[ i ];
+            }
+
+            BELFEM_ERROR( tHeader->LabelOffset <= mMappedSize
+                       && tHeader->LabelSize <= mMappedSize - tHeader->LabelOffset,
+                          "labels of compiled table %s are out of bounds",
+                          aPath.c_str() );
+
+            // labels are stored as one string, terminated by semicolons
+            mFieldLabels.clear() ;
+            string tLabel = "" ;
+            for( uint64_t k=0; k<tHeader->LabelSize; ++k )
+            {
+                char tChar = tMemory[ tHeader->LabelOffset + k ];
+
+                if( tChar == ';' )
+                {
+                    mFieldLabels.push( tLabel );
+                    tLabel = "" ;
+                }
+                else
+                {
+                    tLabel += tChar ;
+                }
+            }
+
+            this->create_field_map() ;
+            this->compute_geometry() ;
+            this->compute_coefficients() ;
+
+            BELFEM_ERROR( tHeader->DataSize == mNumberOfElements * mNumberOfNodesPerElement * mFieldLabels.size()
+                        && tHeader->DataOffset + tHeader->DataSize * sizeof( real ) <= mMappedSize,
+                          "size of compiled table %s does not match its header",
+                          aPath.c_str() );
+
+            mData = reinterpret_cast< const real * >( tMemory + tHeader->DataOffset );
+
+            // the access pattern of a lookup is random
+            madvise( mMappedMemory, mMappedSize, MADV_RANDOM );
+        }
+
+//------------------------------------------------------------------------------
+
+        FlatTable::~FlatTable()
+        {
+            if( mMappedMemory != nullptr )
+            {
+                munmap( mMappedMemory, mMappedSize );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        FlatTable::save( const string & aPath, const string & aSourcePath ) const
+        {
+            string tLabels = "" ;
+            for( const string & tLabel : mFieldLabels )
+            {
+                tLabels += tLabel + ";" ;
+            }
+
+            FlatTableHeader tHeader ;
+            std::memset( &tHeader, 0, sizeof( FlatTableHeader ) );
+            std::memcpy( tHeader.Magic, gFlatTableMagic, 8 );
+
+            tHeader.Version  = BELFEM_BSPLINE_TABLE_VERSION ;
+            tHeader.Endian   = gFlatTableEndian ;
+            tHeader.RealSize = sizeof( real );
+            tHeader.NumberOfDimensions = mNumberOfDimensions ;
+            tHeader.Order = mOrder ;
+
+            for( uint i=0; i<mNumberOfDimensions; ++i )
+            {
+                tHeader.NumberOfElements[ i ] = mNumberOfElementsPerDirection( i );
+                tHeader.Min[ i ] = mPmin( i );
+                tHeader.Max[ i ] = mPmax( i );
+            }
+
+            tHeader.LabelOffset = sizeof( FlatTableHeader );
+            tHeader.LabelSize   = tLabels.length() ;
+
+            // the data block is aligned to a cache line
+            tHeader.DataOffset  = ( ( tHeader.LabelOffset + tHeader.LabelSize + 63 ) / 64 ) * 64 ;
+            tHeader.DataSize    = mNumberOfElements * mNumberOfNodesPerElement * mFieldLabels.size() ;
+
+            // remember the version of the source file
+            struct stat tSourceStat ;
+            if( aSourcePath.length() > 0 && stat( aSourcePath.c_str(), &tSourceStat ) == 0 )
+            {
+                tHeader.SourceSize = tSourceStat.st_size ;
+                tHeader.SourceTime = tSourceStat.st_mtime ;
+            }
+
+            // write into a temporary file first
+            string tTempPath = aPath + ".tmp" + std::to_string( getpid() );
+
+            std::ofstream tFile( tTempPath, std::ios::binary | std::ios::trunc );
+
+            BELFEM_ERROR( tFile.good(), "could not write table %s", tTempPath.c_str() );
+
+            tFile.write( reinterpret_cast< const char * >( &tHeader ), sizeof( FlatTableHeader ) );
+            tFile.write( tLabels.c_str(), tLabels.length() );
+
+            // padding
+            string tPadding( tHeader.DataOffset - tHeader.LabelOffset - tHeader.LabelSize, '\0' );
+            tFile.write( tPadding.c_str(), tPadding.length() );
+
+            tFile.write( reinterpret_cast< const char * >( mData ), tHeader.DataSize * sizeof( real ) );
+
+            BELFEM_ERROR( tFile.good(), "could not write table %s", tTempPath.c_str() );
+
+            tFile.close() ;
+
+            if( std::rename( tTempPath.c_str(), aPath.c_str() ) != 0 )
+            {
+                std::remove( tTempPath.c_str() );
+                BELFEM_ERROR( false, "could not rename table %s to %s",
+                              tTempPath.c_str(), aPath.c_str() );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        string
+        FlatTable::cache_path( const string & aMeshPath )
+        {
+            // remove the file ending, if there is one
+            std::size_t tDot   = aMeshPath.find_last_of( '.' );
+            std::size_t tSlash = aMeshPath.find_last_of( '/' );
+
+            if( tDot != string::npos && ( tSlash == string::npos || tDot > tSlash ) )
+            {
+                return aMeshPath.substr( 0, tDot ) + ".bst" ;
+            }
+            else
+            {
+                return aMeshPath + ".bst" ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        FlatTable::is_compiled( const string & aPath )
+        {
+            std::ifstream tFile( aPath, std::ios::binary );
+
+            char tMagic[ 8 ];
+
+            if( ! tFile.read( tMagic, 8 ) )
+            {
+                return false ;
+            }
+
+            return std::strncmp( tMagic, gFlatTableMagic, 8 ) == 0 ;
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        FlatTable::was_compiled_from( const string & aPath, const string & aSourcePath )
+        {
+            struct stat tSourceStat ;
+
+            if( stat( aSourcePath.c_str(), &tSourceStat ) != 0 )
+            {
+                return false ;
+            }
+
+            std::ifstream tFile( aPath, std::ios::binary );
+
+            FlatTableHeader tHeader ;
+
+            if( ! tFile.read( reinterpret_cast< char * >( &tHeader ), sizeof( FlatTableHeader ) ) )
+            {
+                return false ;
+            }
+
+            return std::strncmp( tHeader.Magic, gFlatTableMagic, 8 ) == 0
+                && tHeader.Endian == gFlatTableEndian
+                && tHeader.Version == BELFEM_BSPLINE_TABLE_VERSION
+                && tHeader.SourceSize == ( uint64_t ) tSourceStat.st_size
+                && tHeader.SourceTime == ( int64_t ) tSourceStat.st_mtime ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        FlatTable::create_field_map()
+        {
+            mFieldMap.clear();
+
+            uint tNumFields = mFieldLabels.size() ;
+
+            for ( uint k=0; k<tNumFields; ++k )
+            {
+                mFieldMap[ mFieldLabels( k ) ] = k ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        FlatTable::compute_geometry()
+        {
+            mElementLength.set_size( mNumberOfDimensions );
+            mInverseElementLength.set_size( mNumberOfDimensions );
+
+            mNumberOfElements = 1 ;
+
+            for( uint i=0; i<mNumberOfDimensions; ++i )
+            {
+                mNumberOfElements *= mNumberOfElementsPerDirection( i );
+                mElementLength( i ) = ( mPmax( i ) - mPmin( i ) )
+                        / ( ( real ) mNumberOfElementsPerDirection( i ) );
+                mInverseElementLength( i ) = 1.0 / mElementLength( i );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        FlatTable::compute_coefficients()
+        {
+            for( uint d=0; d<3; ++d )
+            {
+                for( uint i=0; i<=BELFEM_BSPLINE_MAX_ORDER; ++i )
+                {
+                    for( uint m=0; m<=BELFEM_BSPLINE_MAX_ORDER; ++m )
+                    {
+                        mCoefficients[ d ][ i ][ m ] = 0.0 ;
+                    }
+                }
+            }
+
+            // equidistant nodes on [-1, 1]
+            real tXi[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            for( uint i=0; i<mNumberOfNodesPerDirection; ++i )
+            {
+                tXi[ i ] = 2.0 * ( ( real ) i ) / ( ( real ) mOrder ) - 1.0 ;
+            }
+
+            for( uint i=0; i<mNumberOfNodesPerDirection; ++i )
+            {
+                // multiply out prod_( j != i ) ( xi - xi_j ) / ( xi_i - xi_j )
+                real * tC = mCoefficients[ 0 ][ i ];
+                tC[ 0 ] = 1.0 ;
+                uint tDegree = 0 ;
+
+                for( uint j=0; j<mNumberOfNodesPerDirection; ++j )
+                {
+                    if( j != i )
+                    {
+                        real tScale = 1.0 / ( tXi[ i ] - tXi[ j ] );
+
+                        ++tDegree ;
+                        for( uint m=tDegree; m>0; --m )
+                        {
+                            tC[ m ] = ( tC[ m - 1 ] - tXi[ j ] * tC[ m ] ) * tScale ;
+                        }
+                        tC[ 0 ] *= -tXi[ j ] * tScale ;
+                    }
+                }
+
+                // derivatives of the polynomial
+                for( uint m=1; m<=mOrder; ++m )
+                {
+                    mCoefficients[ 1 ][ i ][ m - 1 ] = m * mCoefficients[ 0 ][ i ][ m ];
+                }
+                for( uint m=1; m<mOrder; ++m )
+                {
+                    mCoefficients[ 2 ][ i ][ m - 1 ] = m * mCoefficients[ 1 ][ i ][ m ];
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        FlatTable::collect_values( Mesh & aMesh )
+        {
+            uint tNumFields = mFieldLabels.size() ;
+
+            mValues.set_size( tNumFields * mNumberOfElements * mNumberOfNodesPerElement, 0.0 );
+            mData = mValues.ptr() ;
+
+            Cell< mesh::Element * > & tElements = aMesh.block( 1 )->elements() ;
+
+            BELFEM_ERROR( tElements.size() == mNumberOfElements,
+                          "number of elements on mesh does not match globals ( %lu vs %lu )",
+                          ( long unsigned int ) tElements.size(),
+                          ( long unsigned int ) mNumberOfElements );
+
+            // position of a node inside the element
+            Vector< index_t > tPosition( mNumberOfNodesPerElement );
+
+            // ijk-position of the element
+            index_t tIJK[ 3 ] = { 0, 0, 0 };
+
+            // offset between nodes
+            Vector< real > tNodeDistance( mElementLength );
+            tNodeDistance *= 1.0 / ( ( real ) mOrder );
+
+            for( mesh::Element * tElement : tElements )
+            {
+                mesh::Node * tCorner = tElement->node( 0 );
+
+                // the position of the element follows from its first corner,
+                // so that we do not rely on the order of the elements in the file
+                for( uint i=0; i<mNumberOfDimensions; ++i )
+                {
+                    tIJK[ i ] = std::lround( ( tCorner->x( i ) - mPmin( i ) ) * mInverseElementLength( i ) );
+                }
+
+                index_t tElementIndex = this->element_index( tIJK[ 0 ], tIJK[ 1 ], tIJK[ 2 ] );
+
+                // tensor position of each node
+                for( uint k=0; k<mNumberOfNodesPerElement; ++k )
+                {
+                    index_t tIndex = 0 ;
+
+                    for( int i=mNumberOfDimensions-1; i>=0; --i )
+                    {
+                        tIndex = tIndex * mNumberOfNodesPerDirection + std::lround(
+                                ( tElement->node( k )->x( i ) - tCorner->x( i ) ) / tNodeDistance( i ) );
+                    }
+
+                    tPosition( k ) = tIndex ;
+                }
+
+                // copy the data
+                for( uint f=0; f<tNumFields; ++f )
+                {
+                    const Vector< real > & tField = aMesh.field( f )->data() ;
+
+                    real * tValues = mValues.ptr()
+                            + ( f * mNumberOfElements + tElementIndex ) * mNumberOfNodesPerElement ;
+
+                    for( uint k=0; k<mNumberOfNodesPerElement; ++k )
+                    {
+                        tValues[ tPosition( k ) ] = tField( tElement->node( k )->index() );
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
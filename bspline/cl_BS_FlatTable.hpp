@@ -0,0 +1,370 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#ifndef BELFEM_CL_BS_FLATTABLE_HPP
+#define BELFEM_CL_BS_FLATTABLE_HPP
+
+#include "typedefs.hpp"
+#include "assert.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Map.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Mesh.hpp"
+
+// maximum supported interpolation order of a table
+#define BELFEM_BSPLINE_MAX_ORDER 3
+
+// version of the binary table format, increase if the layout changes
+#define BELFEM_BSPLINE_TABLE_VERSION 2
+
+namespace belfem
+{
+    namespace bspline
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Compiled, cache friendly layout of a lookup table.
+         *
+         * The node values of each element are stored contiguously,
+         * in tensor order ( i + ( p+1 ) * ( j + ( p+1 ) * k ) ),
+         * and field by field. Since the grid is regular, the 1D Lagrange
+         * shape functions are the same on each element, and their
+         * polynomial coefficients are precomputed.
+         *
+         * A compiled table is saved as a versioned binary file. When it is
+         * opened, the node values are mapped read-only into memory, so that
+         * all processes on one machine share the same physical pages.
+         */
+        class FlatTable
+        {
+            uint mNumberOfDimensions = 0 ;
+
+            // interpolation order
+            uint mOrder = 0 ;
+
+            // nodes per element and direction ( p + 1 )
+            uint mNumberOfNodesPerDirection = 0 ;
+
+            // nodes per element ( p + 1 )^d
+            uint mNumberOfNodesPerElement = 0 ;
+
+            // how many elements exist
+            Vector< index_t > mNumberOfElementsPerDirection ;
+
+            index_t mNumberOfElements = 0 ;
+
+            // first point of bounding box
+            Vector< real > mPmin ;
+
+            // last point of bounding box
+            Vector< real > mPmax ;
+
+            // size of one element
+            Vector< real > mElementLength ;
+
+            // inverse of element size
+            Vector< real > mInverseElementLength ;
+
+            // field labels in the order of the original mesh
+            Cell< string > mFieldLabels ;
+
+            // map to field lables with indices
+            Map< string, index_t > mFieldMap ;
+
+            // polynomial coefficients of the 1D shape functions
+            // and of their first and second derivatives
+            // [ derivative ][ shape function ][ power ]
+            real mCoefficients[ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ] ;
+
+            // node values, element by element, field by field,
+            // only used if the table was compiled from a mesh
+            Vector< real > mValues ;
+
+            // points either to mValues or into the mapped file
+            const real * mData = nullptr ;
+
+            // memory of the mapped file
+            void * mMappedMemory = nullptr ;
+
+            std::size_t mMappedSize = 0 ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * compile the table from a mesh that has been created by
+             * the bspline::Mapper
+             */
+            FlatTable( Mesh & aMesh );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * open a compiled table. The file is not parsed, but mapped
+             * read-only into memory.
+             */
+            FlatTable( const string & aPath );
+
+//------------------------------------------------------------------------------
+
+            FlatTable( const FlatTable & ) = delete ;
+
+//------------------------------------------------------------------------------
+
+            ~FlatTable();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * write the compiled table into a binary file. The file is
+             * written under a temporary name and then renamed, so that
+             * other processes never map an incomplete table.
+             * If a source path is given, its size and modification time
+             * are stored in the header.
+             */
+            void
+            save( const string & aPath, const string & aSourcePath="" ) const ;
+
+//------------------------------------------------------------------------------
+
+            // the path where the compiled table of a mesh file is stored
+            static string
+            cache_path( const string & aMeshPath );
+
+//------------------------------------------------------------------------------
+
+            // checks if a file is a compiled table
+            static bool
+            is_compiled( const string & aPath );
+
+//------------------------------------------------------------------------------
+
+            // checks if a compiled table was created from the current
+            // version of the source file, by its size and modification time
+            static bool
+            was_compiled_from( const string & aPath, const string & aSourcePath );
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_dimensions() const
+            {
+                return mNumberOfDimensions ;
+            }
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            order() const
+            {
+                return mOrder ;
+            }
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_nodes_per_direction() const
+            {
+                return mNumberOfNodesPerDirection ;
+            }
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_fields() const
+            {
+                return mFieldLabels.size() ;
+            }
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            field_index( const string & aLabel ) const
+            {
+                return mFieldMap( aLabel );
+            }
+
+//------------------------------------------------------------------------------
+
+            inline const real &
+            min( const uint aIndex ) const
+            {
+                return mPmin( aIndex );
+            }
+
+//------------------------------------------------------------------------------
+
+            inline const real &
+            max( const uint aIndex ) const
+            {
+                return mPmax( aIndex );
+            }
+
+//------------------------------------------------------------------------------
+
+            inline const real &
+            element_length( const uint aIndex ) const
+            {
+                return mElementLength( aIndex );
+            }
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_elements( const uint aIndex ) const
+            {
+                return mNumberOfElementsPerDirection( aIndex );
+            }
+
+//------------------------------------------------------------------------------
+
+            /**
+             * find the element index along one direction and compute
+             * the parameter coordinate. Points on the upper boundary
+             * belong to the last element. Points outside of the table
+             * are clamped to the boundary.
+             */
+            inline index_t
+            locate( const uint aDimension, const real aX, real & aXi ) const ;
+
+//------------------------------------------------------------------------------
+
+            // element index from ijk-position
+            inline index_t
+            element_index( const index_t aI, const index_t aJ=0, const index_t aK=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+            // the node values of one element for one field
+            inline const real *
+            values( const index_t aFieldIndex, const index_t aElementIndex ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * evaluate the 1D shape functions or their derivatives
+             *
+             * @param aDerivative  0: N, 1: dN/dxi, 2: d2N/dxi2
+             * @param aXi          parameter coordinate
+             * @param aN           output, must hold p+1 values
+             */
+            inline void
+            shape( const uint aDerivative, const real aXi, real * aN ) const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            void
+            create_field_map();
+
+//------------------------------------------------------------------------------
+
+            void
+            compute_geometry();
+
+//------------------------------------------------------------------------------
+
+            void
+            compute_coefficients();
+
+//------------------------------------------------------------------------------
+
+            void
+            collect_values( Mesh & aMesh );
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+// Inline functions
+//------------------------------------------------------------------------------
+
+        inline index_t
+        FlatTable::locate( const uint aDimension, const real aX, real & aXi ) const
+        {
+            real tS = ( aX - mPmin( aDimension ) ) * mInverseElementLength( aDimension );
+
+            // clamp to the table, this also catches NaN
+            if( ! ( tS > 0.0 ) )
+            {
+                tS = 0.0 ;
+            }
+            else if( tS > ( real ) mNumberOfElementsPerDirection( aDimension ) )
+            {
+                tS = ( real ) mNumberOfElementsPerDirection( aDimension );
+            }
+
+            index_t tI = std::min( ( index_t ) std::floor( tS ),
+                                   mNumberOfElementsPerDirection( aDimension ) - 1 );
+
+            aXi = 2.0 * ( tS - ( real ) tI ) - 1.0 ;
+
+            return tI ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        FlatTable::element_index( const index_t aI, const index_t aJ, const index_t aK ) const
+        {
+            switch( mNumberOfDimensions )
+            {
+                case( 1 ) :
+                {
+                    return aI ;
+                }
+                case( 2 ) :
+                {
+                    return aJ * mNumberOfElementsPerDirection( 0 ) + aI ;
+                }
+                default:
+                {
+                    return mNumberOfElementsPerDirection( 0 )
+                           * ( mNumberOfElementsPerDirection( 1 ) * aK + aJ ) + aI ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const real *
+        FlatTable::values( const index_t aFieldIndex, const index_t aElementIndex ) const
+        {
+            return mData
+                + ( aFieldIndex * mNumberOfElements + aElementIndex ) * mNumberOfNodesPerElement ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline void
+        FlatTable::shape( const uint aDerivative, const real aXi, real * aN ) const
+        {
+            // Horner scheme
+            for( uint i=0; i<mNumberOfNodesPerDirection; ++i )
+            {
+                const real * tC = mCoefficients[ aDerivative ][ i ];
+
+                real tN = tC[ mOrder ];
+                for( int m=mOrder-1; m>=0; --m )
+                {
+                    tN = tN * aXi + tC[ m ];
+                }
+                aN[ i ] = tN ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_BS_FLATTABLE_HPP
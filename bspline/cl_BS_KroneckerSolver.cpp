@@ -0,0 +1,264 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#include <thread>
+
+#include "assert.hpp"
+#include "cl_BS_KroneckerSolver.hpp"
+
+namespace belfem
+{
+    namespace bspline
+    {
+//------------------------------------------------------------------------------
+
+        KroneckerSolver::KroneckerSolver(
+                const uint                     aOrder,
+                const Vector< index_t >      & aNumberOfBasisPerDimension,
+                const Cell< Matrix< real > > & aElementMassMatrices ) :
+                mNumberOfDimensions( aNumberOfBasisPerDimension.length() ),
+                mOrder( aOrder ),
+                mNumberOfBasisPerDimension( aNumberOfBasisPerDimension )
+        {
+            BELFEM_ERROR( aElementMassMatrices.size() == mNumberOfDimensions,
+                          "need one element matrix per dimension" );
+
+            mNumberOfBasis = 1 ;
+            for( uint d=0; d<mNumberOfDimensions; ++d )
+            {
+                mNumberOfBasis *= mNumberOfBasisPerDimension( d );
+            }
+
+            mFactors.set_size( mNumberOfDimensions, Matrix< real >() );
+
+            for( uint d=0; d<mNumberOfDimensions; ++d )
+            {
+                this->factorize( d, aElementMassMatrices( d ) );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        KroneckerSolver::solve(
+                const Matrix< real > & aRHS,
+                      Matrix< real > & aLHS,
+                const uint aNumberOfThreads ) const
+        {
+            BELFEM_ERROR( aRHS.n_rows() == mNumberOfBasis,
+                          "RHS has wrong number of rows ( is %lu, expect %lu )",
+                          ( long unsigned int ) aRHS.n_rows(),
+                          ( long unsigned int ) mNumberOfBasis );
+
+            index_t tNumberOfColumns = aRHS.n_cols() ;
+
+            aLHS = aRHS ;
+
+            index_t tNumberOfThreads = aNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : aNumberOfThreads ;
+
+            tNumberOfThreads = std::max( ( index_t ) 1, std::min( tNumberOfThreads, tNumberOfColumns ) );
+
+            if( tNumberOfThreads == 1 )
+            {
+                this->solve_columns( aLHS, 0, tNumberOfColumns );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                index_t tChunk = tNumberOfColumns / tNumberOfThreads ;
+
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    index_t tFirst = t * tChunk ;
+                    index_t tLast  = t == tNumberOfThreads - 1 ? tNumberOfColumns : tFirst + tChunk ;
+
+                    // each thread works on its own columns
+                    tThreads.emplace_back( &KroneckerSolver::solve_columns, this,
+                                           std::ref( aLHS ), tFirst, tLast );
+                }
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        KroneckerSolver::factorize( const uint aDirection, const Matrix< real > & aElementMassMatrix )
+        {
+            index_t tN = mNumberOfBasisPerDimension( aDirection );
+            uint    tP = mOrder ;
+
+            BELFEM_ERROR( aElementMassMatrix.n_rows() == tP + 1,
+                          "element matrix must be of size p+1" );
+
+            // assemble the banded matrix, A( a, a-m ) = tL( m, a )
+            Matrix< real > & tL = mFactors( aDirection );
+            tL.set_size( tP + 1, tN, 0.0 );
+
+            index_t tNumberOfElements = tN - tP ;
+
+            for( index_t e=0; e<tNumberOfElements; ++e )
+            {
+                for( uint j=0; j<=tP; ++j )
+                {
+                    for( uint i=j; i<=tP; ++i )
+                    {
+                        tL( i - j, e + i ) += aElementMassMatrix( i, j );
+                    }
+                }
+            }
+
+            // banded Cholesky decomposition, in place
+            for( index_t a=0; a<tN; ++a )
+            {
+                // first index in band
+                index_t tFirst = a < tP ? 0 : a - tP ;
+
+                for( index_t b=tFirst; b<a; ++b )
+                {
+                    real tValue = tL( a - b, a );
+
+                    index_t tStart = std::max( tFirst, b < tP ? 0 : b - tP );
+
+                    for( index_t c=tStart; c<b; ++c )
+                    {
+                        tValue -= tL( a - c, a ) * tL( b - c, b );
+                    }
+
+                    tL( a - b, a ) = tValue / tL( 0, b );
+                }
+
+                real tDiag = tL( 0, a );
+                for( index_t c=tFirst; c<a; ++c )
+                {
+                    tDiag -= tL( a - c, a ) * tL( a - c, a );
+                }
+
+                BELFEM_ERROR( tDiag > 0, "mass matrix in direction %u is not positive definite",
+                              ( unsigned int ) aDirection );
+
+                tL( 0, a ) = std::sqrt( tDiag );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        KroneckerSolver::solve_axis( const uint aDirection, real * aData ) const
+        {
+            const Matrix< real > & tL = mFactors( aDirection );
+
+            index_t tN = mNumberOfBasisPerDimension( aDirection );
+            uint    tP = mOrder ;
+
+            // the data is seen as [ outer ][ n ][ inner ]
+            index_t tInner = 1 ;
+            for( uint d=0; d<aDirection; ++d )
+            {
+                tInner *= mNumberOfBasisPerDimension( d );
+            }
+            index_t tOuter = mNumberOfBasis / ( tInner * tN );
+
+            for( index_t o=0; o<tOuter; ++o )
+            {
+                real * tBlock = aData + o * tN * tInner ;
+
+                // forward substitution L y = b, the inner loops
+                // run over contiguous memory
+                for( index_t a=0; a<tN; ++a )
+                {
+                    real * tRowA = tBlock + a * tInner ;
+                    index_t tFirst = a < tP ? 0 : a - tP ;
+
+                    for( index_t c=tFirst; c<a; ++c )
+                    {
+                        const real tFactor = tL( a - c, a );
+                        const real * tRowC = tBlock + c * tInner ;
+
+                        for( index_t i=0; i<tInner; ++i )
+                        {
+                            tRowA[ i ] -= tFactor * tRowC[ i ];
+                        }
+                    }
+
+                    const real tScale = 1.0 / tL( 0, a );
+                    for( index_t i=0; i<tInner; ++i )
+                    {
+                        tRowA[ i ] *= tScale ;
+                    }
+                }
+
+                // backward substitution L^T x = y
+                for( index_t a=tN; a>0; --a )
+                {
+                    real * tRowA = tBlock + ( a - 1 ) * tInner ;
+                    index_t tLast = std::min( a + tP, tN );
+
+                    for( index_t c=a; c<tLast; ++c )
+                    {
+                        const real tFactor = tL( c - a + 1, c );
+                        const real * tRowC = tBlock + c * tInner ;
+
+                        for( index_t i=0; i<tInner; ++i )
+                        {
+                            tRowA[ i ] -= tFactor * tRowC[ i ];
+                        }
+                    }
+
+                    const real tScale = 1.0 / tL( 0, a - 1 );
+                    for( index_t i=0; i<tInner; ++i )
+                    {
+                        tRowA[ i ] *= tScale ;
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        KroneckerSolver::solve_columns(
+                      Matrix< real > & aLHS,
+                const index_t aFirst,
+                const index_t aLast ) const
+        {
+            // work vector, since the matrix may use padded columns
+            Vector< real > tWork( mNumberOfBasis );
+
+            for( index_t f=aFirst; f<aLast; ++f )
+            {
+                for( index_t k=0; k<mNumberOfBasis; ++k )
+                {
+                    tWork( k ) = aLHS( k, f );
+                }
+
+                for( uint d=0; d<mNumberOfDimensions; ++d )
+                {
+                    this->solve_axis( d, tWork.ptr() );
+                }
+
+                for( index_t k=0; k<mNumberOfBasis; ++k )
+                {
+                    aLHS( k, f ) = tWork( k );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
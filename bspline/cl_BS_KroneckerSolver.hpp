@@ -0,0 +1,115 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#ifndef BELFEM_CL_BS_KRONECKERSOLVER_HPP
+#define BELFEM_CL_BS_KRONECKERSOLVER_HPP
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+
+namespace belfem
+{
+    namespace bspline
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Solves the mass matrix system of a B-Spline fit on a tensor grid.
+         *
+         * On a regular grid, the mass matrix is the Kronecker product
+         * M = Mz x My x Mx of the 1D mass matrices, which are banded
+         * with a half bandwidth of p. Therefore, only the 1D matrices
+         * are factorized ( banded Cholesky ), and the system is solved
+         * by applying the inverse of each 1D matrix along its axis.
+         * The memory needed is of the order of the number of basis.
+         */
+        class KroneckerSolver
+        {
+            const uint mNumberOfDimensions ;
+
+            // half bandwidth of the 1D matrices
+            const uint mOrder ;
+
+            // number of basis per dimension
+            const Vector< index_t > mNumberOfBasisPerDimension ;
+
+            index_t mNumberOfBasis ;
+
+            // Cholesky factors for each direction, stored as
+            // L( a, a-m ) = mFactors( d )( m, a )
+            Cell< Matrix< real > > mFactors ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aOrder                     order of the B-Splines
+             * @param aNumberOfBasisPerDimension number of basis along each axis
+             * @param aElementMassMatrices       1D mass matrix of one element
+             *                                   for each direction, sorted by
+             *                                   basis offset
+             */
+            KroneckerSolver(
+                    const uint                     aOrder,
+                    const Vector< index_t >      & aNumberOfBasisPerDimension,
+                    const Cell< Matrix< real > > & aElementMassMatrices );
+
+//------------------------------------------------------------------------------
+
+            ~KroneckerSolver() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * solve the system for several right hand sides
+             *
+             * @param aRHS              one column per field
+             * @param aLHS              solution, one column per field
+             * @param aNumberOfThreads  0: use all available cores
+             */
+            void
+            solve( const Matrix< real > & aRHS,
+                         Matrix< real > & aLHS,
+                   const uint aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // assemble and factorize the 1D matrix of one direction
+            void
+            factorize( const uint aDirection, const Matrix< real > & aElementMassMatrix );
+
+//------------------------------------------------------------------------------
+
+            // apply the inverse of the 1D matrix along one axis
+            void
+            solve_axis( const uint aDirection, real * aData ) const ;
+
+//------------------------------------------------------------------------------
+
+            // worker: solve the columns [ aFirst, aLast )
+            void
+            solve_columns(
+                          Matrix< real > & aLHS,
+                    const index_t aFirst,
+                    const index_t aLast ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_BS_KRONECKERSOLVER_HPP
@@ -9,10 +9,14 @@
  * See the top-level LICENSE file for the complete license and disclaimer.
  */
 
+#include <thread>
+#include <algorithm>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "commtools.hpp"
 #include "cl_BS_LookupTable.hpp"
-#include "cl_IF_InterpolationFunctionFactory.hpp"
-#include "meshtools.hpp"
+#include "cl_Mesh.hpp"
 
 namespace belfem
 {
@@ -21,15 +25,10 @@ namespace belfem
 //------------------------------------------------------------------------------
 
         LookupTable::LookupTable( const string aPath ) :
-            mMesh( new Mesh( aPath, comm_rank(), false ) ),
-            mNumberOfDimensions( mMesh->number_of_dimensions() ),
-            mElementType( mMesh->block( 1 )->element_type() ),
-            mNumberOfNodesPerElement( mesh::number_of_nodes( mElementType ) ),
-            mElements( mMesh->block( 1 )->elements() )
+            mTable( LookupTable::load_table( aPath ) ),
+            mNumberOfDimensions( mTable->number_of_dimensions() ),
+            mOrder( mTable->order() )
         {
-            this->create_interpolation_function() ;
-            this->create_field_map();
-            this->polpulate_globals() ;
             this->compute_derivative_factors() ;
         }
 
@@ -37,111 +36,69 @@ namespace belfem
 
         LookupTable::~LookupTable()
         {
-            delete mInterpolationFunction ;
-            delete mMesh ;
+            delete mTable ;
         }
 
 //------------------------------------------------------------------------------
 
-        void
-        LookupTable::create_interpolation_function()
+        FlatTable *
+        LookupTable::load_table( const string & aPath )
         {
-            // create a factory
-            fem::InterpolationFunctionFactory tFactory;
-
-            // create the function
-            mInterpolationFunction = tFactory.create_lagrange_function( mElementType );
+            string tCachePath = FlatTable::cache_path( aPath );
 
-            // container for parameter coordinates
-            mXi.set_size( mNumberOfDimensions );
-
-            // vector for shape funtion
-            mN.set_size( 1, mNumberOfNodesPerElement );
+            // check if we were given the compiled table directly
+            if( FlatTable::is_compiled( aPath ) )
+            {
+                return new FlatTable( aPath );
+            }
+            else if( LookupTable::cache_is_valid( aPath, tCachePath ) )
+            {
+                return new FlatTable( tCachePath );
+            }
+            else
+            {
+                // read the mesh and compile the table
+                Mesh tMesh( aPath, comm_rank(), false );
 
-            // matrix for first derivatives
-            mdNdxi.set_size( mNumberOfDimensions, mNumberOfNodesPerElement );
+                FlatTable * aTable = new FlatTable( tMesh );
 
-            // matrix for second derivatives
-            md2Ndxi2.set_size(
-                    std::pow( 3, mNumberOfDimensions),
-                    mNumberOfNodesPerElement );
+                // write the compiled table next to the mesh,
+                // if we are allowed to write into that directory
+                std::size_t tSlash = tCachePath.find_last_of( '/' );
+                string tDirectory = tSlash == string::npos ? "." : tCachePath.substr( 0, tSlash );
 
+                if( comm_rank() == 0 && access( tDirectory.c_str(), W_OK ) == 0 )
+                {
+                    aTable->save( tCachePath, aPath );
+                }
 
-            // allocate values vector
-            mValues.set_size( mNumberOfNodesPerElement );
+                return aTable ;
+            }
         }
 
 //------------------------------------------------------------------------------
 
-        void
-        LookupTable::create_field_map()
+        bool
+        LookupTable::cache_is_valid( const string & aMeshPath, const string & aCachePath )
         {
-            mFieldMap.clear();
-
-            uint tNumFields = mMesh->number_of_fields() ;
+            struct stat tMeshStat ;
+            struct stat tCacheStat ;
 
-            for ( uint k=0; k<tNumFields; ++k )
+            if( stat( aCachePath.c_str(), &tCacheStat ) != 0 )
             {
-                mFieldMap[ mMesh->field( k )->label() ] = k ;
+                // compiled table does not exist
+                return false ;
             }
-        }
-
-//------------------------------------------------------------------------------
-
-        void
-        LookupTable::polpulate_globals()
-        {
-            // allocate vectors
-            mNumberOfElementsPerDirection.set_size( mNumberOfDimensions );
-
-            mPmin.set_size( mNumberOfDimensions );
-            mPmax.set_size( mNumberOfDimensions );
-            mElementLength.set_size( mNumberOfDimensions );
-
-            mNumberOfElementsPerDirection( 0 ) = ( index_t ) mMesh->global_variable_data("numElemsX" );
-            mPmin( 0 ) = mMesh->global_variable_data("Xmin" );
-            mPmax( 0 ) = mMesh->global_variable_data("Xmax" );
-            mElementLength( 0 ) = mMesh->global_variable_data("DeltaX");
-
-            if( mNumberOfDimensions > 1 )
+            else if( stat( aMeshPath.c_str(), &tMeshStat ) != 0 )
             {
-                mNumberOfElementsPerDirection( 1 ) = ( index_t ) mMesh->global_variable_data("numElemsY" );
-                mPmin( 1 ) = mMesh->global_variable_data("Ymin" );
-                mPmax( 1 ) = mMesh->global_variable_data("Ymax" );
-                mElementLength( 1 ) = mMesh->global_variable_data("DeltaY");
-
-                if( mNumberOfDimensions > 2 )
-                {
-                    mNumberOfElementsPerDirection( 2 ) = ( index_t ) mMesh->global_variable_data("numElemsZ" );
-                    mPmin( 2 ) = mMesh->global_variable_data("Zmin" );
-                    mPmax( 2 ) = mMesh->global_variable_data("Zmax" );
-                    mElementLength( 2 ) = mMesh->global_variable_data("DeltaZ");
-                }
+                // there is only the compiled table
+                return true ;
             }
-        }
-
-//------------------------------------------------------------------------------
-
-        void
-        LookupTable::update_values( const index_t aFieldIndex )
-        {
-            // check if values are up to data
-            if( aFieldIndex != mFieldIndex || mElementID != mElement->id() )
+            else
             {
-                // get field from mesh
-                const Vector< real > & tField = mMesh->field( aFieldIndex )->data();
-
-                // populate data
-                for ( uint k = 0; k < mNumberOfNodesPerElement; ++k )
-                {
-                    mValues( k ) = tField( mElement->node( k )->index());
-                }
-
-                // remember field index
-                mFieldIndex = aFieldIndex;
-
-                // remember ID of element
-                mElementID = mElement->id();
+                // a copied or restored mesh can be older than the table,
+                // so the size and time of the mesh are compared
+                return FlatTable::was_compiled_from( aCachePath, aMeshPath );
             }
         }
 
@@ -150,21 +107,21 @@ namespace belfem
         void
         LookupTable::compute_derivative_factors()
         {
-            mScaleDX    = 2.0 / mElementLength( 0 );
-            mScaleD2X2  = 4.0 / ( mElementLength( 0 ) * mElementLength( 0 ) );
+            mScaleDX    = 2.0 / mTable->element_length( 0 );
+            mScaleD2X2  = mScaleDX * mScaleDX ;
 
             if( mNumberOfDimensions > 1 )
             {
-                mScaleDY    = 2.0 / mElementLength( 1 );
-                mScaleD2Y2  = 4.0 / ( mElementLength( 1 ) * mElementLength( 1 ) );
-                mScaleDXDY  = 4.0 / ( mElementLength( 0 ) * mElementLength( 1 ) );
+                mScaleDY    = 2.0 / mTable->element_length( 1 );
+                mScaleD2Y2  = mScaleDY * mScaleDY ;
+                mScaleDXDY  = mScaleDX * mScaleDY ;
 
                 if( mNumberOfDimensions > 2 )
                 {
-                    mScaleDZ    = 2.0 / mElementLength( 2 );
-                    mScaleD2Z2  = 4.0 / ( mElementLength( 2 ) * mElementLength( 2 ) );
-                    mScaleDXDZ  = 4.0 / ( mElementLength( 0 ) * mElementLength( 2 ) );
-                    mScaleDYDZ  = 4.0 / ( mElementLength( 1 ) * mElementLength( 2 ) );
+                    mScaleDZ    = 2.0 / mTable->element_length( 2 );
+                    mScaleD2Z2  = mScaleDZ * mScaleDZ ;
+                    mScaleDXDZ  = mScaleDX * mScaleDZ ;
+                    mScaleDYDZ  = mScaleDY * mScaleDZ ;
                 }
             }
         }
@@ -172,34 +129,23 @@ namespace belfem
 //------------------------------------------------------------------------------
 
         real
-        LookupTable::compute_value( const index_t & aFieldIndex, const real aX )
+        LookupTable::compute_value( const index_t & aFieldIndex, const real aX ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 1, "Table must be of dimension 1" );
 
-            // check if element must be updated
-            if( aX != mX )
-            {
-                // select the element from the mesh
-                this->select_element( aX );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
+            // shape function
+            real tN[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
 
-                // remember x value
-                mX = aX ;
-            }
+            // parameter coordinate
+            real tXi ;
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            // select the element
+            index_t tI = mTable->locate( 0, aX, tXi );
 
             // compute interpolation function
-            mInterpolationFunction->N( mXi, mN );
+            mTable->shape( 0, tXi, tN );
 
-            // compute the value
-            Vector< real > tVal( ( mN * mValues ) );
-
-            // return the value
-            return  tVal( 0 );
+            return this->interpolate( mTable->values( aFieldIndex, tI ), tN );
         }
 
 //------------------------------------------------------------------------------
@@ -208,36 +154,29 @@ namespace belfem
         LookupTable::compute_value(
                 const index_t & aFieldIndex,
                 const real aX,
-                const real aY )
+                const real aY ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 2, "Table must be of dimension 2" );
 
-            // check if element must be updated
-            if( aX != mX || aY != mY )
-            {
-                // select the element from the mesh
-                this->select_element( aX, aY );
+            // shape functions
+            real tNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
 
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
+            // parameter coordinates
+            real tXi ;
+            real tEta ;
 
-                // remember x and y values
-                mX = aX ;
-                mY = aY ;
-            }
-
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            // select the element
+            index_t tI = mTable->locate( 0, aX, tXi );
+            index_t tJ = mTable->locate( 1, aY, tEta );
 
             // compute interpolation function
-            mInterpolationFunction->N( mXi, mN );
-
-            // compute the value
-            Vector< real > tVal( ( mN * mValues ) );
+            mTable->shape( 0, tXi, tNx );
+            mTable->shape( 0, tEta, tNy );
 
-            // return the value
-            return  tVal( 0 );
+            return this->interpolate(
+                    mTable->values( aFieldIndex, mTable->element_index( tI, tJ ) ),
+                    tNx, tNy );
         }
 
 //------------------------------------------------------------------------------
@@ -247,71 +186,259 @@ namespace belfem
                 const index_t & aFieldIndex,
                 const real aX,
                 const real aY,
-                const real & aZ )
+                const real & aZ ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 3, "Table must be of dimension 3" );
 
-            // check if element must be updated
-            if( aX != mX || aY != mY )
+            // shape functions
+            real tNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNz[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+
+            // parameter coordinates
+            real tXi ;
+            real tEta ;
+            real tZeta ;
+
+            // select the element
+            index_t tI = mTable->locate( 0, aX, tXi );
+            index_t tJ = mTable->locate( 1, aY, tEta );
+            index_t tK = mTable->locate( 2, aZ, tZeta );
+
+            // compute interpolation function
+            mTable->shape( 0, tXi, tNx );
+            mTable->shape( 0, tEta, tNy );
+            mTable->shape( 0, tZeta, tNz );
+
+            return this->interpolate(
+                    mTable->values( aFieldIndex, mTable->element_index( tI, tJ, tK ) ),
+                    tNx, tNy, tNz );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        LookupTable::evaluate(
+                const Vector< index_t > & aFieldIndices,
+                const Vector< real >    & aX,
+                      Matrix< real >    & aValues,
+                const uint                aDerivative,
+                const uint                aNumberOfThreads ) const
+        {
+            BELFEM_ERROR( mNumberOfDimensions == 1, "Table must be of dimension 1" );
+
+            BELFEM_ERROR( aDerivative < 2, "invalid derivative flag: %u",
+                          ( unsigned int ) aDerivative );
+
+            Cell< const Vector< real > * > tPoints( 1, &aX );
+
+            this->evaluate_batch( aFieldIndices, tPoints, aValues, aDerivative, aNumberOfThreads );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        LookupTable::evaluate(
+                const Vector< index_t > & aFieldIndices,
+                const Vector< real >    & aX,
+                const Vector< real >    & aY,
+                      Matrix< real >    & aValues,
+                const uint                aDerivative,
+                const uint                aNumberOfThreads ) const
+        {
+            BELFEM_ERROR( mNumberOfDimensions == 2, "Table must be of dimension 2" );
+
+            BELFEM_ERROR( aX.length() == aY.length(),
+                          "length of coordinate vectors does not match ( %lu vs %lu )",
+                          ( long unsigned int ) aX.length(),
+                          ( long unsigned int ) aY.length() );
+
+            BELFEM_ERROR( aDerivative < 3, "invalid derivative flag: %u",
+                          ( unsigned int ) aDerivative );
+
+            Cell< const Vector< real > * > tPoints( 2, nullptr );
+            tPoints( 0 ) = &aX ;
+            tPoints( 1 ) = &aY ;
+
+            this->evaluate_batch( aFieldIndices, tPoints, aValues, aDerivative, aNumberOfThreads );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        LookupTable::evaluate_batch(
+                const Vector< index_t > & aFieldIndices,
+                const Cell< const Vector< real > * > & aPoints,
+                      Matrix< real > & aValues,
+                const uint aDerivative,
+                const uint aNumberOfThreads ) const
+        {
+            index_t tNumberOfPoints = aPoints( 0 )->length() ;
+
+            aValues.set_size( aFieldIndices.length(), tNumberOfPoints );
+
+            if( tNumberOfPoints == 0 )
             {
-                // select the element from the mesh
-                this->select_element( aX, aY, aZ );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
-                this->compute_xi( 2, aZ );
-
-                // remember x and y values
-                mX = aX ;
-                mY = aY ;
-                mZ = aZ ;
+                return;
             }
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            // step 1: find the element for each point
+            Vector< index_t > tElementIndices( tNumberOfPoints );
 
-            // compute interpolation function
-            mInterpolationFunction->N( mXi, mN );
+            real tXi ;
+            for( index_t k=0; k<tNumberOfPoints; ++k )
+            {
+                index_t tIndex = 0 ;
+
+                // loop backwards over dimensions: i + nx * ( j + ny * k )
+                for( int i=mNumberOfDimensions-1; i>=0; --i )
+                {
+                    tIndex = tIndex * mTable->number_of_elements( i )
+                            + mTable->locate( i, ( *aPoints( i ) )( k ), tXi );
+                }
+                tElementIndices( k ) = tIndex ;
+            }
+
+            // step 2: sort the points by element, so that the values
+            // of each element are only loaded once
+            Cell< index_t > tSortedPoints( tNumberOfPoints, 0 );
+            for( index_t k=0; k<tNumberOfPoints; ++k )
+            {
+                tSortedPoints( k ) = k ;
+            }
+
+            std::sort( tSortedPoints.begin(), tSortedPoints.end(),
+                       [ &tElementIndices ]( const index_t aA, const index_t aB ) -> bool
+                       {
+                           return tElementIndices( aA ) < tElementIndices( aB ) ;
+                       } );
+
+            // step 3: distribute the work
+            index_t tNumberOfThreads = aNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : aNumberOfThreads ;
+
+            // it makes no sense to spawn a thread for only a few points
+            tNumberOfThreads = std::max( ( index_t ) 1,
+                    std::min( tNumberOfThreads, tNumberOfPoints / 64 ) );
+
+            if( tNumberOfThreads == 1 )
+            {
+                this->evaluate_sorted_points( aFieldIndices, aPoints,
+                                              tElementIndices, tSortedPoints,
+                                              0, tNumberOfPoints,
+                                              aValues, aDerivative );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                index_t tChunk = tNumberOfPoints / tNumberOfThreads ;
 
-            // compute the value
-            Vector< real > tVal( ( mN * mValues ) );
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    index_t tFirst = t * tChunk ;
+                    index_t tLast  = t == tNumberOfThreads - 1 ? tNumberOfPoints : tFirst + tChunk ;
+
+                    // each thread writes into its own columns of aValues
+                    tThreads.emplace_back( &LookupTable::evaluate_sorted_points, this,
+                                           std::cref( aFieldIndices ),
+                                           std::cref( aPoints ),
+                                           std::cref( tElementIndices ),
+                                           std::cref( tSortedPoints ),
+                                           tFirst, tLast,
+                                           std::ref( aValues ),
+                                           aDerivative );
+                }
 
-            // return the value
-            return  tVal( 0 );
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
         }
 
 //------------------------------------------------------------------------------
 
-        real
-        LookupTable::compute_derivative(
-                const index_t  aFieldIndex,
-                const real     aX )
+        void
+        LookupTable::evaluate_sorted_points(
+                const Vector< index_t > & aFieldIndices,
+                const Cell< const Vector< real > * > & aPoints,
+                const Vector< index_t > & aElementIndices,
+                const Cell< index_t > & aSortedPoints,
+                const index_t aFirst,
+                const index_t aLast,
+                      Matrix< real > & aValues,
+                const uint aDerivative ) const
         {
-            BELFEM_ASSERT( mNumberOfDimensions == 1, "Table must be of dimension 1" );
+            uint tNumberOfFields = aFieldIndices.length() ;
 
-            // check if element must be updated
-            if( aX != mX )
+            // shape functions per direction
+            real tN[ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+
+            // parameter coordinate
+            real tXi ;
+
+            // direction of derivative and scaling factor
+            uint tDirection = aDerivative == 0 ? 0 : aDerivative - 1 ;
+            real tScale = aDerivative == 0 ? 1.0 : 2.0 / mTable->element_length( tDirection );
+
+            for( index_t k=aFirst; k<aLast; ++k )
             {
-                // select the element from the mesh
-                this->select_element( aX );
+                index_t tPoint = aSortedPoints( k );
+                index_t tElement = aElementIndices( tPoint );
 
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
+                // compute the shape functions
+                for( uint i=0; i<mNumberOfDimensions; ++i )
+                {
+                    mTable->locate( i, ( *aPoints( i ) )( tPoint ), tXi );
+                    mTable->shape( aDerivative > 0 && i == tDirection ? 1 : 0, tXi, tN[ i ] );
+                }
 
-                // remember x value
-                mX = aX ;
+                // compute values for all fields
+                for( uint f=0; f<tNumberOfFields; ++f )
+                {
+                    const real * tValues = mTable->values( aFieldIndices( f ), tElement );
+
+                    switch( mNumberOfDimensions )
+                    {
+                        case( 1 ) :
+                        {
+                            aValues( f, tPoint ) = tScale * this->interpolate( tValues, tN[ 0 ] );
+                            break ;
+                        }
+                        case( 2 ) :
+                        {
+                            aValues( f, tPoint ) = tScale * this->interpolate( tValues, tN[ 0 ], tN[ 1 ] );
+                            break ;
+                        }
+                        default:
+                        {
+                            aValues( f, tPoint ) = tScale * this->interpolate( tValues, tN[ 0 ], tN[ 1 ], tN[ 2 ] );
+                            break ;
+                        }
+                    }
+                }
             }
+        }
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+//------------------------------------------------------------------------------
 
-            // compute interpolation function
-            mInterpolationFunction->dNdXi( mXi, mdNdxi );
+        real
+        LookupTable::compute_derivative(
+                const index_t  aFieldIndex,
+                const real     aX ) const
+        {
+            BELFEM_ASSERT( mNumberOfDimensions == 1, "Table must be of dimension 1" );
+
+            real tdN[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tXi ;
+
+            index_t tI = mTable->locate( 0, aX, tXi );
+
+            mTable->shape( 1, tXi, tdN );
 
-            // compute the value
-            Vector< real > aDerivative(mdNdxi * mValues * mScaleDX );
-            return aDerivative( 0 );
+            return mScaleDX * this->interpolate( mTable->values( aFieldIndex, tI ), tdN );
         }
 
 //------------------------------------------------------------------------------
@@ -320,37 +447,33 @@ namespace belfem
         LookupTable::compute_derivative(
                 const index_t aFieldIndex,
                 const real aX,
-                const real aY )
+                const real aY ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 2, "Table must be of dimension 2" );
 
-            // check if element must be updated
-            if( aX != mX || aY != mY )
-            {
-                // select the element from the mesh
-                this->select_element( aX, aY );
+            real tNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tdNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tdNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
 
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
+            real tXi ;
+            real tEta ;
 
-                // remember x and y values
-                mX = aX ;
-                mY = aY ;
-            }
+            index_t tI = mTable->locate( 0, aX, tXi );
+            index_t tJ = mTable->locate( 1, aY, tEta );
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            mTable->shape( 0, tXi, tNx );
+            mTable->shape( 0, tEta, tNy );
+            mTable->shape( 1, tXi, tdNx );
+            mTable->shape( 1, tEta, tdNy );
 
-            // compute interpolation function
-            mInterpolationFunction->dNdXi( mXi, mdNdxi );
+            const real * tValues = mTable->values( aFieldIndex, mTable->element_index( tI, tJ ) );
 
-            // compute the values
-            Vector< real > aDerivative( mdNdxi * mValues );
+            Vector< real > aDerivative( 2 );
 
-            // transform derivatives
-            aDerivative( 0 ) *= mScaleDX ;
-            aDerivative( 1 ) *= mScaleDY ;
+            // compute and transform derivatives
+            aDerivative( 0 ) = mScaleDX * this->interpolate( tValues, tdNx, tNy );
+            aDerivative( 1 ) = mScaleDY * this->interpolate( tValues, tNx, tdNy );
 
             return aDerivative ;
         }
@@ -362,41 +485,40 @@ namespace belfem
                 const index_t aFieldIndex,
                 const real aX,
                 const real aY,
-                const real aZ )
+                const real aZ ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 3, "Table must be of dimension 3" );
 
-            // check if element must be updated
-            if ( aX != mX || aY != mY )
-            {
-                // select the element from the mesh
-                this->select_element( aX, aY, aZ );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
-                this->compute_xi( 2, aZ );
-
-                // remember x and y values
-                mX = aX;
-                mY = aY;
-                mZ = aZ;
-            }
+            real tNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tNz[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tdNx[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tdNy[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tdNz[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            real tXi ;
+            real tEta ;
+            real tZeta ;
 
-            // compute interpolation function
-            mInterpolationFunction->dNdXi( mXi, mdNdxi );
+            index_t tI = mTable->locate( 0, aX, tXi );
+            index_t tJ = mTable->locate( 1, aY, tEta );
+            index_t tK = mTable->locate( 2, aZ, tZeta );
 
-            // compute the values
-            Vector< real > aDerivative( mdNdxi * mValues );
+            mTable->shape( 0, tXi, tNx );
+            mTable->shape( 0, tEta, tNy );
+            mTable->shape( 0, tZeta, tNz );
+            mTable->shape( 1, tXi, tdNx );
+            mTable->shape( 1, tEta, tdNy );
+            mTable->shape( 1, tZeta, tdNz );
 
+            const real * tValues = mTable->values( aFieldIndex, mTable->element_index( tI, tJ, tK ) );
 
-            // transform derivatives
-            aDerivative( 0 ) *= mScaleDX ;
-            aDerivative( 1 ) *= mScaleDY ;
-            aDerivative( 2 ) *= mScaleDZ ;
+            Vector< real > aDerivative( 3 );
+
+            // compute and transform derivatives
+            aDerivative( 0 ) = mScaleDX * this->interpolate( tValues, tdNx, tNy, tNz );
+            aDerivative( 1 ) = mScaleDY * this->interpolate( tValues, tNx, tdNy, tNz );
+            aDerivative( 2 ) = mScaleDZ * this->interpolate( tValues, tNx, tNy, tdNz );
 
             return aDerivative ;
         }
@@ -405,33 +527,18 @@ namespace belfem
         real
         LookupTable::compute_second_derivative(
                 const index_t    aFieldIndex,
-                const real       aX )
+                const real       aX ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 1, "Table must be of dimension 1" );
 
-            // check if element must be updated
-            if( aX != mX )
-            {
-                // select the element from the mesh
-                this->select_element( aX );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
+            real td2N[ BELFEM_BSPLINE_MAX_ORDER + 1 ];
+            real tXi ;
 
-                // remember x value
-                mX = aX ;
-            }
+            index_t tI = mTable->locate( 0, aX, tXi );
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            mTable->shape( 2, tXi, td2N );
 
-            // compute interpolation function
-            mInterpolationFunction->d2NdXi2( mXi, md2Ndxi2 );
-
-            // compute the value
-            Vector< real > aDerivative( md2Ndxi2 * mValues * mScaleD2X2 );
-
-            return aDerivative( 0 );
+            return mScaleD2X2 * this->interpolate( mTable->values( aFieldIndex, tI ), td2N );
         }
 
 //------------------------------------------------------------------------------
@@ -440,38 +547,21 @@ namespace belfem
         LookupTable::compute_second_derivative(
                 const index_t aFieldIndex,
                 const real aX,
-                const real aY )
+                const real aY ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 2, "Table must be of dimension 2" );
 
-            // check if element must be updated
-            if( aX != mX || aY != mY )
-            {
-                // select the element from the mesh
-                this->select_element( aX, aY );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
+            const real tPoint[ 2 ] = { aX, aY };
+            real tResult[ 6 ];
 
-                // remember x and y values
-                mX = aX ;
-                mY = aY ;
-            }
-
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
-
-            // compute interpolation function
-            mInterpolationFunction->d2NdXi2( mXi, md2Ndxi2 );
+            this->run_kernel< 2 >( aFieldIndex, tPoint, tResult );
 
-            // compute the values
-            Vector< real > aDerivative( md2Ndxi2 * mValues );
+            Vector< real > aDerivative( 3 );
 
             // transform derivatives
-            aDerivative( 0 ) *= mScaleD2X2 ;
-            aDerivative( 1 ) *= mScaleD2Y2 ;
-            aDerivative( 2 ) *= mScaleDXDY ;
+            aDerivative( 0 ) = mScaleD2X2 * tResult[ 3 ];
+            aDerivative( 1 ) = mScaleD2Y2 * tResult[ 4 ];
+            aDerivative( 2 ) = mScaleDXDY * tResult[ 5 ];
 
             return aDerivative;
         }
@@ -483,48 +573,111 @@ namespace belfem
                 const index_t aFieldIndex,
                 const real aX,
                 const real aY,
-                const real aZ )
+                const real aZ ) const
         {
             BELFEM_ASSERT( mNumberOfDimensions == 3, "Table must be of dimension 3" );
 
-            // check if element must be updated
-            if ( aX != mX || aY != mY )
+            const real tPoint[ 3 ] = { aX, aY, aZ };
+            real tResult[ 10 ];
+
+            this->run_kernel< 3 >( aFieldIndex, tPoint, tResult );
+
+            Vector< real > aDerivative( 6 );
+
+            // transform derivatives
+            aDerivative( 0 ) = mScaleD2X2 * tResult[ 4 ];
+            aDerivative( 1 ) = mScaleD2Y2 * tResult[ 5 ];
+            aDerivative( 2 ) = mScaleD2Z2 * tResult[ 6 ];
+            aDerivative( 3 ) = mScaleDYDZ * tResult[ 7 ];
+            aDerivative( 4 ) = mScaleDXDZ * tResult[ 8 ];
+            aDerivative( 5 ) = mScaleDXDY * tResult[ 9 ];
+
+            return aDerivative ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        LookupTable::compute_value_and_derivatives(
+                const index_t    aFieldIndex,
+                const real       aX,
+                Vector< real > & aResult ) const
+        {
+            BELFEM_ASSERT( mNumberOfDimensions == 1, "Table must be of dimension 1" );
+
+            if( aResult.length() != 3 )
             {
-                // select the element from the mesh
-                this->select_element( aX, aY, aZ );
-
-                // compute parameter coordinate
-                this->compute_xi( 0, aX );
-                this->compute_xi( 1, aY );
-                this->compute_xi( 2, aZ );
-
-                // remember x and y values
-                mX = aX;
-                mY = aY;
-                mZ = aZ;
+                aResult.set_size( 3 );
             }
 
-            // update field if element or field was changed
-            this->update_values( aFieldIndex );
+            this->run_kernel< 1 >( aFieldIndex, &aX, aResult.ptr() );
 
-            // compute interpolation function
-            mInterpolationFunction->d2NdXi2( mXi, md2Ndxi2 );
+            // transform derivatives
+            aResult( 1 ) *= mScaleDX ;
+            aResult( 2 ) *= mScaleD2X2 ;
+        }
 
-            // compute the values
-            Vector< real > aDerivative( md2Ndxi2 * mValues );
+//------------------------------------------------------------------------------
 
+        void
+        LookupTable::compute_value_and_derivatives(
+                const index_t    aFieldIndex,
+                const real       aX,
+                const real       aY,
+                Vector< real > & aResult ) const
+        {
+            BELFEM_ASSERT( mNumberOfDimensions == 2, "Table must be of dimension 2" );
+
+            if( aResult.length() != 6 )
+            {
+                aResult.set_size( 6 );
+            }
+
+            const real tPoint[ 2 ] = { aX, aY };
+
+            this->run_kernel< 2 >( aFieldIndex, tPoint, aResult.ptr() );
 
             // transform derivatives
-            aDerivative( 0 ) *= mScaleD2X2 ;
-            aDerivative( 1 ) *= mScaleD2Y2 ;
-            aDerivative( 2 ) *= mScaleD2Z2 ;
-            aDerivative( 3 ) *= mScaleDYDZ ;
-            aDerivative( 4 ) *= mScaleDXDZ ;
-            aDerivative( 5 ) *= mScaleDXDY ;
+            aResult( 1 ) *= mScaleDX ;
+            aResult( 2 ) *= mScaleDY ;
+            aResult( 3 ) *= mScaleD2X2 ;
+            aResult( 4 ) *= mScaleD2Y2 ;
+            aResult( 5 ) *= mScaleDXDY ;
+        }
 
-            return aDerivative ;
+//------------------------------------------------------------------------------
+
+        void
+        LookupTable::compute_value_and_derivatives(
+                const index_t    aFieldIndex,
+                const real       aX,
+                const real       aY,
+                const real       aZ,
+                Vector< real > & aResult ) const
+        {
+            BELFEM_ASSERT( mNumberOfDimensions == 3, "Table must be of dimension 3" );
+
+            if( aResult.length() != 10 )
+            {
+                aResult.set_size( 10 );
+            }
+
+            const real tPoint[ 3 ] = { aX, aY, aZ };
+
+            this->run_kernel< 3 >( aFieldIndex, tPoint, aResult.ptr() );
+
+            // transform derivatives
+            aResult( 1 ) *= mScaleDX ;
+            aResult( 2 ) *= mScaleDY ;
+            aResult( 3 ) *= mScaleDZ ;
+            aResult( 4 ) *= mScaleD2X2 ;
+            aResult( 5 ) *= mScaleD2Y2 ;
+            aResult( 6 ) *= mScaleD2Z2 ;
+            aResult( 7 ) *= mScaleDYDZ ;
+            aResult( 8 ) *= mScaleDXDZ ;
+            aResult( 9 ) *= mScaleDXDY ;
         }
 
 //------------------------------------------------------------------------------
     }
-}
\ No newline at end of file
+}
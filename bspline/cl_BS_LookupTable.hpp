@@ -19,9 +19,8 @@
 #include "cl_Map.hpp"
 #include "cl_Vector.hpp"
 #include "cl_Matrix.hpp"
-#include "cl_Mesh.hpp"
-#include "cl_Element.hpp"
-#include "cl_IF_InterpolationFunction.hpp"
+#include "cl_BS_FlatTable.hpp"
+#include "cl_BS_TensorKernel.hpp"
 
 namespace belfem
 {
@@ -31,36 +30,13 @@ namespace belfem
 
         class LookupTable
         {
-            // mesh containing interpolation data
-            Mesh * mMesh = nullptr;
+            // compiled table data
+            FlatTable * mTable = nullptr ;
 
-            const int mNumberOfDimensions;
+            const uint mNumberOfDimensions;
 
-            // element type of first block
-            const ElementType mElementType;
-
-            const uint mNumberOfNodesPerElement ;
-
-            // elements of first block
-            Cell< mesh::Element * > & mElements;
-
-            // interpolation function for table
-            fem::InterpolationFunction * mInterpolationFunction;
-
-            // map to field lables with indices
-            Map< string, index_t > mFieldMap ;
-
-            // first point of bounding box
-            Vector< real > mPmin;
-
-            // last point of bounding box
-            Vector< real > mPmax;
-
-            // how many elements exist
-            Vector< index_t > mNumberOfElementsPerDirection;
-
-            // size of one element
-            Vector< real > mElementLength;
+            // order of the table
+            const uint mOrder ;
 
             // factors for derivatives
             real mScaleDX    = BELFEM_QUIET_NAN ;
@@ -74,35 +50,17 @@ namespace belfem
             real mScaleDXDZ  = BELFEM_QUIET_NAN ;
             real mScaleDXDY  = BELFEM_QUIET_NAN ;
 
-            // current values for x, y and z
-            real mX = BELFEM_REAL_MAX ;
-            real mY = BELFEM_REAL_MAX ;
-            real mZ = BELFEM_REAL_MAX ;
-
-            // current element
-            mesh::Element * mElement = nullptr ;
-
-            // parameter coordinates on element
-            Vector< real > mXi ;
-
-            // vector containing values for interpolation function
-            Matrix< real > mN ;
-            Matrix< real > mdNdxi ;
-            Matrix< real > md2Ndxi2 ;
-
-            // vector containing values for one element
-            Vector< real > mValues ;
-
-            // remmember index of stored field
-            uint mFieldIndex = BELFEM_INT_MAX ;
-
-            // remember id of selected element when field was colleted
-            index_t mElementID = 0 ;
-
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
 
+            /**
+             * Opens a table. aPath can either point to a compiled table,
+             * or to a mesh file. In the latter case, the compiled table
+             * is created once and written next to it, see
+             * FlatTable::cache_path. The compiled table is used directly
+             * if it is up to date.
+             */
             LookupTable( const string aPath );
 
 //------------------------------------------------------------------------------
@@ -113,13 +71,22 @@ namespace belfem
 
             // get a field index from a lanbel
             inline index_t
-            field_index( const string & aLabel );
+            field_index( const string & aLabel ) const ;
+
+//------------------------------------------------------------------------------
+
+            // expose the compiled table
+            inline const FlatTable &
+            table() const
+            {
+                return *mTable ;
+            }
 
 //------------------------------------------------------------------------------
             real
             compute_value(
                     const index_t & aFieldIndex,
-                    const real aX );
+                    const real aX ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -127,7 +94,7 @@ namespace belfem
             compute_value(
                     const index_t & aFieldIndex,
                     const real aX,
-                    const real aY );
+                    const real aY ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -136,14 +103,58 @@ namespace belfem
                     const index_t & aFieldIndex,
                     const real aX,
                     const real aY,
-                    const real & aZ );
+                    const real & aZ ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * batched evaluation of several fields on a 1D table.
+             * The points are sorted by element, and all requested fields
+             * are evaluated for each element at once. This function
+             * does not touch the member state of the table and can
+             * therefore be called concurrently on a shared table.
+             *
+             * @param aFieldIndices     indices of the fields to evaluate
+             * @param aX                coordinates of the points
+             * @param aValues           result ( number of fields x number of points )
+             * @param aDerivative       0: value, 1: d/dx
+             * @param aNumberOfThreads  0: use all available cores
+             */
+            void
+            evaluate(
+                    const Vector< index_t > & aFieldIndices,
+                    const Vector< real >    & aX,
+                          Matrix< real >    & aValues,
+                    const uint                aDerivative=0,
+                    const uint                aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * batched evaluation of several fields on a 2D table
+             *
+             * @param aFieldIndices     indices of the fields to evaluate
+             * @param aX                first coordinates of the points
+             * @param aY                second coordinates of the points
+             * @param aValues           result ( number of fields x number of points )
+             * @param aDerivative       0: value, 1: d/dx, 2: d/dy
+             * @param aNumberOfThreads  0: use all available cores
+             */
+            void
+            evaluate(
+                    const Vector< index_t > & aFieldIndices,
+                    const Vector< real >    & aX,
+                    const Vector< real >    & aY,
+                          Matrix< real >    & aValues,
+                    const uint                aDerivative=0,
+                    const uint                aNumberOfThreads=0 ) const ;
 
 //------------------------------------------------------------------------------
 
             real
             compute_derivative(
                     const index_t aFieldIndex,
-                    const real aX );
+                    const real aX ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -151,7 +162,7 @@ namespace belfem
             compute_derivative(
                     const index_t aFieldIndex,
                     const real aX,
-                    const real aY );
+                    const real aY ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -160,14 +171,14 @@ namespace belfem
                     const index_t aFieldIndex,
                     const real aX,
                     const real aY,
-                    const real aZ );
+                    const real aZ ) const ;
 
 //------------------------------------------------------------------------------
 
             real
             compute_second_derivative(
                     const index_t aFieldIndex,
-                    const real aX );
+                    const real aX ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -175,7 +186,7 @@ namespace belfem
             compute_second_derivative(
                     const index_t aFieldIndex,
                     const real aX,
-                    const real aY );
+                    const real aY ) const ;
 
 //------------------------------------------------------------------------------
 
@@ -184,41 +195,71 @@ namespace belfem
                     const index_t aFieldIndex,
                     const real aX,
                     const real aY,
-                    const real aZ );
+                    const real aZ ) const ;
 
 //------------------------------------------------------------------------------
 
-            inline const real  &
-            min( const uint aIndex ) const
-            {
-                return mPmin( aIndex );
-            }
+            /**
+             * computes the value, the gradient and the Hessian
+             * in one pass over the element
+             *
+             * @param aResult  v, dx, dxx
+             */
+            void
+            compute_value_and_derivatives(
+                    const index_t    aFieldIndex,
+                    const real       aX,
+                    Vector< real > & aResult ) const ;
 
 //------------------------------------------------------------------------------
 
-            inline const real  &
-            max( const uint aIndex ) const
-            {
-                return mPmax( aIndex );
-            }
+            /**
+             * computes the value, the gradient and the Hessian
+             * in one pass over the element
+             *
+             * @param aResult  v, dx, dy, dxx, dyy, dxy
+             */
+            void
+            compute_value_and_derivatives(
+                    const index_t    aFieldIndex,
+                    const real       aX,
+                    const real       aY,
+                    Vector< real > & aResult ) const ;
 
-//------------------------------------------------------------------------------
-        private:
 //------------------------------------------------------------------------------
 
+            /**
+             * computes the value, the gradient and the Hessian
+             * in one pass over the element
+             *
+             * @param aResult  v, dx, dy, dz, dxx, dyy, dzz, dyz, dxz, dxy
+             */
             void
-            create_field_map();
+            compute_value_and_derivatives(
+                    const index_t    aFieldIndex,
+                    const real       aX,
+                    const real       aY,
+                    const real       aZ,
+                    Vector< real > & aResult ) const ;
 
 //------------------------------------------------------------------------------
 
-            void
-            create_interpolation_function();
+            inline const real  &
+            min( const uint aIndex ) const
+            {
+                return mTable->min( aIndex );
+            }
 
 //------------------------------------------------------------------------------
 
-            void
-            polpulate_globals();
+            inline const real  &
+            max( const uint aIndex ) const
+            {
+                return mTable->max( aIndex );
+            }
 
+//------------------------------------------------------------------------------
+        private:
 //------------------------------------------------------------------------------
 
             void
@@ -226,49 +267,72 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
-            // element grabber for 1D problem
-            inline mesh::Element *
-            get_element( const index_t & aI );
+            // load the compiled table, or create it from the mesh
+            static FlatTable *
+            load_table( const string & aPath );
 
 //------------------------------------------------------------------------------
 
-            // element grabber for 2D problem
-            inline mesh::Element *
-            get_element( const index_t & aI, const index_t & aJ );
+            // checks if the compiled table exists and was created from this mesh
+            static bool
+            cache_is_valid( const string & aMeshPath, const string & aCachePath );
 
 //------------------------------------------------------------------------------
 
-            // element grabber for 3D problem
-            inline mesh::Element *
-            get_element( const index_t & aI, const index_t & aJ, const index_t & aK );
+            // tensor product for 1D problem
+            inline real
+            interpolate( const real * aValues, const real * aNx ) const ;
 
 //------------------------------------------------------------------------------
 
-            // element finder for 1D problem
-            inline void
-            select_element( const real aX );
+            // tensor product for 2D problem
+            inline real
+            interpolate( const real * aValues, const real * aNx, const real * aNy ) const ;
 
 //------------------------------------------------------------------------------
 
-            // element finder for 2D problem
-            inline void
-            select_element( const real aX, const real aY );
+            // tensor product for 3D problem
+            inline real
+            interpolate( const real * aValues,
+                         const real * aNx,
+                         const real * aNy,
+                         const real * aNz ) const ;
 
 //------------------------------------------------------------------------------
 
-            // element finder for 3D problem
+            // computes the shape functions and calls the tensor kernel,
+            // result is with respect to the parameter coordinates
+            template< uint D >
             inline void
-            select_element( const real aX, const real aY, const real & aZ );
+            run_kernel( const index_t aFieldIndex,
+                        const real  * aPoint,
+                              real  * aResult ) const ;
 
 //------------------------------------------------------------------------------
 
+            // sorts the points by element and distributes them over the threads
             void
-            update_values( const index_t aFieldIndex );
+            evaluate_batch(
+                    const Vector< index_t > & aFieldIndices,
+                    const Cell< const Vector< real > * > & aPoints,
+                          Matrix< real > & aValues,
+                    const uint aDerivative,
+                    const uint aNumberOfThreads ) const ;
 
 //------------------------------------------------------------------------------
 
-            inline void
-            compute_xi( const uint & aI, const real aX );
+            // worker for batched evaluation, processes the sorted points
+            // within [ aFirst, aLast )
+            void
+            evaluate_sorted_points(
+                    const Vector< index_t > & aFieldIndices,
+                    const Cell< const Vector< real > * > & aPoints,
+                    const Vector< index_t > & aElementIndices,
+                    const Cell< index_t > & aSortedPoints,
+                    const index_t aFirst,
+                    const index_t aLast,
+                          Matrix< real > & aValues,
+                    const uint aDerivative ) const ;
 
 //------------------------------------------------------------------------------
         };
@@ -278,112 +342,107 @@ namespace belfem
 
         // get a field index from a lanbel
         inline index_t
-        LookupTable::field_index( const string & aLabel )
+        LookupTable::field_index( const string & aLabel ) const
         {
-            return mFieldMap( aLabel );
+            return mTable->field_index( aLabel );
         }
 
 //------------------------------------------------------------------------------
-        // element grabber for 1D problem
-        mesh::Element *
-        LookupTable::get_element( const index_t & aI )
+
+        inline real
+        LookupTable::interpolate( const real * aValues, const real * aNx ) const
         {
-            BELFEM_ASSERT( aI < mNumberOfElementsPerDirection( 0 ),
-                          "index i out of bounds: %lu > %lu",
-                          ( long unsigned int ) aI,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 0 ) );
+            real aValue = 0.0 ;
 
-            return mElements( aI );
+            for( uint i=0; i<=mOrder; ++i )
+            {
+                aValue += aNx[ i ] * aValues[ i ];
+            }
 
+            return aValue ;
         }
 
 //------------------------------------------------------------------------------
 
-        // element grabber for 2D problem
-        mesh::Element *
-        LookupTable::get_element( const index_t & aI, const index_t & aJ )
+        inline real
+        LookupTable::interpolate( const real * aValues, const real * aNx, const real * aNy ) const
         {
-            BELFEM_ASSERT( aI < mNumberOfElementsPerDirection( 0 ),
-                          "index i out of bounds: %lu > %lu",
-                          ( long unsigned int ) aI,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 0 ) );
+            real aValue = 0.0 ;
 
-            BELFEM_ASSERT( aJ < mNumberOfElementsPerDirection( 1 ),
-                          "index j out of bounds: %lu > %lu",
-                          ( long unsigned int ) aJ,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 1 ) );
+            for( uint j=0; j<=mOrder; ++j )
+            {
+                aValue += aNy[ j ] * this->interpolate( aValues, aNx );
+                aValues += mOrder + 1 ;
+            }
 
-            return mElements( aJ*mNumberOfElementsPerDirection( 0 ) + aI );
+            return aValue ;
         }
 
-
 //------------------------------------------------------------------------------
 
-        // element grabber for 1D problem
-        mesh::Element *
-        LookupTable::get_element( const index_t & aI, const index_t & aJ, const index_t & aK )
+        inline real
+        LookupTable::interpolate(
+                const real * aValues,
+                const real * aNx,
+                const real * aNy,
+                const real * aNz ) const
         {
-            BELFEM_ASSERT( aI < mNumberOfElementsPerDirection( 0 ),
-                          "index i out of bounds: %lu > %lu",
-                          ( long unsigned int ) aI,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 0 ) );
-
-            BELFEM_ASSERT( aJ < mNumberOfElementsPerDirection( 1 ),
-                          "index j out of bounds: %lu > %lu",
-                          ( long unsigned int ) aJ,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 1 ) );
-
-            BELFEM_ASSERT( aK < mNumberOfElementsPerDirection( 2 ),
-                          "index j out of bounds: %lu > %lu",
-                          ( long unsigned int ) aK,
-                          ( long unsigned int ) mNumberOfElementsPerDirection( 2 ) );
-
-            return mElements( mNumberOfElementsPerDirection( 0 )
-                *( mNumberOfElementsPerDirection( 1 ) * aK + aJ ) + aI );
-        }
+            real aValue = 0.0 ;
 
-//------------------------------------------------------------------------------
+            for( uint k=0; k<=mOrder; ++k )
+            {
+                aValue += aNz[ k ] * this->interpolate( aValues, aNx, aNy );
+                aValues += ( mOrder + 1 ) * ( mOrder + 1 );
+            }
 
-        // element finder for 1D problem
-        void
-        LookupTable::select_element( const real aX )
-        {
-            mElement = this->get_element( std::floor( ( aX - mPmin( 0 ) ) / mElementLength( 0 ) ) );
+            return aValue ;
         }
 
 //------------------------------------------------------------------------------
 
-        // element finder for 2D problem
-        void
-        LookupTable::select_element( const real aX, const real aY )
+        template< uint D >
+        inline void
+        LookupTable::run_kernel(
+                const index_t aFieldIndex,
+                const real  * aPoint,
+                      real  * aResult ) const
         {
-            mElement = this->get_element(
-                    std::floor( ( aX - mPmin( 0 ) ) / mElementLength( 0 ) ),
-                    std::floor( ( aY - mPmin( 1 ) ) / mElementLength( 1 ) ) );
-        }
+            // shape functions [ direction ][ derivative ][ node ]
+            real tN[ D ][ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ];
 
-//------------------------------------------------------------------------------
+            index_t tIJK[ 3 ] = { 0, 0, 0 };
 
-        // element finder for 3D problem
-        void
-        LookupTable::select_element( const real aX, const real aY, const real & aZ )
-        {
-            mElement = this->get_element(
-                    std::floor( ( aX - mPmin( 0 ) ) / mElementLength( 0 ) ),
-                    std::floor( ( aY - mPmin( 1 ) ) / mElementLength( 1 ) ),
-                    std::floor( ( aZ - mPmin( 2 ) ) / mElementLength( 2 ) ) );
-        }
+            real tXi ;
 
-//------------------------------------------------------------------------------
+            for( uint i=0; i<D; ++i )
+            {
+                tIJK[ i ] = mTable->locate( i, aPoint[ i ], tXi );
+                mTable->shape( 0, tXi, tN[ i ][ 0 ] );
+                mTable->shape( 1, tXi, tN[ i ][ 1 ] );
+                mTable->shape( 2, tXi, tN[ i ][ 2 ] );
+            }
 
-        void
-        LookupTable::compute_xi( const uint & aI, const real aX )
-        {
-            mXi( aI ) = 2.0 * ( aX - mElement->node( 0 )->x( aI )) /
-                        mElementLength( aI ) - 1.0;
+            const real * tValues = mTable->values( aFieldIndex,
+                    mTable->element_index( tIJK[ 0 ], tIJK[ 1 ], tIJK[ 2 ] ) );
 
-            BELFEM_ASSERT( mXi( aI ) >= -1.0 && mXi( aI ) <= 1.0,
-                    "Wrong element selected" );
+            switch( mOrder )
+            {
+                case( 1 ) :
+                {
+                    TensorKernel< D, 1 >::evaluate( tValues, tN, aResult );
+                    break ;
+                }
+                case( 2 ) :
+                {
+                    TensorKernel< D, 2 >::evaluate( tValues, tN, aResult );
+                    break ;
+                }
+                default:
+                {
+                    TensorKernel< D, 3 >::evaluate( tValues, tN, aResult );
+                    break ;
+                }
+            }
         }
 
 //------------------------------------------------------------------------------
@@ -9,6 +9,8 @@
  * See the top-level LICENSE file for the complete license and disclaimer.
  */
 
+#include <thread>
+
 #include "commtools.hpp"
 #include "cl_BS_Mapper.hpp"
 #include "fn_linspace.hpp"
@@ -32,9 +34,11 @@ namespace belfem
                         const uint aOrder,
                         const Vector <index_t> & aNumberOfElementsPerDimension,
                         const Vector< real > & aMinPoint,
-                        const Vector< real > & aMaxPoint ) :
+                        const Vector< real > & aMaxPoint,
+                        const bool aUseKroneckerSolver ) :
                 mNumberOfDimensions( aNumberOfDimensions ),
                 mOrder( aOrder ),
+                mUseKroneckerSolver( aUseKroneckerSolver ),
                 mNumberOfElementsPerDimension( aNumberOfElementsPerDimension ),
                 mOffset( aMinPoint )
         {
@@ -47,10 +51,23 @@ namespace belfem
             this->create_integration_grid();
             this->create_basis();
             this->create_bspline_elements();
-            this->create_basis_adjency();
+            this->create_colors();
             this->create_interpolation_function();
             this->compute_element_matrices();
-            this->create_jacobian();
+
+            if( mUseKroneckerSolver )
+            {
+                // the basis graph is not needed in this mode
+                this->create_kronecker_solver();
+            }
+            else
+            {
+                this->create_basis_adjency();
+                this->create_jacobian();
+
+                // create the solver
+                mSolver = new Solver( SolverType::UMFPACK );
+            }
         }
 
 //------------------------------------------------------------------------------
@@ -62,6 +79,10 @@ namespace belfem
                 delete tField ;
             }
 
+            delete mSolver ;
+
+            delete mKroneckerSolver ;
+
             delete mJacobian ;
 
             delete mInterpolationFunction;
@@ -116,12 +137,15 @@ namespace belfem
         void
         Mapper::compute_node_values()
         {
-            uint tNumberOfFields = mFields.size() ;
+            this->compute_dofs();
+        }
 
-            for( uint k=0; k<tNumberOfFields; ++k )
-            {
-                this->compute_dofs( k );
-            }
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::set_number_of_threads( const uint aNumberOfThreads )
+        {
+            mNumberOfThreads = aNumberOfThreads ;
         }
 
 //------------------------------------------------------------------------------
@@ -531,12 +555,6 @@ namespace belfem
             // allocate memory
             mBasis.set_size( mNumberOfBasis, nullptr );
 
-            // vector with dofs
-            mDOFs.set_size( mNumberOfBasis );
-
-            // vector with RHS
-            mRHS.set_size( mNumberOfBasis );
-
             for ( index_t k = 0; k<mNumberOfBasis; ++k )
             {
                 // create dof
@@ -557,12 +575,6 @@ namespace belfem
 
             mElements.set_size( tElements.size(), nullptr );
 
-            // create elements and link them to the elements on the mesh
-            for( index_t k=0; k<mNumberOfElements; ++k )
-            {
-                mElements( k ) = new Element( tElements( k ) );
-            }
-
             // get basis indices
             const Matrix< index_t > & tIndex = mTMatrix->basis_index();
 
@@ -644,6 +656,9 @@ namespace belfem
 
                             // increment anchor offset
                             tOff += 1;
+
+                            // add element to container
+                            mElements( tCount++ ) = tElement;
                         }
                         tOff0 += mNumberOfBasisPerDimension( 0 );
                     }
@@ -692,6 +707,86 @@ namespace belfem
 
         }
 
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::create_colors()
+        {
+            // elements that are more than p apart in each direction
+            // do not share any basis
+            uint tNumberOfColors = 1 ;
+            for( uint i=0; i<mNumberOfDimensions; ++i )
+            {
+                tNumberOfColors *= mOrder + 1 ;
+            }
+
+            mColors.set_size( tNumberOfColors, Cell< index_t >() );
+
+            index_t tNx = mNumberOfElementsPerDimension( 0 );
+            index_t tNy = mNumberOfDimensions > 1 ? mNumberOfElementsPerDimension( 1 ) : 1 ;
+
+            // elements are ordered as i + nx * ( j + ny * k )
+            for( index_t e=0; e<mNumberOfElements; ++e )
+            {
+                index_t tI = e % tNx ;
+                index_t tJ = ( e / tNx ) % tNy ;
+                index_t tK = e / ( tNx * tNy );
+
+                uint tColor = ( tK % ( mOrder + 1 ) * ( mOrder + 1 )
+                                + tJ % ( mOrder + 1 ) ) * ( mOrder + 1 )
+                              + tI % ( mOrder + 1 ) ;
+
+                mColors( tColor ).push( e );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::run_colored( void ( Mapper::*aWorker )(
+                const Cell< index_t > &,
+                const index_t,
+                const index_t ) )
+        {
+            index_t tMaxNumberOfThreads = mNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : mNumberOfThreads ;
+
+            for( const Cell< index_t > & tElementIndices : mColors )
+            {
+                index_t tNumberOfElements = tElementIndices.size() ;
+
+                // it makes no sense to spawn a thread for only a few elements
+                index_t tNumberOfThreads = std::max( ( index_t ) 1,
+                        std::min( tMaxNumberOfThreads, tNumberOfElements / 16 ) );
+
+                if( tNumberOfThreads == 1 )
+                {
+                    ( this->*aWorker )( tElementIndices, 0, tNumberOfElements );
+                }
+                else
+                {
+                    std::vector< std::thread > tThreads ;
+                    tThreads.reserve( tNumberOfThreads );
+
+                    index_t tChunk = tNumberOfElements / tNumberOfThreads ;
+
+                    for( index_t t=0; t<tNumberOfThreads; ++t )
+                    {
+                        index_t tFirst = t * tChunk ;
+                        index_t tLast  = t == tNumberOfThreads - 1 ? tNumberOfElements : tFirst + tChunk ;
+
+                        tThreads.emplace_back( aWorker, this, std::cref( tElementIndices ), tFirst, tLast );
+                    }
+
+                    // the next color may only start when this one is done
+                    for( std::thread & tThread : tThreads )
+                    {
+                        tThread.join() ;
+                    }
+                }
+            }
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -710,15 +805,28 @@ namespace belfem
         {
             mJacobian = new SpMatrix( reinterpret_cast< Graph& >( mBasis ) );
 
+            // assemble jacobian
+            this->run_colored( &Mapper::assemble_jacobian );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::assemble_jacobian(
+                const Cell< index_t > & aElementIndices,
+                const index_t aFirst,
+                const index_t aLast )
+        {
             // convert pointer to ref
             SpMatrix & tM = *mJacobian ;
 
             // index vector
             Vector< index_t > tIndex( mNumberOfBasisPerElement );
 
-            // assemble jacobian
-            for( Element * tElement : mElements )
+            for( index_t e=aFirst; e<aLast; ++e )
             {
+                Element * tElement = mElements( aElementIndices( e ) );
+
                 // populate element index
                 for( uint k=0; k<mNumberOfBasisPerElement; ++k )
                 {
@@ -736,6 +844,80 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::create_kronecker_solver()
+        {
+            // the 1D element
+            TMatrix tTMatrix( 1, mOrder );
+
+            fem::InterpolationFunctionFactory tFactory ;
+
+            fem::InterpolationFunction * tFunction = tFactory.create_lagrange_function(
+                    tTMatrix.lagrange_type() );
+
+            Vector< real > tWeights ;
+            Matrix< real > tPoints ;
+
+            intpoints( IntegrationScheme::GAUSSCLASSIC,
+                       GeometryType::LINE,
+                       2*mOrder + 1,
+                       tWeights,
+                       tPoints );
+
+            uint tNumberOfIntegrationPoints = tWeights.length() ;
+            uint tNumberOfNodes = mOrder + 1 ;
+
+            // the N Matrix
+            Matrix< real > tN( 1, tNumberOfNodes );
+
+            // vector with point data
+            Vector< real > tXi( 1 );
+
+            // offset of each basis in the 1D element
+            const Matrix< index_t > & tIndex = tTMatrix.basis_index() ;
+
+            Cell< Matrix< real > > tMassMatrices( mNumberOfDimensions, Matrix< real >() );
+
+            for( uint d=0; d<mNumberOfDimensions; ++d )
+            {
+                // determinant of geometry jacobian
+                real tDetJ = 0.5 * mElementLength( d );
+
+                Matrix< real > tM( tNumberOfNodes, tNumberOfNodes, 0.0 );
+
+                for( uint k=0; k<tNumberOfIntegrationPoints; ++k )
+                {
+                    tXi( 0 ) = tPoints( 0, k );
+
+                    // compute function
+                    tFunction->N( tXi, tN );
+
+                    // add value to mass matrix
+                    tM += tWeights( k ) * trans( tN ) * tN * tDetJ ;
+                }
+
+                Matrix< real > tB = trans( tTMatrix.Lagrange() ) * tM * tTMatrix.Lagrange() ;
+
+                // sort by basis offset
+                Matrix< real > & tMass = tMassMatrices( d );
+                tMass.set_size( tNumberOfNodes, tNumberOfNodes );
+
+                for( uint j=0; j<tNumberOfNodes; ++j )
+                {
+                    for( uint i=0; i<tNumberOfNodes; ++i )
+                    {
+                        tMass( tIndex( 0, i ), tIndex( 0, j ) ) = tB( i, j );
+                    }
+                }
+            }
+
+            delete tFunction ;
+
+            mKroneckerSolver = new KroneckerSolver( mOrder, mNumberOfBasisPerDimension, tMassMatrices );
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -790,17 +972,79 @@ namespace belfem
 //------------------------------------------------------------------------------
 
         void
-        Mapper::compute_dofs( const index_t aFieldIndex )
+        Mapper::compute_dofs()
         {
-            // reset vectors
-            mDOFs.fill( 0.0 );
-            mRHS.fill( 0.0 );
+            index_t tNumberOfFields = mFields.size() ;
 
-            // get field
-            Vector< real > & tIntegrationField = *mFields( aFieldIndex );
+            // reset matrices
+            mDOFs.set_size( mNumberOfBasis, tNumberOfFields, 0.0 );
+            mRHS.set_size( mNumberOfBasis, tNumberOfFields, 0.0 );
 
-            // init counter
-            index_t tCount = 0;
+            // assemble the right hand sides of all fields
+            this->run_colored( &Mapper::assemble_rhs );
+
+            // solve system, the jacobian is only factorized once
+            if( mUseKroneckerSolver )
+            {
+                mKroneckerSolver->solve( mRHS, mDOFs, mNumberOfThreads );
+            }
+            else
+            {
+                mSolver->solve( *mJacobian, mDOFs, mRHS ) ;
+            }
+
+            // create the nodal fields
+            Cell< Vector< real > * > tNodeFields( tNumberOfFields, nullptr );
+            for( index_t f=0; f<tNumberOfFields; ++f )
+            {
+                tNodeFields( f ) = & mMesh->create_field( mFieldLables( f ) );
+            }
+
+            // unflag all nodes on the mesh
+            mMesh->unflag_all_nodes();
+
+            // each thread writes into its own fields
+            index_t tNumberOfThreads = mNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : mNumberOfThreads ;
+
+            tNumberOfThreads = std::max( ( index_t ) 1, std::min( tNumberOfThreads, tNumberOfFields ) );
+
+            if( tNumberOfThreads == 1 )
+            {
+                this->compute_field_node_values( tNodeFields, 0, tNumberOfFields );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                index_t tChunk = tNumberOfFields / tNumberOfThreads ;
+
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    index_t tFirst = t * tChunk ;
+                    index_t tLast  = t == tNumberOfThreads - 1 ? tNumberOfFields : tFirst + tChunk ;
+
+                    tThreads.emplace_back( &Mapper::compute_field_node_values, this,
+                                           std::cref( tNodeFields ), tFirst, tLast );
+                }
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mapper::assemble_rhs(
+                const Cell< index_t > & aElementIndices,
+                const index_t aFirst,
+                const index_t aLast )
+        {
+            index_t tNumberOfFields = mFields.size() ;
 
             // number of integration points per element
             uint tNumberOfIntegrationPoints = mIntegrationWeights.length() ;
@@ -811,64 +1055,73 @@ namespace belfem
             // RHS vector
             Vector< real > tRHS( mNumberOfBasisPerElement );
 
-            // loop over all elements
-            for ( Element * tElement : mElements )
+            for( index_t e=aFirst; e<aLast; ++e )
             {
-                // populate values vector
-                for( uint i=0; i<tNumberOfIntegrationPoints; ++i )
-                {
-                   tValues( i ) =  tIntegrationField( tCount++ );
-                }
+                Element * tElement = mElements( aElementIndices( e ) );
 
-                tRHS = mRhsMatrix * tValues ;
+                // the integration points of an element are stored contiguously
+                index_t tOffset = aElementIndices( e ) * tNumberOfIntegrationPoints ;
 
-                // add values to RHS
-                for( uint k=0; k<mNumberOfBasisPerElement; ++k )
+                for( index_t f=0; f<tNumberOfFields; ++f )
                 {
-                    mRHS( tElement->basis( k )->index() ) += tRHS( k );
-                }
-            }
+                    // get field
+                    const Vector< real > & tIntegrationField = *mFields( f );
 
-            // create a solver
-            Solver tSolver( SolverType::UMFPACK );
+                    // populate values vector
+                    for( uint i=0; i<tNumberOfIntegrationPoints; ++i )
+                    {
+                        tValues( i ) = tIntegrationField( tOffset + i );
+                    }
 
-            // solve system
-            tSolver.solve( *mJacobian, mDOFs, mRHS ) ;
+                    tRHS = mRhsMatrix * tValues ;
 
-            // delete the solver
-            tSolver.free();
+                    // add values to RHS
+                    for( uint k=0; k<mNumberOfBasisPerElement; ++k )
+                    {
+                        mRHS( tElement->basis( k )->index(), f ) += tRHS( k );
+                    }
+                }
+            }
+        }
 
-            // create the nodal field
-            Vector< real > & tField = mMesh->create_field( mFieldLables( aFieldIndex ) );
+//------------------------------------------------------------------------------
 
+        void
+        Mapper::compute_field_node_values(
+                const Cell< Vector< real > * > & aNodeFields,
+                const index_t aFirst,
+                const index_t aLast )
+        {
             // transformation matrix
-           const Matrix< real > & tT = mTMatrix->Lagrange() ;
+            const Matrix< real > & tT = mTMatrix->Lagrange() ;
 
             // DOFs and node values
             Vector< real > tBasis( mNumberOfBasisPerElement );
             Vector< real > tNodes( mNumberOfNodesPerElement );
 
-            // unflag all nodes on the mesh
-            mMesh->unflag_all_nodes();
-
-            // now, we can compute the node values
-            for( Element * tElement : mElements )
+            for( index_t f=aFirst; f<aLast; ++f )
             {
-                // populate basis
-                for( uint k=0; k<mNumberOfBasisPerElement; ++k )
+                Vector< real > & tField = *aNodeFields( f );
+
+                // now, we can compute the node values
+                for( Element * tElement : mElements )
                 {
-                    tBasis( k ) = mDOFs( tElement->basis( k )->index() );
-                }
+                    // populate basis
+                    for( uint k=0; k<mNumberOfBasisPerElement; ++k )
+                    {
+                        tBasis( k ) = mDOFs( tElement->basis( k )->index(), f );
+                    }
 
-                // compute nodal values
-                tNodes = tT * tBasis ;
+                    // compute nodal values
+                    tNodes = tT * tBasis ;
 
-                // write values onto mesh
-                for( uint i=0; i<mNumberOfNodesPerElement; ++i )
-                {
-                    if( ! tElement->element()->node( i )->is_flagged() )
+                    // write values onto mesh
+                    for( uint i=0; i<mNumberOfNodesPerElement; ++i )
                     {
-                        tField( tElement->element()->node( i )->index() ) = tNodes( i );
+                        if( ! tElement->element()->node( i )->is_flagged() )
+                        {
+                            tField( tElement->element()->node( i )->index() ) = tNodes( i );
+                        }
                     }
                 }
             }
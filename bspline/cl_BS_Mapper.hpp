@@ -18,6 +18,8 @@
 #include "cl_BS_Basis.hpp"
 #include "cl_BS_Element.hpp"
 #include "cl_SpMatrix.hpp"
+#include "cl_Solver.hpp"
+#include "cl_BS_KroneckerSolver.hpp"
 #include "cl_IF_InterpolationFunction.hpp"
 
 namespace belfem
@@ -34,6 +36,10 @@ namespace belfem
             const uint mNumberOfDimensions ;
             const uint mOrder ;
 
+            // if set, the tensor structure of the mass matrix is used
+            // and no sparse jacobian is assembled
+            const bool mUseKroneckerSolver ;
+
             // number of elements per dimension
             const Vector< index_t > mNumberOfElementsPerDimension ;
 
@@ -74,10 +80,23 @@ namespace belfem
 
             Cell< Element * > mElements ;
 
+            // element indices grouped so that no two elements of the same color
+            // share a basis. Elements of one color can be assembled in parallel
+            Cell< Cell< index_t > > mColors ;
+
+            // number of threads for assembly, 0: use all available cores
+            uint mNumberOfThreads = 0 ;
+
             fem::InterpolationFunction * mInterpolationFunction = nullptr ;
 
             SpMatrix * mJacobian = nullptr ;
 
+            // the solver keeps the factorization of the jacobian
+            Solver * mSolver = nullptr ;
+
+            // alternative solver that uses the 1D mass matrices
+            KroneckerSolver * mKroneckerSolver = nullptr ;
+
             // mass matrix for one lagrange element
             Matrix< real > mMassMatrix ;
 
@@ -87,8 +106,9 @@ namespace belfem
             Cell< Vector< real > * > mFields ;
             Cell< string > mFieldLables ;
 
-            Vector< real > mRHS ;
-            Vector< real > mDOFs ;
+            // one column per field
+            Matrix< real > mRHS ;
+            Matrix< real > mDOFs ;
 
 //------------------------------------------------------------------------------
         public:
@@ -101,12 +121,16 @@ namespace belfem
              * @param aNumberOfElementsPerDiection
              * @param aMinPoint  point with small coordinates of bounding box
              * @param aMaxPoint  point with high coordinates of bounding box
+             * @param aUseKroneckerSolver  factorize only the 1D mass matrices
+             *                             instead of the full sparse jacobian,
+             *                             recommended for large 3D tables
              */
             Mapper( const uint aNumberOfDimensions,
                     const uint aOrder,
                     const Vector< index_t > & aNumberOfElementsPerDimension,
                     const Vector< real >    & aMinPoint,
-                    const Vector< real >    & aMaxPoint
+                    const Vector< real >    & aMaxPoint,
+                    const bool                aUseKroneckerSolver=false
                     );
 
 //------------------------------------------------------------------------------
@@ -144,9 +168,20 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
+            /**
+             * fits all fields at once. The jacobian is factorized
+             * only once, and all fields are solved as multiple
+             * right hand sides.
+             */
             void
             compute_node_values();
 
+//------------------------------------------------------------------------------
+
+            // set the number of threads for assembly, 0: use all available cores
+            void
+            set_number_of_threads( const uint aNumberOfThreads );
+
 //------------------------------------------------------------------------------
 
             void
@@ -213,6 +248,12 @@ namespace belfem
             void
             create_basis_adjency();
 
+//------------------------------------------------------------------------------
+
+            // group the elements by ( i mod p+1, j mod p+1, k mod p+1 )
+            void
+            create_colors();
+
 //------------------------------------------------------------------------------
 
             void
@@ -223,6 +264,11 @@ namespace belfem
             void
             create_jacobian();
 
+//------------------------------------------------------------------------------
+
+            void
+            create_kronecker_solver();
+
 //------------------------------------------------------------------------------
 
             void
@@ -231,7 +277,44 @@ namespace belfem
 //------------------------------------------------------------------------------
 
             void
-            compute_dofs( const index_t aFieldIndex );
+            compute_dofs();
+
+//------------------------------------------------------------------------------
+
+            // calls the worker for each color, elements of one color
+            // are distributed over the threads
+            void
+            run_colored( void ( Mapper::*aWorker )(
+                    const Cell< index_t > &,
+                    const index_t,
+                    const index_t ) );
+
+//------------------------------------------------------------------------------
+
+            // worker: add element mass matrices to the jacobian
+            void
+            assemble_jacobian(
+                    const Cell< index_t > & aElementIndices,
+                    const index_t aFirst,
+                    const index_t aLast );
+
+//------------------------------------------------------------------------------
+
+            // worker: add element contributions of all fields to the RHS
+            void
+            assemble_rhs(
+                    const Cell< index_t > & aElementIndices,
+                    const index_t aFirst,
+                    const index_t aLast );
+
+//------------------------------------------------------------------------------
+
+            // worker: compute the node values for the fields [ aFirst, aLast )
+            void
+            compute_field_node_values(
+                    const Cell< Vector< real > * > & aNodeFields,
+                    const index_t aFirst,
+                    const index_t aLast );
 
 //------------------------------------------------------------------------------
         };
@@ -0,0 +1,263 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#ifndef BELFEM_CL_BS_TENSORKERNEL_HPP
+#define BELFEM_CL_BS_TENSORKERNEL_HPP
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+#include <immintrin.h>
+#endif
+
+#include "typedefs.hpp"
+#include "cl_BS_FlatTable.hpp"
+
+namespace belfem
+{
+    namespace bspline
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Evaluates the value, the gradient and the Hessian of one field
+         * on one element in a single pass over the node values.
+         *
+         * The node values are contracted along the last direction first,
+         * so that each contraction works on contiguous rows of p+1 values.
+         * Since the order is a template parameter, all loops have a fixed
+         * length and are unrolled by the compiler.
+         *
+         * aN contains the 1D shape functions for each direction
+         * as [ direction ][ derivative ][ node ].
+         *
+         * The result is written as
+         *
+         * 1D : v, dx, dxx
+         * 2D : v, dx, dy, dxx, dyy, dxy
+         * 3D : v, dx, dy, dz, dxx, dyy, dzz, dyz, dxz, dxy
+         *
+         * with respect to the parameter coordinates.
+         */
+        template< uint D, uint P >
+        struct TensorKernel
+        {
+        };
+
+//------------------------------------------------------------------------------
+
+        // nodes per direction
+        template< uint P >
+        struct TensorRow
+        {
+            static constexpr uint N = P + 1 ;
+
+//------------------------------------------------------------------------------
+
+            // aResult += aFactor * aRow
+            static inline void
+            axpy( const real aFactor, const real * aRow, real * aResult )
+            {
+                for( uint i=0; i<N; ++i )
+                {
+                    aResult[ i ] += aFactor * aRow[ i ];
+                }
+            }
+
+//------------------------------------------------------------------------------
+
+            static inline real
+            dot( const real * aA, const real * aB )
+            {
+                real aValue = 0.0 ;
+                for( uint i=0; i<N; ++i )
+                {
+                    aValue += aA[ i ] * aB[ i ];
+                }
+                return aValue ;
+            }
+
+//------------------------------------------------------------------------------
+
+            // contract one row with the shape function and its derivatives
+            static inline void
+            contract( const real * aRow,
+                      const real aN[ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ],
+                      real & aValue, real & aD1, real & aD2 )
+            {
+                aValue = dot( aRow, aN[ 0 ] );
+                aD1    = dot( aRow, aN[ 1 ] );
+                aD2    = dot( aRow, aN[ 2 ] );
+            }
+        };
+
+//------------------------------------------------------------------------------
+#if defined( __AVX2__ ) && defined( __FMA__ )
+
+        // for a cubic table, one row fits exactly into one AVX register
+        template<>
+        struct TensorRow< 3 >
+        {
+            static constexpr uint N = 4 ;
+
+//------------------------------------------------------------------------------
+
+            static inline void
+            axpy( const real aFactor, const real * aRow, real * aResult )
+            {
+                _mm256_storeu_pd( aResult,
+                        _mm256_fmadd_pd( _mm256_set1_pd( aFactor ),
+                                         _mm256_loadu_pd( aRow ),
+                                         _mm256_loadu_pd( aResult ) ) );
+            }
+
+//------------------------------------------------------------------------------
+
+            static inline real
+            dot( const real * aA, const real * aB )
+            {
+                __m256d tP = _mm256_mul_pd( _mm256_loadu_pd( aA ), _mm256_loadu_pd( aB ) );
+                __m128d tS = _mm_add_pd( _mm256_castpd256_pd128( tP ), _mm256_extractf128_pd( tP, 1 ) );
+                return _mm_cvtsd_f64( _mm_add_sd( tS, _mm_unpackhi_pd( tS, tS ) ) );
+            }
+
+//------------------------------------------------------------------------------
+
+            static inline void
+            contract( const real * aRow,
+                      const real aN[ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ],
+                      real & aValue, real & aD1, real & aD2 )
+            {
+                __m256d tRow = _mm256_loadu_pd( aRow );
+
+                __m256d tA = _mm256_mul_pd( tRow, _mm256_loadu_pd( aN[ 0 ] ) );
+                __m256d tB = _mm256_mul_pd( tRow, _mm256_loadu_pd( aN[ 1 ] ) );
+                __m256d tC = _mm256_mul_pd( tRow, _mm256_loadu_pd( aN[ 2 ] ) );
+
+                // three horizontal sums at once
+                __m256d tAB = _mm256_hadd_pd( tA, tB );
+                __m256d tCC = _mm256_hadd_pd( tC, tC );
+
+                __m128d tS0 = _mm_add_pd( _mm256_castpd256_pd128( tAB ), _mm256_extractf128_pd( tAB, 1 ) );
+                __m128d tS1 = _mm_add_pd( _mm256_castpd256_pd128( tCC ), _mm256_extractf128_pd( tCC, 1 ) );
+
+                aValue = _mm_cvtsd_f64( tS0 );
+                aD1    = _mm_cvtsd_f64( _mm_unpackhi_pd( tS0, tS0 ) );
+                aD2    = _mm_cvtsd_f64( tS1 );
+            }
+        };
+
+#endif
+//------------------------------------------------------------------------------
+
+        template< uint P >
+        struct TensorKernel< 1, P >
+        {
+            static inline void
+            evaluate( const real * aValues,
+                      const real aN[][ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ],
+                      real * aResult )
+            {
+                TensorRow< P >::contract( aValues, aN[ 0 ], aResult[ 0 ], aResult[ 1 ], aResult[ 2 ] );
+            }
+        };
+
+//------------------------------------------------------------------------------
+
+        template< uint P >
+        struct TensorKernel< 2, P >
+        {
+            static inline void
+            evaluate( const real * aValues,
+                      const real aN[][ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ],
+                      real * aResult )
+            {
+                constexpr uint N = P + 1 ;
+
+                // rows contracted in y-direction: N, dN/deta, d2N/deta2
+                real tR[ 3 ][ N ] = {};
+
+                for( uint j=0; j<N; ++j )
+                {
+                    const real * tRow = aValues + j * N ;
+
+                    TensorRow< P >::axpy( aN[ 1 ][ 0 ][ j ], tRow, tR[ 0 ] );
+                    TensorRow< P >::axpy( aN[ 1 ][ 1 ][ j ], tRow, tR[ 1 ] );
+                    TensorRow< P >::axpy( aN[ 1 ][ 2 ][ j ], tRow, tR[ 2 ] );
+                }
+
+                // value, d/dxi, d2/dxi2
+                TensorRow< P >::contract( tR[ 0 ], aN[ 0 ], aResult[ 0 ], aResult[ 1 ], aResult[ 3 ] );
+
+                // d/deta
+                aResult[ 2 ] = TensorRow< P >::dot( tR[ 1 ], aN[ 0 ][ 0 ] );
+
+                // d2/deta2
+                aResult[ 4 ] = TensorRow< P >::dot( tR[ 2 ], aN[ 0 ][ 0 ] );
+
+                // d2/dxi deta
+                aResult[ 5 ] = TensorRow< P >::dot( tR[ 1 ], aN[ 0 ][ 1 ] );
+            }
+        };
+
+//------------------------------------------------------------------------------
+
+        template< uint P >
+        struct TensorKernel< 3, P >
+        {
+            static inline void
+            evaluate( const real * aValues,
+                      const real aN[][ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ],
+                      real * aResult )
+            {
+                constexpr uint N = P + 1 ;
+
+                // rows contracted in y- and z-direction
+                // [ derivative in y ][ derivative in z ]
+                real tR[ 3 ][ 3 ][ N ] = {};
+
+                for( uint k=0; k<N; ++k )
+                {
+                    for( uint j=0; j<N; ++j )
+                    {
+                        const real * tRow = aValues + ( k * N + j ) * N ;
+
+                        const real tNy0 = aN[ 1 ][ 0 ][ j ];
+                        const real tNy1 = aN[ 1 ][ 1 ][ j ];
+
+                        // only the combinations up to the second derivative
+                        TensorRow< P >::axpy( tNy0 * aN[ 2 ][ 0 ][ k ], tRow, tR[ 0 ][ 0 ] );
+                        TensorRow< P >::axpy( tNy1 * aN[ 2 ][ 0 ][ k ], tRow, tR[ 1 ][ 0 ] );
+                        TensorRow< P >::axpy( tNy0 * aN[ 2 ][ 1 ][ k ], tRow, tR[ 0 ][ 1 ] );
+                        TensorRow< P >::axpy( aN[ 1 ][ 2 ][ j ] * aN[ 2 ][ 0 ][ k ], tRow, tR[ 2 ][ 0 ] );
+                        TensorRow< P >::axpy( tNy0 * aN[ 2 ][ 2 ][ k ], tRow, tR[ 0 ][ 2 ] );
+                        TensorRow< P >::axpy( tNy1 * aN[ 2 ][ 1 ][ k ], tRow, tR[ 1 ][ 1 ] );
+                    }
+                }
+
+                // value, d/dxi, d2/dxi2
+                TensorRow< P >::contract( tR[ 0 ][ 0 ], aN[ 0 ], aResult[ 0 ], aResult[ 1 ], aResult[ 4 ] );
+
+                // first derivatives
+                aResult[ 2 ] = TensorRow< P >::dot( tR[ 1 ][ 0 ], aN[ 0 ][ 0 ] );
+                aResult[ 3 ] = TensorRow< P >::dot( tR[ 0 ][ 1 ], aN[ 0 ][ 0 ] );
+
+                // second derivatives
+                aResult[ 5 ] = TensorRow< P >::dot( tR[ 2 ][ 0 ], aN[ 0 ][ 0 ] );
+                aResult[ 6 ] = TensorRow< P >::dot( tR[ 0 ][ 2 ], aN[ 0 ][ 0 ] );
+                aResult[ 7 ] = TensorRow< P >::dot( tR[ 1 ][ 1 ], aN[ 0 ][ 0 ] );
+                aResult[ 8 ] = TensorRow< P >::dot( tR[ 0 ][ 1 ], aN[ 0 ][ 1 ] );
+                aResult[ 9 ] = TensorRow< P >::dot( tR[ 1 ][ 0 ], aN[ 0 ][ 1 ] );
+            }
+        };
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_BS_TENSORKERNEL_HPP
@@ -75,14 +75,7 @@ namespace belfem
 
             if ( !mStatevals.test( BELFEM_STATEVAL_M ))
             {
-                real tM = mTable.compute_value( mIndexM, aT, this->pi( aT, aP ));
-
-                // set the M-value
-                mStatevals.set( BELFEM_STATEVAL_M, tM );
-
-                // set the R-value
-                mStatevals.set( BELFEM_STATEVAL_R, constant::Rm / tM );
-
+                this->update_M( aT, aP );
             }
 
             return mStatevals.get( BELFEM_STATEVAL_M );
@@ -97,18 +90,7 @@ namespace belfem
 
             if ( !mStatevals.test( BELFEM_STATEVAL_DMDT ))
             {
-                // compute derivative
-                Vector< real > tDM(
-                        mTable.compute_derivative( mIndexM, aT,
-                                                   this->pi( aT, aP )));
-
-                // scale derivative to p
-                tDM( 1 ) *= mdpscale / aP;
-
-                // set the value
-                mStatevals.set( BELFEM_STATEVAL_DMDT, tDM( 0 ));
-                mStatevals.set( BELFEM_STATEVAL_DMDP, tDM( 1 ));
-
+                this->update_M( aT, aP );
             }
 
             return mStatevals.get( BELFEM_STATEVAL_DMDT );
@@ -123,21 +105,29 @@ namespace belfem
 
             if ( !mStatevals.test( BELFEM_STATEVAL_DMDP ))
             {
-                // compute derivative
-                Vector< real > tDM(
-                        mTable.compute_derivative( mIndexM, aT,
-                                                   this->pi( aT, aP )));
+                this->update_M( aT, aP );
+            }
 
-                // scale derivative to p
-                tDM( 1 ) *= mdpscale / aP;
+            return mStatevals.get( BELFEM_STATEVAL_DMDP );
+        }
 
-                // set the value
-                mStatevals.set( BELFEM_STATEVAL_DMDT, tDM( 0 ));
-                mStatevals.set( BELFEM_STATEVAL_DMDP, tDM( 1 ));
+//----------------------------------------------------------------------------
 
-            }
+        void
+        EoS_TableGas::update_M( const real aT, const real aP )
+        {
+            // value, gradient and Hessian in one call
+            mTable.compute_value_and_derivatives( mIndexM, aT, this->pi( aT, aP ), mWork );
 
-            return mStatevals.get( BELFEM_STATEVAL_DMDP );
+            // set the M-value
+            mStatevals.set( BELFEM_STATEVAL_M, mWork( 0 ) );
+
+            // set the R-value
+            mStatevals.set( BELFEM_STATEVAL_R, constant::Rm / mWork( 0 ) );
+
+            // set the derivatives, scaled to p
+            mStatevals.set( BELFEM_STATEVAL_DMDT, mWork( 1 ) );
+            mStatevals.set( BELFEM_STATEVAL_DMDP, mWork( 2 ) * mdpscale / aP );
         }
 
 //----------------------------------------------------------------------------
@@ -147,50 +137,68 @@ namespace belfem
         real
         EoS_TableGas::p( const real aT, const real aV )
         {
-            // relaxation factor
-            const real tOmega0 = 0.9;
-            real tOmega1;
-            real tOmega ;
-
             // constant for function
             real tC = constant::Rm * aT / aV;
 
-            real tF = BELFEM_REAL_MAX;
-            real tdF;
+            // the molar mass changes only slowly, so the ideal gas law with
+            // the molar mass of the last state is a very good first guess
+            real aP = tC / this->M( aT, mStatevals.get( BELFEM_STATEVAL_P ) );
 
-            uint tCount = 0;
+            // molar mass
+            real tM = this->M( aT, aP );
 
-            // get a value to start the iteration
-            real aP = mStatevals.get( BELFEM_STATEVAL_P );
+            // function
+            real tF = tC / tM - aP;
 
-            while ( std::abs( tF ) > 1e-7 )
-            {
-                // molar mass
-                real tM = this->M( aT, aP );
-
-                // function
-                tF = tC / tM - aP;
+            mNumberOfIterations = 0 ;
 
+            while ( std::abs( tF ) > mInverseTolerance * aP )
+            {
                 // derivative
-                tdF = tC * this->dMdp( aT, aP )/( tM * tM ) - 1.0;
+                real tdF = tC * this->dMdp( aT, aP ) / ( tM * tM ) - 1.0;
 
-                tOmega1 = 0.9 * std::abs( ( aP - mPmin ) * tdF / tF  );
+                // newton step
+                real tStep = tF / tdF ;
 
-                if( tOmega1 < BELFEM_EPSILON )
+                // safeguard: damp the step if the pressure would become negative,
+                // or if the residual does not decrease
+                real tP = aP - tStep ;
+                real tNewF = BELFEM_REAL_MAX ;
+
+                for( uint k=0; k<20; ++k )
                 {
-                    return mPmin ;
+                    if( tP > 0.0 )
+                    {
+                        tM = this->M( aT, tP );
+                        tNewF = tC / tM - tP ;
+
+                        if( std::abs( tNewF ) < std::abs( tF ) )
+                        {
+                            break ;
+                        }
+                    }
+
+                    tStep *= 0.5 ;
+                    tP = aP - tStep ;
                 }
 
-                tOmega = tOmega1 < tOmega0 ? tOmega1 : tOmega0 ;
-
-                // perform newton step
-                aP -= tOmega * tF / tdF;
+                // the residual can not be decreased any further, which is
+                // only accepted at the round-off level of the table
+                if( std::abs( tNewF ) >= std::abs( tF ) )
+                {
+                    BELFEM_ERROR( std::abs( tF ) < 100.0 * mRoundOff * aP,
+                                  "EoS_TableGas::p did not converge for T = %f, v = %f, |F| / p = %e",
+                                  ( float ) aT, ( float ) aV, ( double ) ( std::abs( tF ) / aP ) );
+                    break ;
+                }
 
-                BELFEM_ERROR( tCount++ < 1000,
-                             "too many iterations in EoS_TableGas::p for T = %f, v= %f ",
-                             ( float ) aT,
-                             ( float ) aV );
+                aP = tP ;
+                tF = tNewF ;
 
+                BELFEM_ERROR( ++mNumberOfIterations < 100,
+                              "too many iterations in EoS_TableGas::p for T = %f, v = %f",
+                              ( float ) aT,
+                              ( float ) aV );
             }
 
             // return pressure value
@@ -210,40 +218,68 @@ namespace belfem
         real
         EoS_TableGas::T( const real aP, const real aV )
         {
-            // relaxation factor
-            const real tOmega = 0.9;
-
             // constant for function
             real tC = constant::Rm / aV;
 
-            real tF = BELFEM_REAL_MAX;
-            real tM;
-            real tdF;
+            // initial guess from the ideal gas law T = p * v * M / Rm,
+            // using the molar mass of the last state
+            real aT = aP * this->M( mStatevals.get( BELFEM_STATEVAL_T ), aP ) / tC ;
+
+            // compute M
+            real tM = this->M( aT, aP );
 
-            uint tCount = 0;
+            // function
+            real tF = tC * aT / tM - aP;
 
-            real aT = mStatevals.get( BELFEM_STATEVAL_T );
+            mNumberOfIterations = 0 ;
 
-            while ( std::abs( tF ) < 1e-7 )
+            while ( std::abs( tF ) > mInverseTolerance * aP )
             {
-                // compute M
-                tM = this->M( aT, aP );
+                // derivative
+                real tdF = tC * ( tM - aT * this->dMdT( aT, aP )) / ( tM * tM );
 
+                // newton step
+                real tStep = tF / tdF ;
 
-                // function
-                tF = tC * aT / tM - aP;
+                // safeguard: damp the step if the temperature would become negative,
+                // or if the residual does not decrease
+                real tT = aT - tStep ;
+                real tNewF = BELFEM_REAL_MAX ;
 
-                // derivative
-                tdF = tC * ( tM - aT * this->dMdT( aT, aP )) / ( tM * tM );
+                for( uint k=0; k<20; ++k )
+                {
+                    if( tT > 0.0 )
+                    {
+                        tM = this->M( tT, aP );
+                        tNewF = tC * tT / tM - aP ;
+
+                        if( std::abs( tNewF ) < std::abs( tF ) )
+                        {
+                            break ;
+                        }
+                    }
+
+                    tStep *= 0.5 ;
+                    tT = aT - tStep ;
+                }
 
-                // perform newton step
-                aT -= tOmega * tF / tdF;
+                // the residual can not be decreased any further, which is
+                // only accepted at the round-off level of the table
+                if( std::abs( tNewF ) >= std::abs( tF ) )
+                {
+                    BELFEM_ERROR( std::abs( tF ) < 100.0 * mRoundOff * aP,
+                                  "EoS_TableGas::T did not converge for p = %f, v = %f, |F| / p = %e",
+                                  ( float ) aP, ( float ) aV, ( double ) ( std::abs( tF ) / aP ) );
+                    break ;
+                }
 
-                BELFEM_ERROR( tCount++ < 1000,
-                             "too many iterations in EoS_TableGas::T for p = %f, v= %f ",
-                             ( float ) aP,
-                             ( float ) aV );
+                aT = tT ;
+                tF = tNewF ;
 
+                BELFEM_ERROR( ++mNumberOfIterations < 100,
+                              "too many iterations in EoS_TableGas::T for p = %f, v = %f",
+                              ( float ) aP,
+                              ( float ) aV );
             }
 
             // return temperature value
@@ -268,13 +304,13 @@ namespace belfem
         EoS_TableGas::d2pdT2( const real aT, const real aV )
         {
             real tP = this->p( aT, aV );
-            real tM = this->M( aT, tP );
-            real tdMdT = this->dMdT( aT, tP );
 
-            Vector< real > tD2M( mTable.compute_second_derivative(
-                    mIndexM, aT, this->pi( aT, tP )));
+            // value, gradient and Hessian in one call
+            mTable.compute_value_and_derivatives( mIndexM, aT, this->pi( aT, tP ), mWork );
 
-            real td2MdT2 = tD2M( 0 );
+            real tM      = mWork( 0 );
+            real tdMdT   = mWork( 1 );
+            real td2MdT2 = mWork( 3 );
 
             return -constant::Rm / ( aV * tM * tM * tM ) *
                    ( 2.0 * tdMdT * ( tM - aT * tdMdT )
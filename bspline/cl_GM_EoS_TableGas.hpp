@@ -47,6 +47,18 @@ namespace belfem
             // constant for scaling derivative to p
             const real mdpscale = 1000.0 / std::log( 10.0 );
 
+            // work vector for value and derivatives of M
+            Vector< real > mWork ;
+
+            // relative tolerance for the inverse functions p( T, v ) and T( p, v )
+            const real mInverseTolerance = 1e-12 ;
+
+            // relative round-off of the molar mass, which is a sum of
+            // up to 64 spline terms evaluated in double precision
+            const real mRoundOff = 64.0 * BELFEM_EPSILON ;
+
+            // iterations needed by the last call of p( T, v ) or T( p, v )
+            uint mNumberOfIterations = 0 ;
 
 //----------------------------------------------------------------------------
         public:
@@ -71,7 +83,7 @@ namespace belfem
             pi( const real aT, const real aP );
 
             real
-            dpidp(const real &aT, const real &aP);
+            dpidp( const real aT, const real aP );
 
             const real &
             M( const real aT, const real aP );
@@ -95,6 +107,13 @@ namespace belfem
             real
             T( const real aP, const real aV );
 
+            // iterations needed by the last call of p( T, v ) or T( p, v )
+            inline uint
+            number_of_iterations() const
+            {
+                return mNumberOfIterations ;
+            }
+
 //------------------------------------------------------------------------------
 // State Derivatives
 //------------------------------------------------------------------------------
@@ -194,6 +213,14 @@ namespace belfem
             real
             cpdep( const uint aIndex, const real aT, const real aP );
 
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // computes M, R, dMdT and dMdp in one pass over the table
+            void
+            update_M( const real aT, const real aP );
+
 //------------------------------------------------------------------------------
         };
 
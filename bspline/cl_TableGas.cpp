@@ -24,6 +24,15 @@ namespace belfem
         this->create_eos();
     }
 
+//---------------------------------------------------------------------------
+
+    TableGas::TableGas( const std::shared_ptr< bspline::LookupTable > & aTable ) :
+        mTable( aTable )
+    {
+        this->init_parameters();
+        this->create_eos();
+    }
+
 //---------------------------------------------------------------------------
 
     TableGas::~TableGas()
@@ -31,8 +40,16 @@ namespace belfem
         // destroyed by parent
         // delete mEoS ;
 
-        // destroy the lookop table
-        delete mTable ;
+        // the lookup table is destroyed by the shared pointer
+        // once the last clone is gone
+    }
+
+//---------------------------------------------------------------------------
+
+    TableGas *
+    TableGas::clone() const
+    {
+        return new TableGas( mTable );
     }
 
 //---------------------------------------------------------------------------
@@ -43,13 +60,13 @@ namespace belfem
         if( aPath == "" )
         {
             // create default table
-            mTable = new bspline::LookupTable(
+            mTable = std::make_shared< bspline::LookupTable >(
                     gastables::data_path() + "/hotair.hdf5" );
         }
         else
         {
             // create table from file
-            mTable = new bspline::LookupTable( aPath );
+            mTable = std::make_shared< bspline::LookupTable >( aPath );
         }
     }
 
@@ -67,6 +84,10 @@ namespace belfem
         mIndexMu = mTable->field_index( "mu" );
         mIndexLambda = mTable->field_index( "lambda" );
         mIndexHd = mTable->field_index( "hd" );
+
+        // same bounds as in EoS_TableGas
+        mPimin = mTable->min( 1 ) + 1.0 ;
+        mPimax = mTable->max( 1 ) - 1.0 ;
     }
 
 //---------------------------------------------------------------------------
@@ -447,5 +468,144 @@ namespace belfem
                                       this->pi( aT, aP ) );
     }
 
+//------------------------------------------------------------------------------
+// Batched Evaluation
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::h( const Vector< real > & aT,
+                 const Vector< real > & aP,
+                       Vector< real > & aH,
+                 const uint aNumberOfThreads ) const
+    {
+        this->evaluate_table( mIndexH, aT, aP, aH, 0, aNumberOfThreads );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::cp( const Vector< real > & aT,
+                  const Vector< real > & aP,
+                        Vector< real > & aCp,
+                  const uint aNumberOfThreads ) const
+    {
+        // cp is the derivative of h to T
+        this->evaluate_table( mIndexH, aT, aP, aCp, 1, aNumberOfThreads );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::mu( const Vector< real > & aT,
+                  const Vector< real > & aP,
+                        Vector< real > & aMu,
+                  const uint aNumberOfThreads ) const
+    {
+        this->evaluate_table( mIndexMu, aT, aP, aMu, 0, aNumberOfThreads );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::lambda( const Vector< real > & aT,
+                      const Vector< real > & aP,
+                            Vector< real > & aLambda,
+                      const uint aNumberOfThreads ) const
+    {
+        this->evaluate_table( mIndexLambda, aT, aP, aLambda, 0, aNumberOfThreads );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::compute_properties(
+            const Vector< real > & aT,
+            const Vector< real > & aP,
+                  Vector< real > & aH,
+                  Vector< real > & aCp,
+                  Vector< real > & aMu,
+                  Vector< real > & aLambda,
+            const uint aNumberOfThreads ) const
+    {
+        index_t tNumberOfPoints = aT.length() ;
+
+        Vector< real > tPi ;
+        this->compute_pi( aP, tPi );
+
+        // pass 1: all values at once
+        Vector< index_t > tFields = { mIndexH, mIndexMu, mIndexLambda };
+        Matrix< real > tValues ;
+        mTable->evaluate( tFields, aT, tPi, tValues, 0, aNumberOfThreads );
+
+        aH.set_size( tNumberOfPoints );
+        aMu.set_size( tNumberOfPoints );
+        aLambda.set_size( tNumberOfPoints );
+
+        for( index_t k=0; k<tNumberOfPoints; ++k )
+        {
+            aH( k )      = tValues( 0, k );
+            aMu( k )     = tValues( 1, k );
+            aLambda( k ) = tValues( 2, k );
+        }
+
+        // pass 2: temperature derivative of enthalpy
+        Vector< index_t > tH = { mIndexH };
+        mTable->evaluate( tH, aT, tPi, tValues, 1, aNumberOfThreads );
+
+        aCp.set_size( tNumberOfPoints );
+        for( index_t k=0; k<tNumberOfPoints; ++k )
+        {
+            aCp( k ) = tValues( 0, k );
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::compute_pi( const Vector< real > & aP, Vector< real > & aPi ) const
+    {
+        index_t tNumberOfPoints = aP.length() ;
+
+        aPi.set_size( tNumberOfPoints );
+
+        for( index_t k=0; k<tNumberOfPoints; ++k )
+        {
+            aPi( k ) = std::max( std::min( std::log10( aP( k ) ) * 1000.0, mPimax ), mPimin );
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    TableGas::evaluate_table(
+            const index_t          aFieldIndex,
+            const Vector< real > & aT,
+            const Vector< real > & aP,
+                  Vector< real > & aValues,
+            const uint             aDerivative,
+            const uint             aNumberOfThreads ) const
+    {
+        BELFEM_ERROR( aT.length() == aP.length(),
+                      "length of T and p vectors does not match ( %lu vs %lu )",
+                      ( long unsigned int ) aT.length(),
+                      ( long unsigned int ) aP.length() );
+
+        Vector< real > tPi ;
+        this->compute_pi( aP, tPi );
+
+        Vector< index_t > tFields = { aFieldIndex };
+        Matrix< real > tValues ;
+
+        mTable->evaluate( tFields, aT, tPi, tValues, aDerivative, aNumberOfThreads );
+
+        index_t tNumberOfPoints = aT.length() ;
+        aValues.set_size( tNumberOfPoints );
+
+        for( index_t k=0; k<tNumberOfPoints; ++k )
+        {
+            aValues( k ) = tValues( 0, k );
+        }
+    }
+
 //------------------------------------------------------------------------------
 }
@@ -12,6 +12,8 @@
 #ifndef BELFEM_CL_TABLEGAS_HPP
 #define BELFEM_CL_TABLEGAS_HPP
 
+#include <memory>
+
 #include "cl_Gas.hpp"
 #include "cl_BS_LookupTable.hpp"
 #include "fn_GT_data_path.hpp"
@@ -21,8 +23,8 @@ namespace belfem
 {
     class TableGas : public Gas
     {
-
-        bspline::LookupTable * mTable;
+        // the table is immutable and shared between clones
+        std::shared_ptr< bspline::LookupTable > mTable;
 
         // index for mass table
         index_t mIndexM;
@@ -45,6 +47,10 @@ namespace belfem
         // constant for scaling derivative to p
         const real mdpscale = 1000.0 / std::log( 10.0 );
 
+        // bounds of the pressure parameter on the table
+        real mPimin ;
+        real mPimax ;
+
 //------------------------------------------------------------------------------
     public:
 //------------------------------------------------------------------------------
@@ -55,6 +61,16 @@ namespace belfem
 
         ~TableGas();
 
+//------------------------------------------------------------------------------
+
+        /**
+         * creates a new gas that uses the same lookup table,
+         * but has its own equation of state and state value cache.
+         * The clone can be used on another thread.
+         */
+        TableGas *
+        clone() const ;
+
 //------------------------------------------------------------------------------
 
         void
@@ -150,10 +166,68 @@ namespace belfem
         real
         Pr( const real aT, const real aP );
 
+//------------------------------------------------------------------------------
+// Batched Evaluation
+//------------------------------------------------------------------------------
+
+        /**
+         * The following functions evaluate the table for many states at
+         * once, for example for all points of a channel grid. They bypass
+         * the state value cache and do not modify the gas, so several
+         * threads can share one table. aNumberOfThreads=0 uses all cores.
+         */
+        void
+        h( const Vector< real > & aT,
+           const Vector< real > & aP,
+                 Vector< real > & aH,
+           const uint aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+        void
+        cp( const Vector< real > & aT,
+            const Vector< real > & aP,
+                  Vector< real > & aCp,
+            const uint aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+        void
+        mu( const Vector< real > & aT,
+            const Vector< real > & aP,
+                  Vector< real > & aMu,
+            const uint aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+        void
+        lambda( const Vector< real > & aT,
+                const Vector< real > & aP,
+                      Vector< real > & aLambda,
+                const uint aNumberOfThreads=0 ) const ;
+
+//------------------------------------------------------------------------------
+
+        // evaluates h, cp, mu and lambda in two passes over the table
+        void
+        compute_properties(
+                const Vector< real > & aT,
+                const Vector< real > & aP,
+                      Vector< real > & aH,
+                      Vector< real > & aCp,
+                      Vector< real > & aMu,
+                      Vector< real > & aLambda,
+                const uint aNumberOfThreads=0 ) const ;
+
 
 
 //------------------------------------------------------------------------------
     private:
+//------------------------------------------------------------------------------
+
+        // constructor for clone
+        TableGas( const std::shared_ptr< bspline::LookupTable > & aTable );
+
 //------------------------------------------------------------------------------
 
         // special parameter for table
@@ -175,6 +249,24 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
+        // thread safe version of pi for batched evaluation
+        void
+        compute_pi( const Vector< real > & aP, Vector< real > & aPi ) const ;
+
+//------------------------------------------------------------------------------
+
+        // batched evaluation of one field
+        void
+        evaluate_table(
+                const index_t          aFieldIndex,
+                const Vector< real > & aT,
+                const Vector< real > & aP,
+                      Vector< real > & aValues,
+                const uint             aDerivative,
+                const uint             aNumberOfThreads ) const ;
+
+//------------------------------------------------------------------------------
+
 
 
 
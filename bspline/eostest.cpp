@@ -0,0 +1,140 @@
+/*
+ * BELFEM -- The Berkeley Lab Finite Element Framework
+ * Copyright (c) 2026, The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any required
+ * approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Developers: Christian Messe, Gregory Giard
+ *
+ * See the top-level LICENSE file for the complete license and disclaimer.
+ */
+
+#include <iostream>
+#include <cmath>
+
+#include "typedefs.hpp"
+#include "assert.hpp"
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "cl_Vector.hpp"
+
+#include "cl_TableGas.hpp"
+#include "cl_GM_EoS_TableGas.hpp"
+
+using namespace belfem;
+
+Communicator gComm;
+Logger       gLog( 5 );
+
+//------------------------------------------------------------------------------
+
+/**
+ * checks that T( p, v( T, p ) ) and p( T, v( T, p ) ) return their
+ * arguments. Since Newton starts from the last state, the state is
+ * reset to 300 K and 1 bar before each call.
+ */
+void
+test_inverse_eos( gasmodels::EoS_TableGas & aEoS )
+{
+    std::cout << "Test 1: inverse functions of the equation of state..." << std::endl;
+
+    uint tMaxIterations = 0 ;
+
+    for( real tTi : { 300.0, 1500.0, 4000.0, 8000.0 } )
+    {
+        for( real tPi : { 1e1, 1e3, 1e5, 1e6 } )
+        {
+            real tVi = aEoS.v( tTi, tPi );
+
+            aEoS.M( 300.0, 1e5 );
+            real tErrT = std::abs( aEoS.T( tPi, tVi ) - tTi ) / tTi ;
+            tMaxIterations = std::max( tMaxIterations, aEoS.number_of_iterations() );
+
+            aEoS.M( 300.0, 1e5 );
+            real tErrP = std::abs( aEoS.p( tTi, tVi ) - tPi ) / tPi ;
+            tMaxIterations = std::max( tMaxIterations, aEoS.number_of_iterations() );
+
+            BELFEM_ERROR( tErrT < 1e-9 && tErrP < 1e-9,
+                          "inverse EoS failed for T = %f, p = %f: errT = %e, errP = %e",
+                          ( float ) tTi, ( float ) tPi, tErrT, tErrP );
+        }
+    }
+
+    std::cout << "  maximum number of iterations: " << tMaxIterations << std::endl;
+
+    BELFEM_ERROR( tMaxIterations < 20, "inverse EoS needs too many iterations" );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * states along a channel change only little from step to step,
+ * so the warm start must converge within a few iterations
+ */
+void
+test_inverse_eos_warm_start( gasmodels::EoS_TableGas & aEoS )
+{
+    std::cout << "Test 2: warm start of the inverse functions..." << std::endl;
+
+    const uint tNumberOfSteps = 100 ;
+
+    Vector< real > tT( tNumberOfSteps );
+    Vector< real > tP( tNumberOfSteps );
+    Vector< real > tV( tNumberOfSteps );
+
+    // a slowly expanding and cooling flow
+    tT( 0 ) = 2500.0 ;
+    tP( 0 ) = 2e5 ;
+    tV( 0 ) = aEoS.v( tT( 0 ), tP( 0 ) );
+
+    for( uint k=1; k<tNumberOfSteps; ++k )
+    {
+        tT( k ) = 0.999 * tT( k-1 );
+        tP( k ) = 0.998 * tP( k-1 );
+        tV( k ) = aEoS.v( tT( k ), tP( k ) );
+    }
+
+    // start from the first state
+    aEoS.M( tT( 0 ), tP( 0 ) );
+
+    uint tMaxIterations = 0 ;
+
+    for( uint k=1; k<tNumberOfSteps; ++k )
+    {
+        real tErr = std::abs( aEoS.p( tT( k ), tV( k ) ) - tP( k ) ) / tP( k );
+        tMaxIterations = std::max( tMaxIterations, aEoS.number_of_iterations() );
+
+        BELFEM_ERROR( tErr < 1e-9, "inverse EoS failed for T = %f, p = %f: errP = %e",
+                      ( float ) tT( k ), ( float ) tP( k ), tErr );
+    }
+
+    std::cout << "  maximum number of iterations: " << tMaxIterations << " (expected: <= 3)" << std::endl;
+
+    BELFEM_ERROR( tMaxIterations <= 3, "warm start needs too many iterations" );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm.init( argc, argv );
+
+    // the default table of hot air
+    TableGas tAir( "" );
+
+    // a separate equation of state, so that the iterations can be counted
+    gasmodels::EoS_TableGas tEoS( tAir );
+
+    test_inverse_eos( tEoS );
+    test_inverse_eos_warm_start( tEoS );
+
+    std::cout << "All tests PASSED!" << std::endl;
+
+    return gComm.finalize();
+}
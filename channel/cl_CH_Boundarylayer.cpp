@@ -353,6 +353,8 @@ namespace belfem
         void
         Boundarylayer::set_sigma_recovery_mode( const SigmaRecoveryMode aMode )
         {
+            mSigmaRecoveryMode = aMode ;
+
             switch( aMode )
             {
                 case( SigmaRecoveryMode::vanDriest ) :
@@ -1330,6 +1332,358 @@ namespace belfem
 
         void
         Boundarylayer::update_lookup_tables()
+        {
+            // 2D mode
+            if( mPressureTable.size() > 0 )
+            {
+                real tLogP = std::log( mP );
+
+                if( tLogP >= mPressureTableLogPmin && tLogP <= mPressureTableLogPmax
+                    && this->composition_matches( mPressureTable( 0 ) ) )
+                {
+                    this->interpolate_pressure_table() ;
+                    return;
+                }
+            }
+
+            if( mSplineCacheCapacity > 0 )
+            {
+                // search the cache
+                for( auto tSet = mSplineCache.begin(); tSet != mSplineCache.end(); ++tSet )
+                {
+                    if( std::abs( tSet->P - mP ) <= mSplineCacheResolution * mP
+                        && this->composition_matches( *tSet ) )
+                    {
+                        this->load_splines( *tSet );
+
+                        // move entry to the front
+                        mSplineCache.splice( mSplineCache.begin(), mSplineCache, tSet );
+                        return;
+                    }
+                }
+
+                this->compute_lookup_tables() ;
+
+                // drop the least recently used entry
+                if( mSplineCache.size() >= mSplineCacheCapacity )
+                {
+                    mSplineCache.pop_back();
+                }
+
+                mSplineCache.emplace_front();
+                this->store_splines( mSplineCache.front() );
+            }
+            else
+            {
+                this->compute_lookup_tables() ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::set_spline_cache( const uint aCapacity, const real aResolution )
+        {
+            mSplineCacheCapacity   = aCapacity ;
+            mSplineCacheResolution = aResolution ;
+
+            while( mSplineCache.size() > mSplineCacheCapacity )
+            {
+                mSplineCache.pop_back();
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        Boundarylayer *
+        Boundarylayer::clone( Gas & aGas )
+        {
+            BELFEM_ERROR( &aGas != &mGas, "a clone can not use the same gas" );
+
+            BELFEM_ERROR( aGas.number_of_components() == mGas.number_of_components(),
+                          "gas of clone has a different number of components" );
+
+            Boundarylayer * aClone = new Boundarylayer(
+                    aGas,
+                    mMethod,
+                    mSigmaRecoveryMode,
+                    mNumberOfCells,
+                    mMeshRatio );
+
+            // settings
+            aClone->mKtech                = mKtech ;
+            aClone->mBartzConst           = mBartzConst ;
+            aClone->mIsAxisymmetric       = mIsAxisymmetric ;
+            aClone->mUseParametersAsInput = mUseParametersAsInput ;
+
+            if( ! std::isnan( mDh ) )
+            {
+                aClone->set_hydraulic_diameter( mDh );
+            }
+
+            // lookup tables
+            aClone->mP = mP ;
+            aClone->copy_lookup_tables( *this );
+
+            aClone->mSplineCache           = mSplineCache ;
+            aClone->mSplineCacheCapacity   = mSplineCacheCapacity ;
+            aClone->mSplineCacheResolution = mSplineCacheResolution ;
+            aClone->mPressureTable         = mPressureTable ;
+            aClone->mPressureTableLogPmin  = mPressureTableLogPmin ;
+            aClone->mPressureTableLogPmax  = mPressureTableLogPmax ;
+            aClone->mPressureTableStep     = mPressureTableStep ;
+
+            return aClone ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::copy_lookup_tables( Boundarylayer & aSource )
+        {
+            BoundarylayerSplineSet tSet ;
+            aSource.store_splines( tSet );
+            this->load_splines( tSet );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::store_state( BoundarylayerState & aState )
+        {
+            aState.mData    = mData ;
+            aState.mBalance = mBalance ;
+            this->store_splines( aState.mSplines );
+
+            aState.mTm    = mTm ;
+            aState.mP     = mP ;
+            aState.mUm    = mUm ;
+            aState.mRhom  = mRhom ;
+            aState.mHm    = mHm ;
+            aState.mSm    = mSm ;
+            aState.mPrm   = mPrm ;
+            aState.mReDh  = mReDh ;
+            aState.mReDhw = mReDhw ;
+            aState.mDotM  = mDotM ;
+            aState.mDotI  = mDotI ;
+            aState.mDotH  = mDotH ;
+            aState.mTw1   = mTw1 ;
+            aState.mTw2   = mTw2 ;
+            aState.mDh    = mDh ;
+            aState.mA     = mA ;
+
+            aState.mUtau     = mUtau ;
+            aState.mPi       = mPi ;
+            aState.mBplus    = mBplus ;
+            aState.mExpKB    = mExpKB ;
+            aState.mRecovery = mRecovery ;
+            aState.mSigma    = mSigma ;
+            aState.mCplus    = mCplus ;
+            aState.mPhi      = mPhi ;
+            aState.mPsi      = mPsi ;
+            aState.mChi      = mChi ;
+            aState.mAlpha    = mAlpha ;
+            aState.mBeta     = mBeta ;
+
+            aState.mUseParametersAsInput = mUseParametersAsInput ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::load_state( const BoundarylayerState & aState )
+        {
+            BELFEM_ERROR( aState.mData.n_rows() == mNumberOfNodes,
+                          "state was created by a boundary layer with a different number of cells" );
+
+            mData    = aState.mData ;
+            mBalance = aState.mBalance ;
+            mP       = aState.mP ;
+            this->load_splines( aState.mSplines );
+
+            mTm    = aState.mTm ;
+            mUm    = aState.mUm ;
+            mRhom  = aState.mRhom ;
+            mHm    = aState.mHm ;
+            mSm    = aState.mSm ;
+            mPrm   = aState.mPrm ;
+            mReDh  = aState.mReDh ;
+            mReDhw = aState.mReDhw ;
+            mDotM  = aState.mDotM ;
+            mDotI  = aState.mDotI ;
+            mDotH  = aState.mDotH ;
+            mTw1   = aState.mTw1 ;
+            mTw2   = aState.mTw2 ;
+            mDh    = aState.mDh ;
+            mA     = aState.mA ;
+
+            mUtau     = aState.mUtau ;
+            mPi       = aState.mPi ;
+            mBplus    = aState.mBplus ;
+            mExpKB    = aState.mExpKB ;
+            mRecovery = aState.mRecovery ;
+            mSigma    = aState.mSigma ;
+            mCplus    = aState.mCplus ;
+            mPhi      = aState.mPhi ;
+            mPsi      = aState.mPsi ;
+            mChi      = aState.mChi ;
+            mAlpha    = aState.mAlpha ;
+            mBeta     = aState.mBeta ;
+
+            mUseParametersAsInput = aState.mUseParametersAsInput ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::store_warm_start( BoundarylayerWarmStart & aState ) const
+        {
+            aState.mThat     = mData( mCenter, BELFEM_CHANNEL_T );
+            aState.mUhat     = mData( mCenter, BELFEM_CHANNEL_U );
+            aState.mTauW     = mData( 0, BELFEM_CHANNEL_TAU );
+            aState.mUtau     = mUtau ;
+            aState.mPi       = mPi ;
+            aState.mSigma    = mSigma ;
+            aState.mRecovery = mRecovery ;
+            aState.mIsSet    = true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::load_warm_start( const BoundarylayerWarmStart & aState )
+        {
+            BELFEM_ASSERT( aState.mIsSet, "warm start state has not been stored" );
+
+            this->compute_wall_state() ;
+
+            mData( 0, BELFEM_CHANNEL_TAU ) = aState.mTauW ;
+
+            mUtau     = aState.mUtau ;
+            mPi       = aState.mPi ;
+            mSigma    = aState.mSigma ;
+            mRecovery = aState.mRecovery ;
+
+            this->set_center_conditions( aState.mThat, aState.mUhat );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::create_pressure_table(
+                const real aPmin,
+                const real aPmax,
+                const uint aNumberOfLevels )
+        {
+            BELFEM_ERROR( aPmin > 0.0 && aPmax > aPmin && aNumberOfLevels > 1,
+                          "invalid parameters for pressure table" );
+
+            // remember current pressure
+            real tP = mP ;
+
+            mPressureTableLogPmin = std::log( aPmin );
+            mPressureTableLogPmax = std::log( aPmax );
+            mPressureTableStep    = ( mPressureTableLogPmax - mPressureTableLogPmin )
+                    / ( ( real ) ( aNumberOfLevels - 1 ) );
+
+            mPressureTable.set_size( aNumberOfLevels, BoundarylayerSplineSet() );
+
+            for( uint k=0; k<aNumberOfLevels; ++k )
+            {
+                mP = std::exp( mPressureTableLogPmin + k * mPressureTableStep );
+
+                this->compute_lookup_tables() ;
+
+                BoundarylayerSplineSet & tSet = mPressureTable( k );
+                this->store_splines( tSet );
+
+                // the volume is almost proportional to 1/p,
+                // so p*v and rho/p are interpolated instead
+                tSet.mVolume *= mP ;
+                tSet.mRhoMax /= mP ;
+            }
+
+            // restore pressure and splines
+            mP = tP ;
+            this->update_lookup_tables() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::interpolate_pressure_table()
+        {
+            real tS = ( std::log( mP ) - mPressureTableLogPmin ) / mPressureTableStep ;
+
+            uint tK = std::min( ( uint ) tS, ( uint ) mPressureTable.size() - 2 );
+
+            // interpolation weight
+            real tW = tS - ( real ) tK ;
+
+            const BoundarylayerSplineSet & tA = mPressureTable( tK );
+            const BoundarylayerSplineSet & tB = mPressureTable( tK + 1 );
+
+            mVolumeSpline->matrix_data() = ( ( 1.0 - tW ) / mP ) * tA.mVolume + ( tW / mP ) * tB.mVolume ;
+            mHeatSpline->matrix_data()   = ( 1.0 - tW ) * tA.mHeat   + tW * tB.mHeat ;
+            mMuSpline->matrix_data()     = ( 1.0 - tW ) * tA.mMu     + tW * tB.mMu ;
+            mLambdaSpline->matrix_data() = ( 1.0 - tW ) * tA.mLambda + tW * tB.mLambda ;
+
+            mRhoMax = ( ( 1.0 - tW ) * tA.mRhoMax + tW * tB.mRhoMax ) * mP ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::store_splines( BoundarylayerSplineSet & aSet )
+        {
+            aSet.mP      = mP ;
+            aSet.mComposition = mGas.molar_fractions() ;
+            aSet.mVolume = mVolumeSpline->matrix_data() ;
+            aSet.mHeat   = mHeatSpline->matrix_data() ;
+            aSet.mMu     = mMuSpline->matrix_data() ;
+            aSet.mLambda = mLambdaSpline->matrix_data() ;
+            aSet.mRhoMax = mRhoMax ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::load_splines( const BoundarylayerSplineSet & aSet )
+        {
+            mVolumeSpline->matrix_data() = aSet.mVolume ;
+            mHeatSpline->matrix_data()   = aSet.mHeat ;
+            mMuSpline->matrix_data()     = aSet.mMu ;
+            mLambdaSpline->matrix_data() = aSet.mLambda ;
+            mRhoMax = aSet.mRhoMax ;
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        Boundarylayer::composition_matches( const BoundarylayerSplineSet & aSet ) const
+        {
+            const Vector< real > & tComposition = mGas.molar_fractions() ;
+
+            if( tComposition.length() != aSet.mComposition.length() )
+            {
+                return false ;
+            }
+
+            for( index_t k=0; k<tComposition.length(); ++k )
+            {
+                if( std::abs( tComposition( k ) - aSet.mComposition( k ) ) > BELFEM_EPSILON )
+                {
+                    return false ;
+                }
+            }
+
+            return true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Boundarylayer::compute_lookup_tables()
         {
             if( mGas.gas_model() == GasModel::HELMHOLTZ )
             {
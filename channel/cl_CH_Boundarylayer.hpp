@@ -3,7 +3,10 @@
 //
 #ifndef BELFEM_CL_CH_BOUNDARYLAYER_HPP
 #define BELFEM_CL_CH_BOUNDARYLAYER_HPP
+#include <list>
+
 #include "typedefs.hpp"
+#include "cl_Cell.hpp"
 #include "cl_Spline.hpp"
 #include "cl_Gas.hpp"
 #include "cl_Vector.hpp"
@@ -21,6 +24,105 @@ namespace belfem
             Petrukov
         };
 
+        /**
+         * the fitted property splines for one pressure
+         */
+        struct BoundarylayerSplineSet
+        {
+            // pressure the splines were fitted for
+            real mP ;
+
+            // mixture the splines were fitted for
+            Vector< real > mComposition ;
+
+            Matrix< real > mVolume ;
+            Matrix< real > mHeat ;
+            Matrix< real > mMu ;
+            Matrix< real > mLambda ;
+
+            real mRhoMax ;
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * the flow conditions and the converged solution of a boundary
+         * layer, used to restore it or to warm start another one
+         */
+        struct BoundarylayerState
+        {
+            // profiles
+            Matrix< real > mData ;
+
+            // balance errors of the Messe model
+            Vector< real > mBalance ;
+
+            // splines of the current pressure
+            BoundarylayerSplineSet mSplines ;
+
+            // flow conditions and geometry
+            real mTm ;
+            real mP ;
+            real mUm ;
+            real mRhom ;
+            real mHm ;
+            real mSm ;
+            real mPrm ;
+            real mReDh ;
+            real mReDhw ;
+            real mDotM ;
+            real mDotI ;
+            real mDotH ;
+            real mTw1 ;
+            real mTw2 ;
+            real mDh ;
+            real mA ;
+
+            // solution of the last compute
+            real mUtau ;
+            real mPi ;
+            real mBplus ;
+            real mExpKB ;
+            real mRecovery ;
+            real mSigma ;
+            real mCplus ;
+            cplx mPhi ;
+            cplx mPsi ;
+            cplx mChi ;
+            cplx mAlpha ;
+            cplx mBeta ;
+
+            bool mUseParametersAsInput ;
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * the scalars a converged boundary layer needs to start the
+         * next compute of a similar state. The profiles are not stored.
+         */
+        struct BoundarylayerWarmStart
+        {
+            // center conditions
+            real mThat ;
+            real mUhat ;
+
+            // wall shear stress and friction velocity
+            real mTauW ;
+            real mUtau ;
+
+            // coles wake parameter
+            real mPi ;
+
+            real mSigma ;
+            real mRecovery ;
+
+            // false until a state has been stored
+            bool mIsSet = false ;
+        };
+
+//------------------------------------------------------------------------------
+
         class Boundarylayer
         {
             Gas & mGas ;
@@ -131,6 +233,23 @@ namespace belfem
             Spline * mHeatSpline   = nullptr ;
             Spline * mMuSpline     = nullptr ;
 
+            // recently fitted splines, most recently used first
+            std::list< BoundarylayerSplineSet > mSplineCache ;
+
+            // maximum number of entries in the cache, 0 : no cache
+            uint mSplineCacheCapacity = 64 ;
+
+            // relative pressure difference below which cached splines are used
+            real mSplineCacheResolution = 1e-6 ;
+
+            // splines on logarithmic pressure levels for the 2D mode,
+            // volume and density are stored multiplied or divided by p,
+            // only used as long as the mixture does not change
+            Cell< BoundarylayerSplineSet > mPressureTable ;
+            real mPressureTableLogPmin = BELFEM_QUIET_NAN ;
+            real mPressureTableLogPmax = BELFEM_QUIET_NAN ;
+            real mPressureTableStep    = BELFEM_QUIET_NAN ;
+
             real mTw1 ;
             real mTw2 ;
             //real mRadius1 ;
@@ -147,6 +266,9 @@ namespace belfem
             void
             ( Boundarylayer::* mSigmaRecoveryFunction )();
 
+            // remembered for clone
+            SigmaRecoveryMode mSigmaRecoveryMode ;
+
             void
             ( Boundarylayer::* mFrictionFunction )( real & aDotQ, real & aTauw, real & aTr, real & aHr );
 
@@ -185,6 +307,16 @@ namespace belfem
 
             ~Boundarylayer() ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates a boundary layer with the same settings and
+             * lookup tables that works on aGas, which must have
+             * the same components as the gas of this object
+             */
+            Boundarylayer *
+            clone( Gas & aGas );
+
 //------------------------------------------------------------------------------
 
             void
@@ -376,9 +508,85 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
+            /**
+             * update the property splines for the current pressure.
+             * The splines are taken from the pressure table or the cache
+             * if possible, otherwise they are fitted and cached.
+             */
             void
             update_lookup_tables();
 
+//------------------------------------------------------------------------------
+
+            /**
+             * configure the cache of fitted splines
+             *
+             * @param aCapacity    maximum number of pressures, 0 disables the cache
+             * @param aResolution  relative pressure difference below
+             *                     which cached splines are reused
+             */
+            void
+            set_spline_cache( const uint aCapacity, const real aResolution=1e-6 );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * copy the property splines from another boundary layer
+             */
+            void
+            copy_lookup_tables( Boundarylayer & aSource );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * copy the flow conditions, the splines and the
+             * converged solution into a state object
+             */
+            void
+            store_state( BoundarylayerState & aState );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * restore a state. The state can come from another boundary
+             * layer with the same number of cells, which is then used
+             * as starting point for the next compute
+             */
+            void
+            load_state( const BoundarylayerState & aState );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * copy the scalars of the converged solution that are needed
+             * to warm start the next compute
+             */
+            void
+            store_warm_start( BoundarylayerWarmStart & aState ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * use a stored solution instead of compute_initial_guesses.
+             * Expects that the flow conditions, the wall temperature and
+             * the hydraulic diameter are already set.
+             */
+            void
+            load_warm_start( const BoundarylayerWarmStart & aState );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * 2D mode: fits the splines once on logarithmically spaced
+             * pressure levels. Afterwards, update_lookup_tables interpolates
+             * linearly in log( p ) between two levels and does not
+             * call the gas model anymore.
+             */
+            void
+            create_pressure_table( const real aPmin,
+                                   const real aPmax,
+                                   const uint aNumberOfLevels=64 );
+
 //------------------------------------------------------------------------------
 
             /**
@@ -503,6 +711,36 @@ namespace belfem
             void
             init_lookup_tables();
 
+//------------------------------------------------------------------------------
+
+            // evaluates the gas model and fits the splines for mP
+            void
+            compute_lookup_tables();
+
+//------------------------------------------------------------------------------
+
+            // copy the current splines into a set
+            void
+            store_splines( BoundarylayerSplineSet & aSet );
+
+//------------------------------------------------------------------------------
+
+            // write a set into the current splines
+            void
+            load_splines( const BoundarylayerSplineSet & aSet );
+
+//------------------------------------------------------------------------------
+
+            // interpolate the splines from the pressure table
+            void
+            interpolate_pressure_table();
+
+//------------------------------------------------------------------------------
+
+            // check if a set was created with the current mixture
+            bool
+            composition_matches( const BoundarylayerSplineSet & aSet ) const ;
+
 //------------------------------------------------------------------------------
 // fricition functions
 //------------------------------------------------------------------------------
@@ -32,16 +32,25 @@ namespace belfem
                 // allocate Pivot Vector
                 mPivot.set_size( 3 );
 
+                // allocate derivatives of Jacobi matrix
+                mdJacobidV.set_size( 3, 3, 0.0 );
+                mdJacobidU.set_size( 3, 3, 0.0 );
+                mdJacobidT.set_size( 3, 3, 0.0 );
+
                 // link compute matrix
                 if( mGas.is_idgas() )
                 {
                     mJacobiFunction
                             = & ChannelODE::compute_jacobi_idgas ;
+                    mJacobiDerivativeFunction
+                            = & ChannelODE::compute_jacobi_derivatives_idgas ;
                 }
                 else
                 {
                     mJacobiFunction
                             = & ChannelODE::compute_jacobi_realgas ;
+                    mJacobiDerivativeFunction
+                            = & ChannelODE::compute_jacobi_derivatives_realgas ;
                 }
 
                 mComputeFunction = & ChannelODE::compute_channel_ode ;
@@ -83,16 +92,25 @@ namespace belfem
                 // allocate Pivot Vector
                 mPivot.set_size( 3 );
 
+                // allocate derivatives of Jacobi matrix
+                mdJacobidV.set_size( 3, 3, 0.0 );
+                mdJacobidU.set_size( 3, 3, 0.0 );
+                mdJacobidT.set_size( 3, 3, 0.0 );
+
                 // link compute matrix
                 if( mGas.is_idgas() )
                 {
                     mJacobiFunction
                             = & ChannelODE::compute_jacobi_idgas ;
+                    mJacobiDerivativeFunction
+                            = & ChannelODE::compute_jacobi_derivatives_idgas ;
                 }
                 else
                 {
                     mJacobiFunction
                             = & ChannelODE::compute_jacobi_realgas ;
+                    mJacobiDerivativeFunction
+                            = & ChannelODE::compute_jacobi_derivatives_realgas ;
                 }
 
                 mComputeFunction = & ChannelODE::compute_channel_ode ;
@@ -106,6 +124,13 @@ namespace belfem
             mWorkN.set_size( 3 );
             mWorkV.set_size( 3 );
 
+            // work data for compute_jacobian
+            mWorkJacobi.set_size( 3, 3 );
+            mInverseJacobi.set_size( 3, 3 );
+            mdBdY.set_size( 3, 3, 0.0 );
+            mWorkB.set_size( 3 );
+            mWorkZ.set_size( 3 );
+
             // link geometry function
             mGeometryFunction
                     = & ChannelODE::compute_geometry_from_element ;
@@ -115,6 +140,36 @@ namespace belfem
                     = & ChannelODE::compute_friction_element ;
         }
 
+//------------------------------------------------------------------------------
+
+        ChannelODE *
+        ChannelODE::clone( Gas & aGas ) const
+        {
+            BELFEM_ERROR( &aGas != &mGas, "a clone can not use the same gas" );
+
+            ChannelODE * aClone = mElementMode ?
+                    new ChannelODE( aGas, mMode ) :
+                    new ChannelODE( *mGeometry, aGas, mMode );
+
+            // links
+            aClone->mGeometry         = mGeometry ;
+            aClone->mElement          = mElement ;
+            aClone->mReverse          = mReverse ;
+            aClone->mGeometryFunction = mGeometryFunction ;
+            aClone->mFrictionFunction = mFrictionFunction ;
+
+            // settings
+            aClone->mTwall   = mTwall ;
+            aClone->mdRdxR   = mdRdxR ;
+            aClone->mdwdx    = mdwdx ;
+            aClone->mdMdxM   = mdMdxM ;
+            aClone->mdIdx    = mdIdx ;
+            aClone->mdYdx    = mdYdx ;
+            aClone->mCombust = mCombust ;
+
+            return aClone ;
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -256,6 +311,140 @@ namespace belfem
             adYdT( 2 ) *= aY( 2 );
         }
 
+//------------------------------------------------------------------------------
+
+        void
+        ChannelODE::compute_jacobian(
+                const real           & aX,
+                const Vector< real > & aY,
+                      Vector< real > & adYdx,
+                      Matrix< real > & adFdY,
+                      Matrix< real > & adFdH )
+        {
+            BELFEM_ERROR( mMode == ChannelMode::Channel && mElementMode && ! mCombust,
+                          "the Jacobian is only implemented for channels in element mode without combustion" );
+
+            // get inverse density
+            const real & tV = aY( 0 );
+
+            // get velocity
+            const real & tU = aY( 1 );
+
+            // get temperature
+            const real & tT = aY( 2 );
+
+            // compute pressure
+            const real tP = mGas.p( tT, tV );
+
+            // derivatives of the pressure
+            const real tdPdV = -1.0 / ( tV * mGas.kappa( tT, tP ) );
+            const real tdPdT = tP * mGas.beta( tT, tP );
+
+            // compute geometry data
+            ( this->*mGeometryFunction )( aX, mDh, mA, mdAdx );
+
+            // mass flux
+            real tDotM = mA * tU / tV ;
+
+            // local shear stress
+            real tTauW ;
+
+            // heat flux
+            real tDotQ ;
+
+            // Compute Jacobian Matrix and its derivatives
+            ( this->*mJacobiFunction )( tV, tU, tT, tP );
+            ( this->*mJacobiDerivativeFunction )( tV, tU, tT, tP, tdPdV, tdPdT );
+
+            // compute shear stress, also computes the interpolation function
+            ( this->*mFrictionFunction ) (
+                    aX,
+                    tV,
+                    tU,
+                    tT,
+                    tP,
+                    mTwall,
+                    tTauW,
+                    tDotQ ) ;
+
+            const real tSign = mReverse ? -1.0 : 1.0 ;
+
+            // right hand side, see compute_channel_ode
+            mWorkB( 0 ) = tSign * mdAdx / mA ;
+            mWorkB( 1 ) = tSign * ( - 4.0 * tTauW / ( mDh * tP ) - mdRdxR );
+            mWorkB( 2 ) = tSign * ( - 4.0 * mA * tDotQ / ( mDh * tDotM ) - mdwdx );
+
+            // derivatives of the right hand side, tau_w and dot_q
+            // are interpolated and do not depend on the state
+            mdBdY( 1, 0 ) = tSign * 4.0 * tTauW * tdPdV / ( mDh * tP * tP );
+            mdBdY( 1, 2 ) = tSign * 4.0 * tTauW * tdPdT / ( mDh * tP * tP );
+            mdBdY( 2, 0 ) = - tSign * 4.0 * tDotQ / ( mDh * tU );
+            mdBdY( 2, 1 ) = tSign * 4.0 * tDotQ * tV / ( mDh * tU * tU );
+
+            // inverse of the Jacobi matrix, gesv overwrites its arguments
+            for( uint k=0; k<3; ++k )
+            {
+                mWorkJacobi = mJacobi ;
+                mWorkZ.fill( 0.0 );
+                mWorkZ( k ) = 1.0 ;
+
+                gesv( mWorkJacobi, mWorkZ, mPivot );
+
+                for( uint i=0; i<3; ++i )
+                {
+                    mInverseJacobi( i, k ) = mWorkZ( i );
+                }
+            }
+
+            // relative change of the state
+            for( uint i=0; i<3; ++i )
+            {
+                mWorkZ( i ) = 0.0 ;
+                for( uint k=0; k<3; ++k )
+                {
+                    mWorkZ( i ) += mInverseJacobi( i, k ) * mWorkB( k );
+                }
+                adYdx( i ) = aY( i ) * mWorkZ( i );
+            }
+
+            // dz/dy = J^-1 * ( db/dy - dJ/dy * z )
+            const Matrix< real > * tdJacobi[ 3 ] = { &mdJacobidV, &mdJacobidU, &mdJacobidT };
+
+            for( uint j=0; j<3; ++j )
+            {
+                for( uint k=0; k<3; ++k )
+                {
+                    mWorkB( k ) = mdBdY( k, j );
+                    for( uint l=0; l<3; ++l )
+                    {
+                        mWorkB( k ) -= ( *tdJacobi[ j ] )( k, l ) * mWorkZ( l );
+                    }
+                }
+
+                for( uint i=0; i<3; ++i )
+                {
+                    adFdY( i, j ) = i == j ? mWorkZ( i ) : 0.0 ;
+                    for( uint k=0; k<3; ++k )
+                    {
+                        adFdY( i, j ) += aY( i ) * mInverseJacobi( i, k ) * mWorkB( k );
+                    }
+                }
+            }
+
+            // the right hand side is linear in tau_w and dot_q
+            for( uint n=0; n<3; ++n )
+            {
+                real tdBdTau = - tSign * 4.0 * mWorkN( n ) / ( mDh * tP );
+                real tdBdQ   = - tSign * 4.0 * mA * mWorkN( n ) / ( mDh * tDotM );
+
+                for( uint i=0; i<3; ++i )
+                {
+                    adFdH( i, 2 * n )     = aY( i ) * mInverseJacobi( i, 1 ) * tdBdTau ;
+                    adFdH( i, 2 * n + 1 ) = aY( i ) * mInverseJacobi( i, 2 ) * tdBdQ ;
+                }
+            }
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -474,6 +663,94 @@ namespace belfem
             mJacobi( 2, 2 ) = ( mGas.cv( aT, aP ) + aP * aV * tBeta ) * aT ;
         }
 
+//------------------------------------------------------------------------------
+
+        void
+        ChannelODE::compute_jacobi_derivatives_idgas(
+                const real & aV,
+                const real & aU,
+                const real & aT,
+                const real & aP,
+                const real & adPdV,
+                const real & adPdT )
+        {
+            // derivatives of compute_jacobi_idgas, p = p( T, v )
+            const real tM11 = aU * aU / ( aP * aV );
+
+            mdJacobidV( 1, 1 ) = - tM11 * ( 1.0 / aV + adPdV / aP );
+            mdJacobidU( 1, 1 ) = 2.0 * aU / ( aP * aV );
+            mdJacobidT( 1, 1 ) = - tM11 * adPdT / aP ;
+
+            mdJacobidU( 2, 1 ) = 2.0 * aU ;
+
+            // cp of an ideal gas only depends on T
+            mdJacobidT( 2, 2 ) = mGas.dcpdT( aT, aP ) * aT + mGas.cp( aT, aP );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ChannelODE::compute_jacobi_derivatives_realgas(
+                const real & aV,
+                const real & aU,
+                const real & aT,
+                const real & aP,
+                const real & adPdV,
+                const real & adPdT )
+        {
+            const real tAlpha = mGas.alpha( aT, aP );
+            const real tBeta  = mGas.beta( aT, aP );
+            const real tKappa = mGas.kappa( aT, aP );
+            const real tCv    = mGas.cv( aT, aP );
+
+            // the gas provides no derivatives of these coefficients,
+            // so they are computed by central differences in T and p
+            const real tDeltaT = 1e-6 * aT ;
+            const real tDeltaP = 1e-6 * aP ;
+
+            const real tdAlphadT = ( mGas.alpha( aT + tDeltaT, aP ) - mGas.alpha( aT - tDeltaT, aP ) ) / ( 2.0 * tDeltaT );
+            const real tdAlphadP = ( mGas.alpha( aT, aP + tDeltaP ) - mGas.alpha( aT, aP - tDeltaP ) ) / ( 2.0 * tDeltaP );
+            const real tdBetadT  = ( mGas.beta( aT + tDeltaT, aP ) - mGas.beta( aT - tDeltaT, aP ) ) / ( 2.0 * tDeltaT );
+            const real tdBetadP  = ( mGas.beta( aT, aP + tDeltaP ) - mGas.beta( aT, aP - tDeltaP ) ) / ( 2.0 * tDeltaP );
+            const real tdKappadT = ( mGas.kappa( aT + tDeltaT, aP ) - mGas.kappa( aT - tDeltaT, aP ) ) / ( 2.0 * tDeltaT );
+            const real tdKappadP = ( mGas.kappa( aT, aP + tDeltaP ) - mGas.kappa( aT, aP - tDeltaP ) ) / ( 2.0 * tDeltaP );
+            const real tdCvdT    = ( mGas.cv( aT + tDeltaT, aP ) - mGas.cv( aT - tDeltaT, aP ) ) / ( 2.0 * tDeltaT );
+            const real tdCvdP    = ( mGas.cv( aT, aP + tDeltaP ) - mGas.cv( aT, aP - tDeltaP ) ) / ( 2.0 * tDeltaP );
+
+            const real tM11 = aU * aU / ( aP * aV );
+
+            // derivatives of compute_jacobi_realgas with respect to v and T,
+            // where p = p( T, v )
+            Matrix< real > * tdJacobi[ 2 ] = { &mdJacobidV, &mdJacobidT };
+            const real tdV[ 2 ] = { 1.0, 0.0 };
+            const real tdT[ 2 ] = { 0.0, 1.0 };
+            const real tdP[ 2 ] = { adPdV, adPdT };
+
+            for( uint d=0; d<2; ++d )
+            {
+                Matrix< real > & tdJ = *tdJacobi[ d ];
+
+                const real tdAlpha = tdAlphadT * tdT[ d ] + tdAlphadP * tdP[ d ];
+                const real tdBeta  = tdBetadT  * tdT[ d ] + tdBetadP  * tdP[ d ];
+                const real tdKappa = tdKappadT * tdT[ d ] + tdKappadP * tdP[ d ];
+                const real tdCv    = tdCvdT    * tdT[ d ] + tdCvdP    * tdP[ d ];
+
+                tdJ( 1, 0 ) = ( tBeta * tdAlpha - tAlpha * tdBeta ) / ( tAlpha * tAlpha );
+                tdJ( 2, 0 ) = ( ( tdT[ d ] * tAlpha + aT * tdAlpha ) * aV
+                              + ( aT * tAlpha - 1.0 ) * tdV[ d ] ) / tKappa
+                              - ( aT * tAlpha - 1.0 ) * aV * tdKappa / ( tKappa * tKappa );
+
+                tdJ( 1, 1 ) = - tM11 * ( tdV[ d ] / aV + tdP[ d ] / aP );
+
+                tdJ( 1, 2 ) = tdBeta * aT + tBeta * tdT[ d ];
+                tdJ( 2, 2 ) = ( tdCv + ( tdP[ d ] * aV + aP * tdV[ d ] ) * tBeta + aP * aV * tdBeta ) * aT
+                              + ( tCv + aP * aV * tBeta ) * tdT[ d ];
+            }
+
+            mdJacobidU( 1, 1 ) = 2.0 * aU / ( aP * aV );
+            mdJacobidU( 2, 1 ) = 2.0 * aU ;
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -48,6 +48,20 @@ namespace belfem
             // Pivot Vector for gesv
             Vector< int > mPivot;
 
+            // derivatives of the Jacobian Matrix with respect to v, u and T
+            Matrix< real > mdJacobidV ;
+            Matrix< real > mdJacobidU ;
+            Matrix< real > mdJacobidT ;
+
+            // work matrices for compute_jacobian
+            Matrix< real > mWorkJacobi ;
+            Matrix< real > mInverseJacobi ;
+            Matrix< real > mdBdY ;
+
+            // work vectors for compute_jacobian
+            Vector< real > mWorkB ;
+            Vector< real > mWorkZ ;
+
             // value for dRdx/R ( combustion only )
             real mdRdxR = 0.0 ;
 
@@ -111,6 +125,18 @@ namespace belfem
               const real & aT,
               const real & aP );
 
+//------------------------------------------------------------------------------
+
+            // Function pointer for the derivatives of the Jacobi matrix
+            void
+            ( ChannelODE:: * mJacobiDerivativeFunction )
+            ( const real & aV,
+              const real & aU,
+              const real & aT,
+              const real & aP,
+              const real & adPdV,
+              const real & adPdT );
+
 //------------------------------------------------------------------------------
 
             // Function pointer for friction
@@ -144,6 +170,15 @@ namespace belfem
             virtual
             ~ChannelODE() = default ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates a copy with the same settings that works on aGas.
+             * The geometry and the linked element are shared.
+             */
+            ChannelODE *
+            clone( Gas & aGas ) const ;
+
 //------------------------------------------------------------------------------
 
             virtual void
@@ -152,6 +187,26 @@ namespace belfem
                     const Vector <real> & aY,
                     Vector <real>       & adYdT ) ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * computes the right hand side like compute, and its
+             * derivatives with respect to the state ( v, u, T ) and to
+             * tau_w and dot_q at the nodes of the linked element.
+             * Only for channels in element mode without combustion.
+             *
+             * adFdY : 3x3 matrix
+             * adFdH : 3x6 matrix, columns tau_w and dot_q of each node,
+             *         in the order of Element::collect_data
+             */
+            void
+            compute_jacobian(
+                    const real           & aX,
+                    const Vector< real > & aY,
+                          Vector< real > & adYdx,
+                          Matrix< real > & adFdY,
+                          Matrix< real > & adFdH );
+
 //------------------------------------------------------------------------------
 
             // set the wall temperature
@@ -247,6 +302,29 @@ namespace belfem
                     const real & aT,
                     const real & aP ) ;
 
+//------------------------------------------------------------------------------
+
+            void
+            compute_jacobi_derivatives_idgas(
+                    const real & aV,
+                    const real & aU,
+                    const real & aT,
+                    const real & aP,
+                    const real & adPdV,
+                    const real & adPdT );
+
+//------------------------------------------------------------------------------
+
+            void
+            compute_jacobi_derivatives_realgas(
+                    const real & aV,
+                    const real & aU,
+                    const real & aT,
+                    const real & aP,
+                    const real & adPdV,
+                    const real & adPdT );
+
+
 //------------------------------------------------------------------------------
 
             void
@@ -0,0 +1,248 @@
+//
+// Created on 16.10.26.
+//
+
+#include "assert.hpp"
+#include "cl_Cell.hpp"
+#include "fn_GT_data_path.hpp"
+#include "cl_ODE_Integrator.hpp"
+#include "en_ODE_Type.hpp"
+
+#include "cl_CH_Combustor.hpp"
+#include "cl_CH_ChannelODE.hpp"
+#include "cl_CH_ReactingSolver.hpp"
+#include "cl_CN_Injector.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        Combustor::Combustor( const string & aChemkinFilePath ) :
+            mScheme( aChemkinFilePath.size() == 0 ?
+                     gastables::data_path() + "/jachimowski.inp" : aChemkinFilePath,
+                     Fuel::LH2, Oxidizer::AIR ),
+            mFuel( "H2" )
+        {
+
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Combustor::set_output_step( const real aOutputStep )
+        {
+            BELFEM_ERROR( aOutputStep > 0, "output step must be positive" );
+            mOutputStep = aOutputStep ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Combustor::store_profile( const bool aSwitch )
+        {
+            mStoreProfile = aSwitch ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Combustor::run( const CombustorCase & aCase, CombustorResult & aResult )
+        {
+            aResult = CombustorResult() ;
+            aResult.mCase = aCase ;
+
+            Gas * tGas = mScheme.combgas() ;
+
+            // reset scheme at initial condition
+            mScheme.reset_combgas_mixture();
+
+            real tX = 0.0 ;
+            real tXinj = mGeometry.injector_position() ;
+            real tLength = mGeometry.length() ;
+
+            // massflow of air
+            real tDotM_air = tGas->c( aCase.mT3, aCase.mP3 ) * aCase.mMa3
+                    * tGas->rho( aCase.mT3, aCase.mP3 ) * mGeometry.A( 0 );
+
+            combustion::Injector tInjector(
+                    mScheme,
+                    tXinj,
+                    2.0 * mGeometry.R( 0.0 ),
+                    aCase.mEtaMix,
+                    aCase.mPulsonetti );
+
+            tInjector.set_phi( aCase.mPhi );
+            tInjector.set_oxidizer_massflow( tDotM_air );
+
+            real tDotM_fuel = tDotM_air / tInjector.of() ;
+
+            ChannelODE tODE( mGeometry, *tGas, ChannelMode::Combustor );
+            tODE.set_combustion( 0.0, 0.0 );
+            tODE.set_wall_temperature( aCase.mTw );
+
+            // initial state
+            Vector< real > tY( 3 );
+            tY( 0 ) = tGas->v( aCase.mT3, aCase.mP3 );
+            tY( 1 ) = aCase.mMa3 * tGas->c( aCase.mT3, aCase.mP3 );
+            tY( 2 ) = aCase.mT3 ;
+
+            Cell< Vector< real > > tProfile ;
+            Cell< real > tPositions ;
+
+            real tMaxT = tY( 2 );
+
+//------------------------------------------------------------------------------
+// air up to the injector
+//------------------------------------------------------------------------------
+
+            ode::Integrator tIntegrator( tODE, ode::Type::RK45 );
+            tIntegrator.maxtime() = tXinj ;
+            tIntegrator.timestep() = 0.01 ;
+
+            while( tX < tXinj )
+            {
+                tIntegrator.step( tX, tY );
+
+                if( mStoreProfile )
+                {
+                    tProfile.push( tY );
+                    tPositions.push( tX );
+                }
+            }
+
+//------------------------------------------------------------------------------
+// expansion across the step and mixing
+//------------------------------------------------------------------------------
+
+            real tA1 = mGeometry.A( tXinj - BELFEM_EPSILON );
+            real tA2 = mGeometry.A( tXinj + BELFEM_EPSILON );
+
+            tX += 0.01 ;
+
+            real tT2 ;
+            real tP2 ;
+            real tU2 ;
+
+            tGas->expand( tA1, tY( 2 ), tGas->p( tY( 2 ), tY( 0 ) ), tY( 1 ),
+                          tA2, tT2, tP2, tU2 );
+
+            tY( 0 ) = tGas->v( tT2, tP2 );
+            tY( 1 ) = tU2 ;
+            tY( 2 ) = tT2 ;
+
+            this->mix_fuel( aCase, tDotM_air, tDotM_fuel, tY );
+
+            // fuel that is already mixed at the current position
+            tInjector.inject( tX );
+
+//------------------------------------------------------------------------------
+// reacting flow
+//------------------------------------------------------------------------------
+
+            ReactingSolver tSolver( tODE, mScheme, &tInjector );
+
+            Vector< real > tMassFractions ;
+
+            while( tX < tLength )
+            {
+                tSolver.run( tX, tY, std::min( tX + mOutputStep, tLength ) );
+
+                tMassFractions = tGas->mass_fractions() ;
+                tGas->remix_mass( tMassFractions, true, true );
+
+                tMaxT = std::max( tMaxT, tY( 2 ) );
+
+                if( mStoreProfile )
+                {
+                    tProfile.push( tY );
+                    tPositions.push( tX );
+                }
+            }
+
+//------------------------------------------------------------------------------
+// result
+//------------------------------------------------------------------------------
+
+            aResult.mX  = tX ;
+            aResult.mT  = tY( 2 );
+            aResult.mP  = tGas->p( tY( 2 ), tY( 0 ) );
+            aResult.mU  = tY( 1 );
+            aResult.mMa = tY( 1 ) / tGas->c( aResult.mT, aResult.mP );
+            aResult.mMaxT = tMaxT ;
+            aResult.mNumberOfSteps = tSolver.number_of_accepted_steps() ;
+
+            // unburned fuel
+            tMassFractions = tGas->mass_fractions() ;
+            real tMu = tDotM_fuel / ( tDotM_air + tDotM_fuel );
+            aResult.mEfficiency = 1.0 - ( tMassFractions( mScheme.reacting_fuel_index() )
+                                        + tMassFractions( mScheme.inert_fuel_index() ) ) / tMu ;
+
+            if( mStoreProfile )
+            {
+                uint tN = tProfile.size() ;
+                aResult.mProfile.set_size( tN, 4 );
+
+                for( uint k=0; k<tN; ++k )
+                {
+                    aResult.mProfile( k, 0 ) = tPositions( k );
+                    for( uint i=0; i<3; ++i )
+                    {
+                        aResult.mProfile( k, i+1 ) = tProfile( k )( i );
+                    }
+                }
+            }
+
+            aResult.mSuccess = true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Combustor::mix_fuel(
+                const CombustorCase & aCase,
+                const real aAirMassflow,
+                const real aFuelMassflow,
+                Vector< real > & aY )
+        {
+            Gas * tGas = mScheme.combgas() ;
+
+            real tT = aY( 2 );
+            real tP = tGas->p( aY( 2 ), aY( 0 ) );
+            real tU = aY( 1 );
+
+            real tDotM = aAirMassflow + aFuelMassflow ;
+
+            // enthalpy of air
+            real tHair = tGas->h( tT, tP ) + 0.5 * tU * tU ;
+
+            // enthalpy of fuel
+            real tHfuel = mFuel.h( aCase.mFuelTemperature, tP )
+                    + 0.5 * aCase.mFuelVelocity * aCase.mFuelVelocity ;
+
+            // new velocity
+            tU = ( aAirMassflow * tU + aFuelMassflow * aCase.mFuelVelocity ) / tDotM ;
+
+            // new total enthalpy
+            real tHt = ( tHair * aAirMassflow + tHfuel * aFuelMassflow ) / tDotM ;
+
+            // inject fuel into gas, it is inert until it is mixed
+            Vector< real > tMassFractions = tGas->mass_fractions() ;
+            tMassFractions *= aAirMassflow ;
+            tMassFractions( mScheme.inert_fuel_index() ) += aFuelMassflow ;
+            tMassFractions /= tDotM ;
+
+            tGas->remix_mass( tMassFractions );
+
+            // compute new temperature
+            tT = tGas->T_from_h( tHt - 0.5 * tU * tU, tP );
+
+            aY( 0 ) = tGas->v( tT, tP );
+            aY( 1 ) = tU ;
+            aY( 2 ) = tT ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
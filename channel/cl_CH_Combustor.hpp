@@ -0,0 +1,182 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CH_COMBUSTOR_HPP
+#define BELFEM_CL_CH_COMBUSTOR_HPP
+
+#include "typedefs.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+#include "cl_Gas.hpp"
+
+#include "cl_CN_Scheme.hpp"
+#include "cl_CH_GeometryCombustor.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * input parameters of one combustor run
+         */
+        struct CombustorCase
+        {
+            // equivalence ratio
+            real mPhi = 0.6 ;
+
+            // state at combustor entry
+            real mMa3 = 2.77 ;
+            real mT3  = 1100.0 ;
+            real mP3  = 0.43e5 ;
+
+            // wall temperature
+            real mTw  = 600.0 ;
+
+            // fuel state at injection
+            real mFuelTemperature = 600.0 ;
+            real mFuelVelocity    = 300.0 ;
+
+            // mixing model, see combustion::Injector
+            real mEtaMix     = 0.8 ;
+            real mPulsonetti = 15.0 ;
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * result of one combustor run
+         */
+        struct CombustorResult
+        {
+            CombustorCase mCase ;
+
+            // false if the run did not reach the exit
+            bool mSuccess = false ;
+
+            // state at the exit
+            real mX  = BELFEM_QUIET_NAN ;
+            real mT  = BELFEM_QUIET_NAN ;
+            real mP  = BELFEM_QUIET_NAN ;
+            real mU  = BELFEM_QUIET_NAN ;
+            real mMa = BELFEM_QUIET_NAN ;
+
+            // maximum temperature along the channel
+            real mMaxT = BELFEM_QUIET_NAN ;
+
+            // fraction of injected fuel that has been burned
+            real mEfficiency = BELFEM_QUIET_NAN ;
+
+            // number of steps of the reacting part
+            uint mNumberOfSteps = 0 ;
+
+            // x, v, u, T, only if requested
+            Matrix< real > mProfile ;
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * The ITLR supersonic combustor model.
+         *
+         * The air is integrated up to the injector step, expanded
+         * across the step and mixed with the hydrogen. The reacting
+         * part is integrated with the ReactingSolver.
+         *
+         * Each object owns its own Scheme and Gas, so several
+         * combustors can run at the same time on different threads.
+         */
+        class Combustor
+        {
+            GeometryCombustor mGeometry ;
+
+            combustion::Scheme mScheme ;
+
+            // pure fuel for injection enthalpy
+            Gas mFuel ;
+
+            // distance between two output points
+            real mOutputStep = 0.001 ;
+
+            // flag telling if the profile is written into the result
+            bool mStoreProfile = false ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aChemkinFilePath  reaction mechanism, uses the
+             *                          Jachimowski mechanism if empty
+             */
+            Combustor( const string & aChemkinFilePath="" );
+
+//------------------------------------------------------------------------------
+
+            ~Combustor() = default ;
+
+//------------------------------------------------------------------------------
+
+            void
+            set_output_step( const real aOutputStep );
+
+//------------------------------------------------------------------------------
+
+            void
+            store_profile( const bool aSwitch );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * run one case. Failures within the solver are not caught
+             * here, see CombustorSweep.
+             */
+            void
+            run( const CombustorCase & aCase, CombustorResult & aResult );
+
+//------------------------------------------------------------------------------
+
+            inline GeometryCombustor &
+            geometry() ;
+
+//------------------------------------------------------------------------------
+
+            inline combustion::Scheme &
+            scheme() ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // mix the fuel into the air behind the step
+            void
+            mix_fuel( const CombustorCase & aCase,
+                      const real aAirMassflow,
+                      const real aFuelMassflow,
+                      Vector< real > & aY );
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline GeometryCombustor &
+        Combustor::geometry()
+        {
+            return mGeometry ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline combustion::Scheme &
+        Combustor::scheme()
+        {
+            return mScheme ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_CH_COMBUSTOR_HPP
@@ -0,0 +1,193 @@
+//
+// Created on 16.10.26.
+//
+
+#include <thread>
+#include <stdexcept>
+
+#include "assert.hpp"
+#include "cl_HDF5.hpp"
+#include "cl_CH_CombustorSweep.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        CombustorSweep::CombustorSweep(
+                const string & aChemkinFilePath,
+                const uint aNumberOfThreads ) :
+            mNextCase( 0 )
+        {
+            uint tNumberOfThreads = aNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : aNumberOfThreads ;
+
+            tNumberOfThreads = std::max( tNumberOfThreads, ( uint ) 1 );
+
+            // the combustors are created here, so that reading
+            // the mechanism and the gas data is not done in parallel
+            for( uint t=0; t<tNumberOfThreads; ++t )
+            {
+                mCombustors.push( new Combustor( aChemkinFilePath ) );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        CombustorSweep::~CombustorSweep()
+        {
+            for( Combustor * tCombustor : mCombustors )
+            {
+                delete tCombustor ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::add_case( const CombustorCase & aCase )
+        {
+            mCases.push( aCase );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::add_grid(
+                const Vector< real > & aPhi,
+                const Vector< real > & aMa3,
+                const Vector< real > & aT3,
+                const Vector< real > & aP3,
+                const Vector< real > & aTw,
+                const CombustorCase  & aTemplate )
+        {
+            CombustorCase tCase = aTemplate ;
+
+            for( uint e=0; e<aTw.length(); ++e )
+            {
+                tCase.mTw = aTw( e );
+
+                for( uint d=0; d<aP3.length(); ++d )
+                {
+                    tCase.mP3 = aP3( d );
+
+                    for( uint c=0; c<aT3.length(); ++c )
+                    {
+                        tCase.mT3 = aT3( c );
+
+                        for( uint b=0; b<aMa3.length(); ++b )
+                        {
+                            tCase.mMa3 = aMa3( b );
+
+                            for( uint a=0; a<aPhi.length(); ++a )
+                            {
+                                tCase.mPhi = aPhi( a );
+                                mCases.push( tCase );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::run()
+        {
+            index_t tNumberOfCases = mCases.size() ;
+
+            mResults.set_size( tNumberOfCases, CombustorResult() );
+            mNextCase = 0 ;
+
+            index_t tNumberOfThreads = std::min( ( index_t ) mCombustors.size(), tNumberOfCases );
+
+            if( tNumberOfThreads < 2 )
+            {
+                this->run_cases( mCombustors( 0 ) );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    tThreads.emplace_back( &CombustorSweep::run_cases, this, mCombustors( t ) );
+                }
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::run_cases( Combustor * aCombustor )
+        {
+            index_t tNumberOfCases = mCases.size() ;
+
+            for( index_t k = mNextCase++; k<tNumberOfCases; k = mNextCase++ )
+            {
+                // a case that fails must not end the other threads,
+                // it is marked as not successful instead
+                try
+                {
+                    aCombustor->run( mCases( k ), mResults( k ) );
+                }
+                catch( const std::exception & )
+                {
+                    mResults( k ) = CombustorResult() ;
+                    mResults( k ).mCase = mCases( k );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::get_table( Matrix< real > & aTable ) const
+        {
+            index_t tNumberOfCases = mResults.size() ;
+
+            aTable.set_size( tNumberOfCases, 12 );
+
+            for( index_t k=0; k<tNumberOfCases; ++k )
+            {
+                const CombustorResult & tResult = mResults( k );
+
+                aTable( k,  0 ) = tResult.mCase.mPhi ;
+                aTable( k,  1 ) = tResult.mCase.mMa3 ;
+                aTable( k,  2 ) = tResult.mCase.mT3 ;
+                aTable( k,  3 ) = tResult.mCase.mP3 ;
+                aTable( k,  4 ) = tResult.mCase.mTw ;
+                aTable( k,  5 ) = tResult.mSuccess ? 1.0 : 0.0 ;
+                aTable( k,  6 ) = tResult.mT ;
+                aTable( k,  7 ) = tResult.mP ;
+                aTable( k,  8 ) = tResult.mMa ;
+                aTable( k,  9 ) = tResult.mMaxT ;
+                aTable( k, 10 ) = tResult.mEfficiency ;
+                aTable( k, 11 ) = tResult.mNumberOfSteps ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CombustorSweep::save( const string & aPath ) const
+        {
+            Matrix< real > tTable ;
+            this->get_table( tTable );
+
+            HDF5 tFile( aPath, FileMode::NEW );
+            tFile.save_data( "Sweep", tTable );
+            tFile.close();
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,141 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CH_COMBUSTORSWEEP_HPP
+#define BELFEM_CL_CH_COMBUSTORSWEEP_HPP
+
+#include <atomic>
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+
+#include "cl_CH_Combustor.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Runs many combustor cases on all cores.
+         *
+         * Each thread owns one Combustor with its own Scheme and Gas.
+         * The combustors are created on the main thread, and the
+         * cases are handed out one by one, since their runtime
+         * differs a lot between ignition and no ignition.
+         */
+        class CombustorSweep
+        {
+            // one combustor per thread
+            Cell< Combustor * > mCombustors ;
+
+            Cell< CombustorCase > mCases ;
+            Cell< CombustorResult > mResults ;
+
+            // next case to be computed
+            std::atomic< index_t > mNextCase ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aChemkinFilePath  reaction mechanism, see Combustor
+             * @param aNumberOfThreads  0: use all available cores
+             */
+            CombustorSweep( const string & aChemkinFilePath="",
+                            const uint aNumberOfThreads=0 );
+
+//------------------------------------------------------------------------------
+
+            ~CombustorSweep();
+
+//------------------------------------------------------------------------------
+
+            void
+            add_case( const CombustorCase & aCase );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add all combinations of the given parameters.
+             * The remaining parameters are taken from aTemplate.
+             */
+            void
+            add_grid( const Vector< real > & aPhi,
+                      const Vector< real > & aMa3,
+                      const Vector< real > & aT3,
+                      const Vector< real > & aP3,
+                      const Vector< real > & aTw,
+                      const CombustorCase  & aTemplate=CombustorCase() );
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_cases() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * compute all cases
+             */
+            void
+            run();
+
+//------------------------------------------------------------------------------
+
+            inline const Cell< CombustorResult > &
+            results() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * one row per case:
+             * phi, Ma3, T3, p3, Tw, success, T, p, Ma, Tmax, efficiency, steps
+             */
+            void
+            get_table( Matrix< real > & aTable ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * write the table into an HDF5 file
+             */
+            void
+            save( const string & aPath ) const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // worker: compute cases until none are left
+            void
+            run_cases( Combustor * aCombustor );
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CombustorSweep::number_of_cases() const
+        {
+            return mCases.size() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Cell< CombustorResult > &
+        CombustorSweep::results() const
+        {
+            return mResults ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_CH_COMBUSTORSWEEP_HPP
@@ -0,0 +1,476 @@
+//
+// Created on 16.10.26.
+//
+
+#include <cmath>
+#include <utility>
+
+#include "cl_CH_ReactingSolver.hpp"
+#include "assert.hpp"
+#include "cl_GT_RefGas.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        ReactingSolver::ReactingSolver(
+                ChannelODE           & aODE,
+                combustion::Scheme   & aScheme,
+                combustion::Injector * aInjector ) :
+                mODE( aODE ),
+                mScheme( aScheme ),
+                mGas( *aScheme.combgas() ),
+                mInjector( aInjector ),
+                mNumberOfSpecies( aScheme.combgas()->number_of_components() ),
+                mNumberOfReactingSpecies( aScheme.number_of_reacting_species() ),
+                mDimension( mNumberOfSpecies + 3 )
+        {
+            mM.set_size( mNumberOfSpecies );
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                mM( k ) = mGas.component( k )->M() ;
+            }
+
+            mZ.set_size( mDimension );
+            mZ1.set_size( mDimension );
+            mF0.set_size( mDimension );
+            mF1.set_size( mDimension );
+            mK1.set_size( mDimension );
+            mK2.set_size( mDimension );
+            mWork.set_size( mDimension );
+
+            mY.set_size( mNumberOfSpecies );
+
+            mFlow.set_size( 3 );
+            mdFlowdX.set_size( 3 );
+            mdFlowdR.set_size( 3 );
+            mdFlowdW.set_size( 3 );
+
+            mdRdY.set_size( mNumberOfReactingSpecies );
+            mdWdY.set_size( mNumberOfReactingSpecies );
+
+            mJacobi.set_size( mDimension, mDimension );
+            mLU.set_size( mDimension, mDimension );
+            mPivot.set_size( mDimension );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::set_tolerances(
+                const real aRelativeTolerance,
+                const real aAbsoluteTolerance )
+        {
+            mRelativeTolerance = aRelativeTolerance ;
+            mAbsoluteTolerance = aAbsoluteTolerance ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::set_step_limits( const real aMinStep, const real aMaxStep )
+        {
+            BELFEM_ERROR( aMinStep > 0 && aMinStep < aMaxStep, "invalid step limits" );
+
+            mMinStep = aMinStep ;
+            mMaxStep = aMaxStep ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::step( real & aX, Vector< real > & aY, const real aXmax )
+        {
+            // assemble the coupled state
+            const Vector< real > & tY = mGas.mass_fractions() ;
+
+            for( uint i=0; i<3; ++i )
+            {
+                mZ( i ) = aY( i );
+            }
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                mZ( k + 3 ) = tY( k );
+            }
+
+            // the Jacobian is computed once per step
+            this->compute_rhs( aX, mZ, mF0 );
+            this->compute_jacobi( aX );
+
+            bool tAccepted = false ;
+
+            while( ! tAccepted )
+            {
+                BELFEM_ERROR( mStep >= mMinStep,
+                              "step width below minimum at x=%g", aX );
+
+                // do not step beyond the end
+                const bool tIsTruncated = aX + mStep > aXmax ;
+                const real tH = tIsTruncated ? aXmax - aX : mStep ;
+
+                // iteration matrix W = I - gamma * h * J,
+                // which is factorized once for both stages
+                mLU = mJacobi ;
+                mLU *= - mGamma * tH ;
+                for( uint i=0; i<mDimension; ++i )
+                {
+                    mLU( i, i ) += 1.0 ;
+                }
+                this->factorize_iteration_matrix();
+
+                // first stage : W k1 = f( x, z )
+                mK1 = mF0 ;
+                this->solve_iteration_matrix( mK1 );
+
+                // second stage : W k2 = f( x + h, z + h k1 ) - 2 k1
+                for( uint i=0; i<mDimension; ++i )
+                {
+                    mZ1( i ) = mZ( i ) + tH * mK1( i );
+                }
+
+                this->compute_rhs( aX + tH, mZ1, mF1 );
+
+                for( uint i=0; i<mDimension; ++i )
+                {
+                    mK2( i ) = mF1( i ) - 2.0 * mK1( i );
+                }
+                this->solve_iteration_matrix( mK2 );
+
+                // new state and difference to the embedded first order solution
+                for( uint i=0; i<mDimension; ++i )
+                {
+                    mZ1( i ) = mZ( i ) + tH * ( 1.5 * mK1( i ) + 0.5 * mK2( i ) );
+                    mWork( i ) = 0.5 * tH * ( mK1( i ) + mK2( i ) );
+                }
+
+                real tError = this->error_norm( mWork );
+
+                // a negative volume or temperature is never accepted
+                if( ! ( mZ1( 0 ) > 0 && mZ1( 2 ) > 0 ) )
+                {
+                    tError = BELFEM_REAL_MAX ;
+                }
+
+                tAccepted = tError <= 1.0 ;
+
+                // new step width for a first order error estimate
+                real tFactor = tError > 0.0 ? 0.9 / std::sqrt( tError ) : 5.0 ;
+                tFactor = std::max( std::min( tFactor, 5.0 ), 0.2 );
+
+                if( tAccepted )
+                {
+                    ++mNumberOfAcceptedSteps ;
+
+                    // hit the end exactly, so that no tiny step is left
+                    aX = tIsTruncated ? aXmax : aX + tH ;
+
+                    // a truncated step must not shrink the step width
+                    if( ! tIsTruncated )
+                    {
+                        mStep = std::min( tFactor * tH, mMaxStep );
+                    }
+                }
+                else
+                {
+                    ++mNumberOfRejectedSteps ;
+                    mStep = tFactor * tH ;
+                }
+            }
+
+            // write back the result
+            for( uint i=0; i<3; ++i )
+            {
+                aY( i ) = mZ1( i );
+            }
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                mY( k ) = std::max( mZ1( k + 3 ), 0.0 );
+            }
+            mGas.remix_mass( mY, false, false );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::run( real & aX, Vector< real > & aY, const real aXend )
+        {
+            while( aX < aXend )
+            {
+                this->step( aX, aY, aXend );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::compute_rhs(
+                const real aX,
+                const Vector< real > & aZ,
+                      Vector< real > & adZdX )
+        {
+            // update the composition of the gas, negative
+            // values of the stages are not passed to the chemistry
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                mY( k ) = std::max( aZ( k + 3 ), 0.0 );
+            }
+            mGas.remix_mass( mY, false, false );
+
+            const real & tV = aZ( 0 );
+            const real & tU = aZ( 1 );
+            const real & tT = aZ( 2 );
+            const real   tP = mGas.p( tT, tV );
+
+            // reaction rates, the chemistry Jacobian is only
+            // computed once per step by compute_jacobi
+            mScheme.compute_rates( tT, tP );
+
+            const Vector< real > & tdYdt = mScheme.dYdt() ;
+
+            // change of the species along the channel
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                adZdX( k + 3 ) = k < mNumberOfReactingSpecies ? tdYdt( k ) / tU : 0.0 ;
+            }
+
+            // fuel that is mixed into the reacting part
+            if( mInjector != nullptr )
+            {
+                real tRate = mInjector->mixing_rate( aX );
+                adZdX( mScheme.inert_fuel_index() + 3 ) -= tRate ;
+                adZdX( mScheme.reacting_fuel_index() + 3 ) += tRate ;
+            }
+
+            // change of the gas constant
+            real tS  = 0.0 ;
+            real tdS = 0.0 ;
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                tS  += mY( k ) / mM( k );
+                tdS += adZdX( k + 3 ) / mM( k );
+            }
+            mdRdxR = tdS / tS ;
+
+            // heat of reaction
+            mdwdx = mGas.cp( tT, tP ) * mScheme.dTdt() / tU ;
+
+            // flow equations
+            for( uint i=0; i<3; ++i )
+            {
+                mFlow( i ) = aZ( i );
+            }
+
+            mODE.set_combustion( mdRdxR, mdwdx );
+            mODE.compute( aX, mFlow, mdFlowdX );
+
+            for( uint i=0; i<3; ++i )
+            {
+                adZdX( i ) = mdFlowdX( i );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::compute_jacobi( const real aX )
+        {
+            mJacobi.fill( 0.0 );
+
+            const real tU = mZ( 1 );
+            const real tT = mZ( 2 );
+            const real tP = mGas.p( tT, mZ( 0 ) );
+
+            // the gas still holds the composition of the last call of compute_rhs
+            mScheme.compute_rates_and_jacobi( tT, tP );
+
+            const Matrix< real > & tJ = mScheme.jacobi() ;
+            const uint tTemperatureIndex = mNumberOfReactingSpecies ;
+
+            real tS = 0.0 ;
+            for( uint k=0; k<mNumberOfSpecies; ++k )
+            {
+                tS += mY( k ) / mM( k );
+            }
+
+            const real tCp = mGas.cp( tT, tP );
+
+            for( uint j=0; j<mNumberOfReactingSpecies; ++j )
+            {
+                real tdS = 0.0 ;
+
+                for( uint i=0; i<mNumberOfReactingSpecies; ++i )
+                {
+                    mJacobi( i + 3, j + 3 ) = tJ( i, j ) / tU ;
+                    tdS += tJ( i, j ) / mM( i );
+                }
+
+                // the change of the heat capacity and of the
+                // denominator of dR/R is neglected, which is
+                // allowed for a W-method
+                mdRdY( j ) = tdS / ( tU * tS );
+                mdWdY( j ) = tCp * tJ( tTemperatureIndex, j ) / tU ;
+            }
+
+            // the flow equations are linear in the combustion terms
+            for( uint i=0; i<3; ++i )
+            {
+                mFlow( i ) = mZ( i );
+            }
+
+            const real tdRdxR = mdRdxR ;
+            const real tdwdx  = mdwdx ;
+
+            real tDeltaR = 1e-6 * std::max( std::abs( tdRdxR ), 1.0 );
+            mODE.set_combustion( tdRdxR + tDeltaR, tdwdx );
+            mODE.compute( aX, mFlow, mdFlowdR );
+
+            real tDeltaW = 1e-6 * std::max( std::abs( tdwdx ), 1.0 );
+            mODE.set_combustion( tdRdxR, tdwdx + tDeltaW );
+            mODE.compute( aX, mFlow, mdFlowdW );
+
+            for( uint i=0; i<3; ++i )
+            {
+                mdFlowdR( i ) = ( mdFlowdR( i ) - mF0( i ) ) / tDeltaR ;
+                mdFlowdW( i ) = ( mdFlowdW( i ) - mF0( i ) ) / tDeltaW ;
+            }
+
+            for( uint j=0; j<mNumberOfReactingSpecies; ++j )
+            {
+                for( uint i=0; i<3; ++i )
+                {
+                    mJacobi( i, j + 3 ) = mdFlowdR( i ) * mdRdY( j )
+                                        + mdFlowdW( i ) * mdWdY( j );
+                }
+            }
+
+            // columns of the flow variables by finite differences,
+            // these also contain the dependency of the chemistry
+            // on temperature and pressure
+            for( uint j=0; j<3; ++j )
+            {
+                mWork = mZ ;
+                real tDelta = 1e-7 * std::max( std::abs( mZ( j ) ), 1.0 );
+                mWork( j ) += tDelta ;
+
+                this->compute_rhs( aX, mWork, mF1 );
+
+                for( uint i=0; i<mDimension; ++i )
+                {
+                    mJacobi( i, j ) = ( mF1( i ) - mF0( i ) ) / tDelta ;
+                }
+            }
+
+            // restore the combustion terms of the current state
+            mdRdxR = tdRdxR ;
+            mdwdx  = tdwdx ;
+        }
+
+//------------------------------------------------------------------------------
+
+        real
+        ReactingSolver::error_norm( const Vector< real > & aError ) const
+        {
+            real aNorm = 0.0 ;
+
+            for( uint i=0; i<mDimension; ++i )
+            {
+                real tScale = mAbsoluteTolerance + mRelativeTolerance *
+                        std::max( std::abs( mZ( i ) ), std::abs( mZ1( i ) ) );
+
+                aNorm += std::pow( aError( i ) / tScale, 2 );
+            }
+
+            return std::sqrt( aNorm / mDimension );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::factorize_iteration_matrix()
+        {
+            // LU decomposition with partial pivoting, like getrf
+            for( uint k=0; k<mDimension; ++k )
+            {
+                // find the pivot
+                uint tPivot = k ;
+                real tMax = std::abs( mLU( k, k ) );
+                for( uint i=k+1; i<mDimension; ++i )
+                {
+                    if( std::abs( mLU( i, k ) ) > tMax )
+                    {
+                        tMax = std::abs( mLU( i, k ) );
+                        tPivot = i ;
+                    }
+                }
+
+                BELFEM_ERROR( tMax > 0.0, "iteration matrix is singular" );
+
+                mPivot( k ) = tPivot ;
+
+                if( tPivot != k )
+                {
+                    for( uint j=0; j<mDimension; ++j )
+                    {
+                        std::swap( mLU( k, j ), mLU( tPivot, j ) );
+                    }
+                }
+
+                // eliminate the column below the diagonal
+                const real tInvDiag = 1.0 / mLU( k, k );
+                for( uint i=k+1; i<mDimension; ++i )
+                {
+                    const real tL = mLU( i, k ) * tInvDiag ;
+                    mLU( i, k ) = tL ;
+
+                    for( uint j=k+1; j<mDimension; ++j )
+                    {
+                        mLU( i, j ) -= tL * mLU( k, j );
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        ReactingSolver::solve_iteration_matrix( Vector< real > & aX ) const
+        {
+            // apply the row interchanges, like getrs
+            for( uint k=0; k<mDimension; ++k )
+            {
+                if( ( uint ) mPivot( k ) != k )
+                {
+                    std::swap( aX( k ), aX( mPivot( k ) ) );
+                }
+            }
+
+            // forward substitution, L has a unit diagonal
+            for( uint i=1; i<mDimension; ++i )
+            {
+                real tValue = aX( i );
+                for( uint j=0; j<i; ++j )
+                {
+                    tValue -= mLU( i, j ) * aX( j );
+                }
+                aX( i ) = tValue ;
+            }
+
+            // backward substitution
+            for( uint i=mDimension; i>0; --i )
+            {
+                const uint r = i - 1 ;
+
+                real tValue = aX( r );
+                for( uint j=i; j<mDimension; ++j )
+                {
+                    tValue -= mLU( r, j ) * aX( j );
+                }
+                aX( r ) = tValue / mLU( r, r );
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
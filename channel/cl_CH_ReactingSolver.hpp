@@ -0,0 +1,254 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CH_REACTINGSOLVER_HPP
+#define BELFEM_CL_CH_REACTINGSOLVER_HPP
+
+#include "typedefs.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+#include "cl_Gas.hpp"
+
+#include "cl_CH_ChannelODE.hpp"
+#include "cl_CN_Scheme.hpp"
+#include "cl_CN_Injector.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Integrates the flow and the chemistry of a combustor
+         * as one coupled system
+         *
+         *   z = [ v, u, T, Y_0, ..., Y_n-1 ]
+         *
+         * with the two stage Rosenbrock-W method ROS2 ( Verwer et al. 1999 ).
+         * The method is L-stable and only needs the Jacobian as an
+         * approximation. The chemistry block is taken from
+         * combustion::Scheme, the columns of the flow variables
+         * are computed by finite differences.
+         *
+         * The step size is controlled by the difference between
+         * the second order solution and the embedded first order one.
+         * This replaces the operator splitting between the flow integrator
+         * and the sub-steps of Scheme::compute.
+         */
+        class ReactingSolver
+        {
+            // the flow equations in combustor mode
+            ChannelODE & mODE ;
+
+            // the chemistry
+            combustion::Scheme & mScheme ;
+
+            // the combustion gas of the scheme
+            Gas & mGas ;
+
+            // optional injector
+            combustion::Injector * mInjector ;
+
+            const uint mNumberOfSpecies ;
+            const uint mNumberOfReactingSpecies ;
+
+            // v, u, T + species
+            const uint mDimension ;
+
+            // molar masses
+            Vector< real > mM ;
+
+            // tolerances
+            real mRelativeTolerance = 1e-6 ;
+            real mAbsoluteTolerance = 1e-10 ;
+
+            // current step width
+            real mStep = 1e-6 ;
+
+            // maximum step width
+            real mMaxStep = 1e-3 ;
+
+            // minimum step width
+            real mMinStep = 1e-12 ;
+
+            // coupled state
+            Vector< real > mZ ;
+            Vector< real > mZ1 ;
+
+            // right hand sides and stages
+            Vector< real > mF0 ;
+            Vector< real > mF1 ;
+            Vector< real > mK1 ;
+            Vector< real > mK2 ;
+
+            // work vector for the finite differences
+            Vector< real > mWork ;
+
+            // mass fractions for the gas
+            Vector< real > mY ;
+
+            // flow state and derivative for ChannelODE
+            Vector< real > mFlow ;
+            Vector< real > mdFlowdX ;
+
+            // sensitivity of the flow with respect to the combustion terms
+            Vector< real > mdFlowdR ;
+            Vector< real > mdFlowdW ;
+
+            // derivatives of the combustion terms
+            // with respect to the reacting species
+            Vector< real > mdRdY ;
+            Vector< real > mdWdY ;
+
+            // Jacobian of the coupled system
+            Matrix< real > mJacobi ;
+
+            // LU factors of the iteration matrix
+            Matrix< real > mLU ;
+
+            Vector< int > mPivot ;
+
+            // combustion terms of the last evaluation
+            real mdRdxR = 0.0 ;
+            real mdwdx  = 0.0 ;
+
+            uint mNumberOfAcceptedSteps = 0 ;
+            uint mNumberOfRejectedSteps = 0 ;
+
+            // gamma = 1 + 1/sqrt(2)
+            const real mGamma = 1.0 + 0.5 * std::sqrt( 2.0 ) ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aODE       the flow equations, must be in combustor
+             *                   mode and use the gas of the scheme
+             * @param aScheme    the reaction mechanism
+             * @param aInjector  if set, the inert fuel is converted
+             *                   into reacting fuel along the mixing length
+             */
+            ReactingSolver( ChannelODE           & aODE,
+                            combustion::Scheme   & aScheme,
+                            combustion::Injector * aInjector=nullptr );
+
+//------------------------------------------------------------------------------
+
+            ~ReactingSolver() = default ;
+
+//------------------------------------------------------------------------------
+
+            void
+            set_tolerances( const real aRelativeTolerance, const real aAbsoluteTolerance );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * limits for the step width, the initial step is set
+             * with timestep()
+             */
+            void
+            set_step_limits( const real aMinStep, const real aMaxStep );
+
+//------------------------------------------------------------------------------
+
+            inline real &
+            timestep();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * performs one accepted step. The flow state aY = [ v, u, T ]
+             * and the mass fractions of the gas are updated.
+             *
+             * @param aX     position, is incremented
+             * @param aY     flow state
+             * @param aXmax  the step does not go beyond this point
+             */
+            void
+            step( real & aX, Vector< real > & aY, const real aXmax );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * integrate until aXend is reached
+             */
+            void
+            run( real & aX, Vector< real > & aY, const real aXend );
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_accepted_steps() const ;
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_rejected_steps() const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // derivative of the coupled state
+            void
+            compute_rhs( const real aX, const Vector< real > & aZ, Vector< real > & adZdX );
+
+//------------------------------------------------------------------------------
+
+            // compute the approximate Jacobian at mZ, expects mF0
+            void
+            compute_jacobi( const real aX );
+
+//------------------------------------------------------------------------------
+
+            // weighted rms norm of the error
+            real
+            error_norm( const Vector< real > & aError ) const ;
+
+//------------------------------------------------------------------------------
+
+            // LU factorization of mLU in place, the row interchanges go into mPivot
+            void
+            factorize_iteration_matrix();
+
+//------------------------------------------------------------------------------
+
+            // solve with the factors of the iteration matrix, overwrites aX
+            void
+            solve_iteration_matrix( Vector< real > & aX ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline real &
+        ReactingSolver::timestep()
+        {
+            return mStep ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        ReactingSolver::number_of_accepted_steps() const
+        {
+            return mNumberOfAcceptedSteps ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        ReactingSolver::number_of_rejected_steps() const
+        {
+            return mNumberOfRejectedSteps ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_CH_REACTINGSOLVER_HPP
@@ -40,6 +40,27 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Segment *
+        Segment::clone( Mesh & aMesh ) const
+        {
+            Segment * aClone = new Segment( mID,
+                                            this->x(),
+                                            this->cross_section(),
+                                            this->perimeter(),
+                                            mNumWalls );
+
+            aClone->mData = mData ;
+
+            for( uint k=0; k<mNumWalls; ++k )
+            {
+                aClone->add_wall( k, mWalls( k )->clone( aMesh ) );
+            }
+
+            return aClone ;
+        }
+
 //------------------------------------------------------------------------------
 
         void
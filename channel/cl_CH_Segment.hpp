@@ -46,6 +46,15 @@ namespace belfem
 
             ~Segment();
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates a segment with the same data,
+             * whose walls are linked to another mesh
+             */
+            Segment *
+            clone( Mesh & aMesh ) const ;
+
 //------------------------------------------------------------------------------
 
             void
@@ -0,0 +1,86 @@
+//
+// Created on 16.10.26.
+//
+
+#include "cl_CH_TangentODE.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+//------------------------------------------------------------------------------
+
+        TangentODE::TangentODE( ChannelODE & aChannelOde ) :
+            ODE( 30 ),
+            mChannelOde( aChannelOde )
+        {
+            mY.set_size( 3 );
+            mdYdx.set_size( 3 );
+            mdFdY.set_size( 3, 3 );
+            mdFdH.set_size( 3, 6 );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        TangentODE::compute(
+                const real           & aX,
+                const Vector< real > & aY,
+                      Vector< real > & adYdX )
+        {
+            mY( 0 ) = aY( 0 );
+            mY( 1 ) = aY( 1 );
+            mY( 2 ) = aY( 2 );
+
+            mChannelOde.compute_jacobian( aX, mY, mdYdx, mdFdY, mdFdH );
+
+            for( uint i=0; i<3; ++i )
+            {
+                adYdX( i ) = mdYdx( i );
+
+                // dS/dx = dF/dY * S + dF/dH
+                for( uint c=0; c<9; ++c )
+                {
+                    real & tdS = adYdX( 3 + 9 * i + c );
+
+                    tdS = c < 3 ? 0.0 : mdFdH( i, c - 3 );
+
+                    for( uint j=0; j<3; ++j )
+                    {
+                        tdS += mdFdY( i, j ) * aY( 3 + 9 * j + c );
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        TangentODE::initialize( const Vector< real > & aY0, Vector< real > & aY ) const
+        {
+            aY.set_size( 30, 0.0 );
+
+            for( uint i=0; i<3; ++i )
+            {
+                aY( i ) = aY0( i );
+                aY( 3 + 9 * i + i ) = 1.0 ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        TangentODE::collect_tangent( const Vector< real > & aY, Matrix< real > & aS ) const
+        {
+            for( uint i=0; i<3; ++i )
+            {
+                for( uint c=0; c<9; ++c )
+                {
+                    aS( i, c ) = aY( 3 + 9 * i + c );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,83 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CH_TANGENTODE_HPP
+#define BELFEM_CL_CH_TANGENTODE_HPP
+
+#include "typedefs.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+
+#include "cl_ODE.hpp"
+#include "cl_CH_ChannelODE.hpp"
+
+namespace belfem
+{
+    namespace channel
+    {
+        /**
+         * the state ( v, u, T ) of a ChannelODE in element mode together
+         * with its derivatives with respect to the state at the entry of
+         * the element and to tau_w and dot_q at the nodes of the element.
+         *
+         * Y contains the state, followed by the 3x9 tangent row by row.
+         * Columns of the tangent: v, u, T at the entry, then tau_w and
+         * dot_q of each node in the order of Element::collect_data.
+         *
+         * If this ODE is integrated with the same explicit scheme and
+         * the same steps as the state, the tangent is the exact
+         * derivative of the discrete solution.
+         */
+        class TangentODE : public ode::ODE
+        {
+            // the ODE of the state
+            ChannelODE & mChannelOde ;
+
+            // work data
+            Vector< real > mY ;
+            Vector< real > mdYdx ;
+            Matrix< real > mdFdY ;
+            Matrix< real > mdFdH ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            TangentODE( ChannelODE & aChannelOde );
+
+//------------------------------------------------------------------------------
+
+            virtual
+            ~TangentODE() = default ;
+
+//------------------------------------------------------------------------------
+
+            virtual void
+            compute(
+                    const real          & aX,
+                    const Vector <real> & aY,
+                    Vector <real>       & adYdX ) ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * initial value: the state aY0 and the identity for
+             * the derivatives with respect to the entry state
+             */
+            void
+            initialize( const Vector< real > & aY0, Vector< real > & aY ) const ;
+
+//------------------------------------------------------------------------------
+
+            // extract the 3x9 tangent from aY
+            void
+            collect_tangent( const Vector< real > & aY, Matrix< real > & aS ) const ;
+
+//------------------------------------------------------------------------------
+        };
+//------------------------------------------------------------------------------
+    } /* namespace channel */
+}  /* namespace belfem */
+
+#endif //BELFEM_CL_CH_TANGENTODE_HPP
@@ -39,6 +39,21 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Wall *
+        Wall::clone( Mesh & aMesh ) const
+        {
+            Vector< id_t > tNodeIDs( mNumNodes );
+
+            for ( index_t k=0; k<mNumNodes; ++k )
+            {
+                tNodeIDs( k ) = mNodes( k )->id();
+            }
+
+            return new Wall( aMesh, tNodeIDs );
+        }
+
 //------------------------------------------------------------------------------
 
         real
@@ -56,6 +56,15 @@ namespace belfem
 
             ~Wall();
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates a wall with the same nodes on another mesh,
+             * which must have the same node IDs
+             */
+            Wall *
+            clone( Mesh & aMesh ) const ;
+
 //------------------------------------------------------------------------------
 
             /**
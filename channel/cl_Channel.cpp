@@ -1,6 +1,8 @@
 //
 // Created by Christian Messe on 23.11.20.
 //
+#include <thread>
+
 #include "assert.hpp"
 #include "fn_gesv.hpp"
 #include "fn_trans.hpp"
@@ -10,7 +12,9 @@
 #include "cl_CH_Factory.hpp"
 #include "cl_CH_Boundarylayer.hpp"
 #include "cl_CH_Element.hpp"
+#include "cl_CH_TangentODE.hpp"
 #include "fn_norm.hpp"
+#include "fn_dot.hpp"
 
 namespace belfem
 {
@@ -89,7 +93,60 @@ namespace belfem
 
 
 
-        // create the elements
+        this->create_elements();
+    }
+
+//------------------------------------------------------------------------------
+
+    Channel::Channel( const Channel & aChannel, Gas & aGas, Mesh & aMesh ) :
+            mGas( aGas ),
+            mMesh1( aMesh ),
+            mGeometry( aChannel.mGeometry ),
+            mOwnsGeometry( false ),
+            mIsReacting( aChannel.mIsReacting ),
+            mNumberOfChannels( aChannel.mNumberOfChannels ),
+            mInitialMolarFractions( aChannel.mInitialMolarFractions ),
+            mTt( aChannel.mTt ),
+            mPt( aChannel.mPt ),
+            mUseBroyden( aChannel.mUseBroyden )
+    {
+        // the ODE keeps the link to the shared geometry
+        mOde = aChannel.mOde->clone( aGas );
+        mIntegrator = new ode::Integrator( *mOde, ode::Type::RK45 );
+        mIntegrator->set_auto_timestep( true );
+
+        mBoundaryLayer = aChannel.mBoundaryLayer->clone( aGas );
+
+        // copy the segments, including the data of the last run
+        mSegments.set_size( aChannel.mSegments.size(), nullptr );
+
+        for( uint k=0; k<mSegments.size(); ++k )
+        {
+            mSegments( k ) = aChannel.mSegments( k )->clone( aMesh );
+        }
+
+        this->create_elements();
+    }
+
+//------------------------------------------------------------------------------
+
+    Channel *
+    Channel::clone( Gas & aGas, Mesh & aMesh ) const
+    {
+        BELFEM_ERROR( &aGas != &mGas && &aMesh != &mMesh1,
+                     "a clone must use its own gas and mesh objects" );
+
+        BELFEM_ERROR( aGas.number_of_components() == mGas.number_of_components(),
+                      "gas of clone has a different number of components" );
+
+        return new Channel( *this, aGas, aMesh );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::create_elements()
+    {
         uint tNumChannels = ( mSegments.size() - 1 ) / 2;
 
         mElements.set_size( tNumChannels, nullptr );
@@ -106,6 +163,10 @@ namespace belfem
 
         // link last segment
         mLastSegment = mSegments( mSegments.size() - 1 );
+
+        // steps of the integrator, written by run()
+        mStepPositions.set_size( tNumChannels, {} );
+        mNumberOfCenterSteps.set_size( tNumChannels, 0 );
     }
 
 //------------------------------------------------------------------------------
@@ -128,12 +189,18 @@ namespace belfem
         }
 
         // check if geometry object exists and delete if so
-        if ( mGeometry != nullptr )
+        if ( mGeometry != nullptr && mOwnsGeometry )
         {
             delete mGeometry;
         }
 
         delete mBoundaryLayer;
+
+        // delete the workers for run_inverse
+        for( Channel * tWorker : mInverseWorkers )
+        {
+            delete tWorker ;
+        }
     }
 
 //------------------------------------------------------------------------------
@@ -330,8 +397,13 @@ namespace belfem
         mBoundaryLayer->use_input_from_parameters( true );
 
 
-        for ( channel::Element * tElement : mElements )
+        for ( uint e = 0; e < mElements.size(); ++e )
         {
+            channel::Element * tElement = mElements( e );
+
+            // positions of the integrator steps
+            Cell< real > & tSteps = mStepPositions( e );
+
             tY0 = tY;
             mOde->link_element( tElement );
 
@@ -372,15 +444,21 @@ namespace belfem
                 //mIntegrator->timestep() = 0.00001;
                 uint tCount2 = 0;
 
+                // only the steps of the last iteration are kept
+                tSteps.clear();
+
                 // first half of channel
                 while ( tX < tElement->x2() )
                 {
                     mIntegrator->step( tX, tY );
                     tP = mGas.p( tT, tV );
+                    tSteps.push( tX );
 
                     BELFEM_ERROR( tCount2++ < 10000, "Too many iterations" );
                 }
 
+                mNumberOfCenterSteps( e ) = tSteps.size();
+
                 // remember values
                 tTm = tT;
                 tPm = tP;
@@ -397,6 +475,8 @@ namespace belfem
                     mIntegrator->step( tX, tY );
 
                     tP = mGas.p( tT, tV );
+                    tSteps.push( tX );
+
                     BELFEM_ERROR( tCount2++ < 10000, "Too many iterations" );
                 }
 
@@ -497,6 +577,253 @@ namespace belfem
         this->push_heatloads();
     }
 
+//------------------------------------------------------------------------------
+
+    void
+    Channel::run_with_sensitivities( Matrix< real > & aSensitivities )
+    {
+        BELFEM_ERROR( ! mIsReacting,
+                     "sensitivities are not implemented for reacting flow" );
+
+        this->run() ;
+
+        aSensitivities.set_size( 4, 4, BELFEM_QUIET_NAN );
+
+        if( comm_rank() == 0 )
+        {
+            this->compute_sensitivities( aSensitivities );
+        }
+
+        broadcast( 0, aSensitivities );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::compute_sensitivities( Matrix< real > & aSensitivities )
+    {
+        // inflow state
+        channel::Segment * tFirst = mSegments( 0 );
+
+        real tT = tFirst->value( BELFEM_CHANNEL_TM );
+        real tP = tFirst->value( BELFEM_CHANNEL_PM );
+        real tU = tFirst->value( BELFEM_CHANNEL_UM );
+        real tC = mGas.c( tT, tP );
+        real tMa = tU / tC ;
+
+        real tV = mGas.v( tT, tP );
+
+        // the gas provides no derivatives of the speed of sound
+        real tDeltaT = 1e-6 * tT ;
+        real tDeltaP = 1e-6 * tP ;
+
+        // tangent of the state ( v, u, T ) for each parameter ( T, p, Ma, Tw )
+        Matrix< real > tdY0( 3, 4, 0.0 );
+
+        tdY0( 0, 0 ) = tV * mGas.alpha( tT, tP );
+        tdY0( 0, 1 ) = - tV * mGas.kappa( tT, tP );
+        tdY0( 1, 0 ) = tMa * ( mGas.c( tT + tDeltaT, tP ) - mGas.c( tT - tDeltaT, tP ) )
+                / ( 2.0 * tDeltaT );
+        tdY0( 1, 1 ) = tMa * ( mGas.c( tT, tP + tDeltaP ) - mGas.c( tT, tP - tDeltaP ) )
+                / ( 2.0 * tDeltaP );
+        tdY0( 1, 2 ) = tC ;
+        tdY0( 2, 0 ) = 1.0 ;
+
+        Vector< real > tY0( 3 );
+        Vector< real > tY1( 3 );
+        Vector< real > tY2( 3 );
+
+        // derivatives of the heat loads at the segments, see compute_heatload_derivatives
+        Matrix< real > tG0( 2, 4 );
+        Matrix< real > tG1( 2, 4 );
+        Matrix< real > tG2( 2, 4 );
+
+        // tangent of tau_w and dot_q for each parameter
+        Matrix< real > tdH0( 2, 4 );
+        Matrix< real > tdH1( 2, 4 );
+        Matrix< real > tdH2( 2, 4 );
+
+        this->collect_state( tFirst, tY0 );
+        this->compute_heatload_derivatives( tFirst, tY0, tG0 );
+
+        for( uint p=0; p<4; ++p )
+        {
+            for( uint k=0; k<2; ++k )
+            {
+                tdH0( k, p ) = p == 3 ? tG0( k, 3 ) : 0.0 ;
+
+                for( uint j=0; j<3; ++j )
+                {
+                    tdH0( k, p ) += tG0( k, j ) * tdY0( j, p );
+                }
+            }
+        }
+
+        Matrix< real > tS1( 3, 9 );
+        Matrix< real > tS2( 3, 9 );
+        Matrix< real > tdY1( 3, 4 );
+
+        Matrix< real > tM( 6, 6 );
+        Matrix< real > tLU( 6, 6 );
+        Vector< real > tRHS( 6 );
+        Vector< int >  tPivot( 6 );
+
+        // tangent of the heat load
+        Vector< real > tdQ( 4, 0.0 );
+
+        // the tangent is integrated with the same scheme as the state
+        channel::TangentODE tTangent( *mOde );
+        ode::Integrator tIntegrator( tTangent, ode::Type::RK45 );
+        tIntegrator.set_auto_timestep( false );
+
+        for ( uint e = 0; e < mElements.size(); ++e )
+        {
+            channel::Element * tElement = mElements( e );
+            mOde->link_element( tElement );
+
+            channel::Segment * tSegment0 = tElement->segment0() ;
+            channel::Segment * tSegment1 = tElement->segment1() ;
+            channel::Segment * tSegment2 = tElement->segment2() ;
+
+            // start from the converged state to avoid a drift
+            this->collect_state( tSegment0, tY0 );
+            this->integrate_element_tangent( e, tTangent, tIntegrator, tY0, tS2, tS1 );
+
+            this->collect_state( tSegment2, tY2 );
+            this->collect_state( tSegment1, tY1 );
+            this->compute_heatload_derivatives( tSegment2, tY2, tG2 );
+            this->compute_heatload_derivatives( tSegment1, tY1, tG1 );
+
+            // the heat loads in the center and at the exit depend on the
+            // states there, which gives a linear system for both tangents.
+            // columns of tS: state at entry, tau_w and dot_q of segment 0, 1, 2
+            for( uint i=0; i<3; ++i )
+            {
+                for( uint j=0; j<3; ++j )
+                {
+                    real tI = i == j ? 1.0 : 0.0 ;
+
+                    tM( i, j )     = tI - tS2( i, 7 ) * tG2( 0, j ) - tS2( i, 8 ) * tG2( 1, j );
+                    tM( i, j+3 )   =    - tS2( i, 5 ) * tG1( 0, j ) - tS2( i, 6 ) * tG1( 1, j );
+                    tM( i+3, j )   =    - tS1( i, 7 ) * tG2( 0, j ) - tS1( i, 8 ) * tG2( 1, j );
+                    tM( i+3, j+3 ) = tI - tS1( i, 5 ) * tG1( 0, j ) - tS1( i, 6 ) * tG1( 1, j );
+                }
+            }
+
+            for( uint p=0; p<4; ++p )
+            {
+                // only the last parameter changes the wall temperature
+                real tW = p == 3 ? 1.0 : 0.0 ;
+
+                for( uint i=0; i<3; ++i )
+                {
+                    tRHS( i ) = tS2( i, 3 ) * tdH0( 0, p ) + tS2( i, 4 ) * tdH0( 1, p )
+                            + tW * ( tS2( i, 5 ) * tG1( 0, 3 ) + tS2( i, 6 ) * tG1( 1, 3 )
+                                   + tS2( i, 7 ) * tG2( 0, 3 ) + tS2( i, 8 ) * tG2( 1, 3 ) );
+
+                    tRHS( i+3 ) = tS1( i, 3 ) * tdH0( 0, p ) + tS1( i, 4 ) * tdH0( 1, p )
+                            + tW * ( tS1( i, 5 ) * tG1( 0, 3 ) + tS1( i, 6 ) * tG1( 1, 3 )
+                                   + tS1( i, 7 ) * tG2( 0, 3 ) + tS1( i, 8 ) * tG2( 1, 3 ) );
+
+                    for( uint j=0; j<3; ++j )
+                    {
+                        tRHS( i )   += tS2( i, j ) * tdY0( j, p );
+                        tRHS( i+3 ) += tS1( i, j ) * tdY0( j, p );
+                    }
+                }
+
+                // gesv overwrites the matrix and the right hand side
+                tLU = tM ;
+                gesv( tLU, tRHS, tPivot );
+
+                for( uint k=0; k<2; ++k )
+                {
+                    tdH2( k, p ) = tW * tG2( k, 3 );
+                    tdH1( k, p ) = tW * tG1( k, 3 );
+
+                    for( uint j=0; j<3; ++j )
+                    {
+                        tdH2( k, p ) += tG2( k, j ) * tRHS( j );
+                        tdH1( k, p ) += tG1( k, j ) * tRHS( j+3 );
+                    }
+                }
+
+                for( uint i=0; i<3; ++i )
+                {
+                    tdY1( i, p ) = tRHS( i+3 );
+                }
+            }
+
+            // the heat flux is set to zero by run() if its sign switches
+            if( tSegment1->value( BELFEM_CHANNEL_DOTQ ) == 0.0 )
+            {
+                for( uint p=0; p<4; ++p )
+                {
+                    tdH1( 1, p ) = 0.0 ;
+                }
+            }
+
+            // heat load of this element, see compute_heat_load
+            real tL  = tElement->length() / 6.0 ;
+            real tPerimeter0 = 4.0 * tSegment0->value( BELFEM_CHANNEL_A ) / tSegment0->value( BELFEM_CHANNEL_DH );
+            real tPerimeter1 = 4.0 * tSegment1->value( BELFEM_CHANNEL_A ) / tSegment1->value( BELFEM_CHANNEL_DH );
+            real tPerimeter2 = 4.0 * tSegment2->value( BELFEM_CHANNEL_A ) / tSegment2->value( BELFEM_CHANNEL_DH );
+
+            for( uint p=0; p<4; ++p )
+            {
+                tdQ( p ) += tL * ( tPerimeter0 * tdH0( 1, p ) + 4.0 * tPerimeter2 * tdH2( 1, p ) + tPerimeter1 * tdH1( 1, p ) );
+            }
+
+            // the exit is the entry of the next element
+            tdY0 = tdY1 ;
+            tdH0 = tdH1 ;
+        }
+
+        // exit pressure as function of T and v
+        this->collect_state( mLastSegment, tY1 );
+
+        tP = mLastSegment->value( BELFEM_CHANNEL_PM );
+
+        real tdpdv = -1.0 / ( tY1( 0 ) * mGas.kappa( tY1( 2 ), tP ) );
+        real tdpdT = tP * mGas.beta( tY1( 2 ), tP );
+
+        for( uint p=0; p<4; ++p )
+        {
+            aSensitivities( 0, p ) = tdY0( 2, p );
+            aSensitivities( 1, p ) = tdpdv * tdY0( 0, p ) + tdpdT * tdY0( 2, p );
+            aSensitivities( 2, p ) = tdY0( 1, p );
+            aSensitivities( 3, p ) = tdQ( p );
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    real
+    Channel::compute_heat_load()
+    {
+        real aHeatLoad = 0.0 ;
+
+        for ( channel::Element * tElement : mElements )
+        {
+            channel::Segment * tSegment0 = tElement->segment0() ;
+            channel::Segment * tSegment1 = tElement->segment1() ;
+            channel::Segment * tSegment2 = tElement->segment2() ;
+
+            // wetted perimeter
+            real tPerimeter0 = 4.0 * tSegment0->value( BELFEM_CHANNEL_A ) / tSegment0->value( BELFEM_CHANNEL_DH );
+            real tPerimeter1 = 4.0 * tSegment1->value( BELFEM_CHANNEL_A ) / tSegment1->value( BELFEM_CHANNEL_DH );
+            real tPerimeter2 = 4.0 * tSegment2->value( BELFEM_CHANNEL_A ) / tSegment2->value( BELFEM_CHANNEL_DH );
+
+            // Simpson's rule
+            aHeatLoad += tElement->length() / 6.0 * (
+                      tPerimeter0 * tSegment0->value( BELFEM_CHANNEL_DOTQ )
+                    + tPerimeter2 * tSegment2->value( BELFEM_CHANNEL_DOTQ ) * 4.0
+                    + tPerimeter1 * tSegment1->value( BELFEM_CHANNEL_DOTQ ) );
+        }
+
+        return aHeatLoad ;
+    }
+
 //------------------------------------------------------------------------------
 
     void
@@ -507,43 +834,240 @@ namespace belfem
         mTt = aTt;
         mPt = aPt;
 
-        Vector< real > tA( 2 );
-        Vector< real > tB( 2 );
-        Vector< real > tC( 2 );
-        Vector< real > tD( 2 );
+        for( Channel * tWorker : mInverseWorkers )
+        {
+            tWorker->mTt = aTt ;
+            tWorker->mPt = aPt ;
+        }
+
+        // perturbed points, and the center point if it is not known
+        Matrix< real > tPoints ;
+        Matrix< real > tResults ;
+
         Vector< real > tF( 2 );
+        Vector< real > tF0( 2 );
+        Vector< real > tDeltaX( 2 );
         Matrix< real > tJ( 2, 2 );
+        Matrix< real > tLU( 2, 2 );
         Vector< int > tPivot( 2 );
 
         real tT = aTthroat;
         real tP = aPthroat;
         real tOmega = 0.9;
         real tErr = BELFEM_REAL_MAX;
+        real tErr0 = BELFEM_REAL_MAX;
 
         for ( uint k = 0; k < 10; ++k )
         {
-            real tDeltaT = 0.01 * tT;
-            real tDeltaP = 0.01 * tP;
+            // without reactions, the Jacobian is computed by run_with_sensitivities
+            bool tUpdateJacobian = mIsReacting && ( k == 0 || ! mUseBroyden );
+
+            // true if tF already contains the residual at tT, tP
+            bool tHaveCenter = false ;
+
+            if( ! mIsReacting )
+            {
+                this->compute_inverse_step( tT, tP, tF, tJ );
+                tErr = norm( tF );
+            }
+            else if( ! tUpdateJacobian )
+            {
+                // only compute the center point
+                this->compute_inverse_step( tT, tP, tF );
+                tHaveCenter = true ;
 
-            this->compute_inverse_step( tT - tDeltaT, tP, tA );
-            this->compute_inverse_step( tT + tDeltaT, tP, tB );
-            this->compute_inverse_step( tT, tP - tDeltaP, tC );
-            this->compute_inverse_step( tT, tP + tDeltaP, tD );
-            this->compute_inverse_step( tT, tP, tF );
+                tErr = norm( tF );
 
-            tErr = norm( tF );
+                if( tErr < tErr0 )
+                {
+                    // Broyden update: J += ( dF - J dx ) dx^T / ( dx^T dx )
+                    real tDX2 = dot( tDeltaX, tDeltaX );
+
+                    for( uint i=0; i<2; ++i )
+                    {
+                        real tR = tF( i ) - tF0( i )
+                                - tJ( i, 0 ) * tDeltaX( 0 )
+                                - tJ( i, 1 ) * tDeltaX( 1 );
+
+                        for( uint j=0; j<2; ++j )
+                        {
+                            tJ( i, j ) += tR * tDeltaX( j ) / tDX2 ;
+                        }
+                    }
+                }
+                else
+                {
+                    // the update did not improve the solution
+                    tUpdateJacobian = true ;
+                }
+            }
 
-            tJ( 0, 0 ) = ( tB( 0 ) - tA( 0 )) / ( 2.0 * tDeltaT );
-            tJ( 1, 0 ) = ( tD( 0 ) - tC( 0 )) / ( 2.0 * tDeltaT );
-            tJ( 0, 1 ) = ( tB( 1 ) - tA( 1 )) / ( 2.0 * tDeltaP );
-            tJ( 1, 1 ) = ( tD( 1 ) - tC( 1 )) / ( 2.0 * tDeltaP );
+            if( tUpdateJacobian )
+            {
+                real tDeltaT = 0.01 * tT;
+                real tDeltaP = 0.01 * tP;
 
-            gesv( tJ, tF, tPivot );
+                // the residual of a rejected Broyden step is reused,
+                // otherwise the center is the first column, which is
+                // computed last by this channel
+                index_t tC = tHaveCenter ? 0 : 1 ;
+
+                tPoints.set_size( 2, tC + 4 );
+
+                if( ! tHaveCenter )
+                {
+                    tPoints( 0, 0 ) = tT ;
+                    tPoints( 1, 0 ) = tP ;
+                }
+
+                tPoints( 0, tC )     = tT - tDeltaT ;
+                tPoints( 1, tC )     = tP ;
+                tPoints( 0, tC + 1 ) = tT + tDeltaT ;
+                tPoints( 1, tC + 1 ) = tP ;
+                tPoints( 0, tC + 2 ) = tT ;
+                tPoints( 1, tC + 2 ) = tP - tDeltaP ;
+                tPoints( 0, tC + 3 ) = tT ;
+                tPoints( 1, tC + 3 ) = tP + tDeltaP ;
+
+                // the perturbed runs are independent
+                this->compute_inverse_steps( tPoints, tResults );
+
+                if( ! tHaveCenter )
+                {
+                    tF( 0 ) = tResults( 0, 0 );
+                    tF( 1 ) = tResults( 1, 0 );
+
+                    tErr = norm( tF );
+                }
+
+                // J( i, j ) = dF_i / dx_j
+                tJ( 0, 0 ) = ( tResults( 0, tC + 1 ) - tResults( 0, tC ) ) / ( 2.0 * tDeltaT );
+                tJ( 1, 0 ) = ( tResults( 1, tC + 1 ) - tResults( 1, tC ) ) / ( 2.0 * tDeltaT );
+                tJ( 0, 1 ) = ( tResults( 0, tC + 3 ) - tResults( 0, tC + 2 ) ) / ( 2.0 * tDeltaP );
+                tJ( 1, 1 ) = ( tResults( 1, tC + 3 ) - tResults( 1, tC + 2 ) ) / ( 2.0 * tDeltaP );
+            }
 
-            tT -= tOmega * tF( 0 );
-            tP -= tOmega * tF( 1 );
             std::cout << k << " " << tT << " " << tP * 1e-5 << " " << tErr << std::endl;
 
+            if( tErr < 1e-6 )
+            {
+                break ;
+            }
+
+            // remember residual for Broyden update
+            tF0 = tF ;
+            tErr0 = tErr ;
+
+            // gesv overwrites the matrix and the right hand side
+            tLU = tJ ;
+            gesv( tLU, tF, tPivot );
+
+            tDeltaX( 0 ) = -tOmega * tF( 0 );
+            tDeltaX( 1 ) = -tOmega * tF( 1 );
+
+            tT += tDeltaX( 0 );
+            tP += tDeltaX( 1 );
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::set_inverse_workers( Cell< Gas * > & aGases, Cell< Mesh * > & aMeshes )
+    {
+        BELFEM_ERROR( aGases.size() == aMeshes.size(),
+                     "number of gases and meshes for the inverse workers does not match" );
+
+        for( Channel * tWorker : mInverseWorkers )
+        {
+            delete tWorker ;
+        }
+
+        mInverseWorkers.clear() ;
+
+        for( index_t k=0; k<aGases.size(); ++k )
+        {
+            // same settings as this channel
+            mInverseWorkers.push( this->clone( *aGases( k ), *aMeshes( k ) ) );
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::use_broyden_update( const bool aSwitch )
+    {
+        mUseBroyden = aSwitch ;
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::compute_inverse_steps( const Matrix< real > & aPoints, Matrix< real > & aF )
+    {
+        aF.set_size( 2, aPoints.n_cols() );
+
+        index_t tNumberOfChannels = mInverseWorkers.size() + 1 ;
+
+        std::vector< std::thread > tThreads ;
+        tThreads.reserve( mInverseWorkers.size() );
+
+        for( index_t w=0; w<mInverseWorkers.size(); ++w )
+        {
+            Channel * tWorker = mInverseWorkers( w );
+
+            // copy state of this channel
+            tWorker->mIsReacting = mIsReacting ;
+            tWorker->mMesh1.field_data( "T" ) = mMesh1.field_data( "T" );
+
+            tThreads.emplace_back( &Channel::compute_inverse_worker, tWorker,
+                                   std::cref( aPoints ), std::ref( aF ),
+                                   w + 1, tNumberOfChannels );
+        }
+
+        // this channel works on the first column
+        this->compute_inverse_worker( aPoints, aF, 0, tNumberOfChannels );
+
+        for( std::thread & tThread : tThreads )
+        {
+            tThread.join() ;
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::compute_inverse_worker(
+            const Matrix< real > & aPoints,
+                  Matrix< real > & aF,
+            const index_t aFirst,
+            const index_t aStride )
+    {
+        index_t tNumberOfPoints = aPoints.n_cols() ;
+
+        if( aFirst >= tNumberOfPoints )
+        {
+            return;
+        }
+
+        Vector< real > tF( 2 );
+
+        // last column of this worker
+        index_t j = aFirst + ( ( tNumberOfPoints - 1 - aFirst ) / aStride ) * aStride ;
+
+        // backwards, so that aFirst is computed last
+        while( true )
+        {
+            this->compute_inverse_step( aPoints( 0, j ), aPoints( 1, j ), tF );
+
+            aF( 0, j ) = tF( 0 );
+            aF( 1, j ) = tF( 1 );
+
+            if( j == aFirst )
+            {
+                break ;
+            }
+            j -= aStride ;
         }
     }
 
@@ -572,6 +1096,181 @@ namespace belfem
         aF( 1 ) = ( tPt - mPt ) / mPt;
     }
 
+//------------------------------------------------------------------------------
+
+    void
+    Channel::compute_inverse_step(
+            const real & aTthroat,
+            const real & aPthroat,
+            Vector< real > & aF,
+            Matrix< real > & aJ )
+    {
+        this->set_inflow_conditions( aTthroat, aPthroat, 0.999 );
+
+        // rows: exit T, p, u, heat load, columns: inflow T, p, Ma, Tw
+        Matrix< real > tSensitivities ;
+        this->run_with_sensitivities( tSensitivities );
+
+        // get static flow properties
+        real tT = mLastSegment->value( BELFEM_CHANNEL_TM );
+        real tP = mLastSegment->value( BELFEM_CHANNEL_PM );
+        real tU = mLastSegment->value( BELFEM_CHANNEL_UM );
+
+        real tTt;
+        real tPt;
+        mGas.total( tT, tP, tU, tTt, tPt );
+
+        // compute error
+        aF( 0 ) = ( tTt - mTt ) / mTt;
+        aF( 1 ) = ( tPt - mPt ) / mPt;
+
+        // the total state satisfies h( Tt, pt ) = h( T, p ) + u^2 / 2
+        // and s( Tt, pt ) = s( T, p ), which is linearized here
+        Matrix< real > tA( 2, 2 );
+        Matrix< real > tLU( 2, 2 );
+        Vector< real > tX( 2 );
+        Vector< int >  tPivot( 2 );
+
+        tA( 0, 0 ) = mGas.cp( tTt, tPt );
+        tA( 1, 0 ) = mGas.dsdT( tTt, tPt );
+        tA( 0, 1 ) = mGas.dhdp( tTt, tPt );
+        tA( 1, 1 ) = mGas.dsdp( tTt, tPt );
+
+        real tdhdT = mGas.cp( tT, tP );
+        real tdhdp = mGas.dhdp( tT, tP );
+        real tdsdT = mGas.dsdT( tT, tP );
+        real tdsdp = mGas.dsdp( tT, tP );
+
+        // inflow temperature and pressure
+        for( uint j=0; j<2; ++j )
+        {
+            tX( 0 ) = tdhdT * tSensitivities( 0, j ) + tdhdp * tSensitivities( 1, j )
+                    + tU * tSensitivities( 2, j );
+            tX( 1 ) = tdsdT * tSensitivities( 0, j ) + tdsdp * tSensitivities( 1, j );
+
+            // gesv overwrites the matrix and the right hand side
+            tLU = tA ;
+            gesv( tLU, tX, tPivot );
+
+            aJ( 0, j ) = tX( 0 ) / mTt ;
+            aJ( 1, j ) = tX( 1 ) / mPt ;
+        }
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::collect_state( channel::Segment * aSegment, Vector< real > & aY )
+    {
+        aY( 0 ) = mGas.v( aSegment->value( BELFEM_CHANNEL_TM ),
+                          aSegment->value( BELFEM_CHANNEL_PM ) );
+        aY( 1 ) = aSegment->value( BELFEM_CHANNEL_UM );
+        aY( 2 ) = aSegment->value( BELFEM_CHANNEL_TM );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::compute_heatload_derivatives(
+            channel::Segment     * aSegment,
+            const Vector< real > & aY,
+                  Matrix< real > & aG )
+    {
+        // work copy, so that the segment keeps the values of the run
+        Vector< real > tData( aSegment->data() );
+
+        // free variables: v, u, T, Tw
+        Vector< real > tX( 4 );
+        tX( 0 ) = aY( 0 );
+        tX( 1 ) = aY( 1 );
+        tX( 2 ) = aY( 2 );
+        tX( 3 ) = tData( BELFEM_CHANNEL_TW1 );
+
+        Vector< real > tXp( 4 );
+
+        real tTauW[ 2 ];
+        real tDotQ[ 2 ];
+
+        // the perturbed solutions must not change the boundary layer
+        channel::BoundarylayerState tState ;
+        mBoundaryLayer->store_state( tState );
+
+        mBoundaryLayer->use_input_from_parameters( true );
+
+        for( uint j=0; j<4; ++j )
+        {
+            // the boundary layer is solved iteratively, so the step
+            // must be larger than for the gas properties
+            real tDelta = 1e-4 * std::abs( tX( j ) );
+
+            for( uint k=0; k<2; ++k )
+            {
+                tXp = tX ;
+                tXp( j ) += k == 0 ? tDelta : -tDelta ;
+
+                tData( BELFEM_CHANNEL_TM )  = tXp( 2 );
+                tData( BELFEM_CHANNEL_PM )  = mGas.p( tXp( 2 ), tXp( 0 ) );
+                tData( BELFEM_CHANNEL_UM )  = tXp( 1 );
+                tData( BELFEM_CHANNEL_TW1 ) = tXp( 3 );
+
+                mBoundaryLayer->compute( tData );
+
+                tTauW[ k ] = tData( BELFEM_CHANNEL_TAUW );
+                tDotQ[ k ] = tData( BELFEM_CHANNEL_DOTQ );
+            }
+
+            aG( 0, j ) = ( tTauW[ 0 ] - tTauW[ 1 ] ) / ( 2.0 * tDelta );
+            aG( 1, j ) = ( tDotQ[ 0 ] - tDotQ[ 1 ] ) / ( 2.0 * tDelta );
+        }
+
+        mBoundaryLayer->load_state( tState );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    Channel::integrate_element_tangent(
+            const uint             aIndex,
+            channel::TangentODE  & aTangent,
+            ode::Integrator      & aIntegrator,
+            const Vector< real > & aY0,
+                  Matrix< real > & aS2,
+                  Matrix< real > & aS1 )
+    {
+        channel::Element * tElement = mElements( aIndex );
+
+        const Cell< real > & tSteps = mStepPositions( aIndex );
+        const index_t tNumberOfCenterSteps = mNumberOfCenterSteps( aIndex );
+
+        BELFEM_ERROR( tSteps.size() > tNumberOfCenterSteps,
+                     "no steps recorded for element %u, call run() first", ( unsigned int ) aIndex );
+
+        Vector< real > tY ;
+        aTangent.initialize( aY0, tY );
+
+        real tX = tElement->x0() ;
+
+        // repeat the steps of the last iteration of run()
+        aIntegrator.maxtime() = tElement->x2() ;
+
+        for( index_t k=0; k<tSteps.size(); ++k )
+        {
+            if( k == tNumberOfCenterSteps )
+            {
+                aTangent.collect_tangent( tY, aS2 );
+                aIntegrator.maxtime() = tElement->x1() ;
+            }
+
+            aIntegrator.timestep() = tSteps( k ) - tX ;
+            aIntegrator.step( tX, tY );
+
+            // avoid a drift of the positions
+            tX = tSteps( k );
+        }
+
+        aTangent.collect_tangent( tY, aS1 );
+    }
+
 //------------------------------------------------------------------------------
 
     void
@@ -21,6 +21,7 @@ namespace belfem
     namespace channel
     {
         class Element ;
+        class TangentODE ;
     }
 
     /**
@@ -44,9 +45,19 @@ namespace belfem
         // geometry object
         channel::Geometry * mGeometry = nullptr ;
 
+        // clones share the geometry of the original
+        bool mOwnsGeometry = true ;
+
         Cell< channel::Segment * > mSegments ;
         Cell< channel::Element * > mElements ;
 
+        // positions after each step of the last iteration of run(),
+        // for each element. Replayed by the tangent sweep.
+        Cell< Cell< real > > mStepPositions ;
+
+        // number of steps of each element up to its center
+        Cell< index_t > mNumberOfCenterSteps ;
+
         // Boundary layer object
         channel::Boundarylayer * mBoundaryLayer ;
 
@@ -64,6 +75,12 @@ namespace belfem
         // pointer to last segment
         channel::Segment * mLastSegment = nullptr ;
 
+        // additional channels for the perturbed runs of the inverse step
+        Cell< Channel * > mInverseWorkers ;
+
+        // flag telling if the inverse Jacobian is updated using Broyden's method
+        bool mUseBroyden = false ;
+
 //------------------------------------------------------------------------------
     public:
 //------------------------------------------------------------------------------
@@ -79,6 +96,17 @@ namespace belfem
 
         ~Channel();
 
+//------------------------------------------------------------------------------
+
+        /**
+         * creates a channel with the same settings, segment data and
+         * boundary layer that works on aGas and aMesh. The mesh must
+         * have the same node IDs as the mesh of this channel.
+         * The geometry is shared. The clone can be used on another thread.
+         */
+        Channel *
+        clone( Gas & aGas, Mesh & aMesh ) const ;
+
 //------------------------------------------------------------------------------
 
         void
@@ -115,6 +143,36 @@ namespace belfem
         void
         run_simple();
 
+//------------------------------------------------------------------------------
+
+        /**
+         * calls run() and computes the derivatives of the exit state
+         * and the heat load with respect to the inflow conditions.
+         *
+         * rows    : exit T, exit p, exit u, heat load
+         * columns : inflow T, inflow p, inflow Ma,
+         *           uniform change of the wall temperature
+         *
+         * The tangent state is integrated together with the flow,
+         * repeating the steps of the integrator in the last iteration
+         * of run(), and the heat loads of each element are linearized
+         * around the boundary layer solution, so that no perturbed
+         * runs of the whole channel are needed.
+         * The tangent is computed on the master and broadcast.
+         * Only implemented for non-reacting flow.
+         */
+        void
+        run_with_sensitivities( Matrix< real > & aSensitivities );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * integrated wall heat flux of one channel,
+         * uses the data of the last run
+         */
+        real
+        compute_heat_load();
+
 //------------------------------------------------------------------------------
 
         void
@@ -126,6 +184,46 @@ namespace belfem
         void
         compute_inverse_step( const real & aTthroat, const real & aPthroat, Vector< real > & aF );
 
+//------------------------------------------------------------------------------
+
+        /**
+         * computes the residual of the inverse step and its Jacobian
+         * with respect to the inflow temperature and pressure,
+         * using run_with_sensitivities. Only for non-reacting flow.
+         */
+        void
+        compute_inverse_step(
+                const real & aTthroat,
+                const real & aPthroat,
+                Vector< real > & aF,
+                Matrix< real > & aJ );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * Provide gas and mesh objects for the threads that compute the
+         * perturbed states of run_inverse concurrently. For each pair,
+         * this channel creates a clone with its current settings, which
+         * is owned by this channel.
+         * Each mesh must contain the same nodes and fields as the mesh
+         * of this channel. The wall temperatures and the reacting flag
+         * are copied from this channel before each run.
+         */
+        void
+        set_inverse_workers( Cell< Gas * > & aGases, Cell< Mesh * > & aMeshes );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * if set, run_inverse computes the Jacobian by finite differences
+         * only in the first iteration or if the error increases,
+         * and uses Broyden updates otherwise.
+         * Only used for reacting flow, otherwise the Jacobian
+         * is computed by run_with_sensitivities.
+         */
+        void
+        use_broyden_update( const bool aSwitch );
+
 //------------------------------------------------------------------------------
 
         void
@@ -205,6 +303,85 @@ namespace belfem
          real
          compute_total_enthalpy_change();
 
+//------------------------------------------------------------------------------
+    private:
+//------------------------------------------------------------------------------
+
+        // constructor for clone
+        Channel( const Channel & aChannel, Gas & aGas, Mesh & aMesh );
+
+//------------------------------------------------------------------------------
+
+        // create the elements from the segments
+        void
+        create_elements();
+
+//------------------------------------------------------------------------------
+
+        /**
+         * computes the inverse step for each column of aPoints ( T, p )
+         * and distributes the runs over this channel and the workers.
+         * This channel computes the first column last, so that its
+         * state corresponds to the first point afterwards.
+         */
+        void
+        compute_inverse_steps( const Matrix< real > & aPoints, Matrix< real > & aF );
+
+//------------------------------------------------------------------------------
+
+        // worker: compute the columns aFirst, aFirst + aStride, ...
+        void
+        compute_inverse_worker(
+                const Matrix< real > & aPoints,
+                      Matrix< real > & aF,
+                const index_t aFirst,
+                const index_t aStride );
+
+//------------------------------------------------------------------------------
+
+        // tangent sweep of run_with_sensitivities, only called on the master
+        void
+        compute_sensitivities( Matrix< real > & aSensitivities );
+
+//------------------------------------------------------------------------------
+
+        // state ( v, u, T ) of a segment after the last run
+        void
+        collect_state( channel::Segment * aSegment, Vector< real > & aY );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * derivatives of shear stress and heat flux of a segment
+         * with respect to the state ( v, u, T ) and the wall temperature,
+         * computed by central differences of the boundary layer.
+         * The state of the boundary layer is restored afterwards.
+         * aG: 2x4 matrix, rows tau_w, dot_q
+         */
+        void
+        compute_heatload_derivatives(
+                channel::Segment     * aSegment,
+                const Vector< real > & aY,
+                      Matrix< real > & aG );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * integrates the state and its tangent over an element with the
+         * steps of the last run. aS2 and aS1 are the derivatives of the
+         * state in the center and at the exit with respect to the state
+         * at the entry and to tau_w and dot_q of the segments in the
+         * order of Element::collect_data ( 3x9 each ).
+         */
+        void
+        integrate_element_tangent(
+                const uint             aIndex,
+                channel::TangentODE  & aTangent,
+                ode::Integrator      & aIntegrator,
+                const Vector< real > & aY0,
+                      Matrix< real > & aS2,
+                      Matrix< real > & aS1 );
+
 //------------------------------------------------------------------------------
 
     };
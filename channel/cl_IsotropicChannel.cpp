@@ -2,6 +2,8 @@
 // Created by Christian Messe on 07.12.20.
 //
 
+#include <thread>
+
 #include "cl_IsotropicChannel.hpp"
 #include "cl_CH_Factory.hpp"
 #include "fn_gesv.hpp"
@@ -29,7 +31,8 @@ namespace belfem
                                         Mesh * aMesh2 ) :
         mType( aType ),
         mGas( aGas ),
-        mMesh1( *aMesh1 )
+        mMesh1( *aMesh1 ),
+        mMethod( aMethod )
     {
         // remember the molar fractions
         mInitialMolarFractions = mGas.molar_fractions() ;
@@ -100,6 +103,11 @@ namespace belfem
             delete mBoundaryLayer ;
         }
 
+        for( channel::Boundarylayer * tBoundaryLayer : mWorkerBoundaryLayers )
+        {
+            delete tBoundaryLayer ;
+        }
+
         for( channel::Segment * tSegment : mSegments )
         {
             delete tSegment ;
@@ -266,6 +274,11 @@ namespace belfem
     IsotropicChannel::set_surface_roughness( const real & aRa )
     {
         mBoundaryLayer->set_surface_roughness( aRa );
+
+        for( channel::Boundarylayer * tBoundaryLayer : mWorkerBoundaryLayers )
+        {
+            tBoundaryLayer->set_surface_roughness( aRa );
+        }
     }
 
 //------------------------------------------------------------------------------
@@ -275,6 +288,11 @@ namespace belfem
                                const real & aNozzleCurvature )
     {
         mBoundaryLayer->set_bartz_geometry_params( aHydraulicDiameter, aNozzleCurvature );
+
+        for( channel::Boundarylayer * tBoundaryLayer : mWorkerBoundaryLayers )
+        {
+            tBoundaryLayer->set_bartz_geometry_params( aHydraulicDiameter, aNozzleCurvature );
+        }
     }
 
 //------------------------------------------------------------------------------
@@ -283,6 +301,13 @@ namespace belfem
     IsotropicChannel::set_friction_method( const channel::BoundaryLayerMethod aMethod )
     {
         mBoundaryLayer->set_friction_method( aMethod );
+
+        for( channel::Boundarylayer * tBoundaryLayer : mWorkerBoundaryLayers )
+        {
+            tBoundaryLayer->set_friction_method( aMethod );
+        }
+
+        mMethod = aMethod ;
     }
 
 //------------------------------------------------------------------------------
@@ -290,86 +315,164 @@ namespace belfem
     void
     IsotropicChannel::compute_heatloads_forward()
     {
-        uint tCount = 0 ;
+        this->compute_heatloads_parallel( false );
+    }
 
+//------------------------------------------------------------------------------
 
-        mGas.remix( mMolarFractions( 0 ), true, true );
+    void
+    IsotropicChannel::compute_heatloads_backward()
+    {
+        this->compute_heatloads_parallel( true );
+    }
+
+//------------------------------------------------------------------------------
+
+    void
+    IsotropicChannel::set_worker_gases( Cell< Gas * > & aGases )
+    {
+        for( channel::Boundarylayer * tBoundaryLayer : mWorkerBoundaryLayers )
+        {
+            delete tBoundaryLayer ;
+        }
 
-        mBoundaryLayer->set_flow_conditions(
-                mSegments( 0 )->value( BELFEM_CHANNEL_TM ),
-                mSegments( 0 )->value( BELFEM_CHANNEL_PM ),
-                mSegments( 0 )->value( BELFEM_CHANNEL_UM ) );
+        mWorkerGases.clear() ;
+        mWorkerBoundaryLayers.clear() ;
 
-        mBoundaryLayer->set_center_conditions(
-                mSegments( 0 )->value( BELFEM_CHANNEL_TM ),
-                mSegments( 0 )->value( BELFEM_CHANNEL_UM ) );
+        for( Gas * tGas : aGases )
+        {
+            BELFEM_ERROR( tGas != & mGas, "a worker can not use the main gas" );
 
-        mBoundaryLayer->set_wall_temperature( mSegments( 0 )->value( BELFEM_CHANNEL_TW1 ) );
+            BELFEM_ERROR( tGas->number_of_components() == mGas.number_of_components(),
+                          "worker gas has a different number of components" );
 
-        mBoundaryLayer->set_hydraulic_diameter( mSegments( 0 )->value( BELFEM_CHANNEL_DH ) );
+            // same settings as the main boundary layer
+            channel::Boundarylayer * tBoundaryLayer = mBoundaryLayer->clone( *tGas );
 
-        mBoundaryLayer->compute_initial_guesses() ;
+            mWorkerGases.push( tGas );
+            mWorkerBoundaryLayers.push( tBoundaryLayer );
+        }
+    }
 
-        mBoundaryLayer->use_input_from_parameters( true );
+//------------------------------------------------------------------------------
 
-        for( channel::Segment * tSegment : mSegments )
+    void
+    IsotropicChannel::compute_heatloads_parallel( const bool aReverse )
+    {
+        index_t tNumSegments = mSegments.size() ;
+
+        if( mSegmentStates.size() != tNumSegments )
         {
+            mSegmentStates.set_size( tNumSegments, channel::BoundarylayerWarmStart() );
+        }
 
-            // update data
-            mGas.remix( mMolarFractions( tCount ), true, false );
+        index_t tNumThreads = std::min( ( index_t ) mWorkerBoundaryLayers.size() + 1, tNumSegments );
 
-            // load lookup tables from memory
-            mBoundaryLayer->heat_spline()->matrix_data() = mHeatData( tCount );
-            mBoundaryLayer->viscosity_spline()->matrix_data() = mViscosityData( tCount );
-            mBoundaryLayer->conductivity_spline()->matrix_data() = mConductivityData( tCount );
+        if( tNumThreads < 2 )
+        {
+            this->compute_heatloads_range( mBoundaryLayer, & mGas, 0, tNumSegments, aReverse );
+            return;
+        }
 
-            // passing the false flag tells the boundary layer module to not
-            // recompute the lookup tables. We know that they are up to date now
-            mBoundaryLayer->compute( tSegment->data() , false );
+        index_t tChunk = tNumSegments / tNumThreads ;
 
-            ++tCount;
+        std::vector< std::thread > tThreads ;
+        tThreads.reserve( tNumThreads - 1 );
+
+        // the workers take the later chunks
+        for( index_t t=1; t<tNumThreads; ++t )
+        {
+            index_t tFirst = t * tChunk ;
+            index_t tLast  = t == tNumThreads - 1 ? tNumSegments : tFirst + tChunk ;
+
+            // the volume spline is not stored per segment
+            mWorkerBoundaryLayers( t - 1 )->copy_lookup_tables( *mBoundaryLayer );
+
+            tThreads.emplace_back( &IsotropicChannel::compute_heatloads_range, this,
+                                   mWorkerBoundaryLayers( t - 1 ),
+                                   mWorkerGases( t - 1 ),
+                                   tFirst, tLast, aReverse );
+        }
+
+        // the main boundary layer computes the first chunk
+        this->compute_heatloads_range( mBoundaryLayer, & mGas, 0, tChunk, aReverse );
+
+        for( std::thread & tThread : tThreads )
+        {
+            tThread.join() ;
         }
     }
 
 //------------------------------------------------------------------------------
 
     void
-    IsotropicChannel::compute_heatloads_backward()
+    IsotropicChannel::compute_heatloads_range(
+            channel::Boundarylayer * aBoundaryLayer,
+            Gas                    * aGas,
+            const index_t            aFirst,
+            const index_t            aLast,
+            const bool               aReverse )
     {
-        int tLast = mSegments.size() -1 ;
+        if( aFirst >= aLast )
+        {
+            return;
+        }
+
+        // index of the first segment to compute
+        index_t tStart = aReverse ? aLast - 1 : aFirst ;
+
+        channel::Segment * tFirstSegment = mSegments( tStart );
+
+        aGas->remix( mMolarFractions( tStart ), true, true );
 
-        mGas.remix( mMolarFractions( tLast ), true, true );
+        aBoundaryLayer->set_flow_conditions(
+                tFirstSegment->value( BELFEM_CHANNEL_TM ),
+                tFirstSegment->value( BELFEM_CHANNEL_PM ),
+                tFirstSegment->value( BELFEM_CHANNEL_UM ) );
 
-        mBoundaryLayer->set_flow_conditions(
-                mSegments( tLast  )->value( BELFEM_CHANNEL_TM ),
-                mSegments( tLast  )->value( BELFEM_CHANNEL_PM ),
-                mSegments( tLast  )->value( BELFEM_CHANNEL_UM ) );
+        aBoundaryLayer->set_center_conditions(
+                tFirstSegment->value( BELFEM_CHANNEL_TM ),
+                tFirstSegment->value( BELFEM_CHANNEL_UM ) );
 
-        mBoundaryLayer->set_center_conditions(
-                mSegments( tLast )->value( BELFEM_CHANNEL_TM ),
-                mSegments( tLast )->value( BELFEM_CHANNEL_UM ) );
+        aBoundaryLayer->set_wall_temperature( tFirstSegment->value( BELFEM_CHANNEL_TW1 ) );
 
-        mBoundaryLayer->set_wall_temperature( mSegments( tLast )->value( BELFEM_CHANNEL_TW1 ) );
+        aBoundaryLayer->set_hydraulic_diameter( tFirstSegment->value( BELFEM_CHANNEL_DH ) );
 
-        mBoundaryLayer->set_hydraulic_diameter( mSegments( tLast )->value( BELFEM_CHANNEL_DH ) );
+        // the neighbour of the first segment in marching direction
+        // belongs to another chunk, which runs at the same time
+        bool tNeighbourIsInOtherChunk = aReverse ?
+                aLast < mSegments.size() : aFirst > 0 ;
 
-        mBoundaryLayer->compute_initial_guesses() ;
+        if( tNeighbourIsInOtherChunk && mSegmentStates( tStart ).mIsSet )
+        {
+            aBoundaryLayer->load_warm_start( mSegmentStates( tStart ) );
+        }
+        else
+        {
+            aBoundaryLayer->compute_initial_guesses() ;
+        }
 
-        mBoundaryLayer->use_input_from_parameters( true );
+        aBoundaryLayer->use_input_from_parameters( true );
 
-        for( int k=tLast; k>=0; --k )
+        for( index_t i=aFirst; i<aLast; ++i )
         {
-            // grab segment
-            channel::Segment * tSegment = mSegments ( k );
+            // each segment is warm started from the one computed before
+            index_t k = aReverse ? aLast - 1 - ( i - aFirst ) : i ;
 
             // update data
-            mGas.remix( mMolarFractions( k ), true, false );
+            aGas->remix( mMolarFractions( k ), true, false );
 
-            mBoundaryLayer->heat_spline()->matrix_data() = mHeatData( k );
-            mBoundaryLayer->viscosity_spline()->matrix_data() = mViscosityData( k );
-            mBoundaryLayer->conductivity_spline()->matrix_data() = mConductivityData( k );
+            // load lookup tables from memory
+            aBoundaryLayer->heat_spline()->matrix_data() = mHeatData( k );
+            aBoundaryLayer->viscosity_spline()->matrix_data() = mViscosityData( k );
+            aBoundaryLayer->conductivity_spline()->matrix_data() = mConductivityData( k );
+
+            // passing the false flag tells the boundary layer module to not
+            // recompute the lookup tables. We know that they are up to date now
+            aBoundaryLayer->compute( mSegments( k )->data() , false );
 
-            mBoundaryLayer->compute( tSegment->data(), false );
+            // each segment belongs to one chunk only, so no other thread writes here
+            aBoundaryLayer->store_warm_start( mSegmentStates( k ) );
         }
     }
 
@@ -48,6 +48,17 @@ namespace belfem
         // Boundary layer object
         channel::Boundarylayer * mBoundaryLayer ;
 
+        // method for the boundary layer, needed for the workers
+        channel::BoundaryLayerMethod mMethod ;
+
+        // additional gases and boundary layers for parallel heatloads
+        Cell< Gas * > mWorkerGases ;
+        Cell< channel::Boundarylayer * > mWorkerBoundaryLayers ;
+
+        // converged solution of each segment, warm starts the
+        // chunk heads of the next parallel run
+        Cell< channel::BoundarylayerWarmStart > mSegmentStates ;
+
         Vector< real > mInitialMolarFractions ;
 
         Cell< Vector< real > > mMolarFractions ;
@@ -150,6 +161,19 @@ namespace belfem
         void
         set_reverse_order_flag( const bool aFlag );
 
+//------------------------------------------------------------------------------
+
+        /**
+         * Compute the heatloads on several threads. Each gas must be
+         * a separate object with the same components as the main gas.
+         * One boundary layer is created for each of them, and the
+         * segments are split into contiguous chunks, one per thread.
+         * Within a chunk, each segment is warm started from the
+         * finished segment before it.
+         */
+        void
+        set_worker_gases( Cell< Gas * > & aGases );
+
 //------------------------------------------------------------------------------
     private:
 //------------------------------------------------------------------------------
@@ -198,6 +222,33 @@ namespace belfem
         void
         compute_heatloads_backward();
 
+//------------------------------------------------------------------------------
+
+        /**
+         * distribute the segments over the boundary layers
+         */
+        void
+        compute_heatloads_parallel( const bool aReverse );
+
+//------------------------------------------------------------------------------
+
+        /**
+         * compute the segments [ aFirst, aLast ) with one boundary layer.
+         * If the neighbour of the first segment belongs to another chunk,
+         * it is computed at the same time and can not be used. The first
+         * segment then starts from its own converged state of the
+         * previous run. Otherwise, and in the first run, it starts from
+         * initial guesses, so the serial path does not depend on the
+         * previous run.
+         */
+        void
+        compute_heatloads_range(
+                channel::Boundarylayer * aBoundaryLayer,
+                Gas                    * aGas,
+                const index_t            aFirst,
+                const index_t            aLast,
+                const bool               aReverse );
+
 //------------------------------------------------------------------------------
 
         /*
@@ -0,0 +1,49 @@
+//
+// Created on 16.10.26.
+//
+
+#include <iostream>
+
+#include "typedefs.hpp"
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "cl_Vector.hpp"
+
+#include "cl_CH_CombustorSweep.hpp"
+
+using namespace belfem;
+using namespace channel;
+
+Communicator gComm;
+Logger       gLog( 3 );
+
+//------------------------------------------------------------------------------
+
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm.init( argc, argv );
+
+    // one combustor per core
+    CombustorSweep tSweep ;
+
+    Vector< real > tPhi = { 0.2, 0.4, 0.6, 0.8, 1.0 };
+    Vector< real > tMa3 = { 2.5, 2.77, 3.0 };
+    Vector< real > tT3  = { 1000.0, 1100.0, 1200.0 };
+    Vector< real > tP3  = { 0.43e5 };
+    Vector< real > tTw  = { 600.0 };
+
+    tSweep.add_grid( tPhi, tMa3, tT3, tP3, tTw );
+
+    std::cout << "running " << tSweep.number_of_cases() << " cases" << std::endl ;
+
+    tSweep.run() ;
+
+    // phi, Ma3, T3, p3, Tw, success, T, p, Ma, Tmax, efficiency, steps
+    tSweep.save( "sweep.hdf5" );
+
+//------------------------------------------------------------------------------
+
+    return gComm.finalize();
+}
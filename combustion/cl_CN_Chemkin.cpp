@@ -2,6 +2,14 @@
 // Created by Christian Messe on 23.09.19.
 //
 
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <functional>
+#include <unistd.h>
+
 #include "cl_CN_Chemkin.hpp"
 #include "cl_GT_GasData.hpp"
 #include "stringtools.hpp"
@@ -15,14 +23,112 @@ namespace belfem
     {
 //------------------------------------------------------------------------------
 
-        Chemkin::Chemkin( const string & aPath ) :
+        // identifies a mechanism cache file
+        const char gChemkinCacheMagic[ 9 ] = "BELFEMCK" ;
+
+        // detects if a cache was written with different byte order
+        const uint32_t gChemkinCacheEndian = 0x01020304 ;
+
+        /**
+         * header of the binary cache, followed by the species
+         * and the entries
+         */
+        struct ChemkinCacheHeader
+        {
+            char     Magic[ 8 ];
+            uint32_t Version ;
+            uint32_t Endian ;
+            uint32_t RealSize ;
+            uint32_t NumberOfSpecies ;
+            uint32_t NumberOfEntries ;
+            uint32_t NumberOfReactions ;
+            uint64_t Hash ;
+            uint64_t DataSize ;
+        };
+
+//------------------------------------------------------------------------------
+
+        // helpers for the cache data block
+
+        inline void
+        chemkin_cache_write( std::ostream & aStream, const string & aString )
+        {
+            uint32_t tLength = aString.length() ;
+            aStream.write( reinterpret_cast< const char * >( &tLength ), sizeof( uint32_t ) );
+            aStream.write( aString.c_str(), tLength );
+        }
+
+        inline void
+        chemkin_cache_write( std::ostream & aStream, const Vector< real > & aVector )
+        {
+            uint32_t tLength = aVector.length() ;
+            aStream.write( reinterpret_cast< const char * >( &tLength ), sizeof( uint32_t ) );
+            for( uint k=0; k<tLength; ++k )
+            {
+                aStream.write( reinterpret_cast< const char * >( &aVector( k ) ), sizeof( real ) );
+            }
+        }
+
+        inline bool
+        chemkin_cache_read( std::istream & aStream, string & aString )
+        {
+            uint32_t tLength ;
+            if( ! aStream.read( reinterpret_cast< char * >( &tLength ), sizeof( uint32_t ) ) )
+            {
+                return false ;
+            }
+            aString.resize( tLength );
+            return tLength == 0 || aStream.read( &aString[ 0 ], tLength );
+        }
+
+        inline bool
+        chemkin_cache_read( std::istream & aStream, Vector< real > & aVector )
+        {
+            uint32_t tLength ;
+            if( ! aStream.read( reinterpret_cast< char * >( &tLength ), sizeof( uint32_t ) ) )
+            {
+                return false ;
+            }
+
+            // an empty vector stays unallocated, like after parsing
+            if( tLength > 0 )
+            {
+                aVector.set_size( tLength );
+                for( uint k=0; k<tLength; ++k )
+                {
+                    if( ! aStream.read( reinterpret_cast< char * >( &aVector( k ) ), sizeof( real ) ) )
+                    {
+                        return false ;
+                    }
+                }
+            }
+            return true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        Chemkin::Chemkin( const string & aPath, const bool aUseCache ) :
             Ascii(aPath, FileMode::OPEN_RDONLY )
         {
-            this->find_tags();
-            this->count_entries();
-            this->read_entries();
-            this->find_duplicates();
-            this->count_active_reactions();
+            // the cache is only valid for exactly this text
+            mHash = this->compute_hash() ;
+
+            string tCachePath = Chemkin::cache_path( aPath );
+
+            if( ! ( aUseCache && this->load_cache( tCachePath ) ) )
+            {
+                this->find_tags();
+                this->count_entries();
+                this->read_entries();
+                this->find_duplicates();
+                this->count_active_reactions();
+                this->collect_species();
+
+                if( aUseCache )
+                {
+                    this->save_cache( tCachePath );
+                }
+            }
         }
 
 //------------------------------------------------------------------------------
@@ -336,6 +442,15 @@ namespace belfem
         void
         Chemkin::get_species( Cell< string > & aSpecies )
         {
+            aSpecies = mSpecies ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Chemkin::collect_species()
+        {
+            Cell< string > & aSpecies = mSpecies ;
             aSpecies.clear();
 
             Cell< string > tEductLabels;
@@ -372,6 +487,243 @@ namespace belfem
             unique( aSpecies );
         }
 
+//------------------------------------------------------------------------------
+
+        string
+        Chemkin::cache_path( const string & aPath )
+        {
+            // replace the file ending, if there is one
+            std::size_t tDot   = aPath.find_last_of( '.' );
+            std::size_t tSlash = aPath.find_last_of( '/' );
+
+            if( tDot != string::npos && ( tSlash == string::npos || tDot > tSlash ) )
+            {
+                return aPath.substr( 0, tDot ) + ".ckb" ;
+            }
+            else
+            {
+                return aPath + ".ckb" ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        uint64_t
+        Chemkin::compute_hash() const
+        {
+            uint64_t aHash = 14695981039346656037ULL ;
+
+            for( const string & tLine : mBuffer )
+            {
+                for( const char & tChar : tLine )
+                {
+                    aHash ^= static_cast< unsigned char >( tChar );
+                    aHash *= 1099511628211ULL ;
+                }
+
+                // end of line
+                aHash ^= static_cast< unsigned char >( '\n' );
+                aHash *= 1099511628211ULL ;
+            }
+
+            return aHash ;
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        Chemkin::load_cache( const string & aCachePath )
+        {
+            std::ifstream tFile( aCachePath, std::ios::binary );
+
+            if( ! tFile.good() )
+            {
+                return false ;
+            }
+
+            ChemkinCacheHeader tHeader ;
+
+            if( ! tFile.read( reinterpret_cast< char * >( &tHeader ), sizeof( ChemkinCacheHeader ) ) )
+            {
+                return false ;
+            }
+
+            // an outdated cache is not an error, it is simply replaced
+            if(    std::strncmp( tHeader.Magic, gChemkinCacheMagic, 8 ) != 0
+                || tHeader.Version  != BELFEM_CHEMKIN_CACHE_VERSION
+                || tHeader.Endian   != gChemkinCacheEndian
+                || tHeader.RealSize != sizeof( real )
+                || tHeader.Hash     != mHash )
+            {
+                return false ;
+            }
+
+            // the data block must fill the rest of the file
+            std::streampos tStart = tFile.tellg() ;
+            tFile.seekg( 0, std::ios::end );
+            std::streampos tEnd = tFile.tellg() ;
+            tFile.seekg( tStart );
+
+            if( tStart < 0 || tEnd < tStart
+                || ( uint64_t ) ( tEnd - tStart ) != tHeader.DataSize )
+            {
+                return false ;
+            }
+
+            // each species and each entry needs at least four bytes,
+            // this protects against huge allocations from a broken header
+            if( 4 * ( ( uint64_t ) tHeader.NumberOfSpecies
+                    + ( uint64_t ) tHeader.NumberOfEntries ) > tHeader.DataSize )
+            {
+                return false ;
+            }
+
+            // species
+            Cell< string > tSpecies( tHeader.NumberOfSpecies, "" );
+            for( string & tLabel : tSpecies )
+            {
+                if( ! chemkin_cache_read( tFile, tLabel ) )
+                {
+                    return false ;
+                }
+            }
+
+            // entries
+            Cell< Entry * > tEntries( tHeader.NumberOfEntries, nullptr );
+
+            bool tOK = true ;
+
+            for( uint k=0; k<tHeader.NumberOfEntries; ++k )
+            {
+                Entry * tEntry = new Entry();
+                tEntries( k ) = tEntry ;
+
+                uint32_t tNumThirdBody = 0 ;
+                char tFlags[ 2 ];
+
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mReaction );
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mCoeffs );
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mDuplicate );
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mLow );
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mTroe );
+                tOK = tOK && chemkin_cache_read( tFile, tEntry->mThirdBodyWeights );
+                tOK = tOK && tFile.read( reinterpret_cast< char * >( &tNumThirdBody ), sizeof( uint32_t ) );
+
+                if( tOK && tNumThirdBody > 0 )
+                {
+                    tEntry->mThirdBodySpecies.set_size( tNumThirdBody, "" );
+                    for( string & tLabel : tEntry->mThirdBodySpecies )
+                    {
+                        tOK = tOK && chemkin_cache_read( tFile, tLabel );
+                    }
+                }
+
+                tOK = tOK && tFile.read( tFlags, 2 );
+
+                if( ! tOK )
+                {
+                    break ;
+                }
+
+                tEntry->mDuplicateFlag = tFlags[ 0 ] != 0 ;
+                tEntry->mActiveFlag    = tFlags[ 1 ] != 0 ;
+            }
+
+            if( ! tOK )
+            {
+                // truncated file
+                for( Entry * tEntry : tEntries )
+                {
+                    if( tEntry != nullptr )
+                    {
+                        delete tEntry ;
+                    }
+                }
+                return false ;
+            }
+
+            mSpecies = tSpecies ;
+            mEntries = tEntries ;
+            mNumberOfEntries   = tHeader.NumberOfEntries ;
+            mNumberOfReactions = tHeader.NumberOfReactions ;
+
+            return true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Chemkin::save_cache( const string & aCachePath ) const
+        {
+            // assemble the data block
+            std::ostringstream tData ;
+
+            for( const string & tLabel : mSpecies )
+            {
+                chemkin_cache_write( tData, tLabel );
+            }
+
+            for( const Entry * tEntry : mEntries )
+            {
+                chemkin_cache_write( tData, tEntry->mReaction );
+                chemkin_cache_write( tData, tEntry->mCoeffs );
+                chemkin_cache_write( tData, tEntry->mDuplicate );
+                chemkin_cache_write( tData, tEntry->mLow );
+                chemkin_cache_write( tData, tEntry->mTroe );
+                chemkin_cache_write( tData, tEntry->mThirdBodyWeights );
+
+                uint32_t tNumThirdBody = tEntry->mThirdBodySpecies.size() ;
+                tData.write( reinterpret_cast< const char * >( &tNumThirdBody ), sizeof( uint32_t ) );
+                for( const string & tLabel : tEntry->mThirdBodySpecies )
+                {
+                    chemkin_cache_write( tData, tLabel );
+                }
+
+                char tFlags[ 2 ] = { tEntry->mDuplicateFlag ? ( char ) 1 : ( char ) 0,
+                                     tEntry->mActiveFlag    ? ( char ) 1 : ( char ) 0 };
+                tData.write( tFlags, 2 );
+            }
+
+            string tBlock = tData.str() ;
+
+            ChemkinCacheHeader tHeader ;
+            std::memset( &tHeader, 0, sizeof( ChemkinCacheHeader ) );
+            std::memcpy( tHeader.Magic, gChemkinCacheMagic, 8 );
+
+            tHeader.Version  = BELFEM_CHEMKIN_CACHE_VERSION ;
+            tHeader.Endian   = gChemkinCacheEndian ;
+            tHeader.RealSize = sizeof( real );
+            tHeader.NumberOfSpecies   = mSpecies.size() ;
+            tHeader.NumberOfEntries   = mNumberOfEntries ;
+            tHeader.NumberOfReactions = mNumberOfReactions ;
+            tHeader.Hash     = mHash ;
+            tHeader.DataSize = tBlock.length() ;
+
+            // write into a temporary file first, so that no other
+            // process reads a half written cache. The name contains
+            // the process and the thread, since several threads of
+            // one process may create the same mechanism
+            string tTempPath = aCachePath + ".tmp" + std::to_string( getpid() )
+                    + "_" + std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() ) );
+
+            std::ofstream tFile( tTempPath, std::ios::binary | std::ios::trunc );
+
+            // the cache is optional, so a failure is not an error
+            if( ! tFile.good() )
+            {
+                return ;
+            }
+
+            tFile.write( reinterpret_cast< const char * >( &tHeader ), sizeof( ChemkinCacheHeader ) );
+            tFile.write( tBlock.c_str(), tBlock.length() );
+            tFile.close() ;
+
+            if( ! tFile.good() || std::rename( tTempPath.c_str(), aCachePath.c_str() ) != 0 )
+            {
+                std::remove( tTempPath.c_str() );
+            }
+        }
+
 //------------------------------------------------------------------------------
     }
 }
\ No newline at end of file
@@ -5,17 +5,32 @@
 #ifndef BELFEM_CL_CN_CHEMKIN_HPP
 #define BELFEM_CL_CN_CHEMKIN_HPP
 
+#include <cstdint>
+
 #include "typedefs.hpp"
 #include "cl_Map.hpp"
 #include "cl_Ascii.hpp"
 #include "cl_Vector.hpp"
 #include "cl_CN_Entry.hpp"
 
+// version of the binary mechanism cache, increase if the layout changes
+#define BELFEM_CHEMKIN_CACHE_VERSION 1
+
 namespace belfem
 {
     namespace combustion
     {
-        // http://akrmys.com/public/chemkin/CKm_inp.html.en
+        /**
+         * http://akrmys.com/public/chemkin/CKm_inp.html.en
+         *
+         * The parsed entries and the species list are saved into a
+         * binary cache next to the input file, which has the ending .ckb.
+         * The cache contains a hash of the text of the input file. If the
+         * hash or the version do not match, the input is parsed again and
+         * the cache is overwritten. If the cache can not be written, for
+         * example because the directory is read only, the parsed data is
+         * used without a cache.
+         */
         class Chemkin : public Ascii
         {
             uint mStartTag;
@@ -29,12 +44,22 @@ namespace belfem
 
             Cell< Entry * >  mEntries;
 
+            // species that exist in the reactions
+            Cell< string > mSpecies ;
+
+            // hash of the input text
+            uint64_t mHash = 0 ;
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
 
 
-            Chemkin( const string & aPath );
+            /**
+             * @param aPath      path to the input file
+             * @param aUseCache  read and write the binary cache
+             */
+            Chemkin( const string & aPath, const bool aUseCache=true );
 
 //------------------------------------------------------------------------------
 
@@ -73,6 +98,14 @@ namespace belfem
             inline Entry *
             entry( const uint & aIndex );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * path of the binary cache that belongs to an input file
+             */
+            static string
+            cache_path( const string & aPath );
+
 //------------------------------------------------------------------------------
         private:
 //------------------------------------------------------------------------------
@@ -100,6 +133,28 @@ namespace belfem
             void
             count_active_reactions();
 
+//------------------------------------------------------------------------------
+
+            void
+            collect_species();
+
+//------------------------------------------------------------------------------
+
+            // FNV-1a hash of the lines of the input file
+            uint64_t
+            compute_hash() const ;
+
+//------------------------------------------------------------------------------
+
+            // returns false if the cache does not exist or is outdated
+            bool
+            load_cache( const string & aCachePath );
+
+//------------------------------------------------------------------------------
+
+            void
+            save_cache( const string & aCachePath ) const ;
+
 //------------------------------------------------------------------------------
         };
 
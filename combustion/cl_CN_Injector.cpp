@@ -253,6 +253,22 @@ namespace belfem
             mGas.remix_mass( mY, false );
         }
 
+//------------------------------------------------------------------------------
+
+        real
+        Injector::mixing_rate( const real & aX ) const
+        {
+            if( aX < mXinj )
+            {
+                return 0.0 ;
+            }
+
+            real tMu = mFuelMassflow /
+                       ( mOxidizerMassflow + mFuelMassflow ) ;
+
+            return tMu * this->dmix( aX );
+        }
+
 //------------------------------------------------------------------------------
 
     }
@@ -138,6 +138,13 @@ namespace belfem
             void
             inject( const real & aX );
 
+//------------------------------------------------------------------------------
+
+            // change of the reacting fuel mass fraction per length
+            // due to mixing, the inert fuel changes by the negative value
+            real
+            mixing_rate( const real & aX ) const ;
+
 //------------------------------------------------------------------------------
         private:
 //------------------------------------------------------------------------------
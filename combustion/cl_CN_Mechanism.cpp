@@ -0,0 +1,1161 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+#include <immintrin.h>
+#endif
+
+#include "cl_CN_Mechanism.hpp"
+#include "cl_CN_Reaction.hpp"
+#include "assert.hpp"
+#include "constants.hpp"
+#include "GT_globals.hpp"
+
+namespace belfem
+{
+    namespace combustion
+    {
+//------------------------------------------------------------------------------
+
+        // c^nu with a fast path for small integer exponents
+        inline real
+        mechanism_power( const real aC, const real aNu, const uint aPower )
+        {
+            switch( aPower )
+            {
+                case( 1 ) :
+                {
+                    return aC ;
+                }
+                case( 2 ) :
+                {
+                    return aC * aC ;
+                }
+                case( 3 ) :
+                {
+                    return aC * aC * aC ;
+                }
+                default :
+                {
+                    return std::pow( aC, aNu );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        // exponent if nu is a small integer, otherwise 0
+        inline uint
+        mechanism_integer_power( const real aNu )
+        {
+            if( aNu == 1.0 )
+            {
+                return 1 ;
+            }
+            else if( aNu == 2.0 )
+            {
+                return 2 ;
+            }
+            else if( aNu == 3.0 )
+            {
+                return 3 ;
+            }
+            else
+            {
+                return 0 ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+#if defined( __AVX2__ ) && defined( __FMA__ )
+
+        // exp of four values, exp( x ) = 2^n * exp( r ) with |r| <= ln( 2 ) / 2.
+        // Arguments below -708 return zero, arguments above 709 infinity.
+        inline __m256d
+        mechanism_exp( const __m256d aX )
+        {
+            const __m256d tMin = _mm256_set1_pd( -708.0 );
+            const __m256d tMax = _mm256_set1_pd(  709.0 );
+
+            // min and max return the second argument for nan
+            const __m256d tX = _mm256_max_pd( tMin, _mm256_min_pd( tMax, aX ) );
+
+            const __m256d tN = _mm256_round_pd(
+                    _mm256_mul_pd( tX, _mm256_set1_pd( 1.4426950408889634074 ) ),
+                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+
+            // ln( 2 ), split into an exact and a small part, see Cephes
+            __m256d tR = _mm256_fnmadd_pd( tN, _mm256_set1_pd( 6.93145751953125e-1 ), tX );
+            tR = _mm256_fnmadd_pd( tN, _mm256_set1_pd( 1.42860682030941723212e-6 ), tR );
+
+            // Taylor series, the remainder is below 1e-17
+            __m256d tP = _mm256_set1_pd( 1.0 / 6227020800.0 );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 479001600.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 39916800.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 3628800.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 362880.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 40320.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 5040.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 720.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 120.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 24.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 / 6.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 0.5 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 ) );
+            tP = _mm256_fmadd_pd( tP, tR, _mm256_set1_pd( 1.0 ) );
+
+            // 2^n, written directly into the exponent bits
+            const __m256i tE = _mm256_slli_epi64(
+                    _mm256_add_epi64( _mm256_cvtepi32_epi64( _mm256_cvtpd_epi32( tN ) ),
+                                      _mm256_set1_epi64x( 1023 ) ), 52 );
+
+            __m256d aExp = _mm256_mul_pd( tP, _mm256_castsi256_pd( tE ) );
+
+            aExp = _mm256_blendv_pd( aExp, _mm256_setzero_pd(),
+                                     _mm256_cmp_pd( aX, tMin, _CMP_LT_OQ ) );
+
+            return _mm256_blendv_pd( aExp, _mm256_set1_pd( std::numeric_limits< double >::infinity() ),
+                                     _mm256_cmp_pd( aX, tMax, _CMP_GT_OQ ) );
+        }
+
+#endif
+//------------------------------------------------------------------------------
+
+        Mechanism::Mechanism(
+                const Cell< Reaction * > & aReactions,
+                const uint aNumberOfReactingSpecies,
+                const uint aNumberOfSpecies ) :
+            mNumberOfReactingSpecies( aNumberOfReactingSpecies ),
+            mNumberOfSpecies( aNumberOfSpecies )
+        {
+            this->count_entries( aReactions );
+
+            for( Reaction * tReaction : aReactions )
+            {
+                this->add_stoichiometry( *tReaction );
+
+                // the reaction tells which kind of forward rate it has
+                tReaction->compile( *this );
+            }
+
+            this->finalize();
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::add_arrhenius( const Vector< real > & aCoeffs )
+        {
+            RateRecord tRecord ;
+            tRecord.mType     = RateType::Arrhenius ;
+            tRecord.mReaction = mNumberOfReactions - 1 ;
+            tRecord.mRate     = this->add_rate( aCoeffs );
+
+            mRecords.push( tRecord );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::add_duplicate(
+                const Vector< real > & aCoeffs1,
+                const Vector< real > & aCoeffs2 )
+        {
+            RateRecord tRecord ;
+            tRecord.mType     = RateType::Duplicate ;
+            tRecord.mReaction = mNumberOfReactions - 1 ;
+            tRecord.mRate     = this->add_rate( aCoeffs1 );
+            this->add_rate( aCoeffs2 );
+
+            mRecords.push( tRecord );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::add_lindemann(
+                const Vector< real > & aCoeffsLow,
+                const Vector< real > & aCoeffsHigh )
+        {
+            RateRecord tRecord ;
+            tRecord.mType     = RateType::Lindemann ;
+            tRecord.mReaction = mNumberOfReactions - 1 ;
+            tRecord.mRate     = this->add_rate( aCoeffsLow );
+            this->add_rate( aCoeffsHigh );
+
+            mRecords.push( tRecord );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::add_troe(
+                const Vector< real > & aCoeffsLow,
+                const Vector< real > & aCoeffsHigh,
+                const real aA,
+                const real aTau1,
+                const real aTau2,
+                const real aTau3,
+                const bool aHasT2 )
+        {
+            RateRecord tRecord ;
+            tRecord.mType     = RateType::Troe ;
+            tRecord.mReaction = mNumberOfReactions - 1 ;
+            tRecord.mRate     = this->add_rate( aCoeffsLow );
+            this->add_rate( aCoeffsHigh );
+
+            tRecord.mTroe[ 0 ] = aA ;
+            tRecord.mTroe[ 1 ] = aTau1 ;
+
+            // tau2 is nan if the fourth parameter is not given
+            tRecord.mTroe[ 2 ] = aHasT2 ? aTau2 : 0.0 ;
+            tRecord.mTroe[ 3 ] = aTau3 ;
+            tRecord.mTroeHasT2 = aHasT2 ;
+
+            mRecords.push( tRecord );
+        }
+
+//------------------------------------------------------------------------------
+
+        uint
+        Mechanism::add_rate( const Vector< real > & aCoeffs )
+        {
+            uint aIndex = mRateBuffer.size() / 3 ;
+
+            mRateBuffer.push( aCoeffs( 0 ) );
+            mRateBuffer.push( aCoeffs( 1 ) );
+            mRateBuffer.push( aCoeffs( 2 ) );
+
+            return aIndex ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::count_entries( const Cell< Reaction * > & aReactions )
+        {
+            uint tNumReactions = aReactions.size() ;
+
+            uint tNumEducts = 0 ;
+            uint tNumProducts = 0 ;
+            uint tNumSources = 0 ;
+            uint tNumRows = 0 ;
+            uint tNumColumns = 0 ;
+            uint tNumThirdBody = 0 ;
+
+            for( const Reaction * tReaction : aReactions )
+            {
+                tNumEducts    += tReaction->mN1 ;
+                tNumProducts  += tReaction->mN2 ;
+                tNumSources   += tReaction->mSourceIndices.length() ;
+                tNumRows      += tReaction->mSparseRows.length() ;
+                tNumColumns   += tReaction->mSparseColumns.length() ;
+                tNumThirdBody += tReaction->mThirdBodyIndices.length() ;
+            }
+
+            mEductPointers.set_size( tNumReactions + 1, 0 );
+            mEductSpecies.set_size( tNumEducts );
+            mEductNu.set_size( tNumEducts );
+            mEductPower.set_size( tNumEducts );
+            mEductSlot.set_size( tNumEducts );
+
+            mProductPointers.set_size( tNumReactions + 1, 0 );
+            mProductSpecies.set_size( tNumProducts );
+            mProductNu.set_size( tNumProducts );
+            mProductPower.set_size( tNumProducts );
+            mProductSlot.set_size( tNumProducts );
+
+            mSourcePointers.set_size( tNumReactions + 1, 0 );
+            mSourceSpecies.set_size( tNumSources );
+            mSourceNu.set_size( tNumSources );
+
+            mRowPointers.set_size( tNumReactions + 1, 0 );
+            mRows.set_size( tNumRows );
+            mRowNu.set_size( tNumRows );
+
+            mColumnPointers.set_size( tNumReactions + 1, 0 );
+            mColumns.set_size( tNumColumns );
+
+            mHasThirdBody.set_size( tNumReactions, 0 );
+            mThirdBodyPointers.set_size( tNumReactions + 1, 0 );
+            mThirdBodySpecies.set_size( tNumThirdBody );
+            mThirdBodyWeights.set_size( tNumThirdBody );
+
+            mPhi1.set_size( tNumReactions );
+            mPhi2.set_size( tNumReactions );
+            mSumNu.set_size( tNumReactions );
+
+            // work containers, the products are computed in blocks of four
+            const uint tNumPadded = 4 * ( ( tNumReactions + 3 ) / 4 );
+
+            mCm.set_size( tNumPadded, 0.0 );
+            mdCmdT.set_size( tNumReactions, 0.0 );
+            mPsi1.set_size( tNumPadded, 0.0 );
+            mPsi2.set_size( tNumPadded, 0.0 );
+            mDeltaG.set_size( tNumReactions, 0.0 );
+            mdDeltaGdT.set_size( tNumReactions, 0.0 );
+            mk1.set_size( tNumReactions, 0.0 );
+            mdk1dT.set_size( tNumReactions, 0.0 );
+            mk2.set_size( tNumReactions, 0.0 );
+            mdk2dT.set_size( tNumReactions, 0.0 );
+            mW.set_size( tNumReactions, 0.0 );
+            mdWdT.set_size( tNumReactions, 0.0 );
+            mdWdY.set_size( tNumColumns, 0.0 );
+            mdPsi1dY.set_size( tNumEducts, 0.0 );
+            mdPsi2dY.set_size( tNumProducts, 0.0 );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::add_stoichiometry( const Reaction & aReaction )
+        {
+            uint r = mNumberOfReactions++ ;
+
+            // columns
+            uint tCount = mColumnPointers( r );
+            for( uint k=0; k<aReaction.mSparseColumns.length(); ++k )
+            {
+                mColumns( tCount++ ) = aReaction.mSparseColumns( k );
+            }
+            mColumnPointers( r + 1 ) = tCount ;
+
+            // educts
+            tCount = mEductPointers( r );
+            for( uint k=0; k<aReaction.mN1; ++k )
+            {
+                const uint tSpecies = aReaction.mEductIndices( k );
+
+                mEductSpecies( tCount ) = tSpecies ;
+                mEductNu( tCount ) = aReaction.mEductNu( k );
+                mEductPower( tCount ) = mechanism_integer_power( aReaction.mEductNu( k ) );
+                mEductSlot( tCount ) = BELFEM_UINT_MAX ;
+
+                for( uint c=mColumnPointers( r ); c<mColumnPointers( r + 1 ); ++c )
+                {
+                    if( mColumns( c ) == tSpecies )
+                    {
+                        mEductSlot( tCount ) = c ;
+                        break ;
+                    }
+                }
+
+                BELFEM_ERROR( mEductSlot( tCount ) < BELFEM_UINT_MAX,
+                              "educt %u of reaction %u is not a reacting species", tSpecies, r );
+                ++tCount ;
+            }
+            mEductPointers( r + 1 ) = tCount ;
+
+            // products
+            tCount = mProductPointers( r );
+            for( uint k=0; k<aReaction.mN2; ++k )
+            {
+                const uint tSpecies = aReaction.mProductIndices( k );
+
+                mProductSpecies( tCount ) = tSpecies ;
+                mProductNu( tCount ) = aReaction.mProductNu( k );
+                mProductPower( tCount ) = mechanism_integer_power( aReaction.mProductNu( k ) );
+                mProductSlot( tCount ) = BELFEM_UINT_MAX ;
+
+                for( uint c=mColumnPointers( r ); c<mColumnPointers( r + 1 ); ++c )
+                {
+                    if( mColumns( c ) == tSpecies )
+                    {
+                        mProductSlot( tCount ) = c ;
+                        break ;
+                    }
+                }
+
+                BELFEM_ERROR( mProductSlot( tCount ) < BELFEM_UINT_MAX,
+                              "product %u of reaction %u is not a reacting species", tSpecies, r );
+                ++tCount ;
+            }
+            mProductPointers( r + 1 ) = tCount ;
+
+            // sources
+            tCount = mSourcePointers( r );
+            for( uint k=0; k<aReaction.mSourceIndices.length(); ++k )
+            {
+                mSourceSpecies( tCount ) = aReaction.mSourceIndices( k );
+                mSourceNu( tCount ) = aReaction.mDeltaNu( aReaction.mSourceIndices( k ) );
+                ++tCount ;
+            }
+            mSourcePointers( r + 1 ) = tCount ;
+
+            // rows of the Jacobian
+            tCount = mRowPointers( r );
+            for( uint k=0; k<aReaction.mSparseRows.length(); ++k )
+            {
+                mRows( tCount ) = aReaction.mSparseRows( k );
+                mRowNu( tCount ) = aReaction.mDeltaNu( aReaction.mSparseRows( k ) );
+                ++tCount ;
+            }
+            mRowPointers( r + 1 ) = tCount ;
+
+            // third body
+            mHasThirdBody( r ) = aReaction.mHaveThirdBody ? 1 : 0 ;
+
+            tCount = mThirdBodyPointers( r );
+            for( uint k=0; k<aReaction.mThirdBodyIndices.length(); ++k )
+            {
+                mThirdBodySpecies( tCount ) = aReaction.mThirdBodyIndices( k );
+                mThirdBodyWeights( tCount ) = aReaction.mThirdBodyWeights( k );
+                ++tCount ;
+            }
+            mThirdBodyPointers( r + 1 ) = tCount ;
+
+            mPhi1( r ) = aReaction.mPhi1 ;
+            mPhi2( r ) = aReaction.mPhi2 ;
+            mSumNu( r ) = aReaction.mSumNu ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::finalize()
+        {
+            BELFEM_ERROR( mRecords.size() == mNumberOfReactions,
+                          "number of compiled rates ( %u ) does not match number of reactions ( %u )",
+                          ( uint ) mRecords.size(), mNumberOfReactions );
+
+            // Arrhenius expressions
+            uint tNumRates = mRateBuffer.size() / 3 ;
+
+            mRateA.set_size( tNumRates );
+            mRateB.set_size( tNumRates );
+            mRateTa.set_size( tNumRates );
+
+            for( uint e=0; e<tNumRates; ++e )
+            {
+                mRateA( e )  = mRateBuffer( 3 * e );
+                mRateB( e )  = mRateBuffer( 3 * e + 1 );
+
+                // activation temperature
+                mRateTa( e ) = mRateBuffer( 3 * e + 2 ) / constant::Rm_cal ;
+            }
+
+            mK.set_size( tNumRates, 0.0 );
+            mdKdT.set_size( tNumRates, 0.0 );
+
+            // count reactions per type
+            uint tNumArrhenius = 0 ;
+            uint tNumDuplicate = 0 ;
+            uint tNumLindemann = 0 ;
+            uint tNumTroe = 0 ;
+
+            for( const RateRecord & tRecord : mRecords )
+            {
+                switch( tRecord.mType )
+                {
+                    case( RateType::Arrhenius ) :
+                    {
+                        ++tNumArrhenius ;
+                        break ;
+                    }
+                    case( RateType::Duplicate ) :
+                    {
+                        ++tNumDuplicate ;
+                        break ;
+                    }
+                    case( RateType::Lindemann ) :
+                    {
+                        ++tNumLindemann ;
+                        break ;
+                    }
+                    case( RateType::Troe ) :
+                    {
+                        ++tNumTroe ;
+                        break ;
+                    }
+                }
+            }
+
+            mArrheniusReactions.set_size( tNumArrhenius );
+            mArrheniusRates.set_size( tNumArrhenius );
+            mDuplicateReactions.set_size( tNumDuplicate );
+            mDuplicateRates.set_size( tNumDuplicate );
+            mLindemannReactions.set_size( tNumLindemann );
+            mLindemannRates.set_size( tNumLindemann );
+            mTroeReactions.set_size( tNumTroe );
+            mTroeRates.set_size( tNumTroe );
+            mTroeA.set_size( tNumTroe );
+            mTroeTau1.set_size( tNumTroe );
+            mTroeTau2.set_size( tNumTroe );
+            mTroeTau3.set_size( tNumTroe );
+            mTroeT2.set_size( tNumTroe );
+
+            tNumArrhenius = 0 ;
+            tNumDuplicate = 0 ;
+            tNumLindemann = 0 ;
+            tNumTroe = 0 ;
+
+            for( const RateRecord & tRecord : mRecords )
+            {
+                switch( tRecord.mType )
+                {
+                    case( RateType::Arrhenius ) :
+                    {
+                        mArrheniusReactions( tNumArrhenius ) = tRecord.mReaction ;
+                        mArrheniusRates( tNumArrhenius++ ) = tRecord.mRate ;
+                        break ;
+                    }
+                    case( RateType::Duplicate ) :
+                    {
+                        mDuplicateReactions( tNumDuplicate ) = tRecord.mReaction ;
+                        mDuplicateRates( tNumDuplicate++ ) = tRecord.mRate ;
+                        break ;
+                    }
+                    case( RateType::Lindemann ) :
+                    {
+                        mLindemannReactions( tNumLindemann ) = tRecord.mReaction ;
+                        mLindemannRates( tNumLindemann++ ) = tRecord.mRate ;
+                        break ;
+                    }
+                    case( RateType::Troe ) :
+                    {
+                        mTroeReactions( tNumTroe ) = tRecord.mReaction ;
+                        mTroeRates( tNumTroe ) = tRecord.mRate ;
+                        mTroeA( tNumTroe ) = tRecord.mTroe[ 0 ];
+                        mTroeTau1( tNumTroe ) = tRecord.mTroe[ 1 ];
+                        mTroeTau2( tNumTroe ) = tRecord.mTroe[ 2 ];
+                        mTroeTau3( tNumTroe ) = tRecord.mTroe[ 3 ];
+                        mTroeT2( tNumTroe++ ) = tRecord.mTroeHasT2 ? 1.0 : 0.0 ;
+                        break ;
+                    }
+                }
+            }
+
+            // the buffers are not needed anymore
+            mRateBuffer.clear() ;
+            mRecords.clear() ;
+
+            this->create_factor_blocks() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::create_factor_blocks()
+        {
+            // a reaction is general if one of its exponents is not 1, 2 or 3
+            Vector< uint > tIsGeneral( mNumberOfReactions, 0 );
+
+            uint tNumGeneral = 0 ;
+            mNumberOfFactors = 0 ;
+
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                uint tNumEducts = 0 ;
+                for( uint k=mEductPointers( r ); k<mEductPointers( r + 1 ); ++k )
+                {
+                    tIsGeneral( r ) = mEductPower( k ) == 0 ? 1 : tIsGeneral( r );
+                    tNumEducts += mEductPower( k );
+                }
+
+                uint tNumProducts = 0 ;
+                for( uint k=mProductPointers( r ); k<mProductPointers( r + 1 ); ++k )
+                {
+                    tIsGeneral( r ) = mProductPower( k ) == 0 ? 1 : tIsGeneral( r );
+                    tNumProducts += mProductPower( k );
+                }
+
+                if( tIsGeneral( r ) != 0 )
+                {
+                    ++tNumGeneral ;
+                }
+                else
+                {
+                    mNumberOfFactors = std::max( mNumberOfFactors, std::max( tNumEducts, tNumProducts ) );
+                }
+            }
+
+            const uint tNumBlocks = ( mNumberOfReactions + 3 ) / 4 ;
+
+            // unused factors point to the trailing one
+            mEductFactors.set_size( 4 * tNumBlocks * mNumberOfFactors, mNumberOfReactingSpecies );
+            mProductFactors.set_size( 4 * tNumBlocks * mNumberOfFactors, mNumberOfReactingSpecies );
+            mGeneralReactions.set_size( tNumGeneral );
+            mConcentrations.set_size( mNumberOfReactingSpecies + 1, 1.0 );
+            mInverseY.set_size( mNumberOfReactingSpecies, 0.0 );
+
+            tNumGeneral = 0 ;
+
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                if( tIsGeneral( r ) != 0 )
+                {
+                    mGeneralReactions( tNumGeneral++ ) = r ;
+                    continue ;
+                }
+
+                // position of the first factor of this reaction
+                const uint tOffset = 4 * mNumberOfFactors * ( r / 4 ) + r % 4 ;
+
+                uint tCount = tOffset ;
+                for( uint k=mEductPointers( r ); k<mEductPointers( r + 1 ); ++k )
+                {
+                    for( uint p=0; p<mEductPower( k ); ++p )
+                    {
+                        mEductFactors( tCount ) = mEductSpecies( k );
+                        tCount += 4 ;
+                    }
+                }
+
+                tCount = tOffset ;
+                for( uint k=mProductPointers( r ); k<mProductPointers( r + 1 ); ++k )
+                {
+                    for( uint p=0; p<mProductPower( k ); ++p )
+                    {
+                        mProductFactors( tCount ) = mProductSpecies( k );
+                        tCount += 4 ;
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::link_sparse_jacobian( const SparseJacobian & aJacobian )
+        {
+            uint tNumPositions = 0 ;
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                tNumPositions += ( mRowPointers( r + 1 ) - mRowPointers( r ) )
+                               * ( mColumnPointers( r + 1 ) - mColumnPointers( r ) );
+            }
+
+            mSparsePositions.set_size( tNumPositions );
+            mSparseTemperaturePositions.set_size( mRows.length() );
+
+            uint tCount = 0 ;
+
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                for( uint i=mRowPointers( r ); i<mRowPointers( r + 1 ); ++i )
+                {
+                    for( uint j=mColumnPointers( r ); j<mColumnPointers( r + 1 ); ++j )
+                    {
+                        mSparsePositions( tCount++ ) = aJacobian.position( mRows( i ), mColumns( j ) );
+                    }
+
+                    mSparseTemperaturePositions( i )
+                        = aJacobian.position( mRows( i ), mNumberOfReactingSpecies );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval(
+                const real aT,
+                const real aAlpha,
+                const Vector< real > & aC,
+                const Vector< real > & aY,
+                const Vector< real > & aG,
+                const Vector< real > & adGdT )
+        {
+            BELFEM_ASSERT( aC.length() == mNumberOfReactingSpecies,
+                           "length of concentration vector does not match" );
+
+            BELFEM_ASSERT( aG.length() == mNumberOfSpecies && adGdT.length() == mNumberOfSpecies,
+                           "length of Gibbs vectors does not match" );
+
+            this->eval_rates( aT );
+            this->eval_third_body( aAlpha, aC );
+            this->eval_forward( aT );
+            this->eval_psi( aC, aY );
+            this->eval_backward( aT, aG, adGdT );
+            this->eval_progress( aAlpha );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_rates( const real aT )
+        {
+            const real tLogT = std::log( aT );
+            const real tInvT = 1.0 / aT ;
+
+            const uint   tN  = mRateA.length() ;
+            const real * tA  = mRateA.ptr() ;
+            const real * tB  = mRateB.ptr() ;
+            const real * tTa = mRateTa.ptr() ;
+                  real * tK  = mK.ptr() ;
+                  real * tdK = mdKdT.ptr() ;
+
+            uint e = 0 ;
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+            const __m256d tLogT4 = _mm256_set1_pd( tLogT );
+            const __m256d tInvT4 = _mm256_set1_pd( tInvT );
+
+            for( ; e+4<=tN; e+=4 )
+            {
+                const __m256d tB4  = _mm256_loadu_pd( tB + e );
+                const __m256d tTa4 = _mm256_loadu_pd( tTa + e );
+
+                const __m256d tK4 = _mm256_mul_pd( _mm256_loadu_pd( tA + e ),
+                        mechanism_exp( _mm256_fmsub_pd( tB4, tLogT4, _mm256_mul_pd( tTa4, tInvT4 ) ) ) );
+
+                _mm256_storeu_pd( tK + e, tK4 );
+                _mm256_storeu_pd( tdK + e, _mm256_mul_pd(
+                        _mm256_mul_pd( tK4, _mm256_fmadd_pd( tTa4, tInvT4, tB4 ) ), tInvT4 ) );
+            }
+#endif
+            // remainder, or all expressions without AVX2
+            for( ; e<tN; ++e )
+            {
+                tK[ e ]  = tA[ e ] * std::exp( tB[ e ] * tLogT - tTa[ e ] * tInvT );
+                tdK[ e ] = tK[ e ] * ( tB[ e ] + tTa[ e ] * tInvT ) * tInvT ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_third_body( const real aAlpha, const Vector< real > & aC )
+        {
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                if( mHasThirdBody( r ) != 0 )
+                {
+                    // Gerlinger ( 2.44 )
+                    real tCm = 0.0 ;
+                    for( uint k=mThirdBodyPointers( r ); k<mThirdBodyPointers( r + 1 ); ++k )
+                    {
+                        tCm += mThirdBodyWeights( k ) * aC( mThirdBodySpecies( k ) );
+                    }
+
+                    mCm( r ) = tCm ;
+                    mdCmdT( r ) = -tCm * aAlpha ;
+                }
+                else
+                {
+                    mCm( r ) = 1.0 ;
+                    mdCmdT( r ) = 0.0 ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_forward( const real aT )
+        {
+            // simple reactions
+            for( uint k=0; k<mArrheniusReactions.length(); ++k )
+            {
+                const uint r = mArrheniusReactions( k );
+                const uint e = mArrheniusRates( k );
+
+                mk1( r ) = mK( e );
+                mdk1dT( r ) = mdKdT( e );
+            }
+
+            // duplicate reactions
+            for( uint k=0; k<mDuplicateReactions.length(); ++k )
+            {
+                const uint r = mDuplicateReactions( k );
+                const uint e = mDuplicateRates( k );
+
+                mk1( r ) = mK( e ) + mK( e + 1 );
+                mdk1dT( r ) = mdKdT( e ) + mdKdT( e + 1 );
+            }
+
+            // Lindemann falloff
+            for( uint k=0; k<mLindemannReactions.length(); ++k )
+            {
+                const uint r = mLindemannReactions( k );
+                const uint e = mLindemannRates( k );
+
+                const real & tk1    = mK( e );
+                const real & tdk1dT = mdKdT( e );
+                const real & tk2    = mK( e + 1 );
+                const real & tdk2dT = mdKdT( e + 1 );
+                const real & tCm    = mCm( r );
+
+                real tX    = tk1 * tCm / tk2 ;
+                real tdXdT = ( tk1 * tk2 * mdCmdT( r ) + tCm * tk2 * tdk1dT - tCm * tk1 * tdk2dT ) / ( tk2 * tk2 );
+
+                mk1( r ) = tk2 * tX / ( 1.0 + tX );
+                mdk1dT( r ) = ( tX * ( 1.0 + tX ) * tdk2dT + tk2 * tdXdT ) / ( ( 1.0 + tX ) * ( 1.0 + tX ) );
+            }
+
+            // Troe falloff, see Reaction_Troe::eval_forward_reaction_speed
+            const real tLog10 = std::log( 10.0 );
+            const real tInvLog10 = 1.0 / tLog10 ;
+
+            for( uint k=0; k<mTroeReactions.length(); ++k )
+            {
+                const uint r = mTroeReactions( k );
+                const uint e = mTroeRates( k );
+
+                const real & tk1    = mK( e );
+                const real & tdk1dT = mdKdT( e );
+                const real & tk2    = mK( e + 1 );
+                const real & tdk2dT = mdKdT( e + 1 );
+                const real & tCm    = mCm( r );
+
+                real tX    = tk1 * tCm / tk2 ;
+                real tdXdT = ( tk1 * tk2 * mdCmdT( r ) + tCm * tk2 * tdk1dT - tCm * tk1 * tdk2dT ) / ( tk2 * tk2 );
+
+                real tY    = std::log( tX ) * tInvLog10 ;
+                real tdYdT = tdXdT * tInvLog10 / tX ;
+
+                // Lindemann part
+                real tL    = tk2 * tX / ( 1.0 + tX );
+                real tdLdT = ( tX * ( 1.0 + tX ) * tdk2dT + tk2 * tdXdT ) / ( ( 1.0 + tX ) * ( 1.0 + tX ) );
+
+                // Fcent, the T2 term is switched off by its weight
+                const real & tA = mTroeA( k );
+                real tExp3 = std::exp( mTroeTau3( k ) * aT );
+                real tExp2 = mTroeT2( k ) * std::exp( mTroeTau2( k ) / aT );
+                real tExp1 = std::exp( mTroeTau1( k ) * aT );
+
+                real tFc = ( 1.0 - tA ) * tExp3 + tA * tExp1 + tExp2 ;
+                real tdFcdT = ( 1.0 - tA ) * tExp3 * mTroeTau3( k )
+                            +         tA   * tExp1 * mTroeTau1( k )
+                            -                tExp2 * mTroeTau2( k ) / ( aT * aT );
+
+                real tGc    = std::log( tFc ) * tInvLog10 ;
+                real tdGcdT = tdFcdT * tInvLog10 / tFc ;
+
+                real tN    = 0.75 - 1.27 * tGc ;
+                real tdNdT = -1.27 * tdGcdT ;
+
+                real tC    = -0.4 - 0.67 * tGc ;
+                real tdCdT = -0.67 * tdGcdT ;
+
+                const real tD = 0.14 ;
+
+                real tDenom = tN - tD * ( tY + tC );
+                real tH     = ( tY + tC ) / tDenom ;
+                real tdHdT  = ( tN * ( tdCdT + tdYdT ) - ( tC + tY ) * tdNdT ) / ( tDenom * tDenom );
+
+                real tI    = 1.0 + tH * tH ;
+                real tJ    = tGc / tI ;
+                real tdJdT = ( tI * tdGcdT - 2.0 * tGc * tH * tdHdT ) / ( tI * tI );
+
+                real tF    = std::exp( tLog10 * tJ );
+                real tdFdT = tLog10 * tF * tdJdT ;
+
+                mk1( r ) = tL * tF ;
+                mdk1dT( r ) = tdLdT * tF + tL * tdFdT ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_psi(
+                const Vector< real > & aC,
+                const Vector< real > & aY )
+        {
+            // the last concentration stays one
+            for( uint k=0; k<mNumberOfReactingSpecies; ++k )
+            {
+                mConcentrations( k ) = aC( k );
+                mInverseY( k ) = aY( k ) > BELFEM_EPSILON ? 1.0 / aY( k ) : 0.0 ;
+            }
+
+            const uint   tNumBlocks = ( mNumberOfReactions + 3 ) / 4 ;
+            const uint   tNumFactors = mNumberOfFactors ;
+            const real * tC         = mConcentrations.ptr() ;
+            const real * tCm        = mCm.ptr() ;
+            const uint * tEducts    = mEductFactors.ptr() ;
+            const uint * tProducts  = mProductFactors.ptr() ;
+                  real * tPsi1      = mPsi1.ptr() ;
+                  real * tPsi2      = mPsi2.ptr() ;
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+            // gather all four lanes
+            const __m256d tZero = _mm256_setzero_pd() ;
+            const __m256d tAll  = _mm256_castsi256_pd( _mm256_set1_epi64x( -1 ) );
+#endif
+            for( uint b=0; b<tNumBlocks; ++b )
+            {
+#if defined( __AVX2__ ) && defined( __FMA__ )
+                __m256d tP1 = _mm256_loadu_pd( tCm + 4 * b );
+                __m256d tP2 = tP1 ;
+
+                for( uint f=0; f<tNumFactors; ++f )
+                {
+                    tP1 = _mm256_mul_pd( tP1, _mm256_mask_i32gather_pd( tZero, tC,
+                            _mm_loadu_si128( reinterpret_cast< const __m128i * >( tEducts ) ), tAll, 8 ) );
+                    tP2 = _mm256_mul_pd( tP2, _mm256_mask_i32gather_pd( tZero, tC,
+                            _mm_loadu_si128( reinterpret_cast< const __m128i * >( tProducts ) ), tAll, 8 ) );
+
+                    tEducts += 4 ;
+                    tProducts += 4 ;
+                }
+
+                _mm256_storeu_pd( tPsi1 + 4 * b, tP1 );
+                _mm256_storeu_pd( tPsi2 + 4 * b, tP2 );
+#else
+                real * tP1 = tPsi1 + 4 * b ;
+                real * tP2 = tPsi2 + 4 * b ;
+
+                for( uint l=0; l<4; ++l )
+                {
+                    tP1[ l ] = tCm[ 4 * b + l ];
+                    tP2[ l ] = tCm[ 4 * b + l ];
+                }
+
+                for( uint f=0; f<tNumFactors; ++f )
+                {
+                    for( uint l=0; l<4; ++l )
+                    {
+                        tP1[ l ] *= tC[ tEducts[ l ] ];
+                        tP2[ l ] *= tC[ tProducts[ l ] ];
+                    }
+
+                    tEducts += 4 ;
+                    tProducts += 4 ;
+                }
+#endif
+            }
+
+            // reactions with a non-integer exponent
+            for( uint r : mGeneralReactions )
+            {
+                // forward reaction
+                real tPsi1 = mCm( r );
+                for( uint k=mEductPointers( r ); k<mEductPointers( r + 1 ); ++k )
+                {
+                    tPsi1 *= mechanism_power( aC( mEductSpecies( k ) ), mEductNu( k ), mEductPower( k ) );
+                }
+
+                // backward reaction
+                real tPsi2 = mCm( r );
+                for( uint k=mProductPointers( r ); k<mProductPointers( r + 1 ); ++k )
+                {
+                    tPsi2 *= mechanism_power( aC( mProductSpecies( k ) ), mProductNu( k ), mProductPower( k ) );
+                }
+
+                mPsi1( r ) = tPsi1 ;
+                mPsi2( r ) = tPsi2 ;
+            }
+
+            // derivatives with respect to the mass fractions
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                for( uint k=mEductPointers( r ); k<mEductPointers( r + 1 ); ++k )
+                {
+                    mdPsi1dY( k ) = mPsi1( r ) * mEductNu( k ) * mInverseY( mEductSpecies( k ) );
+                }
+
+                for( uint k=mProductPointers( r ); k<mProductPointers( r + 1 ); ++k )
+                {
+                    mdPsi2dY( k ) = mPsi2( r ) * mProductNu( k ) * mInverseY( mProductSpecies( k ) );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_backward(
+                const real aT,
+                const Vector< real > & aG,
+                const Vector< real > & adGdT )
+        {
+            // unit of A: mol / ccm, see Reaction::eval_backward_reaction_speed
+            const real tLogA = std::log( gastables::gPref * 1e-6 / ( constant::Rm * aT ) );
+            const real tInvRT = 1.0 / ( constant::Rm * aT );
+            const real tInvT  = 1.0 / aT ;
+
+            // Gibbs energy of reaction
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                real tG = 0.0 ;
+                real tdGdT = 0.0 ;
+                for( uint k=mSourcePointers( r ); k<mSourcePointers( r + 1 ); ++k )
+                {
+                    tG    += mSourceNu( k ) * aG( mSourceSpecies( k ) );
+                    tdGdT += mSourceNu( k ) * adGdT( mSourceSpecies( k ) );
+                }
+
+                mDeltaG( r ) = tG ;
+                mdDeltaGdT( r ) = tdGdT ;
+            }
+
+            const uint   tN      = mNumberOfReactions ;
+            const real * tG      = mDeltaG.ptr() ;
+            const real * tdGdT   = mdDeltaGdT.ptr() ;
+            const real * tSumNu  = mSumNu.ptr() ;
+            const real * tk1     = mk1.ptr() ;
+            const real * tdk1dT  = mdk1dT.ptr() ;
+                  real * tk2     = mk2.ptr() ;
+                  real * tdk2dT  = mdk2dT.ptr() ;
+
+            // product of pressure term and equilibrium constant,
+            // Gerlinger (2.59), computed with one exp
+            uint r = 0 ;
+
+#if defined( __AVX2__ ) && defined( __FMA__ )
+            const __m256d tT4     = _mm256_set1_pd( aT );
+            const __m256d tLogA4  = _mm256_set1_pd( tLogA );
+            const __m256d tInvRT4 = _mm256_set1_pd( tInvRT );
+            const __m256d tInvT4  = _mm256_set1_pd( tInvT );
+
+            for( ; r+4<=tN; r+=4 )
+            {
+                const __m256d tG4     = _mm256_loadu_pd( tG + r );
+                const __m256d tSumNu4 = _mm256_loadu_pd( tSumNu + r );
+                const __m256d tk14    = _mm256_loadu_pd( tk1 + r );
+
+                const __m256d tAB = mechanism_exp(
+                        _mm256_fmadd_pd( tSumNu4, tLogA4, _mm256_mul_pd( tG4, tInvRT4 ) ) );
+
+                const __m256d tdABdT = _mm256_mul_pd( tAB, _mm256_mul_pd( _mm256_fmsub_pd(
+                        _mm256_fmsub_pd( tT4, _mm256_loadu_pd( tdGdT + r ), tG4 ), tInvRT4, tSumNu4 ), tInvT4 ) );
+
+                _mm256_storeu_pd( tk2 + r, _mm256_mul_pd( tk14, tAB ) );
+                _mm256_storeu_pd( tdk2dT + r, _mm256_fmadd_pd( _mm256_loadu_pd( tdk1dT + r ), tAB,
+                                                                _mm256_mul_pd( tk14, tdABdT ) ) );
+            }
+#endif
+            // remainder, or all reactions without AVX2
+            for( ; r<tN; ++r )
+            {
+                real tAB = std::exp( tSumNu[ r ] * tLogA + tG[ r ] * tInvRT );
+                real tdABdT = tAB * ( ( aT * tdGdT[ r ] - tG[ r ] ) * tInvRT - tSumNu[ r ] ) * tInvT ;
+
+                tk2[ r ] = tk1[ r ] * tAB ;
+                tdk2dT[ r ] = tdk1dT[ r ] * tAB + tk1[ r ] * tdABdT ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::eval_progress( const real aAlpha )
+        {
+            const uint   tN     = mNumberOfReactions ;
+            const real * tk1    = mk1.ptr() ;
+            const real * tdk1dT = mdk1dT.ptr() ;
+            const real * tk2    = mk2.ptr() ;
+            const real * tdk2dT = mdk2dT.ptr() ;
+            const real * tPsi1  = mPsi1.ptr() ;
+            const real * tPsi2  = mPsi2.ptr() ;
+            const real * tPhi1  = mPhi1.ptr() ;
+            const real * tPhi2  = mPhi2.ptr() ;
+                  real * tW     = mW.ptr() ;
+                  real * tdWdT  = mdWdT.ptr() ;
+
+            for( uint r=0; r<tN; ++r )
+            {
+                tW[ r ] = tk1[ r ] * tPsi1[ r ] - tk2[ r ] * tPsi2[ r ];
+
+                tdWdT[ r ] = tdk1dT[ r ] * tPsi1[ r ]
+                           + tk1[ r ] * aAlpha * tPhi1[ r ] * tPsi1[ r ]
+                           - tdk2dT[ r ] * tPsi2[ r ]
+                           - tk2[ r ] * aAlpha * tPhi2[ r ] * tPsi2[ r ];
+            }
+
+            // derivatives with respect to the mass fractions
+            mdWdY.fill( 0.0 );
+
+            for( uint r=0; r<tN; ++r )
+            {
+                for( uint k=mEductPointers( r ); k<mEductPointers( r + 1 ); ++k )
+                {
+                    mdWdY( mEductSlot( k ) ) += tk1[ r ] * mdPsi1dY( k );
+                }
+                for( uint k=mProductPointers( r ); k<mProductPointers( r + 1 ); ++k )
+                {
+                    mdWdY( mProductSlot( k ) ) -= tk2[ r ] * mdPsi2dY( k );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::scatter( Vector< real > & aS, Matrix< real > & aJ ) const
+        {
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                const real & tW = mW( r );
+
+                for( uint k=mSourcePointers( r ); k<mSourcePointers( r + 1 ); ++k )
+                {
+                    aS( mSourceSpecies( k ) ) += mSourceNu( k ) * tW ;
+                }
+
+                for( uint i=mRowPointers( r ); i<mRowPointers( r + 1 ); ++i )
+                {
+                    const uint   tRow = mRows( i );
+                    const real & tNu  = mRowNu( i );
+
+                    for( uint j=mColumnPointers( r ); j<mColumnPointers( r + 1 ); ++j )
+                    {
+                        aJ( tRow, mColumns( j ) ) += tNu * mdWdY( j );
+                    }
+
+                    // last column
+                    aJ( tRow, mNumberOfReactingSpecies ) += tNu * mdWdT( r );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::scatter_rates( Vector< real > & aS ) const
+        {
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                const real & tW = mW( r );
+
+                for( uint k=mSourcePointers( r ); k<mSourcePointers( r + 1 ); ++k )
+                {
+                    aS( mSourceSpecies( k ) ) += mSourceNu( k ) * tW ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Mechanism::scatter_sparse( Vector< real > & aS, Vector< real > & aJacobiValues ) const
+        {
+            BELFEM_ASSERT( mSparseTemperaturePositions.length() == mRows.length(),
+                           "link_sparse_jacobian() must be called before scatter_sparse()" );
+
+            uint tCount = 0 ;
+
+            for( uint r=0; r<mNumberOfReactions; ++r )
+            {
+                const real & tW = mW( r );
+
+                for( uint k=mSourcePointers( r ); k<mSourcePointers( r + 1 ); ++k )
+                {
+                    aS( mSourceSpecies( k ) ) += mSourceNu( k ) * tW ;
+                }
+
+                for( uint i=mRowPointers( r ); i<mRowPointers( r + 1 ); ++i )
+                {
+                    const real & tNu = mRowNu( i );
+
+                    for( uint j=mColumnPointers( r ); j<mColumnPointers( r + 1 ); ++j )
+                    {
+                        aJacobiValues( mSparsePositions( tCount++ ) ) += tNu * mdWdY( j );
+                    }
+
+                    // last column
+                    aJacobiValues( mSparseTemperaturePositions( i ) ) += tNu * mdWdT( r );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,383 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CN_MECHANISM_HPP
+#define BELFEM_CL_CN_MECHANISM_HPP
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+#include "cl_CN_SparseJacobian.hpp"
+
+namespace belfem
+{
+    namespace combustion
+    {
+        class Reaction ;
+
+//------------------------------------------------------------------------------
+
+        /**
+         * Compiled form of the reactions of a Scheme.
+         *
+         * The Reaction objects are lowered into flat arrays: the
+         * stoichiometry of all reactions in compressed rows, and the
+         * Arrhenius expressions of all reactions in one block. The
+         * forward rates are evaluated grouped by reaction type, so that
+         * each loop runs over contiguous data without virtual calls or
+         * function pointers.
+         *
+         * Each Arrhenius expression is written as
+         *
+         *   k = A * exp( b * ln( T ) - Ta / T )
+         *
+         * so that only one exp is needed per expression. Integer
+         * stoichiometric coefficients up to three are multiplied
+         * out instead of calling pow.
+         *
+         * The exponentials of the rates and of the equilibrium
+         * constants are computed four at a time with AVX2, if
+         * available. For the concentration products, the educts and
+         * products are also stored in blocks of four reactions, with
+         * one gather per factor. Reactions with a non-integer
+         * exponent are computed from the compressed rows instead.
+         *
+         * The results are identical to Reaction::eval up to round-off.
+         */
+        class Mechanism
+        {
+            enum class RateType
+            {
+                Arrhenius,
+                Duplicate,
+                Lindemann,
+                Troe
+            };
+
+            // forward rate of one reaction, only used while compiling
+            struct RateRecord
+            {
+                RateType mType ;
+                uint     mReaction ;
+                uint     mRate ;
+                real     mTroe[ 4 ] ;
+                bool     mTroeHasT2 ;
+            };
+
+            const uint mNumberOfReactingSpecies ;
+            const uint mNumberOfSpecies ;
+
+            uint mNumberOfReactions = 0 ;
+
+            // educts, sorted by reaction
+            Vector< uint > mEductPointers ;
+            Vector< uint > mEductSpecies ;
+            Vector< real > mEductNu ;
+
+            // exponent if nu is 1, 2 or 3, otherwise 0
+            Vector< uint > mEductPower ;
+
+            // position of the species in the column list
+            Vector< uint > mEductSlot ;
+
+            // products, sorted by reaction
+            Vector< uint > mProductPointers ;
+            Vector< uint > mProductSpecies ;
+            Vector< real > mProductNu ;
+            Vector< uint > mProductPower ;
+            Vector< uint > mProductSlot ;
+
+            // species with a nonzero change in moles, and the change
+            Vector< uint > mSourcePointers ;
+            Vector< uint > mSourceSpecies ;
+            Vector< real > mSourceNu ;
+
+            // same as sources, but only the reacting species
+            Vector< uint > mRowPointers ;
+            Vector< uint > mRows ;
+            Vector< real > mRowNu ;
+
+            // reacting species the speed of a reaction depends on
+            Vector< uint > mColumnPointers ;
+            Vector< uint > mColumns ;
+
+            // third body efficiencies
+            Vector< uint > mHasThirdBody ;
+            Vector< uint > mThirdBodyPointers ;
+            Vector< uint > mThirdBodySpecies ;
+            Vector< real > mThirdBodyWeights ;
+
+            // constants of each reaction
+            Vector< real > mPhi1 ;
+            Vector< real > mPhi2 ;
+            Vector< real > mSumNu ;
+
+            // Arrhenius expressions of all reactions
+            Vector< real > mRateA ;
+            Vector< real > mRateB ;
+            Vector< real > mRateTa ;
+
+            // reactions of each type and their expressions
+            Vector< uint > mArrheniusReactions ;
+            Vector< uint > mArrheniusRates ;
+
+            // for the following types, the index of the first
+            // expression is stored, the second one follows
+
+            // sum of two expressions
+            Vector< uint > mDuplicateReactions ;
+            Vector< uint > mDuplicateRates ;
+
+            // low and high pressure expression
+            Vector< uint > mLindemannReactions ;
+            Vector< uint > mLindemannRates ;
+
+            Vector< uint > mTroeReactions ;
+            Vector< uint > mTroeRates ;
+
+            // Troe parameters, see Reaction_Troe
+            Vector< real > mTroeA ;
+            Vector< real > mTroeTau1 ;
+            Vector< real > mTroeTau2 ;
+            Vector< real > mTroeTau3 ;
+
+            // 1 if the fourth Troe parameter is given, otherwise 0
+            Vector< real > mTroeT2 ;
+
+            // number of factors of the longest concentration product
+            uint mNumberOfFactors = 0 ;
+
+            // concentrations of the educts and products in blocks of four
+            // reactions, [ block ][ factor ][ reaction ]. Unused factors
+            // point to the last entry of mConcentrations, which is one.
+            Vector< uint > mEductFactors ;
+            Vector< uint > mProductFactors ;
+
+            // reactions with a non-integer exponent
+            Vector< uint > mGeneralReactions ;
+
+            // positions in the sparse Jacobian, [ reaction ][ row ][ column ]
+            Vector< uint > mSparsePositions ;
+
+            // positions of the temperature column, per row entry
+            Vector< uint > mSparseTemperaturePositions ;
+
+            // values of the expressions
+            Vector< real > mK ;
+            Vector< real > mdKdT ;
+
+            // concentrations of the reacting species, and one
+            Vector< real > mConcentrations ;
+
+            // inverse mass fractions, zero if the species is absent
+            Vector< real > mInverseY ;
+
+            // Gibbs energy of each reaction and its derivative
+            Vector< real > mDeltaG ;
+            Vector< real > mdDeltaGdT ;
+
+            // values of each reaction, mCm, mPsi1 and mPsi2 are
+            // padded to a multiple of four
+            Vector< real > mCm ;
+            Vector< real > mdCmdT ;
+            Vector< real > mPsi1 ;
+            Vector< real > mPsi2 ;
+            Vector< real > mk1 ;
+            Vector< real > mdk1dT ;
+            Vector< real > mk2 ;
+            Vector< real > mdk2dT ;
+
+            // rate of progress and its temperature derivative
+            Vector< real > mW ;
+            Vector< real > mdWdT ;
+
+            // derivative of the rate of progress, same layout as mColumns
+            Vector< real > mdWdY ;
+
+            // derivatives of Psi for each educt and product entry
+            Vector< real > mdPsi1dY ;
+            Vector< real > mdPsi2dY ;
+
+            // buffers that are only used while compiling
+            Cell< real > mRateBuffer ;
+            Cell< RateRecord > mRecords ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * lower the reactions into the compiled form
+             */
+            Mechanism( const Cell< Reaction * > & aReactions,
+                       const uint aNumberOfReactingSpecies,
+                       const uint aNumberOfSpecies );
+
+//------------------------------------------------------------------------------
+
+            ~Mechanism() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * called by Reaction::compile, the forward rate
+             * of the current reaction is an Arrhenius expression
+             */
+            void
+            add_arrhenius( const Vector< real > & aCoeffs );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * forward rate is the sum of two expressions
+             */
+            void
+            add_duplicate( const Vector< real > & aCoeffs1,
+                           const Vector< real > & aCoeffs2 );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * Lindemann falloff
+             */
+            void
+            add_lindemann( const Vector< real > & aCoeffsLow,
+                           const Vector< real > & aCoeffsHigh );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * Troe falloff, the parameters are passed as stored
+             * in Reaction_Troe
+             */
+            void
+            add_troe( const Vector< real > & aCoeffsLow,
+                      const Vector< real > & aCoeffsHigh,
+                      const real aA,
+                      const real aTau1,
+                      const real aTau2,
+                      const real aTau3,
+                      const bool aHasT2 );
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_reactions() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * Compute the rates of progress of all reactions and
+             * their derivatives. aC are the concentrations of the
+             * reacting species, aY the mass fractions, aG and adGdT
+             * the Gibbs energies of all species.
+             */
+            void
+            eval( const real aT,
+                  const real aAlpha,
+                  const Vector< real > & aC,
+                  const Vector< real > & aY,
+                  const Vector< real > & aG,
+                  const Vector< real > & adGdT );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add the source terms and the Jacobian of the last eval,
+             * same as calling Reaction::eval for each reaction
+             */
+            void
+            scatter( Vector< real > & aS, Matrix< real > & aJ ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add only the source terms of the last eval
+             */
+            void
+            scatter_rates( Vector< real > & aS ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * same as scatter, but for the sparse Jacobian
+             */
+            void
+            scatter_sparse( Vector< real > & aS, Vector< real > & aJacobiValues ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * remember the positions of the entries
+             * after the pattern has been finalized
+             */
+            void
+            link_sparse_jacobian( const SparseJacobian & aJacobian );
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            void
+            count_entries( const Cell< Reaction * > & aReactions );
+
+//------------------------------------------------------------------------------
+
+            void
+            add_stoichiometry( const Reaction & aReaction );
+
+//------------------------------------------------------------------------------
+
+            // add one Arrhenius expression, returns its index
+            uint
+            add_rate( const Vector< real > & aCoeffs );
+
+//------------------------------------------------------------------------------
+
+            // sort the records by type and create the rate containers
+            void
+            finalize();
+
+//------------------------------------------------------------------------------
+
+            // create the blocks of the concentration products
+            void
+            create_factor_blocks();
+
+//------------------------------------------------------------------------------
+
+            void
+            eval_rates( const real aT );
+
+            void
+            eval_third_body( const real aAlpha, const Vector< real > & aC );
+
+            void
+            eval_forward( const real aT );
+
+            void
+            eval_psi( const Vector< real > & aC, const Vector< real > & aY );
+
+            void
+            eval_backward( const real aT, const Vector< real > & aG, const Vector< real > & adGdT );
+
+            void
+            eval_progress( const real aAlpha );
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        Mechanism::number_of_reactions() const
+        {
+            return mNumberOfReactions ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_CN_MECHANISM_HPP
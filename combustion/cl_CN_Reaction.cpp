@@ -55,6 +55,111 @@ namespace belfem
             {
                 mDeltaNu( mProductIndices( k ) ) += mProductNu( k );
             }
+
+            // collect the species of this reaction
+            uint tN = aScheme.number_of_reacting_species() ;
+
+            Vector< uint > tFlags( mDeltaNu.length(), 0 );
+
+            for( uint k=0; k<mN1; ++k )
+            {
+                tFlags( mEductIndices( k ) ) = 1 ;
+            }
+            for( uint k=0; k<mN2; ++k )
+            {
+                tFlags( mProductIndices( k ) ) = 1 ;
+            }
+
+            uint tNumSources = 0 ;
+            uint tNumRows = 0 ;
+            uint tNumColumns = 0 ;
+
+            for( uint k=0; k<mDeltaNu.length(); ++k )
+            {
+                if( tFlags( k ) != 0 )
+                {
+                    if( mDeltaNu( k ) != 0.0 )
+                    {
+                        ++tNumSources ;
+                        if( k < tN )
+                        {
+                            ++tNumRows ;
+                        }
+                    }
+                    if( k < tN )
+                    {
+                        ++tNumColumns ;
+                    }
+                }
+            }
+
+            mSourceIndices.set_size( tNumSources );
+            mSparseRows.set_size( tNumRows );
+            mSparseColumns.set_size( tNumColumns );
+            mSparseWork.set_size( tNumColumns, 0.0 );
+
+            tNumSources = 0 ;
+            tNumRows = 0 ;
+            tNumColumns = 0 ;
+
+            for( uint k=0; k<mDeltaNu.length(); ++k )
+            {
+                if( tFlags( k ) != 0 )
+                {
+                    if( mDeltaNu( k ) != 0.0 )
+                    {
+                        mSourceIndices( tNumSources++ ) = k ;
+                        if( k < tN )
+                        {
+                            mSparseRows( tNumRows++ ) = k ;
+                        }
+                    }
+                    if( k < tN )
+                    {
+                        mSparseColumns( tNumColumns++ ) = k ;
+                    }
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        Reaction::Reaction( const Reaction & aReaction, Scheme & aScheme ) :
+            mScheme( aScheme ),
+            mEductIndices( aReaction.mEductIndices ),
+            mEductNu( aReaction.mEductNu ),
+            mProductIndices( aReaction.mProductIndices ),
+            mProductNu( aReaction.mProductNu ),
+            mHaveThirdBody( aReaction.mHaveThirdBody ),
+            mN1( aReaction.mN1 ),
+            mN2( aReaction.mN2 ),
+            mPhi1( aReaction.mPhi1 ),
+            mPhi2( aReaction.mPhi2 ),
+            mSumNu( aReaction.mSumNu ),
+            mThirdBodyIndices( aReaction.mThirdBodyIndices ),
+            mThirdBodyWeights( aReaction.mThirdBodyWeights ),
+            mAlpha( aReaction.mAlpha ),
+            mCm( aReaction.mCm ),
+            mdCmdT( aReaction.mdCmdT ),
+            mPsi1( aReaction.mPsi1 ),
+            mPsi2( aReaction.mPsi2 ),
+            mDeltaNu( aReaction.mDeltaNu ),
+            mdPsi1dY( aReaction.mdPsi1dY ),
+            mdPsi2dY( aReaction.mdPsi2dY ),
+            mdPsi1dT( aReaction.mdPsi1dT ),
+            mdPsi2dT( aReaction.mdPsi2dT ),
+            mk1( aReaction.mk1 ),
+            mdk1dT( aReaction.mdk1dT ),
+            mk2( aReaction.mk2 ),
+            mdk2dT( aReaction.mdk2dT ),
+            mSourceIndices( aReaction.mSourceIndices ),
+            mSparseRows( aReaction.mSparseRows ),
+            mSparseColumns( aReaction.mSparseColumns ),
+            mSparsePositions( aReaction.mSparsePositions ),
+            mSparseTemperaturePositions( aReaction.mSparseTemperaturePositions ),
+            mSparseWork( aReaction.mSparseWork )
+        {
+
         }
 
 //------------------------------------------------------------------------------
@@ -77,10 +182,30 @@ namespace belfem
 //------------------------------------------------------------------------------
 
         void
-        Reaction::eval(   const real     & aT,
-                          const real     & aP,
-                          Vector< real > & aS,
-                          Matrix< real > & aJ )
+        Reaction::link_sparse_jacobian( const SparseJacobian & aJacobian )
+        {
+            uint tN = mScheme.number_of_reacting_species() ;
+
+            mSparsePositions.set_size( mSparseRows.length() * mSparseColumns.length() );
+            mSparseTemperaturePositions.set_size( mSparseRows.length() );
+
+            uint tCount = 0 ;
+
+            for( uint r=0; r<mSparseRows.length(); ++r )
+            {
+                for( uint c=0; c<mSparseColumns.length(); ++c )
+                {
+                    mSparsePositions( tCount++ ) = aJacobian.position( mSparseRows( r ), mSparseColumns( c ) );
+                }
+
+                mSparseTemperaturePositions( r ) = aJacobian.position( mSparseRows( r ), tN );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction::eval_speeds( const real & aT, const real & aP )
         {
             // calculate alpha parameter
             mAlpha = mScheme.combgas()->alpha( aT, aP );
@@ -95,6 +220,64 @@ namespace belfem
 
             this->eval_forward_reaction_speed( aT );
             this->eval_backward_reaction_speed( aT );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction::eval_sparse(
+                const real     & aT,
+                const real     & aP,
+                Vector< real > & aS,
+                Vector< real > & aJacobiValues )
+        {
+            this->eval_speeds( aT, aP );
+
+            // eval S-Term
+            real tValue = mk1 * mPsi1 - mk2 * mPsi2 ;
+
+            for( uint k=0; k<mSourceIndices.length(); ++k )
+            {
+                aS( mSourceIndices( k ) ) += mDeltaNu( mSourceIndices( k ) ) * tValue ;
+            }
+
+            // derivatives of the reaction speed
+            for( uint c=0; c<mSparseColumns.length(); ++c )
+            {
+                mSparseWork( c ) = mk1 * mdPsi1dY( mSparseColumns( c ) )
+                                 - mk2 * mdPsi2dY( mSparseColumns( c ) );
+            }
+
+            real tdValuedT = mdk1dT * mPsi1
+                           + mk1 * mdPsi1dT
+                           - mdk2dT * mPsi2
+                           - mk2 * mdPsi2dT ;
+
+            uint tCount = 0 ;
+
+            for( uint r=0; r<mSparseRows.length(); ++r )
+            {
+                const real & tDeltaNu = mDeltaNu( mSparseRows( r ) );
+
+                for( uint c=0; c<mSparseColumns.length(); ++c )
+                {
+                    aJacobiValues( mSparsePositions( tCount++ ) ) += tDeltaNu * mSparseWork( c );
+                }
+
+                // last column
+                aJacobiValues( mSparseTemperaturePositions( r ) ) += tDeltaNu * tdValuedT ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction::eval(   const real     & aT,
+                          const real     & aP,
+                          Vector< real > & aS,
+                          Matrix< real > & aJ )
+        {
+            this->eval_speeds( aT, aP );
 
 
             // eval S-Term
@@ -177,8 +360,12 @@ namespace belfem
         void
         Reaction::eval_dPsidY()
         {
-            // forward reaction
-            mdPsi1dY.fill( 0.0 );
+            // forward reaction, only the entries of the educts
+            // are ever written, so only these need to be reset
+            for( uint k=0; k<mN1; ++k )
+            {
+                mdPsi1dY( mEductIndices( k ) ) = 0.0 ;
+            }
 
             for( uint k=0; k<mN1; ++k )
             {
@@ -190,7 +377,11 @@ namespace belfem
             }
 
             // backward reaction
-            mdPsi2dY.fill( 0.0 );
+            for( uint k=0; k<mN2; ++k )
+            {
+                mdPsi2dY( mProductIndices( k ) ) = 0.0 ;
+            }
+
             for( uint k=0; k<mN2; ++k )
             {
                 uint j = mProductIndices( k );
@@ -9,15 +9,20 @@
 #include "cl_Vector.hpp"
 #include "cl_Matrix.hpp"
 #include "cl_Gas.hpp"
+#include "cl_CN_SparseJacobian.hpp"
 
 namespace belfem
 {
     namespace combustion
     {
         class Scheme;
+        class Mechanism;
 
         class Reaction
         {
+            // reads the stoichiometry when the mechanism is compiled
+            friend Mechanism ;
+
 //------------------------------------------------------------------------------
         protected:
 //------------------------------------------------------------------------------
@@ -59,6 +64,27 @@ namespace belfem
             real mk2;
             real mdk2dT;
 
+            // species with a nonzero change in moles
+            Vector< uint > mSourceIndices ;
+
+            // rows and columns of this reaction in the Jacobian
+            Vector< uint > mSparseRows ;
+            Vector< uint > mSparseColumns ;
+
+            // positions in the sparse Jacobian, [ row ][ column ]
+            Vector< uint > mSparsePositions ;
+
+            // positions of the temperature column
+            Vector< uint > mSparseTemperaturePositions ;
+
+            // work vector for column values
+            Vector< real > mSparseWork ;
+
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone, links the copy with aScheme
+            Reaction( const Reaction & aReaction, Scheme & aScheme );
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -71,6 +97,24 @@ namespace belfem
                     const Vector <real> & aProductNu,
                     const bool aHasThirdBody );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * copy of this reaction that belongs to another scheme,
+             * used by Scheme::clone
+             */
+            virtual Reaction *
+            clone( Scheme & aScheme ) const = 0 ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * pass the forward rate of this reaction to the
+             * compiled mechanism, see Mechanism
+             */
+            virtual void
+            compile( Mechanism & aMechanism ) const = 0 ;
+
 //------------------------------------------------------------------------------
 
             inline bool
@@ -99,10 +143,52 @@ namespace belfem
                     Vector< real > & aS,
                     Matrix< real > & aJ );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * same as eval, but only scatters the entries
+             * that belong to this reaction into the sparse Jacobian
+             */
+            void
+            eval_sparse( const real & aT,
+                         const real & aP,
+                         Vector< real > & aS,
+                         Vector< real > & aJacobiValues );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * species that change in this reaction, needed for the
+             * pattern of the sparse Jacobian
+             */
+            inline const Vector< uint > &
+            sparse_rows() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * species the speed of this reaction depends on
+             */
+            inline const Vector< uint > &
+            sparse_columns() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * remember the positions of the entries of this reaction
+             * after the pattern has been finalized
+             */
+            void
+            link_sparse_jacobian( const SparseJacobian & aJacobian );
+
 //------------------------------------------------------------------------------
         private:
 //------------------------------------------------------------------------------
 
+            // computes the reaction speeds and the Psi values
+            void
+            eval_speeds( const real & aT, const real & aP );
+
             void
             eval_cm();
 
@@ -140,6 +226,22 @@ namespace belfem
             return mThirdBodyIndices.length() > 0;
         }
 
+//------------------------------------------------------------------------------
+
+        inline const Vector< uint > &
+        Reaction::sparse_rows() const
+        {
+            return mSparseRows ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< uint > &
+        Reaction::sparse_columns() const
+        {
+            return mSparseColumns ;
+        }
+
 //------------------------------------------------------------------------------
     }
 }
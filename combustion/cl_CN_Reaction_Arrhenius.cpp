@@ -3,6 +3,7 @@
 //
 
 #include "cl_CN_Reaction_Arrhenius.hpp"
+#include "cl_CN_Mechanism.hpp"
 #include "assert.hpp"
 #include "fn_CN_arrhenius.hpp"
 
@@ -42,6 +43,33 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Reaction_Arrhenius::Reaction_Arrhenius( const Reaction_Arrhenius & aReaction, Scheme & aScheme ) :
+                Reaction( aReaction, aScheme ),
+                mCoeffs( aReaction.mCoeffs ),
+                mFunctionK( aReaction.mFunctionK ),
+                mFunctiondKdT( aReaction.mFunctiondKdT )
+        {
+
+        }
+
+//------------------------------------------------------------------------------
+
+        Reaction *
+        Reaction_Arrhenius::clone( Scheme & aScheme ) const
+        {
+            return new Reaction_Arrhenius( *this, aScheme );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction_Arrhenius::compile( Mechanism & aMechanism ) const
+        {
+            aMechanism.add_arrhenius( mCoeffs );
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -30,6 +30,11 @@ namespace belfem
             real ( *mFunctiondKdT )
                 ( const Vector< real > & aCoeffs, const real & aT, const real & aK );
 
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone
+            Reaction_Arrhenius( const Reaction_Arrhenius & aReaction, Scheme & aScheme );
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -42,6 +47,16 @@ namespace belfem
                                 const bool aHasThirdBody,
                                 const Vector < real > & aCoeffs );
 
+//------------------------------------------------------------------------------
+
+            Reaction *
+            clone( Scheme & aScheme ) const ;
+
+//------------------------------------------------------------------------------
+
+            void
+            compile( Mechanism & aMechanism ) const ;
+
 //------------------------------------------------------------------------------
 
             void
@@ -4,6 +4,7 @@
 
 
 #include "cl_CN_Reaction_Duplicate.hpp"
+#include "cl_CN_Mechanism.hpp"
 #include "assert.hpp"
 #include "fn_CN_arrhenius.hpp"
 
@@ -58,6 +59,36 @@ namespace belfem
 
         }
 
+//------------------------------------------------------------------------------
+
+        Reaction_Duplicate::Reaction_Duplicate( const Reaction_Duplicate & aReaction, Scheme & aScheme ) :
+                Reaction( aReaction, aScheme ),
+                mCoeffs1( aReaction.mCoeffs1 ),
+                mCoeffs2( aReaction.mCoeffs2 ),
+                mFunctionK1( aReaction.mFunctionK1 ),
+                mFunctiondK1dT( aReaction.mFunctiondK1dT ),
+                mFunctionK2( aReaction.mFunctionK2 ),
+                mFunctiondK2dT( aReaction.mFunctiondK2dT )
+        {
+
+        }
+
+//------------------------------------------------------------------------------
+
+        Reaction *
+        Reaction_Duplicate::clone( Scheme & aScheme ) const
+        {
+            return new Reaction_Duplicate( *this, aScheme );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction_Duplicate::compile( Mechanism & aMechanism ) const
+        {
+            aMechanism.add_duplicate( mCoeffs1, mCoeffs2 );
+        }
+
 //------------------------------------------------------------------------------
 
         void
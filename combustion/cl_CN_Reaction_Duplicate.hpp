@@ -39,6 +39,11 @@ namespace belfem
             real ( *mFunctiondK2dT )
                     ( const Vector< real > & aCoeffs, const real & aT, const real & aK );
 
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone
+            Reaction_Duplicate( const Reaction_Duplicate & aReaction, Scheme & aScheme );
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -52,6 +57,16 @@ namespace belfem
                                              const Vector < real > & aCoeffs1,
                                              const Vector < real > & aCoeffs2 );
 
+//------------------------------------------------------------------------------
+
+            Reaction *
+            clone( Scheme & aScheme ) const ;
+
+//------------------------------------------------------------------------------
+
+            void
+            compile( Mechanism & aMechanism ) const ;
+
 //------------------------------------------------------------------------------
 
             void
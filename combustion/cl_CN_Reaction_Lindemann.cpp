@@ -5,6 +5,7 @@
 #include "typedefs.hpp"
 #include "cl_Vector.hpp"
 #include "cl_CN_Reaction_Lindemann.hpp"
+#include "cl_CN_Mechanism.hpp"
 #include "fn_CN_arrhenius.hpp"
 
 namespace belfem
@@ -57,6 +58,36 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Reaction_Lindemann::Reaction_Lindemann( const Reaction_Lindemann & aReaction, Scheme & aScheme ) :
+                Reaction( aReaction, aScheme ),
+                mCoeffs1( aReaction.mCoeffs1 ),
+                mCoeffs2( aReaction.mCoeffs2 ),
+                mFunctionK1( aReaction.mFunctionK1 ),
+                mFunctiondK1dT( aReaction.mFunctiondK1dT ),
+                mFunctionK2( aReaction.mFunctionK2 ),
+                mFunctiondK2dT( aReaction.mFunctiondK2dT )
+        {
+
+        }
+
+//------------------------------------------------------------------------------
+
+        Reaction *
+        Reaction_Lindemann::clone( Scheme & aScheme ) const
+        {
+            return new Reaction_Lindemann( *this, aScheme );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction_Lindemann::compile( Mechanism & aMechanism ) const
+        {
+            aMechanism.add_lindemann( mCoeffs1, mCoeffs2 );
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -38,6 +38,11 @@ namespace belfem
             real ( *mFunctiondK2dT )
                     ( const Vector< real > & aCoeffs, const real & aT, const real & aK );
 
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone
+            Reaction_Lindemann( const Reaction_Lindemann & aReaction, Scheme & aScheme );
+
 //------------------------------------------------------------------------------
     public:
 //------------------------------------------------------------------------------
@@ -51,6 +56,16 @@ namespace belfem
                                          const Vector < real > & aCoeffsLow,
                                          const Vector < real > & aCoeffsHigh );
 
+//------------------------------------------------------------------------------
+
+            Reaction *
+            clone( Scheme & aScheme ) const ;
+
+//------------------------------------------------------------------------------
+
+            void
+            compile( Mechanism & aMechanism ) const ;
+
 //------------------------------------------------------------------------------
 
             void
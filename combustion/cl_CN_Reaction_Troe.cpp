@@ -6,6 +6,7 @@
 #include "typedefs.hpp"
 #include "cl_Vector.hpp"
 #include "cl_CN_Reaction_Troe.hpp"
+#include "cl_CN_Mechanism.hpp"
 #include "fn_CN_arrhenius.hpp"
 
 namespace belfem
@@ -74,6 +75,43 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Reaction_Troe::Reaction_Troe( const Reaction_Troe & aReaction, Scheme & aScheme ) :
+                Reaction( aReaction, aScheme ),
+                mCoeffs1( aReaction.mCoeffs1 ),
+                mCoeffs2( aReaction.mCoeffs2 ),
+                mA( aReaction.mA ),
+                mTau3( aReaction.mTau3 ),
+                mTau1( aReaction.mTau1 ),
+                mTau2( aReaction.mTau2 ),
+                mLog10( aReaction.mLog10 ),
+                mFunctionK1( aReaction.mFunctionK1 ),
+                mFunctiondK1dT( aReaction.mFunctiondK1dT ),
+                mFunctionK2( aReaction.mFunctionK2 ),
+                mFunctiondK2dT( aReaction.mFunctiondK2dT ),
+                mFunctionCent( aReaction.mFunctionCent )
+        {
+
+        }
+
+//------------------------------------------------------------------------------
+
+        Reaction *
+        Reaction_Troe::clone( Scheme & aScheme ) const
+        {
+            return new Reaction_Troe( *this, aScheme );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Reaction_Troe::compile( Mechanism & aMechanism ) const
+        {
+            aMechanism.add_troe( mCoeffs1, mCoeffs2, mA, mTau1, mTau2, mTau3,
+                                 mFunctionCent == & Reaction_Troe::F_cent );
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -47,6 +47,11 @@ namespace belfem
             void ( Reaction_Troe::*mFunctionCent ) ( const real & aT, real & aF, real & adFdT );
 
 
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone
+            Reaction_Troe( const Reaction_Troe & aReaction, Scheme & aScheme );
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -61,6 +66,16 @@ namespace belfem
                                          const Vector < real > & aCoeffsHigh,
                                          const Vector < real > & aTroe );
 
+//------------------------------------------------------------------------------
+
+            Reaction *
+            clone( Scheme & aScheme ) const ;
+
+//------------------------------------------------------------------------------
+
+            void
+            compile( Mechanism & aMechanism ) const ;
+
 //------------------------------------------------------------------------------
 
             void
@@ -70,7 +70,94 @@ namespace belfem
                 mNumberOfReactingSpecies = mCombgas->number_of_components();
             }
 
-            // Allocate containers
+            this->allocate_containers();
+        }
+
+//------------------------------------------------------------------------------
+
+        Scheme::Scheme( const Scheme & aScheme ) :
+                mChemkinFileName( aScheme.mChemkinFileName ),
+                mFuel( aScheme.mFuel ),
+                mOxidizer( aScheme.mOxidizer ),
+                mGasModel( aScheme.mGasModel ),
+                mInitialMolarFractions( aScheme.mInitialMolarFractions ),
+                mReactingFuelIndex( aScheme.mReactingFuelIndex ),
+                mInertFuelIndex( aScheme.mInertFuelIndex ),
+                mOxidizerIndex( aScheme.mOxidizerIndex ),
+                mNumberOfReactingSpecies( aScheme.mNumberOfReactingSpecies )
+        {
+            if( aScheme.mReactions.size() > 0 )
+            {
+                // create a new gas with the same species
+                Cell< string > tSpecies ;
+                for( uint k=0; k<aScheme.mCombgas->number_of_components(); ++k )
+                {
+                    tSpecies.push( aScheme.mCombgas->component( k )->label() );
+                }
+
+                mCombgas = new Gas( tSpecies, mInitialMolarFractions, mGasModel );
+
+                // copy the reactions, the parsed coefficients are reused
+                mReactions.set_size( aScheme.mReactions.size(), nullptr );
+
+                for( uint k=0; k<aScheme.mReactions.size(); ++k )
+                {
+                    mReactions( k ) = aScheme.mReactions( k )->clone( *this );
+                }
+            }
+            else
+            {
+                mCombgas = new Gas();
+            }
+
+            // use the current mixture of the original
+            mCombgas->remix( aScheme.mCombgas->molar_fractions() );
+
+            this->allocate_containers();
+
+            mUseMechanism = aScheme.mUseMechanism ;
+
+            if( aScheme.mUseSparseJacobian )
+            {
+                this->use_sparse_jacobian( true );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        Scheme::~Scheme()
+        {
+            delete mCombgas;
+
+            if( mSparseJacobian != nullptr )
+            {
+                delete mSparseJacobian ;
+            }
+
+            if( mMechanism != nullptr )
+            {
+                delete mMechanism ;
+            }
+
+            for( Reaction * tReaction: mReactions )
+            {
+                delete tReaction;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        Scheme *
+        Scheme::clone() const
+        {
+            return new Scheme( *this );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::allocate_containers()
+        {
             mNumberOfAllSpecies = mCombgas->number_of_components();
 
             mY.set_size( mNumberOfAllSpecies );
@@ -109,17 +196,10 @@ namespace belfem
 
             mTemperatureIndex = mNumberOfReactingSpecies ;
 
-        }
-
-//------------------------------------------------------------------------------
-
-        Scheme::~Scheme()
-        {
-            delete mCombgas;
-
-            for( Reaction * tReaction: mReactions )
+            // lower the reactions into flat arrays
+            if( mReactions.size() > 0 )
             {
-                delete tReaction;
+                mMechanism = new Mechanism( mReactions, mNumberOfReactingSpecies, mNumberOfAllSpecies );
             }
         }
 
@@ -336,9 +416,29 @@ namespace belfem
             // sum of reacting species
             this->preprocess( aT, aP );
 
-            this->compute_jacobi( aT, aP );
+            if( mUseSparseJacobian )
+            {
+                this->compute_sparse_jacobi( aT, aP );
+
+                this->compute_rhs( aT, aP, aU, aDeltaX );
 
-            this->compute_rhs( aT, aP, aU, aDeltaX );
+                this->solve_sparse();
+            }
+            else
+            {
+                this->compute_jacobi( aT, aP );
+
+                this->compute_rhs( aT, aP, aU, aDeltaX );
+
+                mJacobi *= - mC1 ;
+                for( uint k=0; k<=mNumberOfReactingSpecies; ++k )
+                {
+                    mJacobi( k, k ) += 1. ;
+                }
+
+                mLHS = mRHS ;
+                gesv( mJacobi, mLHS, mPivot );
+            }
 
             /*mJacobi.print("J");
             for( uint k=0; k<mNumberOfReactingSpecies; ++k )
@@ -349,15 +449,6 @@ namespace belfem
 
             exit( 0 ); */
 
-            mJacobi *= - mC1 ;
-            for( uint k=0; k<=mNumberOfReactingSpecies; ++k )
-            {
-                mJacobi( k, k ) += 1. ;
-            }
-
-            mLHS = mRHS ;
-            gesv( mJacobi, mLHS, mPivot );
-
 
             for( uint k=0; k<mNumberOfReactingSpecies; ++k )
             {
@@ -388,9 +479,17 @@ namespace belfem
 
             mJacobi.fill( 0.0 );
 
-            for ( Reaction * tReaction : mReactions )
+            if( mUseMechanism && mMechanism != nullptr )
             {
-                tReaction->eval( aT, aP, mdYdt, mJacobi );
+                mMechanism->eval( aT, mCombgas->alpha( aT, aP ), mC, mY, mGibbs, mdGibbsdT );
+                mMechanism->scatter( mdYdt, mJacobi );
+            }
+            else
+            {
+                for ( Reaction * tReaction : mReactions )
+                {
+                    tReaction->eval( aT, aP, mdYdt, mJacobi );
+                }
             }
             mdYdt %= mM;
             mdYdt *= mV;
@@ -442,6 +541,223 @@ namespace belfem
                 = tdCpdT / ( tCp * tCp ) * tdHdt - dot( mCp, mdYdt ) / tCp;
         }
 
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::compute_rates( const real & aT, const real & aP )
+        {
+            this->preprocess( aT, aP );
+            this->compute_source_terms( aT, aP );
+            this->compute_temperature_rate();
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::compute_rates_and_jacobi( const real & aT, const real & aP )
+        {
+            this->preprocess( aT, aP );
+
+            if( mUseSparseJacobian )
+            {
+                this->compute_sparse_jacobi( aT, aP );
+                mSparseJacobian->to_dense( mJacobi );
+            }
+            else
+            {
+                this->compute_jacobi( aT, aP );
+            }
+
+            this->compute_temperature_rate();
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::compute_source_terms( const real & aT, const real & aP )
+        {
+            mdYdt.fill( 0.0 );
+
+            if( mUseMechanism && mMechanism != nullptr )
+            {
+                mMechanism->eval( aT, mCombgas->alpha( aT, aP ), mC, mY, mGibbs, mdGibbsdT );
+                mMechanism->scatter_rates( mdYdt );
+            }
+            else
+            {
+                // the reaction objects always compute the Jacobian
+                mJacobi.fill( 0.0 );
+
+                for ( Reaction * tReaction : mReactions )
+                {
+                    tReaction->eval( aT, aP, mdYdt, mJacobi );
+                }
+            }
+            mdYdt %= mM;
+            mdYdt *= mV;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::compute_temperature_rate()
+        {
+            mdTdt = 0.0 ;
+            for( uint k=0; k<mNumberOfReactingSpecies; ++k )
+            {
+                mdTdt += mH( k ) * mdYdt( k );
+            }
+            mdTdt /= - dot( mCp, mY );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::use_sparse_jacobian( const bool aSwitch )
+        {
+            mUseSparseJacobian = aSwitch ;
+
+            if( mUseSparseJacobian && mSparseJacobian == nullptr )
+            {
+                this->create_sparse_jacobian() ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::use_compiled_mechanism( const bool aSwitch )
+        {
+            mUseMechanism = aSwitch ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::create_sparse_jacobian()
+        {
+            mSparseJacobian = new SparseJacobian( mNumberOfReactingSpecies + 1 );
+
+            for ( Reaction * tReaction : mReactions )
+            {
+                mSparseJacobian->add_block( tReaction->sparse_rows(), tReaction->sparse_columns() );
+            }
+
+            // the temperature row and column are dense
+            mSparseJacobian->add_row( mTemperatureIndex );
+            mSparseJacobian->add_column( mTemperatureIndex );
+
+            mSparseJacobian->finalize() ;
+
+            for ( Reaction * tReaction : mReactions )
+            {
+                tReaction->link_sparse_jacobian( *mSparseJacobian );
+            }
+
+            if( mMechanism != nullptr )
+            {
+                mMechanism->link_sparse_jacobian( *mSparseJacobian );
+            }
+
+            mSparseBackup.set_size( mSparseJacobian->number_of_nonzeros() );
+            mSparseWork.set_size( mNumberOfReactingSpecies, 0.0 );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::compute_sparse_jacobi( const real & aT, const real & aP )
+        {
+            // reset matrices
+            mdYdt.fill( 0.0 );
+
+            Vector< real > & tValues = mSparseJacobian->values() ;
+            tValues.fill( 0.0 );
+
+            if( mUseMechanism && mMechanism != nullptr )
+            {
+                mMechanism->eval( aT, mCombgas->alpha( aT, aP ), mC, mY, mGibbs, mdGibbsdT );
+                mMechanism->scatter_sparse( mdYdt, tValues );
+            }
+            else
+            {
+                for ( Reaction * tReaction : mReactions )
+                {
+                    tReaction->eval_sparse( aT, aP, mdYdt, tValues );
+                }
+            }
+            mdYdt %= mM;
+            mdYdt *= mV;
+
+            real tCp = dot( mCp, mY );
+            real tdCpdT =  dot( mdCpdT, mY );
+            real tdHdt = dot( mH, mdYdt );
+
+            const Vector< uint > & tRowPointers = mSparseJacobian->row_pointers() ;
+            const Vector< uint > & tColumns     = mSparseJacobian->columns() ;
+
+            // scale the rows of the species and sum up the
+            // enthalpy contributions for the final row
+            mSparseWork.fill( 0.0 );
+
+            for( uint i=0; i<mNumberOfReactingSpecies; ++i )
+            {
+                real tScale = mM( i ) * mV ;
+
+                for( uint p=tRowPointers( i ); p<tRowPointers( i + 1 ); ++p )
+                {
+                    tValues( p ) *= tScale ;
+
+                    if( tColumns( p ) < mNumberOfReactingSpecies )
+                    {
+                        mSparseWork( tColumns( p ) ) += mH( i ) * tValues( p );
+                    }
+                }
+            }
+
+            // final row
+            for( uint j=0; j<mNumberOfReactingSpecies; ++j )
+            {
+                tValues( mSparseJacobian->position( mTemperatureIndex, j ) ) =
+                        ( tdHdt * tdCpdT / tCp - mSparseWork( j ) ) / tCp ;
+            }
+
+            // last entry
+            tValues( mSparseJacobian->position( mTemperatureIndex, mTemperatureIndex ) )
+                = tdCpdT / ( tCp * tCp ) * tdHdt - dot( mCp, mdYdt ) / tCp;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Scheme::solve_sparse()
+        {
+            Vector< real > & tValues = mSparseJacobian->values() ;
+
+            tValues *= - mC1 ;
+            for( uint k=0; k<=mNumberOfReactingSpecies; ++k )
+            {
+                tValues( mSparseJacobian->diagonal( k ) ) += 1. ;
+            }
+
+            mLHS = mRHS ;
+
+            // the decomposition works in place
+            mSparseBackup = tValues ;
+
+            if( mSparseJacobian->factorize() )
+            {
+                mSparseJacobian->solve( mLHS );
+            }
+            else
+            {
+                // small pivot, use dense solver with pivoting
+                tValues = mSparseBackup ;
+                mSparseJacobian->to_dense( mJacobi );
+                gesv( mJacobi, mLHS, mPivot );
+            }
+        }
+
 //------------------------------------------------------------------------------
 
         void
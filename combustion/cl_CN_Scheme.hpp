@@ -12,6 +12,8 @@
 #include "CN_Enums.hpp"
 #include "en_GM_GasModel.hpp"
 #include "cl_CN_Reaction.hpp"
+#include "cl_CN_SparseJacobian.hpp"
+#include "cl_CN_Mechanism.hpp"
 
 namespace belfem
 {
@@ -83,8 +85,24 @@ namespace belfem
 
             Matrix< real > mJacobi;
 
+            // Jacobian with the sparsity pattern of the reactions
+            SparseJacobian * mSparseJacobian = nullptr ;
+
+            // copy of the sparse values for the dense fallback
+            Vector< real > mSparseBackup ;
+
+            // work vector for final row of sparse Jacobian
+            Vector< real > mSparseWork ;
+
+            bool mUseSparseJacobian = false ;
+
             Cell< Reaction * > mReactions;
 
+            // compiled form of the reactions
+            Mechanism * mMechanism = nullptr ;
+
+            bool mUseMechanism = true ;
+
             uint mCount = 0 ;
 
             // factors for Jacobian stabilization
@@ -104,6 +122,16 @@ namespace belfem
 
             ~Scheme();
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates an independent copy with its own combustion gas.
+             * The reactions are copied instead of reading the
+             * Chemkin file again. The clone can be used on another thread.
+             */
+            Scheme *
+            clone() const ;
+
 //------------------------------------------------------------------------------
 
             /**
@@ -117,6 +145,64 @@ namespace belfem
             real
             compute( const real & aT, const real & aP, const real & aU, const real & aDeltaX  );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * Computes the reaction rates dYdt and dTdt for the mass
+             * fractions of the combustion gas, without performing a step
+             * and without the Jacobian. Used by coupled integrators.
+             */
+            void
+            compute_rates( const real & aT, const real & aP );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * same as compute_rates, but also computes the Jacobian,
+             * using the sparse assembly if it is enabled
+             */
+            void
+            compute_rates_and_jacobi( const real & aT, const real & aP );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * temperature change due to reaction, after compute_rates
+             */
+            inline const real &
+            dTdt() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * Jacobian of dYdt and dTdt with respect to the mass fractions
+             * of the reacting species and the temperature,
+             * after compute_rates_and_jacobi
+             */
+            inline const Matrix< real > &
+            jacobi() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * Switch to the sparse Jacobian. The pattern is created from
+             * the species of each reaction and decomposed symbolically
+             * once. If the sparse decomposition runs into a small pivot,
+             * the dense solver is used for this step.
+             */
+            void
+            use_sparse_jacobian( const bool aSwitch );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * The reactions are evaluated by the compiled Mechanism by
+             * default. Switching it off evaluates each Reaction object,
+             * which is slower but useful for comparison.
+             */
+            void
+            use_compiled_mechanism( const bool aSwitch );
+
 //------------------------------------------------------------------------------
 
             /**
@@ -216,6 +302,16 @@ namespace belfem
 
 //------------------------------------------------------------------------------
         private:
+//------------------------------------------------------------------------------
+
+            // copy constructor for clone
+            Scheme( const Scheme & aScheme );
+
+//------------------------------------------------------------------------------
+
+            void
+            allocate_containers();
+
 //------------------------------------------------------------------------------
 
             void
@@ -250,6 +346,24 @@ namespace belfem
             void
             compute_jacobi( const real & aT, const real & aP );
 
+            void
+            compute_sparse_jacobi( const real & aT, const real & aP );
+
+            // source terms only, without the Jacobian
+            void
+            compute_source_terms( const real & aT, const real & aP );
+
+            // temperature change from the source terms
+            void
+            compute_temperature_rate();
+
+            void
+            create_sparse_jacobian();
+
+            // solve ( I - c1 * J ) * LHS = RHS
+            void
+            solve_sparse();
+
             void
             compute_rhs( const real & aT, const real & aP, const real & aU, const real & aDeltaX  );
 
@@ -317,6 +431,22 @@ namespace belfem
             return mdYdt;
         }
 
+//------------------------------------------------------------------------------
+
+        inline const real &
+        Scheme::dTdt() const
+        {
+            return mdTdt ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Matrix< real > &
+        Scheme::jacobi() const
+        {
+            return mJacobi ;
+        }
+
 //------------------------------------------------------------------------------
 
         const real &
@@ -0,0 +1,247 @@
+//
+// Created on 16.10.26.
+//
+
+#include "cl_CN_SparseJacobian.hpp"
+#include "assert.hpp"
+
+namespace belfem
+{
+    namespace combustion
+    {
+//------------------------------------------------------------------------------
+
+        SparseJacobian::SparseJacobian( const uint aSize ) :
+            mSize( aSize )
+        {
+            // during setup, the position container is used as flag
+            mPositions.set_size( mSize * mSize, 0 );
+
+            // the diagonal is always needed
+            for( uint k=0; k<mSize; ++k )
+            {
+                mPositions( k * mSize + k ) = 1 ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::add_block( const Vector< uint > & aRows, const Vector< uint > & aColumns )
+        {
+            BELFEM_ASSERT( ! mIsFinalized, "can not change the pattern after finalize()" );
+
+            for( uint i=0; i<aRows.length(); ++i )
+            {
+                for( uint j=0; j<aColumns.length(); ++j )
+                {
+                    mPositions( aRows( i ) * mSize + aColumns( j ) ) = 1 ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::add_row( const uint aRow )
+        {
+            BELFEM_ASSERT( ! mIsFinalized, "can not change the pattern after finalize()" );
+
+            for( uint j=0; j<mSize; ++j )
+            {
+                mPositions( aRow * mSize + j ) = 1 ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::add_column( const uint aColumn )
+        {
+            BELFEM_ASSERT( ! mIsFinalized, "can not change the pattern after finalize()" );
+
+            for( uint i=0; i<mSize; ++i )
+            {
+                mPositions( i * mSize + aColumn ) = 1 ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::finalize()
+        {
+            BELFEM_ERROR( ! mIsFinalized, "pattern has already been finalized" );
+
+            // symbolic decomposition: eliminating row k
+            // creates fill-in in each row i that depends on k
+            for( uint k=0; k<mSize; ++k )
+            {
+                for( uint i=k+1; i<mSize; ++i )
+                {
+                    if( mPositions( i * mSize + k ) != 0 )
+                    {
+                        for( uint j=k+1; j<mSize; ++j )
+                        {
+                            if( mPositions( k * mSize + j ) != 0 )
+                            {
+                                mPositions( i * mSize + j ) = 1 ;
+                            }
+                        }
+                    }
+                }
+            }
+
+            // count nonzeros
+            uint tCount = 0 ;
+            for( uint k=0; k<mSize * mSize; ++k )
+            {
+                if( mPositions( k ) != 0 )
+                {
+                    ++tCount ;
+                }
+            }
+
+            mRowPointers.set_size( mSize + 1 );
+            mColumns.set_size( tCount );
+            mDiagonal.set_size( mSize );
+            mValues.set_size( tCount, 0.0 );
+            mWork.set_size( mSize, 0.0 );
+
+            // create compressed rows, columns are sorted
+            tCount = 0 ;
+            for( uint i=0; i<mSize; ++i )
+            {
+                mRowPointers( i ) = tCount ;
+
+                for( uint j=0; j<mSize; ++j )
+                {
+                    uint & tPosition = mPositions( i * mSize + j );
+
+                    if( tPosition != 0 )
+                    {
+                        if( i == j )
+                        {
+                            mDiagonal( i ) = tCount ;
+                        }
+
+                        mColumns( tCount ) = j ;
+                        tPosition = tCount++ ;
+                    }
+                    else
+                    {
+                        tPosition = BELFEM_UINT_MAX ;
+                    }
+                }
+            }
+            mRowPointers( mSize ) = tCount ;
+
+            mIsFinalized = true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::to_dense( Matrix< real > & aMatrix ) const
+        {
+            aMatrix.set_size( mSize, mSize, 0.0 );
+
+            for( uint i=0; i<mSize; ++i )
+            {
+                for( uint p=mRowPointers( i ); p<mRowPointers( i + 1 ); ++p )
+                {
+                    aMatrix( i, mColumns( p ) ) = mValues( p );
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        SparseJacobian::factorize()
+        {
+            BELFEM_ASSERT( mIsFinalized, "pattern has not been finalized" );
+
+            for( uint i=0; i<mSize; ++i )
+            {
+                const uint tFirst = mRowPointers( i );
+                const uint tLast  = mRowPointers( i + 1 );
+
+                real tNorm = 0.0 ;
+
+                // scatter row into work vector
+                for( uint p=tFirst; p<tLast; ++p )
+                {
+                    mWork( mColumns( p ) ) = mValues( p );
+                    tNorm = std::max( tNorm, std::abs( mValues( p ) ) );
+                }
+
+                // eliminate the lower part, the columns are sorted,
+                // so each row k is applied after all its dependencies.
+                // Since the fill-in is part of the pattern, all updated
+                // entries are within the row.
+                for( uint p=tFirst; p<mDiagonal( i ); ++p )
+                {
+                    const uint k = mColumns( p );
+
+                    const real tL = mWork( k ) / mValues( mDiagonal( k ) );
+                    mWork( k ) = tL ;
+
+                    for( uint q=mDiagonal( k ) + 1; q<mRowPointers( k + 1 ); ++q )
+                    {
+                        mWork( mColumns( q ) ) -= tL * mValues( q );
+                    }
+                }
+
+                // gather
+                for( uint p=tFirst; p<tLast; ++p )
+                {
+                    mValues( p ) = mWork( mColumns( p ) );
+                }
+
+                if( std::abs( mValues( mDiagonal( i ) ) ) <= BELFEM_EPSILON * tNorm )
+                {
+                    return false ;
+                }
+            }
+
+            return true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        SparseJacobian::solve( Vector< real > & aX ) const
+        {
+            // forward substitution, L has a unit diagonal
+            for( uint i=0; i<mSize; ++i )
+            {
+                real tValue = aX( i );
+
+                for( uint p=mRowPointers( i ); p<mDiagonal( i ); ++p )
+                {
+                    tValue -= mValues( p ) * aX( mColumns( p ) );
+                }
+
+                aX( i ) = tValue ;
+            }
+
+            // backward substitution
+            for( uint i=mSize; i>0; --i )
+            {
+                const uint r = i - 1 ;
+
+                real tValue = aX( r );
+
+                for( uint p=mDiagonal( r ) + 1; p<mRowPointers( i ); ++p )
+                {
+                    tValue -= mValues( p ) * aX( mColumns( p ) );
+                }
+
+                aX( r ) = tValue / mValues( mDiagonal( r ) );
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,222 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_CN_SPARSEJACOBIAN_HPP
+#define BELFEM_CL_CN_SPARSEJACOBIAN_HPP
+
+#include "typedefs.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+
+namespace belfem
+{
+    namespace combustion
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Sparse matrix for the chemistry Jacobian with a fixed pattern.
+         *
+         * The pattern is built once from the species of each reaction.
+         * finalize() performs the symbolic LU decomposition, so that
+         * the pattern already contains all fill-in entries. Afterwards,
+         * the values are scattered directly into the compressed rows,
+         * and the numeric decomposition and the solve work in place
+         * without allocating memory.
+         *
+         * The decomposition does not pivot. The matrix of the implicit
+         * step is I - c * J, which is dominated by its diagonal for
+         * reasonable step sizes. If a pivot becomes too small,
+         * factorize() returns false and the caller falls back
+         * to the dense solver.
+         */
+        class SparseJacobian
+        {
+            // dimension of matrix
+            const uint mSize ;
+
+            // position of each entry in the value container,
+            // BELFEM_UINT_MAX if the entry is not in the pattern
+            Vector< uint > mPositions ;
+
+            // compressed rows
+            Vector< uint > mRowPointers ;
+            Vector< uint > mColumns ;
+            Vector< uint > mDiagonal ;
+
+            Vector< real > mValues ;
+
+            // work vector for the numeric decomposition
+            Vector< real > mWork ;
+
+            bool mIsFinalized = false ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            SparseJacobian( const uint aSize );
+
+//------------------------------------------------------------------------------
+
+            ~SparseJacobian() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add the entries aRows x aColumns to the pattern
+             */
+            void
+            add_block( const Vector< uint > & aRows, const Vector< uint > & aColumns );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add a full row to the pattern
+             */
+            void
+            add_row( const uint aRow );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * add a full column to the pattern
+             */
+            void
+            add_column( const uint aColumn );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * compute the fill-in and create the compressed rows
+             */
+            void
+            finalize();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * position of an entry in the value container
+             */
+            inline uint
+            position( const uint aRow, const uint aColumn ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            size() const ;
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            number_of_nonzeros() const ;
+
+//------------------------------------------------------------------------------
+
+            inline Vector< real > &
+            values() ;
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< uint > &
+            row_pointers() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< uint > &
+            columns() const ;
+
+//------------------------------------------------------------------------------
+
+            inline uint
+            diagonal( const uint aRow ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * copy the values into a dense matrix
+             */
+            void
+            to_dense( Matrix< real > & aMatrix ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * numeric LU decomposition in place,
+             * returns false if a pivot is too small
+             */
+            bool
+            factorize();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * solve the system after factorize(), overwrites aX
+             */
+            void
+            solve( Vector< real > & aX ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        SparseJacobian::position( const uint aRow, const uint aColumn ) const
+        {
+            return mPositions( aRow * mSize + aColumn );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        SparseJacobian::size() const
+        {
+            return mSize ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        SparseJacobian::number_of_nonzeros() const
+        {
+            return mValues.length() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline Vector< real > &
+        SparseJacobian::values()
+        {
+            return mValues ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< uint > &
+        SparseJacobian::row_pointers() const
+        {
+            return mRowPointers ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< uint > &
+        SparseJacobian::columns() const
+        {
+            return mColumns ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline uint
+        SparseJacobian::diagonal( const uint aRow ) const
+        {
+            return mDiagonal( aRow );
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_CN_SPARSEJACOBIAN_HPP
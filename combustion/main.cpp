@@ -3,9 +3,11 @@
 //
 
 #include <iostream>
+#include <cmath>
 
 #include "typedefs.hpp"
 #include "constants.hpp"
+#include "assert.hpp"
 #include "cl_Communicator.hpp"
 #include "cl_Logger.hpp"
 #include "cl_Timer.hpp"
@@ -13,6 +15,7 @@
 #include "cl_Vector.hpp"
 #include "fn_linspace.hpp"
 #include "fn_r2.hpp"
+#include "fn_gesv.hpp"
 
 #include "cl_Spline.hpp"
 #include "cl_SpMatrix.hpp"
@@ -39,6 +42,175 @@ using namespace combustion;
 Communicator gComm;
 Logger       gLog( 3 );
 
+//------------------------------------------------------------------------------
+
+/**
+ * the sparse assembly must give the same Jacobian as the dense one
+ */
+void
+test_sparse_jacobian( Scheme & aScheme, const real aT, const real aP )
+{
+    aScheme.use_sparse_jacobian( false );
+    aScheme.compute_rates_and_jacobi( aT, aP );
+    Matrix< real > tDense = aScheme.jacobi() ;
+
+    aScheme.use_sparse_jacobian( true );
+    aScheme.compute_rates_and_jacobi( aT, aP );
+    const Matrix< real > & tSparse = aScheme.jacobi() ;
+
+    aScheme.use_sparse_jacobian( false );
+
+    BELFEM_ERROR( tDense.n_rows() == tSparse.n_rows() && tDense.n_cols() == tSparse.n_cols(),
+                  "size of sparse Jacobian does not match" );
+
+    for( uint i=0; i<tDense.n_rows(); ++i )
+    {
+        // errors are measured against the largest entry of the row
+        real tScale = 0.0 ;
+        for( uint j=0; j<tDense.n_cols(); ++j )
+        {
+            tScale = std::max( tScale, std::abs( tDense( i, j ) ) );
+        }
+
+        for( uint j=0; j<tDense.n_cols(); ++j )
+        {
+            BELFEM_ERROR( std::abs( tSparse( i, j ) - tDense( i, j ) ) <= 1e-10 * tScale,
+                          "sparse Jacobian differs at ( %u, %u ): %g vs %g",
+                          ( unsigned int ) i, ( unsigned int ) j,
+                          ( double ) tSparse( i, j ), ( double ) tDense( i, j ) );
+        }
+    }
+
+    std::cout << "sparse Jacobian: PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * Scheme::solve_sparse must give the same solution of ( I - c1 J ) x = b
+ * as gesv on the dense matrix. If aExpectFallback is set, c1 is chosen
+ * such that the first pivot vanishes, so that the dense fallback is used.
+ */
+void
+test_sparse_solve( Scheme & aScheme, const real aT, const real aP, real aC1, const bool aExpectFallback )
+{
+    aScheme.use_sparse_jacobian( true );
+    aScheme.compute_rates_and_jacobi( aT, aP );
+
+    SparseJacobian * tSparse = aScheme.mSparseJacobian ;
+    Vector< real > & tValues = tSparse->values() ;
+
+    const uint tN = tSparse->size() ;
+
+    if( aExpectFallback )
+    {
+        // 1 - c1 * J( 0, 0 ) must be exactly zero, as computed by solve_sparse
+        const real tJ00 = tValues( tSparse->diagonal( 0 ) );
+        aC1 = 1.0 / tJ00 ;
+
+        for( real tC1 : { aC1, std::nextafter( aC1, 0.0 ), std::nextafter( aC1, 2.0 * aC1 ) } )
+        {
+            if( tJ00 * ( - tC1 ) + 1.0 == 0.0 )
+            {
+                aC1 = tC1 ;
+                break ;
+            }
+        }
+    }
+
+    // dense reference
+    Matrix< real > tW = aScheme.jacobi() ;
+    tW *= - aC1 ;
+    for( uint k=0; k<tN; ++k )
+    {
+        tW( k, k ) += 1.0 ;
+    }
+
+    Vector< real > tB( tN );
+    for( uint k=0; k<tN; ++k )
+    {
+        tB( k ) = 1.0 + 0.1 * ( real ) k ;
+    }
+
+    Vector< real > tX = tB ;
+    Vector< int > tPivot( tN );
+    gesv( tW, tX, tPivot );
+
+    // check which path solve_sparse takes, on a copy of the values
+    Vector< real > tJacobi = tValues ;
+    tValues *= - aC1 ;
+    for( uint k=0; k<tN; ++k )
+    {
+        tValues( tSparse->diagonal( k ) ) += 1.0 ;
+    }
+    const bool tFallback = ! tSparse->factorize() ;
+    tValues = tJacobi ;
+
+    BELFEM_ERROR( tFallback == aExpectFallback,
+                  aExpectFallback ? "sparse decomposition did not run into the small pivot"
+                                  : "sparse decomposition fell back to the dense solver" );
+
+    aScheme.mC1 = aC1 ;
+    aScheme.mRHS = tB ;
+    aScheme.solve_sparse() ;
+
+    real tScale = 0.0 ;
+    for( uint k=0; k<tN; ++k )
+    {
+        tScale = std::max( tScale, std::abs( tX( k ) ) );
+    }
+
+    for( uint k=0; k<tN; ++k )
+    {
+        BELFEM_ERROR( std::abs( aScheme.mLHS( k ) - tX( k ) ) <= 1e-10 * tScale,
+                      "sparse solution differs at %u: %g vs %g",
+                      ( unsigned int ) k, ( double ) aScheme.mLHS( k ), ( double ) tX( k ) );
+    }
+
+    aScheme.use_sparse_jacobian( false );
+
+    std::cout << "sparse solve" << ( aExpectFallback ? " with pivot fallback" : "" ) << ": PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * the compiled mechanism must give the same rates as the reaction objects
+ */
+void
+test_compiled_mechanism( Scheme & aScheme, const real aT, const real aP )
+{
+    aScheme.use_compiled_mechanism( false );
+    aScheme.compute_rates( aT, aP );
+    Vector< real > tdYdt = aScheme.dYdt() ;
+    real tdTdt = aScheme.dTdt() ;
+
+    aScheme.use_compiled_mechanism( true );
+    aScheme.compute_rates( aT, aP );
+
+    real tScale = 0.0 ;
+    for( uint k=0; k<tdYdt.length(); ++k )
+    {
+        tScale = std::max( tScale, std::abs( tdYdt( k ) ) );
+    }
+
+    for( uint k=0; k<tdYdt.length(); ++k )
+    {
+        BELFEM_ERROR( std::abs( aScheme.dYdt( k ) - tdYdt( k ) ) <= 1e-10 * tScale,
+                      "compiled mechanism differs for species %u: %g vs %g",
+                      ( unsigned int ) k,
+                      ( double ) aScheme.dYdt( k ), ( double ) tdYdt( k ) );
+    }
+
+    BELFEM_ERROR( std::abs( aScheme.dTdt() - tdTdt ) <= 1e-10 * std::abs( tdTdt ),
+                  "compiled mechanism differs for dTdt: %g vs %g",
+                  ( double ) aScheme.dTdt(), ( double ) tdTdt );
+
+    std::cout << "compiled mechanism: PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
 int main( int    argc,
           char * argv[] )
 {
@@ -73,6 +245,10 @@ int main( int    argc,
 
     tScheme.combgas()->remix( tX );
 
+    test_compiled_mechanism( tScheme, tT, tP );
+    test_sparse_jacobian( tScheme, tT, tP );
+    test_sparse_solve( tScheme, tT, tP, 1e-5, false );
+    test_sparse_solve( tScheme, tT, tP, 0.0, true );
 
     std::cout << "Running ... "<< std::endl;
     Timer tTimer;
@@ -20,7 +20,6 @@
 #include "cl_Timer.hpp"
 
 #include "../../src/fem/bspline/cl_TableGas.hpp"
-#include "../../src/fem/bspline/cl_GM_EoS_TableGas.hpp"
 #include "cl_Atmosphere.hpp"
 
 using namespace belfem;
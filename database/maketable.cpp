@@ -0,0 +1,52 @@
+//
+// Converts a lookup table that has been created by the bspline::Mapper
+// into the binary format that can be mapped into memory.
+//
+// usage: maketable hotair.hdf5 [hotair.bst]
+//
+#include <iostream>
+
+#include "typedefs.hpp"
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "commtools.hpp"
+#include "cl_Mesh.hpp"
+#include "cl_Timer.hpp"
+#include "../../src/fem/bspline/cl_BS_FlatTable.hpp"
+
+using namespace belfem;
+using namespace bspline;
+
+Communicator gComm;
+Logger       gLog( 5 );
+
+
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm.init( argc, argv );
+
+    BELFEM_ERROR( argc > 1, "usage: maketable <table.hdf5> [table.bst]" );
+
+    string tInput = argv[ 1 ];
+
+    string tOutput = argc > 2 ? string( argv[ 2 ] ) : FlatTable::cache_path( tInput );
+
+    Timer tTimer;
+
+    // read the mesh
+    Mesh tMesh( tInput, comm_rank(), false );
+
+    // compile the table
+    FlatTable tTable( tMesh );
+
+    tTable.save( tOutput, tInput );
+
+    std::cout << "    wrote " << tOutput << " with "
+              << tTable.number_of_fields() << " fields" << std::endl;
+
+    std::cout << "    Time for converting table: " << tTimer.stop() << std::endl;
+
+    return gComm.finalize();
+}
@@ -2,6 +2,9 @@
 // Created by Christian Messe on 31.08.20.
 //
 
+#include <thread>
+#include <stdexcept>
+
 #include "cl_EN_Analysis.hpp"
 #include "assert.hpp"
 #include "fn_gesv.hpp"
@@ -61,6 +64,36 @@ namespace belfem
             }
         }
 
+//------------------------------------------------------------------------------
+
+        Analysis *
+        Analysis::clone() const
+        {
+            Analysis * tClone = new Analysis( mParams );
+
+            // copy the computed states
+            tClone->mInjector.copy_values( mInjector );
+            tClone->mTotal.copy_values( mTotal );
+            tClone->mThroat.copy_values( mThroat );
+            tClone->mNozzle.copy_values( mNozzle );
+
+            // copy the performance parameters
+            tClone->mOF       = mOF ;
+            tClone->mPambient = mPambient ;
+            tClone->mDotM     = mDotM ;
+            tClone->mCF       = mCF ;
+            tClone->mCstar    = mCstar ;
+            tClone->mISPref   = mISPref ;
+            tClone->mISPsl    = mISPsl ;
+            tClone->mISPvac   = mISPvac ;
+            tClone->mF        = mF ;
+
+            // the combustion gas gets the current composition
+            tClone->mCombgas->remix( mCombgas->molar_fractions(), true, true );
+
+            return tClone ;
+        }
+
 //------------------------------------------------------------------------------
 
         real
@@ -119,10 +152,19 @@ namespace belfem
             // take the one from the parameters
             real tOF = aOF == 0.0 ? mParams.mixture_ratio() : aOF ;
 
+            this->compute( tOF, mParams.chamber_pressure() );
 
-            this->compute_injector( tOF, mParams.chamber_pressure() );
+            return this->isp( aMode );
+        }
+
+//------------------------------------------------------------------------------
 
-            this->compute_total();
+        void
+        Analysis::compute( const real aOF, const real aP, const real aT0 )
+        {
+            this->compute_injector( aOF, aP );
+
+            this->compute_total( aT0 );
 
             this->compute_throat();
 
@@ -139,8 +181,13 @@ namespace belfem
             mPambient = mNozzle.p() ;
 
             this->compute_performance();
+        }
 
+//------------------------------------------------------------------------------
 
+        real
+        Analysis::isp( const IspMode aMode ) const
+        {
             switch( aMode )
             {
                 case( IspMode::Sealevel ) :
@@ -621,6 +668,9 @@ namespace belfem
 
             // thrust coefficient
             mCF = mF / ( mTotal.p() * mThroat.A() );
+
+            // characteristic velocity
+            mCstar = mTotal.p() * mThroat.A() / mDotM ;
         }
 
 //------------------------------------------------------------------------------
@@ -630,23 +680,25 @@ namespace belfem
                 const real & aOFmax,
                 const IspMode aMode )
         {
-            // do a stepwise search
+            mNumberOfEvaluations = 0 ;
+
+            // coarse scan
             uint tNumSteps = 5 ;
 
             Vector< real > tOF( tNumSteps );
             Vector< real > tISP( tNumSteps );
+            Vector< real > tT( tNumSteps );
 
             linspace( aOFmin, aOFmax, tNumSteps, tOF );
 
+            this->scan_mixtures( tOF, aMode, tISP, tT );
+
             real tISPmax = 0.0;
             uint tK = BELFEM_UINT_MAX;
 
             for ( uint k = 0; k < tNumSteps; ++k )
             {
-                // perform analysis
-                tISP( k ) = this->run( tOF( k ), aMode );
-
-                // remember best value
+                // remember best value, failed points are NaN
                 if ( tISP( k ) > tISPmax )
                 {
                     tK = k;
@@ -654,37 +706,234 @@ namespace belfem
                 }
             }
 
-            // initial values
+            BELFEM_ERROR( tK < tNumSteps, "Failed to compute any point of the mixture scan" );
+
+            // Brent's method on -Isp, see Numerical Recipes, Ch. 10.3
+            const real tGold = 0.5 * ( 3.0 - std::sqrt( 5.0 ) );
+            const real tTol  = 1e-5 ;
+
+            // bracket
+            real tA = tK > 0 ? tOF( tK-1 ) : tOF( 0 );
+            real tB = tK < tNumSteps-1 ? tOF( tK+1 ) : tOF( tNumSteps-1 );
 
-            real tA = tK > 1 ? tOF( tK-1 ) : tOF( 0 );
-            real tB = tK < tNumSteps-3 ? tOF( tK+1 ) : tOF( tNumSteps-1 );
+            // best, second best and previous second best point
+            real tX  = tOF( tK );
+            real tW  = tX ;
+            real tV  = tX ;
+            real tFx = -tISPmax ;
+            real tFw = tFx ;
+            real tFv = tFx ;
 
-            // function values
-            real tFa = ( this->run( 1.05 * tA ) - this->run( 0.95 * tA ) ) / ( 0.1 * tA );
-            //real tFb = ( this->run( 1.05 * tB ) - this->run( 0.95 * tB ) ) / ( 0.1 * tB );
+            // step and step before last
+            real tD = 0.0 ;
+            real tE = 0.0 ;
 
-            real tF = BELFEM_REAL_MAX ;
-            real aOF ;
-            uint tCount = 4 + tNumSteps ;
-            while( std::abs( tF ) > 1e-7 )
+            // initial guess for the equilibrium
+            real tT0 = tT( tK );
+
+            // last evaluated point, the state of the scan may belong to another one
+            real tU  = BELFEM_QUIET_NAN ;
+
+            for( uint tCount=0; tCount<100; ++tCount )
             {
-                aOF = 0.5 * ( tA + tB );
+                real tXm   = 0.5 * ( tA + tB );
+                real tTol1 = tTol * std::abs( tX ) + 1e-10 ;
+                real tTol2 = 2.0 * tTol1 ;
+
+                if( std::abs( tX - tXm ) <= tTol2 - 0.5 * ( tB - tA ) )
+                {
+                    break ;
+                }
+
+                bool tGolden = true ;
+
+                if( std::abs( tE ) > tTol1 )
+                {
+                    // parabola through x, v and w
+                    real tR = ( tX - tW ) * ( tFx - tFv );
+                    real tQ = ( tX - tV ) * ( tFx - tFw );
+                    real tP = ( tX - tV ) * tQ - ( tX - tW ) * tR ;
+                    tQ = 2.0 * ( tQ - tR );
+                    if( tQ > 0.0 )
+                    {
+                        tP = -tP ;
+                    }
+                    tQ = std::abs( tQ );
+
+                    real tEtemp = tE ;
+                    tE = tD ;
+
+                    // accept the parabolic step if it is inside the
+                    // bracket and smaller than half the step before last
+                    if( std::abs( tP ) < std::abs( 0.5 * tQ * tEtemp )
+                        && tP > tQ * ( tA - tX ) && tP < tQ * ( tB - tX ) )
+                    {
+                        tD = tP / tQ ;
+                        tU = tX + tD ;
+                        if( tU - tA < tTol2 || tB - tU < tTol2 )
+                        {
+                            tD = tXm >= tX ? tTol1 : -tTol1 ;
+                        }
+                        tGolden = false ;
+                    }
+                }
+
+                if( tGolden )
+                {
+                    tE = tX >= tXm ? tA - tX : tB - tX ;
+                    tD = tGold * tE ;
+                }
+
+                tU = std::abs( tD ) >= tTol1 ? tX + tD : tX + ( tD > 0 ? tTol1 : -tTol1 );
 
-                tF =  ( this->run( 1.05 * aOF, aMode ) - this->run( 0.95 * aOF, aMode ) ) / ( 0.1 * aOF );
-                if ( tF * tFa > 0 )
+                real tFu = -this->evaluate_mixture( tU, aMode, tT0 );
+
+                if( tFu <= tFx )
                 {
-                    tA = aOF;
-                    tFa = tF;
+                    if( tU >= tX )
+                    {
+                        tA = tX ;
+                    }
+                    else
+                    {
+                        tB = tX ;
+                    }
+                    tV  = tW ;
+                    tFv = tFw ;
+                    tW  = tX ;
+                    tFw = tFx ;
+                    tX  = tU ;
+                    tFx = tFu ;
                 }
                 else
                 {
-                    tB = aOF;
-                    //tFb = tF;
+                    if( tU < tX )
+                    {
+                        tA = tU ;
+                    }
+                    else
+                    {
+                        tB = tU ;
+                    }
+                    if( tFu <= tFw || tW == tX )
+                    {
+                        tV  = tW ;
+                        tFv = tFw ;
+                        tW  = tU ;
+                        tFw = tFu ;
+                    }
+                    else if( tFu <= tFv || tV == tX || tV == tW )
+                    {
+                        tV  = tU ;
+                        tFv = tFu ;
+                    }
                 }
-                tCount += 2 ;
+
+                BELFEM_ERROR( tCount < 99, "Failed to find the best mixture ratio" );
             }
 
-            return aOF ;
+            // make sure that the state belongs to the returned mixture
+            if( tU != tX )
+            {
+                this->evaluate_mixture( tX, aMode, tT0 );
+            }
+
+            return tX ;
+        }
+
+//------------------------------------------------------------------------------
+
+        real
+        Analysis::evaluate_mixture( const real aOF, const IspMode aMode, real & aT0 )
+        {
+            this->compute( aOF, mParams.chamber_pressure(), aT0 );
+
+            ++mNumberOfEvaluations ;
+
+            // warm start for the next point
+            aT0 = mTotal.T() ;
+
+            return this->isp( aMode );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Analysis::scan_mixtures(
+                const Vector< real > & aOF,
+                const IspMode          aMode,
+                      Vector< real > & aISP,
+                      Vector< real > & aT )
+        {
+            uint tNumberOfPoints = aOF.length() ;
+
+            uint tNumberOfThreads = std::min( std::max( std::thread::hardware_concurrency(), ( uint ) 1 ),
+                                              tNumberOfPoints );
+
+            if( tNumberOfThreads < 2 )
+            {
+                this->scan_worker( aOF, aMode, aISP, aT, 0, 1 );
+            }
+            else
+            {
+                // one worker per thread, freed after the scan
+                Cell< Analysis * > tWorkers( tNumberOfThreads - 1, nullptr );
+
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads - 1 );
+
+                for( uint t=1; t<tNumberOfThreads; ++t )
+                {
+                    tWorkers( t-1 ) = this->clone() ;
+                    tThreads.emplace_back( &Analysis::scan_worker, tWorkers( t-1 ),
+                                           std::cref( aOF ), aMode, std::ref( aISP ), std::ref( aT ),
+                                           t, tNumberOfThreads );
+                }
+
+                // this analysis computes the first point
+                this->scan_worker( aOF, aMode, aISP, aT, 0, tNumberOfThreads );
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+
+                for( Analysis * tWorker : tWorkers )
+                {
+                    mNumberOfEvaluations += tWorker->mNumberOfEvaluations ;
+                    delete tWorker ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        Analysis::scan_worker(
+                const Vector< real > & aOF,
+                const IspMode          aMode,
+                      Vector< real > & aISP,
+                      Vector< real > & aT,
+                const uint             aFirst,
+                const uint             aStride )
+        {
+            real tT0 = 2000.0 ;
+
+            for( uint k=aFirst; k<aOF.length(); k+=aStride )
+            {
+                // a point that fails must not end the other threads
+                try
+                {
+                    aISP( k ) = this->evaluate_mixture( aOF( k ), aMode, tT0 );
+                    aT( k ) = tT0 ;
+                }
+                catch( const std::exception & )
+                {
+                    aISP( k ) = BELFEM_QUIET_NAN ;
+                    aT( k ) = BELFEM_QUIET_NAN ;
+                    tT0 = 2000.0 ;
+                }
+            }
         }
 
 //------------------------------------------------------------------------------
@@ -719,6 +968,9 @@ namespace belfem
             std::fprintf( stdout, "         CF  @ p_amb    : %10.3f - \n\n",
                           mCF );
 
+            std::fprintf( stdout, "         c*             : %10.3f m/s \n\n",
+                          mCstar );
+
             std::fprintf( stdout, "         ISP @ p_amb    : %10.3f s \n\n",
                           mISPref );
 
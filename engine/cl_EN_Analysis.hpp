@@ -6,6 +6,7 @@
 #define BELFEM_CL_EN_ANALYSIS_HPP
 
 #include "typedefs.hpp"
+#include "cl_Cell.hpp"
 
 #include "cl_Gas.hpp"
 #include "cl_EN_Parameters.hpp"
@@ -76,6 +77,9 @@ namespace belfem
             // thrust coeffcient
             real mCF = BELFEM_QUIET_NAN ;
 
+            // characteristic velocity
+            real mCstar = BELFEM_QUIET_NAN ;
+
             // ISP
             real mISPref = BELFEM_QUIET_NAN ;
             real mISPsl  = BELFEM_QUIET_NAN ;
@@ -84,6 +88,9 @@ namespace belfem
             // thrust
             real mF   = BELFEM_QUIET_NAN ;
 
+            // number of calls of compute by the last optimization
+            uint mNumberOfEvaluations = 0 ;
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -94,12 +101,43 @@ namespace belfem
 
             ~Analysis() ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * create an independent copy for another thread.
+             * The parameters are shared, the gases are created anew.
+             * The computed states, the performance parameters and the
+             * composition of the combustion gas are copied.
+             */
+            Analysis *
+            clone() const ;
+
 //------------------------------------------------------------------------------
 
             real
             run( const real aOF = 0.0,
                  const IspMode aMode=IspMode::OptimalExpansion ) ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * compute injector, chamber, throat and nozzle for the given
+             * mixture ratio and chamber pressure. aT0 is the initial guess
+             * for the chamber temperature.
+             */
+            void
+            compute( const real aOF,
+                     const real aP,
+                     const real aT0=2000.0 );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * specific impulse of the last computation
+             */
+            real
+            isp( const IspMode aMode ) const ;
+
 //------------------------------------------------------------------------------
 
             real
@@ -180,12 +218,27 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
+            /**
+             * find the mixture ratio with the highest specific impulse.
+             * The interval is scanned in parallel, and the maximum
+             * is refined with Brent's method. Afterwards, the state
+             * corresponds to the returned mixture ratio.
+             */
             real
             find_best_mixture(
                     const real & aOFmin,
                     const real & aOFmax,
                     const IspMode aMode = IspMode::OptimalExpansion );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * number of computed operating points
+             * during the last call of find_best_mixture
+             */
+            const uint &
+            number_of_evaluations() const ;
+
 //------------------------------------------------------------------------------
 
             /**
@@ -214,6 +267,14 @@ namespace belfem
             const real &
             isp_vac_opt() const ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * characteristic velocity of the last computation
+             */
+            const real &
+            cstar() const ;
+
 //------------------------------------------------------------------------------
         private:
 //------------------------------------------------------------------------------
@@ -246,6 +307,33 @@ namespace belfem
             void
             create_initial_mixture( const real & aOF, const real & aP );
 
+//------------------------------------------------------------------------------
+
+            // compute the point and return the specific impulse,
+            // aT0 is updated with the chamber temperature
+            real
+            evaluate_mixture( const real aOF, const IspMode aMode, real & aT0 );
+
+//------------------------------------------------------------------------------
+
+            // evaluate the specific impulse for each mixture ratio in parallel
+            void
+            scan_mixtures( const Vector< real > & aOF,
+                           const IspMode          aMode,
+                                 Vector< real > & aISP,
+                                 Vector< real > & aT );
+
+//------------------------------------------------------------------------------
+
+            // worker: compute the points aFirst, aFirst + aStride, ...
+            void
+            scan_worker( const Vector< real > & aOF,
+                         const IspMode          aMode,
+                               Vector< real > & aISP,
+                               Vector< real > & aT,
+                         const uint             aFirst,
+                         const uint             aStride );
+
 //------------------------------------------------------------------------------
 
             // help function for gas generator mode
@@ -346,6 +434,22 @@ namespace belfem
             return mISPvac ;
         }
 
+//------------------------------------------------------------------------------
+
+        inline const real &
+        Analysis::cstar() const
+        {
+            return mCstar ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const uint &
+        Analysis::number_of_evaluations() const
+        {
+            return mNumberOfEvaluations ;
+        }
+
 //------------------------------------------------------------------------------
     }
 }
@@ -0,0 +1,809 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_EN_GENETICOPTIMIZER_HPP
+#define BELFEM_CL_EN_GENETICOPTIMIZER_HPP
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <stdexcept>
+
+#include "typedefs.hpp"
+#include "assert.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Map.hpp"
+#include "cl_Vector.hpp"
+#include "cl_DNA_old.hpp"
+
+namespace belfem
+{
+    namespace engine
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * the design problem of a GeneticOptimizer.
+         * Each thread uses its own objective, so that the
+         * implementations can keep their own gas and component objects.
+         */
+        template< uint N >
+        class GeneticObjective
+        {
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            GeneticObjective() = default ;
+
+//------------------------------------------------------------------------------
+
+            virtual
+            ~GeneticObjective() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * compute the penalty of a design, smaller is better.
+             * returns false if the design is not feasible
+             */
+            virtual bool
+            compute( const Vector< real > & aValues, real & aFitness ) = 0 ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * Genetic algorithm on DNA< N >, as used for the turbine design.
+         *
+         * In each generation, the best individuals are kept as parents.
+         * Each pair of parents creates a child by single point crossover
+         * and one mutation, until three quarters of the population are
+         * filled. The rest is scattered around the best individual.
+         *
+         * Individuals are evaluated in parallel, one objective per thread.
+         * Genomes that have already been computed are taken from a cache.
+         *
+         * The optimizer draws from its own random number generator, so that
+         * a run with a given seed does not depend on the number of threads.
+         */
+        template< uint N >
+        class GeneticOptimizer
+        {
+            // one objective per thread, not owned
+            Cell< GeneticObjective< N > * > mObjectives ;
+
+            const index_t mNumberOfIndividuals ;
+            const index_t mNumberOfParents ;
+
+            // range of the initial population
+            Vector< real > mLowerBounds ;
+            Vector< real > mUpperBounds ;
+
+            // designs outside of this region are not computed
+            Vector< real > mFeasibleLowerBounds ;
+            Vector< real > mFeasibleUpperBounds ;
+
+            std::mt19937 mRandom ;
+            std::uniform_real_distribution< real > mUniform ;
+
+            Cell< DNA< N > * > mPopulation ;
+
+            // penalties of computed genomes, NaN if not feasible
+            Map< string, real > mCache ;
+            bool mUseCache = true ;
+
+            // stop if the penalty is below this value
+            real mTargetFitness = -BELFEM_REAL_MAX ;
+
+            // stop if the best penalty did not improve by more
+            // than mTolerance within mStagnationLimit generations
+            index_t mStagnationLimit = BELFEM_UINT_MAX ;
+            real mTolerance = 0.0 ;
+
+            // individuals that need to be computed
+            Cell< index_t > mPending ;
+            std::atomic< index_t > mNextPending ;
+
+            Vector< real > mBestValues ;
+            real mBestFitness = BELFEM_REAL_MAX ;
+
+            index_t mNumberOfGenerations = 0 ;
+            index_t mNumberOfEvaluations = 0 ;
+            index_t mNumberOfCacheHits = 0 ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aObjectives          one objective per thread
+             * @param aNumberOfIndividuals size of the population
+             * @param aNumberOfParents     individuals kept in each generation
+             */
+            GeneticOptimizer( Cell< GeneticObjective< N > * > & aObjectives,
+                              const index_t aNumberOfIndividuals,
+                              const index_t aNumberOfParents );
+
+//------------------------------------------------------------------------------
+
+            ~GeneticOptimizer();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * range of the initial population. As in the original turbine
+             * DNA test, a value is drawn as min + ( max - min ) * 2 r1 r2,
+             * with r1 and r2 uniform in [ 0, 1 ). This prefers values near
+             * the lower bound and can reach up to twice the range.
+             * Individuals are not limited to this range, use
+             * set_feasible_region for that.
+             */
+            void
+            set_bounds( const Vector< real > & aLowerBounds,
+                        const Vector< real > & aUpperBounds );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * individuals outside of this region are killed without a
+             * computation. By default, the region is unbounded and the
+             * objective decides what is feasible.
+             */
+            void
+            set_feasible_region( const Vector< real > & aLowerBounds,
+                                 const Vector< real > & aUpperBounds );
+
+//------------------------------------------------------------------------------
+
+            void
+            set_seed( const uint aSeed );
+
+//------------------------------------------------------------------------------
+
+            void
+            use_cache( const bool aSwitch );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * stop as soon as the best penalty is below this value
+             */
+            void
+            set_target_fitness( const real aFitness );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * stop if the best penalty did not improve by more than
+             * aTolerance within aGenerations generations
+             */
+            void
+            set_stagnation_limit( const index_t aGenerations, const real aTolerance=0.0 );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * create a random population and let it evolve,
+             * returns the values of the best individual
+             */
+            const Vector< real > &
+            run( const index_t aMaxNumberOfGenerations );
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< real > &
+            best_values() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const real &
+            best_fitness() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const index_t &
+            number_of_generations() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * number of calls of the objectives during the last run
+             */
+            inline const index_t &
+            number_of_evaluations() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const index_t &
+            number_of_cache_hits() const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // compute all living individuals, returns the number of survivors
+            index_t
+            evaluate();
+
+//------------------------------------------------------------------------------
+
+            // worker: compute pending individuals until none are left
+            void
+            evaluate_worker( GeneticObjective< N > * aObjective );
+
+//------------------------------------------------------------------------------
+
+            // create the next generation from the sorted population
+            void
+            breed( const index_t aNumberOfSurvivors );
+
+//------------------------------------------------------------------------------
+
+            // uniform random number in [ 0, 1 )
+            inline real
+            random();
+
+//------------------------------------------------------------------------------
+
+            void
+            randomize( DNA< N > * aDNA );
+
+//------------------------------------------------------------------------------
+
+            void
+            crossover( const DNA< N > * aMom, const DNA< N > * aDad, DNA< N > * aChild );
+
+//------------------------------------------------------------------------------
+
+            void
+            get_values( const DNA< N > * aDNA, Vector< real > & aValues ) const ;
+
+//------------------------------------------------------------------------------
+
+            string
+            key( const DNA< N > * aDNA ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        GeneticOptimizer< N >::GeneticOptimizer(
+                Cell< GeneticObjective< N > * > & aObjectives,
+                const index_t aNumberOfIndividuals,
+                const index_t aNumberOfParents ) :
+            mNumberOfIndividuals( aNumberOfIndividuals ),
+            mNumberOfParents( aNumberOfParents ),
+            mNextPending( 0 )
+        {
+            BELFEM_ERROR( aObjectives.size() > 0, "at least one objective is needed" );
+            BELFEM_ERROR( aNumberOfParents > 0 && aNumberOfParents < aNumberOfIndividuals,
+                         "number of parents must be between 1 and the number of individuals" );
+
+            for( GeneticObjective< N > * tObjective : aObjectives )
+            {
+                mObjectives.push( tObjective );
+            }
+
+            mPopulation.set_size( mNumberOfIndividuals, nullptr );
+            for( index_t k=0; k<mNumberOfIndividuals; ++k )
+            {
+                mPopulation( k ) = new DNA< N >();
+            }
+
+            mLowerBounds.set_size( N, -BELFEM_REAL_MAX );
+            mUpperBounds.set_size( N, BELFEM_REAL_MAX );
+            mFeasibleLowerBounds.set_size( N, -BELFEM_REAL_MAX );
+            mFeasibleUpperBounds.set_size( N, BELFEM_REAL_MAX );
+            mBestValues.set_size( N, BELFEM_QUIET_NAN );
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        GeneticOptimizer< N >::~GeneticOptimizer()
+        {
+            for( DNA< N > * tDNA : mPopulation )
+            {
+                delete tDNA ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::set_bounds(
+                const Vector< real > & aLowerBounds,
+                const Vector< real > & aUpperBounds )
+        {
+            BELFEM_ERROR( aLowerBounds.length() == N && aUpperBounds.length() == N,
+                         "bounds must have %u entries", ( unsigned int ) N );
+
+            mLowerBounds = aLowerBounds ;
+            mUpperBounds = aUpperBounds ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::set_feasible_region(
+                const Vector< real > & aLowerBounds,
+                const Vector< real > & aUpperBounds )
+        {
+            BELFEM_ERROR( aLowerBounds.length() == N && aUpperBounds.length() == N,
+                         "bounds must have %u entries", ( unsigned int ) N );
+
+            mFeasibleLowerBounds = aLowerBounds ;
+            mFeasibleUpperBounds = aUpperBounds ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::set_seed( const uint aSeed )
+        {
+            mRandom.seed( aSeed );
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::use_cache( const bool aSwitch )
+        {
+            mUseCache = aSwitch ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::set_target_fitness( const real aFitness )
+        {
+            mTargetFitness = aFitness ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::set_stagnation_limit( const index_t aGenerations, const real aTolerance )
+        {
+            mStagnationLimit = aGenerations ;
+            mTolerance = aTolerance ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        const Vector< real > &
+        GeneticOptimizer< N >::run( const index_t aMaxNumberOfGenerations )
+        {
+            mCache.clear() ;
+            mNumberOfGenerations = 0 ;
+            mNumberOfEvaluations = 0 ;
+            mNumberOfCacheHits = 0 ;
+            mBestFitness = BELFEM_REAL_MAX ;
+            mBestValues.fill( BELFEM_QUIET_NAN );
+
+            for( DNA< N > * tDNA : mPopulation )
+            {
+                this->randomize( tDNA );
+            }
+
+            // best penalty at the beginning of the stagnation window
+            real tReference = BELFEM_REAL_MAX ;
+            index_t tStagnation = 0 ;
+
+            for( index_t g=0; g<aMaxNumberOfGenerations; ++g )
+            {
+                index_t tNumberOfSurvivors = this->evaluate() ;
+
+                ++mNumberOfGenerations ;
+
+                if( tNumberOfSurvivors > 0 )
+                {
+                    mBestFitness = mPopulation( 0 )->fitness() ;
+                    this->get_values( mPopulation( 0 ), mBestValues );
+                }
+
+                // early termination
+                if( mBestFitness < mTargetFitness )
+                {
+                    break ;
+                }
+
+                if( tReference - mBestFitness > mTolerance )
+                {
+                    tReference = mBestFitness ;
+                    tStagnation = 0 ;
+                }
+                else if( ++tStagnation >= mStagnationLimit )
+                {
+                    break ;
+                }
+
+                if( g + 1 < aMaxNumberOfGenerations )
+                {
+                    this->breed( tNumberOfSurvivors );
+                }
+            }
+
+            return mBestValues ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        index_t
+        GeneticOptimizer< N >::evaluate()
+        {
+            mPending.clear() ;
+
+            Vector< real > tValues( N );
+
+            for( index_t k=0; k<mNumberOfIndividuals; ++k )
+            {
+                DNA< N > * tDNA = mPopulation( k );
+
+                tDNA->resurrect() ;
+
+                this->get_values( tDNA, tValues );
+
+                // designs outside of the feasible region are not computed
+                bool tInside = true ;
+                for( uint i=0; i<N; ++i )
+                {
+                    if( ! ( tValues( i ) >= mFeasibleLowerBounds( i )
+                         && tValues( i ) <= mFeasibleUpperBounds( i ) ) )
+                    {
+                        tInside = false ;
+                        break ;
+                    }
+                }
+
+                if( ! tInside )
+                {
+                    tDNA->kill() ;
+                    continue ;
+                }
+
+                if( mUseCache )
+                {
+                    string tKey = this->key( tDNA );
+
+                    if( mCache.key_exists( tKey ) )
+                    {
+                        ++mNumberOfCacheHits ;
+
+                        const real & tFitness = mCache( tKey );
+
+                        if( std::isnan( tFitness ) )
+                        {
+                            tDNA->kill() ;
+                        }
+                        else
+                        {
+                            tDNA->set_fitness( tFitness );
+                        }
+                        continue ;
+                    }
+                }
+
+                mPending.push( k );
+            }
+
+            // compute the remaining individuals
+            mNextPending = 0 ;
+
+            index_t tNumberOfThreads = std::min( ( index_t ) mObjectives.size(), ( index_t ) mPending.size() );
+
+            if( tNumberOfThreads < 2 )
+            {
+                this->evaluate_worker( mObjectives( 0 ) );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    tThreads.emplace_back( &GeneticOptimizer< N >::evaluate_worker, this, mObjectives( t ) );
+                }
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
+
+            mNumberOfEvaluations += mPending.size() ;
+
+            // remember the results
+            if( mUseCache )
+            {
+                for( index_t k : mPending )
+                {
+                    DNA< N > * tDNA = mPopulation( k );
+                    mCache[ this->key( tDNA ) ] = tDNA->alive() ? tDNA->fitness() : BELFEM_QUIET_NAN ;
+                }
+            }
+
+            // living individuals first, then by penalty
+            struct
+            {
+                inline bool
+                operator()( const DNA< N > * aA, const DNA< N > * aB )
+                {
+                    if( aA->alive() != aB->alive() )
+                    {
+                        return aA->alive() ;
+                    }
+                    else if( ! aA->alive() )
+                    {
+                        // dead individuals are equivalent
+                        return false ;
+                    }
+                    return aA->fitness() < aB->fitness() ;
+                }
+            } tCompare ;
+
+            sort( mPopulation, tCompare );
+
+            index_t aNumberOfSurvivors = 0 ;
+            for( DNA< N > * tDNA : mPopulation )
+            {
+                if( tDNA->alive() )
+                {
+                    ++aNumberOfSurvivors ;
+                }
+            }
+
+            return aNumberOfSurvivors ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::evaluate_worker( GeneticObjective< N > * aObjective )
+        {
+            Vector< real > tValues( N );
+
+            index_t tNumberOfPending = mPending.size() ;
+
+            for( index_t k = mNextPending++; k<tNumberOfPending; k = mNextPending++ )
+            {
+                DNA< N > * tDNA = mPopulation( mPending( k ) );
+
+                this->get_values( tDNA, tValues );
+
+                real tFitness = BELFEM_QUIET_NAN ;
+                bool tFeasible ;
+
+                // a design that fails must not end the other threads
+                try
+                {
+                    tFeasible = aObjective->compute( tValues, tFitness );
+                }
+                catch( const std::exception & )
+                {
+                    tFeasible = false ;
+                }
+
+                // a NaN penalty would break the ordering of the population
+                if( tFeasible && std::isfinite( tFitness ) )
+                {
+                    tDNA->set_fitness( tFitness );
+                }
+                else
+                {
+                    tDNA->kill() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::breed( const index_t aNumberOfSurvivors )
+        {
+            // nothing survived, start again
+            if( aNumberOfSurvivors == 0 )
+            {
+                for( DNA< N > * tDNA : mPopulation )
+                {
+                    this->randomize( tDNA );
+                }
+                return ;
+            }
+
+            index_t tNumberOfParents = std::min( aNumberOfSurvivors, mNumberOfParents );
+
+            index_t tCount = tNumberOfParents ;
+
+            // each pair of parents creates one child
+            for( index_t j=0; j<tNumberOfParents && tCount<mNumberOfIndividuals; ++j )
+            {
+                for( index_t i=j; i<tNumberOfParents && tCount<mNumberOfIndividuals; ++i )
+                {
+                    this->crossover( mPopulation( j ), mPopulation( i ), mPopulation( tCount++ ) );
+                }
+            }
+
+            // scatter the rest around the best individual
+            tCount = std::min( tCount, index_t( 0.75 * ( real ) mNumberOfIndividuals ) );
+
+            Vector< real > tValues( N );
+
+            for( index_t k=tCount; k<mNumberOfIndividuals; ++k )
+            {
+                for( uint i=0; i<N; ++i )
+                {
+                    tValues( i ) = mBestValues( i )
+                            * ( 1.0 + 0.25 * ( this->random() * this->random() * 4.0 - 1.0 ) );
+                }
+                mPopulation( k )->set_values( tValues );
+                mPopulation( k )->resurrect() ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline real
+        GeneticOptimizer< N >::random()
+        {
+            return mUniform( mRandom );
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::randomize( DNA< N > * aDNA )
+        {
+            Vector< real > tValues( N );
+
+            for( uint i=0; i<N; ++i )
+            {
+                BELFEM_ERROR( mLowerBounds( i ) > -BELFEM_REAL_MAX && mUpperBounds( i ) < BELFEM_REAL_MAX,
+                             "bounds must be set before the run" );
+
+                tValues( i ) = mLowerBounds( i )
+                        + ( mUpperBounds( i ) - mLowerBounds( i ) ) * this->random() * this->random() * 2.0 ;
+            }
+
+            aDNA->set_values( tValues );
+            aDNA->resurrect() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::crossover(
+                const DNA< N > * aMom,
+                const DNA< N > * aDad,
+                      DNA< N > * aChild )
+        {
+            // length of DNA string
+            index_t tNumGenes = aChild->data().size() ;
+
+            // compute split index
+            index_t tSplit = index_t( this->random() * tNumGenes );
+
+            // compute mutation index
+            index_t tMutate = index_t( this->random() * tNumGenes );
+
+            for( index_t k=0; k<tNumGenes; ++k )
+            {
+                if( k < tSplit ? aMom->test( k ) : aDad->test( k ) )
+                {
+                    aChild->set( k );
+                }
+                else
+                {
+                    aChild->reset( k );
+                }
+            }
+
+            // mutate
+            aChild->flip( tMutate );
+
+            aChild->resurrect() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        void
+        GeneticOptimizer< N >::get_values( const DNA< N > * aDNA, Vector< real > & aValues ) const
+        {
+            for( uint i=0; i<N; ++i )
+            {
+                aValues( i ) = aDNA->get_value( i );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        string
+        GeneticOptimizer< N >::key( const DNA< N > * aDNA ) const
+        {
+            index_t tNumGenes = aDNA->data().size() ;
+
+            string aKey( tNumGenes, '0' );
+
+            for( index_t k=0; k<tNumGenes; ++k )
+            {
+                if( aDNA->test( k ) )
+                {
+                    aKey[ k ] = '1' ;
+                }
+            }
+
+            return aKey ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline const Vector< real > &
+        GeneticOptimizer< N >::best_values() const
+        {
+            return mBestValues ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline const real &
+        GeneticOptimizer< N >::best_fitness() const
+        {
+            return mBestFitness ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline const index_t &
+        GeneticOptimizer< N >::number_of_generations() const
+        {
+            return mNumberOfGenerations ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline const index_t &
+        GeneticOptimizer< N >::number_of_evaluations() const
+        {
+            return mNumberOfEvaluations ;
+        }
+
+//------------------------------------------------------------------------------
+
+        template< uint N >
+        inline const index_t &
+        GeneticOptimizer< N >::number_of_cache_hits() const
+        {
+            return mNumberOfCacheHits ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_EN_GENETICOPTIMIZER_HPP
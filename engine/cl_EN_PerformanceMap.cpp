@@ -0,0 +1,308 @@
+//
+// Created on 16.10.26.
+//
+
+#include <thread>
+#include <cmath>
+#include <stdexcept>
+
+#include "assert.hpp"
+#include "cl_HDF5.hpp"
+#include "cl_EN_State.hpp"
+#include "cl_EN_PerformanceMap.hpp"
+
+namespace belfem
+{
+    namespace engine
+    {
+//------------------------------------------------------------------------------
+
+        PerformanceMap::PerformanceMap(
+                const Parameters & aParams,
+                const IspMode aMode,
+                const uint aNumberOfThreads ) :
+            mMode( aMode ),
+            mNextRow( 0 )
+        {
+            uint tNumberOfThreads = aNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : aNumberOfThreads ;
+
+            tNumberOfThreads = std::max( tNumberOfThreads, ( uint ) 1 );
+
+            // the gases are created here, so that
+            // the database is not read in parallel
+            for( uint t=0; t<tNumberOfThreads; ++t )
+            {
+                mWorkers.push( new Analysis( aParams ) );
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        PerformanceMap::PerformanceMap( const string & aPath ) :
+            mMode( IspMode::UNDEFINED ),
+            mNextRow( 0 )
+        {
+            HDF5 tFile( aPath, FileMode::OPEN_RDONLY );
+
+            tFile.load_data( "ChamberPressure", mPressures );
+            tFile.load_data( "MixtureRatio", mMixtureRatios );
+
+            uint tNumberOfFields = static_cast< uint >( MapField::UNDEFINED );
+            mFields.set_size( tNumberOfFields, Matrix< real >() );
+
+            for( uint f=0; f<tNumberOfFields; ++f )
+            {
+                tFile.load_data( this->label( f ), mFields( f ) );
+
+                BELFEM_ERROR( mFields( f ).n_rows() == mPressures.length()
+                           && mFields( f ).n_cols() == mMixtureRatios.length(),
+                              "size of field %s in %s does not match the grid",
+                              this->label( f ).c_str(), aPath.c_str() );
+            }
+
+            tFile.close();
+
+            this->check_grid( mPressures, "ChamberPressure" );
+            this->check_grid( mMixtureRatios, "MixtureRatio" );
+        }
+
+//------------------------------------------------------------------------------
+
+        PerformanceMap::~PerformanceMap()
+        {
+            for( Analysis * tAnalysis : mWorkers )
+            {
+                delete tAnalysis ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        PerformanceMap::compute(
+                const Vector< real > & aPressures,
+                const Vector< real > & aMixtureRatios )
+        {
+            BELFEM_ERROR( mWorkers.size() > 0,
+                         "this map was loaded from a file and can not be computed" );
+
+            this->check_grid( aPressures, "ChamberPressure" );
+            this->check_grid( aMixtureRatios, "MixtureRatio" );
+
+            mPressures     = aPressures ;
+            mMixtureRatios = aMixtureRatios ;
+
+            index_t tNumberOfRows = mPressures.length() ;
+
+            uint tNumberOfFields = static_cast< uint >( MapField::UNDEFINED );
+            mFields.set_size( tNumberOfFields, Matrix< real >() );
+
+            for( Matrix< real > & tField : mFields )
+            {
+                tField.set_size( tNumberOfRows, mMixtureRatios.length(), BELFEM_QUIET_NAN );
+            }
+
+            mNextRow = 0 ;
+
+            index_t tNumberOfThreads = std::min( ( index_t ) mWorkers.size(), tNumberOfRows );
+
+            if( tNumberOfThreads < 2 )
+            {
+                this->compute_rows( mWorkers( 0 ) );
+            }
+            else
+            {
+                std::vector< std::thread > tThreads ;
+                tThreads.reserve( tNumberOfThreads );
+
+                for( index_t t=0; t<tNumberOfThreads; ++t )
+                {
+                    tThreads.emplace_back( &PerformanceMap::compute_rows, this, mWorkers( t ) );
+                }
+
+                for( std::thread & tThread : tThreads )
+                {
+                    tThread.join() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        PerformanceMap::compute_rows( Analysis * aAnalysis )
+        {
+            index_t tNumberOfRows    = mPressures.length() ;
+            index_t tNumberOfColumns = mMixtureRatios.length() ;
+
+            for( index_t i = mNextRow++; i<tNumberOfRows; i = mNextRow++ )
+            {
+                // initial guess for the chamber temperature
+                real tT0 = 2000.0 ;
+
+                for( index_t j=0; j<tNumberOfColumns; ++j )
+                {
+                    // a point that fails must not end the other threads,
+                    // it remains NaN instead
+                    try
+                    {
+                        aAnalysis->compute( mMixtureRatios( j ), mPressures( i ), tT0 );
+                    }
+                    catch( const std::exception & )
+                    {
+                        tT0 = 2000.0 ;
+                        continue ;
+                    }
+
+                    const State * tTotal = aAnalysis->total() ;
+
+                    mFields( static_cast< uint >( MapField::T ) )( i, j )     = tTotal->T() ;
+                    mFields( static_cast< uint >( MapField::Rho ) )( i, j )   = tTotal->rho() ;
+                    mFields( static_cast< uint >( MapField::R ) )( i, j )     = tTotal->value( BELFEM_ENGINE_STATE_R );
+                    mFields( static_cast< uint >( MapField::Gamma ) )( i, j ) = tTotal->gamma() ;
+                    mFields( static_cast< uint >( MapField::Cp ) )( i, j )    = tTotal->value( BELFEM_ENGINE_STATE_CP );
+                    mFields( static_cast< uint >( MapField::Isp ) )( i, j )   = aAnalysis->isp( mMode );
+                    mFields( static_cast< uint >( MapField::Cstar ) )( i, j ) = aAnalysis->cstar() ;
+
+                    // warm start for the next mixture ratio
+                    tT0 = tTotal->T() ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        real
+        PerformanceMap::value( const MapField aField, const real aP, const real aOF ) const
+        {
+            index_t i = this->find_interval( mPressures, aP );
+            index_t j = this->find_interval( mMixtureRatios, aOF );
+
+            real tXi  = ( aP - mPressures( i ) ) / ( mPressures( i + 1 ) - mPressures( i ) );
+            real tEta = ( aOF - mMixtureRatios( j ) ) / ( mMixtureRatios( j + 1 ) - mMixtureRatios( j ) );
+
+            const Matrix< real > & tField = this->field( aField );
+
+            // a point that failed to converge must not be interpolated
+            BELFEM_ERROR( std::isfinite( tField( i, j ) ) && std::isfinite( tField( i, j + 1 ) )
+                       && std::isfinite( tField( i + 1, j ) ) && std::isfinite( tField( i + 1, j + 1 ) ),
+                          "p=%g, OF=%g is next to a point of the map that failed to converge",
+                          ( double ) aP, ( double ) aOF );
+
+            return ( 1.0 - tXi ) * ( ( 1.0 - tEta ) * tField( i, j ) + tEta * tField( i, j + 1 ) )
+                   + tXi * ( ( 1.0 - tEta ) * tField( i + 1, j ) + tEta * tField( i + 1, j + 1 ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        PerformanceMap::save( const string & aPath ) const
+        {
+            HDF5 tFile( aPath, FileMode::NEW );
+
+            tFile.save_data( "ChamberPressure", mPressures );
+            tFile.save_data( "MixtureRatio", mMixtureRatios );
+
+            for( uint f=0; f<mFields.size(); ++f )
+            {
+                tFile.save_data( this->label( f ), mFields( f ) );
+            }
+
+            tFile.close();
+        }
+
+//------------------------------------------------------------------------------
+
+        string
+        PerformanceMap::label( const uint aField ) const
+        {
+            switch( static_cast< MapField >( aField ) )
+            {
+                case( MapField::T ) :
+                {
+                    return "T" ;
+                }
+                case( MapField::Rho ) :
+                {
+                    return "rho" ;
+                }
+                case( MapField::R ) :
+                {
+                    return "R" ;
+                }
+                case( MapField::Gamma ) :
+                {
+                    return "gamma" ;
+                }
+                case( MapField::Cp ) :
+                {
+                    return "cp" ;
+                }
+                case( MapField::Isp ) :
+                {
+                    return "Isp" ;
+                }
+                case( MapField::Cstar ) :
+                {
+                    return "cstar" ;
+                }
+                default:
+                {
+                    BELFEM_ERROR( false, "Invalid field");
+                    return "" ;
+                }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        index_t
+        PerformanceMap::find_interval( const Vector< real > & aGrid, const real aX ) const
+        {
+            index_t tN = aGrid.length() ;
+
+            BELFEM_ERROR( tN > 1, "the map needs at least two points in each direction" );
+
+            BELFEM_ERROR( aX >= aGrid( 0 ) && aX <= aGrid( tN - 1 ),
+                         "value %g is outside of the map ( %g ... %g )",
+                         ( double ) aX, ( double ) aGrid( 0 ), ( double ) aGrid( tN - 1 ) );
+
+            // bisection
+            index_t tLower = 0 ;
+            index_t tUpper = tN - 1 ;
+
+            while( tUpper - tLower > 1 )
+            {
+                index_t tMid = ( tLower + tUpper ) / 2 ;
+
+                if( aX < aGrid( tMid ) )
+                {
+                    tUpper = tMid ;
+                }
+                else
+                {
+                    tLower = tMid ;
+                }
+            }
+
+            return tLower ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        PerformanceMap::check_grid( const Vector< real > & aGrid, const string & aLabel ) const
+        {
+            BELFEM_ERROR( aGrid.length() > 1, "%s needs at least two points", aLabel.c_str() );
+
+            for( index_t k=1; k<aGrid.length(); ++k )
+            {
+                BELFEM_ERROR( aGrid( k ) > aGrid( k - 1 ),
+                              "%s must be strictly increasing", aLabel.c_str() );
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
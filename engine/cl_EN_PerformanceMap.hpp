@@ -0,0 +1,197 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_EN_PERFORMANCEMAP_HPP
+#define BELFEM_CL_EN_PERFORMANCEMAP_HPP
+
+#include <atomic>
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
+
+#include "cl_EN_Parameters.hpp"
+#include "cl_EN_Analysis.hpp"
+
+namespace belfem
+{
+    namespace engine
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * values stored in a performance map,
+         * T, rho, R, gamma and cp refer to the chamber
+         */
+        enum class MapField
+        {
+            T,
+            Rho,
+            R,
+            Gamma,
+            Cp,
+            Isp,
+            Cstar,
+            UNDEFINED
+        };
+
+//------------------------------------------------------------------------------
+
+        /**
+         * Chamber and nozzle performance over a grid of
+         * chamber pressure and mixture ratio.
+         *
+         * Each thread owns an Analysis with its own gases and computes
+         * complete lines of constant pressure. Along a line, the chamber
+         * temperature of the previous mixture ratio is used as initial
+         * guess for the equilibrium. Once computed or loaded, values are
+         * interpolated bilinearly, so that a cycle analysis does not
+         * need to solve the equilibrium again.
+         */
+        class PerformanceMap
+        {
+            IspMode mMode ;
+
+            // one analysis per thread
+            Cell< Analysis * > mWorkers ;
+
+            // chamber pressures in Pa, ascending
+            Vector< real > mPressures ;
+
+            // mixture ratios, ascending
+            Vector< real > mMixtureRatios ;
+
+            // one table per field, rows: pressure, columns: mixture ratio
+            Cell< Matrix< real > > mFields ;
+
+            // next line to be computed
+            std::atomic< index_t > mNextRow ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * @param aParams           fuel, oxidizer and nozzle settings
+             * @param aMode             which specific impulse is stored
+             * @param aNumberOfThreads  0: use all available cores
+             */
+            PerformanceMap( const Parameters & aParams,
+                            const IspMode aMode=IspMode::OptimalExpansion,
+                            const uint aNumberOfThreads=0 );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * load a map that was written by save()
+             */
+            PerformanceMap( const string & aPath );
+
+//------------------------------------------------------------------------------
+
+            ~PerformanceMap();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * compute all combinations of the given values.
+             * Points that fail to converge are set to NaN.
+             */
+            void
+            compute( const Vector< real > & aPressures,
+                     const Vector< real > & aMixtureRatios );
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< real > &
+            pressures() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< real > &
+            mixture_ratios() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * the table of one field
+             */
+            inline const Matrix< real > &
+            field( const MapField aField ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * bilinear interpolation, the point must be inside the map,
+             * and the corners of its cell must have converged
+             */
+            real
+            value( const MapField aField, const real aP, const real aOF ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * write the grid and all fields into an HDF5 file
+             */
+            void
+            save( const string & aPath ) const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // worker: compute lines until none are left
+            void
+            compute_rows( Analysis * aAnalysis );
+
+//------------------------------------------------------------------------------
+
+            // label of the field in the HDF5 file
+            string
+            label( const uint aField ) const ;
+
+//------------------------------------------------------------------------------
+
+            // index of the interval that contains aX
+            index_t
+            find_interval( const Vector< real > & aGrid, const real aX ) const ;
+
+//------------------------------------------------------------------------------
+
+            // checks that the grid is strictly increasing
+            void
+            check_grid( const Vector< real > & aGrid, const string & aLabel ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< real > &
+        PerformanceMap::pressures() const
+        {
+            return mPressures ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< real > &
+        PerformanceMap::mixture_ratios() const
+        {
+            return mMixtureRatios ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Matrix< real > &
+        PerformanceMap::field( const MapField aField ) const
+        {
+            return mFields( static_cast< uint >( aField ) );
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_EN_PERFORMANCEMAP_HPP
@@ -1,10 +1,17 @@
 //
 // Created by Christian Messe on 31.08.20.
 //
+#include <cstdio>
+
 #include "cl_EN_State.hpp"
 #include "cl_EN_Analysis.hpp"
 #include "cl_Gas.hpp"
 #include "cl_Logger.hpp"
+#include "cl_Map.hpp"
+#include "cl_GT_RefGas.hpp"
+#include "constants.hpp"
+#include "GT_globals.hpp"
+#include "fn_gesv.hpp"
 
 namespace belfem
 {
@@ -85,6 +92,425 @@ namespace belfem
             tT = aT ;
             tP = aP ;
 
+            bool tConverged = false ;
+
+            if( mUseNewton && mMolarFractions.length() == mCombgas.number_of_components() )
+            {
+                tConverged = this->solve_hp_equilibrium( tT, aP, aH );
+
+                if( tConverged )
+                {
+                    // set the mixture and recompute the splines
+                    mCombgas.remix( mMolarFractions, true, true );
+
+                    tH  = mCombgas.h( tT, tP );
+                    tCp = mCombgas.cp( tT, tP );
+
+                    // the gas may use other data for the enthalpy than
+                    // the Gibbs energies, in that case, the temperature is
+                    // corrected by the fixed point iteration
+                    tConverged = std::abs( tH - aH ) / tCp < 1e-4 ;
+
+                    if( ! tConverged )
+                    {
+                        std::fprintf( stderr,
+                                      "warning: HP equilibrium of state %s has an enthalpy error of %g K at T = %g K, using the fixed point iteration\n",
+                                      mLabel.c_str(), ( double ) ( std::abs( tH - aH ) / tCp ), ( double ) tT );
+                    }
+                }
+                else
+                {
+                    std::fprintf( stderr,
+                                  "warning: Newton iteration for the HP equilibrium of state %s did not converge, using the fixed point iteration\n",
+                                  mLabel.c_str() );
+                }
+
+                if( ! tConverged )
+                {
+                    ++mNumberOfFallbacks ;
+                }
+            }
+
+            if( ! tConverged )
+            {
+                this->relax_hp_equilibrium( tT, aP, aH );
+            }
+
+            // rember mass fractions
+            mMassFractions  = mCombgas.mass_fractions() ;
+
+            // remember molar fractions
+            mMolarFractions = mCombgas.molar_fractions() ;
+
+            mHasEquilibrium = true ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        State::use_newton_equilibrium( const bool aSwitch )
+        {
+            mUseNewton = aSwitch ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        State::copy_values( const State & aState )
+        {
+            mValues         = aState.mValues ;
+            mMassFractions  = aState.mMassFractions ;
+            mMolarFractions = aState.mMolarFractions ;
+            mHasEquilibrium = aState.mHasEquilibrium ;
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        State::solve_hp_equilibrium( real & aT, const real & aP, const real & aH )
+        {
+            if( mNumberOfElements == 0 )
+            {
+                this->create_element_matrix() ;
+            }
+
+            uint tNumberOfSpecies = mCombgas.number_of_components() ;
+
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+            // element moles per kg of the unburnt mixture
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+
+            const Vector< real > & tX0 = mCombgas.molar_fractions() ;
+
+            real tM0 = 0.0 ;
+            for( uint j=0; j<tNumberOfSpecies; ++j )
+            {
+                tM0 += tX0( j ) * mCombgas.component( j )->M() ;
+            }
+
+            real tMaxB = 0.0 ;
+            for( uint i=0; i<mNumberOfElements; ++i )
+            {
+                mElementMoles( i ) = 0.0 ;
+                for( uint j=0; j<tNumberOfSpecies; ++j )
+                {
+                    mElementMoles( i ) += mElementMatrix( i, j ) * tX0( j );
+                }
+                mElementMoles( i ) /= tM0 ;
+                tMaxB = std::max( tMaxB, mElementMoles( i ) );
+            }
+
+            // elements that are not in the mixture
+            // and species that contain them are ignored
+            uint tNumberOfActiveElements = 0 ;
+            for( uint i=0; i<mNumberOfElements; ++i )
+            {
+                if( mElementMoles( i ) > 1e-12 * tMaxB )
+                {
+                    mActiveElements( tNumberOfActiveElements++ ) = i ;
+                }
+            }
+
+            uint tNumberOfActiveSpecies = 0 ;
+            for( uint j=0; j<tNumberOfSpecies; ++j )
+            {
+                bool tIsActive = true ;
+                for( uint i=0; i<mNumberOfElements; ++i )
+                {
+                    if( mElementMatrix( i, j ) > 0.0 && ! ( mElementMoles( i ) > 1e-12 * tMaxB ) )
+                    {
+                        tIsActive = false ;
+                        break ;
+                    }
+                }
+                if( tIsActive )
+                {
+                    mActiveSpecies( tNumberOfActiveSpecies++ ) = j ;
+                }
+            }
+
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+            // initial composition
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+
+            // total moles per kg
+            real tN = 0.0 ;
+
+            if( mHasEquilibrium )
+            {
+                // warm start from the last equilibrium
+                real tM = 0.0 ;
+                for( uint j=0; j<tNumberOfSpecies; ++j )
+                {
+                    tM += mMolarFractions( j ) * mCombgas.component( j )->M() ;
+                }
+
+                tN = 1.0 / tM ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+                    mLogMoles( j ) = std::log( std::max( mMolarFractions( j ), 1e-12 ) * tN );
+                }
+            }
+
+            if( ! ( tN > 0.0 ) || std::isinf( tN ) )
+            {
+                // Gordon & McBride, Section 2.7, but in mol/kg
+                tN = 1.0 / tM0 ;
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    mLogMoles( mActiveSpecies( s ) ) = std::log( tN / ( real ) tNumberOfActiveSpecies );
+                }
+            }
+
+            // the species enthalpies are shifted by the offsets,
+            // so must be the enthalpy of the unburnt mixture
+            const Vector< real > & tY0 = mCombgas.mass_fractions() ;
+
+            real tH = aH ;
+            for( uint j=0; j<tNumberOfSpecies; ++j )
+            {
+                tH += tY0( j ) * mEnthalpyOffsets( j );
+            }
+
+            real tLogN = std::log( tN );
+            real tLogT = std::log( aT );
+
+            // pressure term
+            const real tLogP = std::log( aP / gastables::gPref );
+
+            // size of the reduced system
+            const uint tL = tNumberOfActiveElements ;
+            const uint tSize = tL + 2 ;
+
+            mJacobian.set_size( tSize, tSize );
+            mRHS.set_size( tSize );
+            mPivot.set_size( tSize );
+
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+            // Newton iteration
+            // - - - - - - - - - - - - - - - - - - - - - - - - -
+
+            for( uint tCount=0; tCount<100; ++tCount )
+            {
+                const real tT = std::exp( tLogT );
+                const real tRT = constant::Rm * tT ;
+                tN = std::exp( tLogN );
+
+                // standard Gibbs energies in J/mol
+                mCombgas.Gibbs( tT, mGibbs );
+
+                // sum of the moles of the species
+                real tSumN = 0.0 ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+
+                    real tNj = std::exp( mLogMoles( j ) );
+                    tSumN += tNj ;
+
+                    // mu / RT
+                    mMu( j ) = mGibbs( j ) / tRT + mLogMoles( j ) - tLogN + tLogP ;
+
+                    // H / RT and Cp / R
+                    mEnthalpies( j ) = ( mCombgas.h( j, tT, aP ) + mEnthalpyOffsets( j ) )
+                            * mCombgas.component( j )->M() / tRT ;
+                    mHeatCapacities( j ) = mCombgas.cp( j, tT, aP ) * mCombgas.component( j )->M() / constant::Rm ;
+                }
+
+                // assemble the system, Gordon & McBride Eqs. ( 2.24 ), ( 2.26 ) and ( 2.27 )
+                mJacobian.fill( 0.0 );
+                mRHS.fill( 0.0 );
+
+                // element rows
+                for( uint k=0; k<tL; ++k )
+                {
+                    uint tK = mActiveElements( k );
+
+                    real tB = 0.0 ;
+
+                    for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                    {
+                        uint j = mActiveSpecies( s );
+
+                        real tAkjNj = mElementMatrix( tK, j ) * std::exp( mLogMoles( j ) );
+
+                        if( tAkjNj == 0.0 )
+                        {
+                            continue ;
+                        }
+
+                        for( uint i=0; i<tL; ++i )
+                        {
+                            mJacobian( k, i ) += tAkjNj * mElementMatrix( mActiveElements( i ), j );
+                        }
+                        mJacobian( k, tL )     += tAkjNj ;
+                        mJacobian( k, tL + 1 ) += tAkjNj * mEnthalpies( j );
+
+                        tB += tAkjNj ;
+                        mRHS( k ) += tAkjNj * mMu( j );
+                    }
+
+                    mRHS( k ) += mElementMoles( tK ) - tB ;
+                }
+
+                // total moles and energy rows
+                real tSumNH  = 0.0 ;
+                real tSumNMu = 0.0 ;
+                real tSumNHMu = 0.0 ;
+                real tSumNCp = 0.0 ;
+                real tSumNHH = 0.0 ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+
+                    real tNj = std::exp( mLogMoles( j ) );
+
+                    tSumNH   += tNj * mEnthalpies( j );
+                    tSumNMu  += tNj * mMu( j );
+                    tSumNHMu += tNj * mEnthalpies( j ) * mMu( j );
+                    tSumNCp  += tNj * mHeatCapacities( j );
+                    tSumNHH  += tNj * mEnthalpies( j ) * mEnthalpies( j );
+
+                    for( uint i=0; i<tL; ++i )
+                    {
+                        real tAijNj = mElementMatrix( mActiveElements( i ), j ) * tNj ;
+                        mJacobian( tL, i )     += tAijNj ;
+                        mJacobian( tL + 1, i ) += tAijNj * mEnthalpies( j );
+                    }
+                }
+
+                mJacobian( tL, tL )     = tSumN - tN ;
+                mJacobian( tL, tL + 1 ) = tSumNH ;
+                mRHS( tL ) = tN - tSumN + tSumNMu ;
+
+                mJacobian( tL + 1, tL )     = tSumNH ;
+                mJacobian( tL + 1, tL + 1 ) = tSumNCp + tSumNHH ;
+                mRHS( tL + 1 ) = tH / tRT - tSumNH + tSumNHMu ;
+
+                gesv( mJacobian, mRHS, mPivot );
+
+                const real tDeltaLogN = mRHS( tL );
+                const real tDeltaLogT = mRHS( tL + 1 );
+
+                if( std::isnan( tDeltaLogN ) || std::isnan( tDeltaLogT ) )
+                {
+                    return false ;
+                }
+
+                // corrections of the species, Eq. ( 2.18 )
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+
+                    mDeltaLogMoles( j ) = -mMu( j ) + tDeltaLogN + mEnthalpies( j ) * tDeltaLogT ;
+                    for( uint i=0; i<tL; ++i )
+                    {
+                        mDeltaLogMoles( j ) += mElementMatrix( mActiveElements( i ), j ) * mRHS( i );
+                    }
+                }
+
+                // damping, Eqs. ( 3.1 ) and ( 3.2 )
+                real tMax = std::max( 5.0 * std::abs( tDeltaLogT ), 5.0 * std::abs( tDeltaLogN ) );
+                real tLambda2 = 1.0 ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+
+                    real tLogX = mLogMoles( j ) - tLogN ;
+
+                    if( tLogX > -18.420681 )
+                    {
+                        if( mDeltaLogMoles( j ) > 0.0 )
+                        {
+                            tMax = std::max( tMax, mDeltaLogMoles( j ) );
+                        }
+                    }
+                    else if( mDeltaLogMoles( j ) >= 0.0 && mDeltaLogMoles( j ) != tDeltaLogN )
+                    {
+                        tLambda2 = std::min( tLambda2,
+                                std::abs( ( -tLogX - 9.2103404 ) / ( mDeltaLogMoles( j ) - tDeltaLogN ) ) );
+                    }
+                }
+
+                real tLambda = tMax > 2.0 ? 2.0 / tMax : 1.0 ;
+                tLambda = std::min( tLambda, tLambda2 );
+
+                // convergence test, Section 3.3, before the update
+                bool tConverged = std::abs( tDeltaLogT ) < 1e-4
+                        && tN * std::abs( tDeltaLogN ) / tSumN < 0.5e-5 ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies && tConverged; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+                    tConverged = std::exp( mLogMoles( j ) ) * std::abs( mDeltaLogMoles( j ) ) / tSumN < 0.5e-5 ;
+                }
+
+                for( uint k=0; k<tL && tConverged; ++k )
+                {
+                    uint tK = mActiveElements( k );
+
+                    real tB = 0.0 ;
+                    for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                    {
+                        uint j = mActiveSpecies( s );
+                        tB += mElementMatrix( tK, j ) * std::exp( mLogMoles( j ) );
+                    }
+                    tConverged = std::abs( mElementMoles( tK ) - tB ) < 1e-6 * tMaxB ;
+                }
+
+                // update
+                tLogT += tLambda * tDeltaLogT ;
+                tLogN += tLambda * tDeltaLogN ;
+
+                for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                {
+                    uint j = mActiveSpecies( s );
+
+                    // keep the moles representable
+                    mLogMoles( j ) = std::max( mLogMoles( j ) + tLambda * mDeltaLogMoles( j ), -300.0 );
+                }
+
+                if( tConverged )
+                {
+                    aT = std::exp( tLogT );
+
+                    // molar fractions of the result
+                    real tSum = 0.0 ;
+                    mMolarFractions.fill( 0.0 );
+                    for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                    {
+                        uint j = mActiveSpecies( s );
+                        mMolarFractions( j ) = std::exp( mLogMoles( j ) );
+                        tSum += mMolarFractions( j );
+                    }
+                    for( uint s=0; s<tNumberOfActiveSpecies; ++s )
+                    {
+                        mMolarFractions( mActiveSpecies( s ) ) /= tSum ;
+                    }
+
+                    return true ;
+                }
+            }
+
+            return false ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        State::relax_hp_equilibrium( real & aT, const real & aP, const real & aH )
+        {
+            // specific enthalpy
+            real & tH = this->value( BELFEM_ENGINE_STATE_H );
+
+            // specific heat capacity
+            real & tCp = this->value( BELFEM_ENGINE_STATE_CP );
+
             // relaxation factor
             real tOmega = 0.3 ;
 
@@ -100,28 +526,80 @@ namespace belfem
             {
 
                 // remix, but do not recompute the splines
-                mCombgas.remix_to_equilibrium( tT, tP, true, false );
+                mCombgas.remix_to_equilibrium( aT, aP, true, false );
 
-                tH = mCombgas.h( tT, tP );
-                tCp = mCombgas.cp( tT, tP );
+                tH = mCombgas.h( aT, aP );
+                tCp = mCombgas.cp( aT, aP );
 
                 // correction step
                 tDeltaT = ( tH - aH ) / tCp;
 
                 // relax step
-                tT -= tOmega * tDeltaT;
+                aT -= tOmega * tDeltaT;
 
                 BELFEM_ERROR( tCount++ < 1000, "Failed to compute equilibrium temperature" );
             }
 
             // one final time for consisiency
-            mCombgas.remix_to_equilibrium( tT, tP, true, true );
+            mCombgas.remix_to_equilibrium( aT, aP, true, true );
+        }
 
-            // rember mass fractions
-            mMassFractions  = mCombgas.mass_fractions() ;
+//------------------------------------------------------------------------------
 
-            // remember molar fractions
-            mMolarFractions = mCombgas.molar_fractions() ;
+        void
+        State::create_element_matrix()
+        {
+            Cell< gastables::RefGas * > & tComponents = mCombgas.components() ;
+
+            uint tNumberOfSpecies = tComponents.size() ;
+
+            // collect the elements of all species
+            Map< string, uint > tMap ;
+            Cell< string > tElements ;
+
+            for( gastables::RefGas * tComponent : tComponents )
+            {
+                for( const string & tElement : tComponent->data()->elements() )
+                {
+                    if( ! tMap.key_exists( tElement ) )
+                    {
+                        tMap[ tElement ] = tElements.size() ;
+                        tElements.push( tElement );
+                    }
+                }
+            }
+
+            mNumberOfElements = tElements.size() ;
+
+            BELFEM_ERROR( mNumberOfElements > 0, "The gas of state %s has no elements", mLabel.c_str() );
+
+            mElementMatrix.set_size( mNumberOfElements, tNumberOfSpecies, 0.0 );
+
+            for( uint j=0; j<tNumberOfSpecies; ++j )
+            {
+                for( uint i=0; i<mNumberOfElements; ++i )
+                {
+                    mElementMatrix( i, j ) = tComponents( j )->data()->component_multiplicity( tElements( i ) );
+                }
+            }
+
+            // reference of the enthalpies, as in combustion::Scheme
+            mEnthalpyOffsets.set_size( tNumberOfSpecies );
+            for( uint j=0; j<tNumberOfSpecies; ++j )
+            {
+                mEnthalpyOffsets( j ) = tComponents( j )->data()->Hf() / tComponents( j )->M()
+                        - tComponents( j )->h( gastables::gTref );
+            }
+
+            mElementMoles.set_size( mNumberOfElements, 0.0 );
+            mActiveElements.set_size( mNumberOfElements, 0 );
+            mActiveSpecies.set_size( tNumberOfSpecies, 0 );
+            mLogMoles.set_size( tNumberOfSpecies, -300.0 );
+            mMu.set_size( tNumberOfSpecies, 0.0 );
+            mEnthalpies.set_size( tNumberOfSpecies, 0.0 );
+            mHeatCapacities.set_size( tNumberOfSpecies, 0.0 );
+            mGibbs.set_size( tNumberOfSpecies, 0.0 );
+            mDeltaLogMoles.set_size( tNumberOfSpecies, 0.0 );
         }
 
 //------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #include "typedefs.hpp"
 #include "cl_Vector.hpp"
+#include "cl_Matrix.hpp"
 #include "cl_Gas.hpp"
 
 // geometry
@@ -68,6 +69,37 @@ namespace belfem
             // molar fractions
             Vector< real > mMolarFractions ;
 
+            // true if the molar fractions are the result of an equilibrium
+            bool mHasEquilibrium = false ;
+
+            // solve the HP equilibrium with the Newton iteration,
+            // otherwise with the fixed point iteration
+            bool mUseNewton = true ;
+
+            // how often the Newton iteration failed
+            uint mNumberOfFallbacks = 0 ;
+
+            // number of elements, zero until the element matrix is built
+            uint mNumberOfElements = 0 ;
+
+            // atoms of each element per molecule, rows: elements, columns: species
+            Matrix< real > mElementMatrix ;
+
+            // work arrays for the HP equilibrium
+            Vector< real > mElementMoles ;
+            Vector< real > mLogMoles ;
+            Vector< real > mMu ;
+            Vector< real > mEnthalpies ;
+            Vector< real > mHeatCapacities ;
+            Vector< real > mEnthalpyOffsets ;
+            Vector< real > mGibbs ;
+            Vector< real > mDeltaLogMoles ;
+            Vector< uint > mActiveElements ;
+            Vector< uint > mActiveSpecies ;
+            Matrix< real > mJacobian ;
+            Vector< real > mRHS ;
+            Vector< int >  mPivot ;
+
 //------------------------------------------------------------------------------
         public:
 //------------------------------------------------------------------------------
@@ -228,17 +260,78 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
+            /**
+             * chemical equilibrium for given pressure and enthalpy.
+             * aT is the initial guess for the temperature.
+             */
             void
             compute_equilibrium(
                     const real & aT,
                     const real & aP,
                     const real & aH );
 
+//------------------------------------------------------------------------------
+
+            /**
+             * select the solver of compute_equilibrium. The Newton
+             * iteration is the default, the fixed point iteration
+             * is used if the switch is false.
+             */
+            void
+            use_newton_equilibrium( const bool aSwitch );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * how often compute_equilibrium had to fall back from the
+             * Newton iteration to the fixed point iteration
+             */
+            uint
+            number_of_fallbacks() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * copy the values and the composition of another state,
+             * which may belong to another gas object
+             */
+            void
+            copy_values( const State & aState );
+
 //------------------------------------------------------------------------------
 
             void
             print() const ;
 
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            /**
+             * Newton iteration over composition and temperature as in
+             * Gordon & McBride, NASA RP-1311, Chapter 2. The element
+             * potentials, the total moles and the temperature are solved
+             * together, the moles of the species follow from them.
+             * Returns false if the iteration does not converge.
+             */
+            bool
+            solve_hp_equilibrium( real & aT, const real & aP, const real & aH );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * fixed point iteration over the temperature,
+             * each step computes the TP equilibrium of the gas
+             */
+            void
+            relax_hp_equilibrium( real & aT, const real & aP, const real & aH );
+
+//------------------------------------------------------------------------------
+
+            // count the atoms of each species
+            void
+            create_element_matrix();
+
 //------------------------------------------------------------------------------
         };
 
@@ -386,6 +479,14 @@ namespace belfem
             return mMolarFractions ;
         }
 
+//------------------------------------------------------------------------------
+
+        inline uint
+        State::number_of_fallbacks() const
+        {
+            return mNumberOfFallbacks ;
+        }
+
 //------------------------------------------------------------------------------
 
         inline real &
@@ -36,6 +36,68 @@ namespace belfem
 
         }
 
+//------------------------------------------------------------------------------
+
+        Turbine *
+        Turbine::clone( Gas & aGas ) const
+        {
+            Turbine * aTurbine = new Turbine( aGas );
+
+            if( mEntryFlag )
+            {
+                aTurbine->set_entry( mNozzleEntry.Tt(), mNozzleEntry.pt() );
+            }
+            if( mNflag )
+            {
+                aTurbine->set_n( mN );
+            }
+            if( mDotMflag )
+            {
+                aTurbine->set_massflow( mDotM );
+            }
+            if( mPflag )
+            {
+                aTurbine->set_power( mP );
+            }
+            if( mYflag )
+            {
+                aTurbine->set_Y( mY );
+            }
+            if( mZ2Flag )
+            {
+                aTurbine->set_Z2( mZ2 );
+            }
+            if( mPitchChordRatioFlag )
+            {
+                aTurbine->set_pitch_chord_ratio( mPitchChordRatio );
+            }
+            if( mPsiFlag )
+            {
+                aTurbine->set_psi( mPsi );
+            }
+            if( mPhi1Flag )
+            {
+                aTurbine->set_phi( mPhi1 );
+            }
+            if( mBDflag )
+            {
+                aTurbine->set_bd( mBD );
+            }
+            if( mBflag )
+            {
+                aTurbine->set_b( mB1 );
+            }
+            if( mEpsilonFlag )
+            {
+                aTurbine->set_epsilon( mEpsilon );
+            }
+
+            aTurbine->set_alpha2( mAlpha2 );
+            aTurbine->mB2B1 = mB2B1 ;
+
+            return aTurbine ;
+        }
+
 //------------------------------------------------------------------------------
 
         void
@@ -205,6 +205,16 @@ namespace belfem
 
             ~Turbine() = default ;
 
+//------------------------------------------------------------------------------
+
+            /**
+             * creates a turbine with the same user settings that works on
+             * aGas, for example for another thread. Computed values
+             * are not copied.
+             */
+            Turbine *
+            clone( Gas & aGas ) const ;
+
 //------------------------------------------------------------------------------
 
             /**
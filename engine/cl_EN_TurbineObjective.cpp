@@ -0,0 +1,136 @@
+//
+// Created on 16.10.26.
+//
+
+#include "assert.hpp"
+#include "cl_EN_State.hpp"
+#include "cl_EN_TurbineObjective.hpp"
+
+namespace belfem
+{
+    namespace engine
+    {
+//------------------------------------------------------------------------------
+
+        TurbineObjective::TurbineObjective(
+                const Analysis & aGasGenerator,
+                const Turbine  & aTurbine ) :
+            mGasGenerator( aGasGenerator.clone() )
+        {
+            mTurbine = aTurbine.clone( *mGasGenerator->combgas() );
+        }
+
+//------------------------------------------------------------------------------
+
+        TurbineObjective::~TurbineObjective()
+        {
+            delete mTurbine ;
+            delete mGasGenerator ;
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        TurbineObjective::compute( const Vector< real > & aValues, real & aFitness )
+        {
+            return TurbineObjective::compute_fitness(
+                    *mTurbine, aValues( 0 ), aValues( 1 ), aValues( 2 ), aFitness );
+        }
+
+//------------------------------------------------------------------------------
+
+        bool
+        TurbineObjective::compute_fitness(
+                Turbine & aTurbine,
+                const real aPhi,
+                const real aPsi,
+                const real aBD,
+                real & aFitness )
+        {
+            // check if the values make sense
+            if( aPhi < 0.2 || aPhi > 1.3 )
+            {
+                return false ;
+            }
+            if( aPsi < 1.75 || aPsi > 3.25 )
+            {
+                return false ;
+            }
+            if( aBD < 0.04 || aBD > 0.4 )
+            {
+                return false ;
+            }
+
+            // set values
+            aTurbine.set_phi( aPhi );
+            aTurbine.set_psi( aPsi );
+            aTurbine.set_bd( aBD );
+
+            // compute the data
+            aTurbine.compute() ;
+
+            // kill if it makes no sense
+            if ( aTurbine.error_code() != 0 )
+            {
+                return false ;
+            }
+            if( ! ( aTurbine.eta() < 1.0 ) )
+            {
+                return false ;
+            }
+
+            if( aTurbine.epsilon() < 0.1  )
+            {
+                return false ;
+            }
+
+            // compute the fitness
+            aFitness = 0.0 ;
+
+            // just pull a tiny bit into best efficiency
+            aFitness += std::pow( std::abs( aTurbine.eta() - 1.0 )*10, 2 );
+
+            // we don't want a negative reaction
+            if( aTurbine.reaction() < 0.01 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.reaction() -0.01 ) * 1000.0, 4 );
+            }
+            else if ( aTurbine.reaction() > 0.1 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.reaction() - 0.1 ) * 100.0, 2 );
+            }
+
+            // epsilon value must be reasonable
+            if( aTurbine.epsilon() < 0.1 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.epsilon() - 0.1 ) * 100.0, 3 );
+            }
+            else if ( aTurbine.epsilon() > 1.0 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.epsilon() - 1.0 ) * 10.0, 3 );
+            }
+
+            // we don't want to cross the sonic area
+            if( aTurbine.turbine_entry()->Ma() > 1.0 && aTurbine.turbine_discharge()->Ma() < 1.2 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.turbine_discharge()->Ma() - 1.2 ) * 10, 3 );
+            }
+            if( aTurbine.turbine_entry()->Ma() < 1.0 && aTurbine.turbine_discharge()->Ma() > 0.85 )
+            {
+                aFitness += std::pow( std::abs(aTurbine.turbine_discharge()->Ma() - 0.85), 3 );
+            }
+
+            aFitness += std::pow( std::abs( aTurbine.blade_entry_error() ) * 100000, 5 );
+
+            if( aTurbine.haller() < 0.8 )
+            {
+                aFitness += std::pow( std::abs( aTurbine.haller() - 0.8 ) * 10, 2 );
+            }
+
+            // a failed blade computation returns NaN
+            return std::isfinite( aFitness ) ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
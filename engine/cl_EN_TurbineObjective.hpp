@@ -0,0 +1,82 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_EN_TURBINEOBJECTIVE_HPP
+#define BELFEM_CL_EN_TURBINEOBJECTIVE_HPP
+
+#include "typedefs.hpp"
+#include "cl_Vector.hpp"
+#include "cl_EN_Analysis.hpp"
+#include "cl_EN_Turbine.hpp"
+#include "cl_EN_GeneticOptimizer.hpp"
+
+namespace belfem
+{
+    namespace engine
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * turbine design for the GeneticOptimizer,
+         * the values are phi, psi and b/Dm
+         */
+        class TurbineObjective : public GeneticObjective< 3 >
+        {
+            // own gas generator, so that each thread has its own gas
+            Analysis * mGasGenerator ;
+
+            Turbine * mTurbine ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            /**
+             * copies the gas generator state and the turbine settings
+             */
+            TurbineObjective( const Analysis & aGasGenerator,
+                              const Turbine  & aTurbine );
+
+//------------------------------------------------------------------------------
+
+            ~TurbineObjective();
+
+//------------------------------------------------------------------------------
+
+            bool
+            compute( const Vector< real > & aValues, real & aFitness );
+
+//------------------------------------------------------------------------------
+
+            inline Turbine *
+            turbine();
+
+//------------------------------------------------------------------------------
+
+            /**
+             * compute the turbine for the given design and its penalty,
+             * returns false if the design is not feasible
+             */
+            static bool
+            compute_fitness( Turbine & aTurbine,
+                             const real aPhi,
+                             const real aPsi,
+                             const real aBD,
+                             real & aFitness );
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline Turbine *
+        TurbineObjective::turbine()
+        {
+            return mTurbine ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_EN_TURBINEOBJECTIVE_HPP
@@ -0,0 +1,88 @@
+//
+// Created on 16.10.26.
+//
+
+#include <iostream>
+#include <cmath>
+
+#include "typedefs.hpp"
+#include "assert.hpp"
+
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "cl_Vector.hpp"
+
+#include "cl_EN_Parameters.hpp"
+#include "cl_EN_Analysis.hpp"
+#include "cl_EN_State.hpp"
+
+using namespace belfem;
+using namespace engine ;
+
+Communicator gComm;
+Logger       gLog( 3 );
+
+//------------------------------------------------------------------------------
+
+/**
+ * the HP equilibrium of the LOX/LNG gas generator, computed with the
+ * Newton iteration and with the fixed point iteration
+ */
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm = Communicator( &argc, &argv );
+
+    Parameters tParams;
+    tParams.set_fuel_and_oxidizer( Fuel::LNG, Oxidizer::LOX );
+    tParams.set_fuel_and_oxidizer_temperatures( 115.7399 ,  97.4270 );
+
+    Analysis tGasGenerator( tParams );
+
+    const real tP = 112.5e5 ;
+
+    real tOF = tGasGenerator.compute_gas_generator( 750.0, tP, 0.1, 0.4 );
+
+    BELFEM_ERROR( tGasGenerator.total()->number_of_fallbacks() == 0,
+                  "the Newton iteration fell back to the fixed point iteration" );
+
+    // unburnt mixture
+    tGasGenerator.compute_injector( tOF, tP );
+    const real tH = tGasGenerator.injector()->h() ;
+
+    State tNewton( *tGasGenerator.combgas(), "Newton", tParams.number_of_species() );
+    tNewton.compute_equilibrium( 700.0, tP, tH );
+
+    BELFEM_ERROR( tNewton.number_of_fallbacks() == 0,
+                  "the Newton iteration fell back to the fixed point iteration" );
+
+    // the gas is now at equilibrium, so the unburnt mixture is set again
+    tGasGenerator.compute_injector( tOF, tP );
+
+    State tRelax( *tGasGenerator.combgas(), "Relax", tParams.number_of_species() );
+    tRelax.use_newton_equilibrium( false );
+    tRelax.compute_equilibrium( 700.0, tP, tH );
+
+    // the fixed point iteration stops at a temperature correction of 1e-4 K
+    real tErrT = std::abs( tNewton.T() - tRelax.T() );
+
+    real tErrX = 0.0 ;
+    for( uint k=0; k<tNewton.molar_fractions().length(); ++k )
+    {
+        tErrX = std::max( tErrX, std::abs( tNewton.molar_fractions()( k )
+            - tRelax.molar_fractions()( k ) ) );
+    }
+
+    std::cout << "OF " << tOF << std::endl ;
+    std::cout << "T  Newton: " << tNewton.T() << " K, fixed point: " << tRelax.T() << " K" << std::endl ;
+    std::cout << "max. difference of the molar fractions: " << tErrX << std::endl ;
+
+    BELFEM_ERROR( tErrT < 1e-2, "temperatures differ by %g K", ( double ) tErrT );
+    BELFEM_ERROR( tErrX < 1e-4, "molar fractions differ by %g", ( double ) tErrX );
+
+    std::cout << "PASSED" << std::endl ;
+
+    // close communicator
+    return gComm.finalize();
+}
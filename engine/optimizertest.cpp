@@ -0,0 +1,258 @@
+//
+// Created on 16.10.26.
+//
+
+#include <iostream>
+#include <cmath>
+
+#include "typedefs.hpp"
+#include "assert.hpp"
+
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+
+#include "cl_EN_GeneticOptimizer.hpp"
+
+using namespace belfem;
+using namespace engine ;
+
+Communicator gComm;
+Logger       gLog( 3 );
+
+//------------------------------------------------------------------------------
+
+/**
+ * distance to the point ( 1, 2 ), or a constant penalty
+ */
+class QuadraticObjective : public GeneticObjective< 2 >
+{
+    const bool mIsConstant ;
+
+    index_t mNumberOfCalls = 0 ;
+
+public:
+
+    QuadraticObjective( const bool aIsConstant=false ) :
+        mIsConstant( aIsConstant )
+    {
+
+    }
+
+    bool
+    compute( const Vector< real > & aValues, real & aFitness )
+    {
+        ++mNumberOfCalls ;
+
+        if( ! ( std::isfinite( aValues( 0 ) ) && std::isfinite( aValues( 1 ) ) ) )
+        {
+            return false ;
+        }
+
+        aFitness = mIsConstant ? 1.0 :
+                   std::pow( aValues( 0 ) - 1.0, 2 ) + std::pow( aValues( 1 ) - 2.0, 2 );
+
+        return true ;
+    }
+
+    index_t
+    number_of_calls() const
+    {
+        return mNumberOfCalls ;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+void
+create_objectives( Cell< GeneticObjective< 2 > * > & aObjectives,
+                   const uint aNumberOfObjectives,
+                   const bool aIsConstant=false )
+{
+    aObjectives.set_size( aNumberOfObjectives, nullptr );
+    for( uint k=0; k<aNumberOfObjectives; ++k )
+    {
+        aObjectives( k ) = new QuadraticObjective( aIsConstant );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+index_t
+count_calls( Cell< GeneticObjective< 2 > * > & aObjectives )
+{
+    index_t aCount = 0 ;
+    for( GeneticObjective< 2 > * tObjective : aObjectives )
+    {
+        aCount += static_cast< QuadraticObjective * >( tObjective )->number_of_calls() ;
+    }
+    return aCount ;
+}
+
+//------------------------------------------------------------------------------
+
+void
+delete_objectives( Cell< GeneticObjective< 2 > * > & aObjectives )
+{
+    for( GeneticObjective< 2 > * tObjective : aObjectives )
+    {
+        delete tObjective ;
+    }
+    aObjectives.clear() ;
+}
+
+//------------------------------------------------------------------------------
+
+void
+setup( GeneticOptimizer< 2 > & aOptimizer )
+{
+    Vector< real > tLowerBounds( 2, 0.0 );
+    Vector< real > tUpperBounds( 2, 3.0 );
+
+    aOptimizer.set_seed( 42 );
+    aOptimizer.set_bounds( tLowerBounds, tUpperBounds );
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * kept parents are taken from the cache, and each call of
+ * an objective is counted as one evaluation
+ */
+void
+test_cache()
+{
+    std::cout << "Test 1: cache..." << std::endl;
+
+    Cell< GeneticObjective< 2 > * > tObjectives ;
+    create_objectives( tObjectives, 4 );
+
+    GeneticOptimizer< 2 > tOptimizer( tObjectives, 200, 10 );
+    setup( tOptimizer );
+    tOptimizer.run( 5 );
+
+    std::cout << "  evaluations: " << tOptimizer.number_of_evaluations()
+              << " cache hits: " << tOptimizer.number_of_cache_hits() << std::endl ;
+
+    BELFEM_ERROR( tOptimizer.number_of_cache_hits() >= 4 * 10,
+                  "the kept parents were not taken from the cache" );
+
+    BELFEM_ERROR( count_calls( tObjectives ) == tOptimizer.number_of_evaluations(),
+                  "number of evaluations does not match the calls of the objectives" );
+
+    delete_objectives( tObjectives );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void
+test_target()
+{
+    std::cout << "Test 2: stop at target..." << std::endl;
+
+    Cell< GeneticObjective< 2 > * > tObjectives ;
+    create_objectives( tObjectives, 2 );
+
+    GeneticOptimizer< 2 > tOptimizer( tObjectives, 200, 10 );
+    setup( tOptimizer );
+
+    // the initial population contains such a point almost surely
+    tOptimizer.set_target_fitness( 0.5 );
+    tOptimizer.run( 20 );
+
+    std::cout << "  generations: " << tOptimizer.number_of_generations()
+              << " penalty: " << tOptimizer.best_fitness() << std::endl ;
+
+    BELFEM_ERROR( tOptimizer.best_fitness() < 0.5, "target was not reached" );
+    BELFEM_ERROR( tOptimizer.number_of_generations() < 20, "run did not stop at the target" );
+
+    delete_objectives( tObjectives );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void
+test_stagnation()
+{
+    std::cout << "Test 3: stop at stagnation..." << std::endl;
+
+    // the penalty never improves
+    Cell< GeneticObjective< 2 > * > tObjectives ;
+    create_objectives( tObjectives, 2, true );
+
+    GeneticOptimizer< 2 > tOptimizer( tObjectives, 200, 10 );
+    setup( tOptimizer );
+    tOptimizer.set_stagnation_limit( 3 );
+    tOptimizer.run( 20 );
+
+    std::cout << "  generations: " << tOptimizer.number_of_generations() << " (expected: 4)" << std::endl ;
+
+    // the first generation sets the reference, three more without improvement
+    BELFEM_ERROR( tOptimizer.number_of_generations() == 4, "run did not stop after stagnation" );
+
+    delete_objectives( tObjectives );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void
+test_threads()
+{
+    std::cout << "Test 4: same result for one and for several objectives..." << std::endl;
+
+    Cell< GeneticObjective< 2 > * > tSerial ;
+    create_objectives( tSerial, 1 );
+
+    GeneticOptimizer< 2 > tSerialOptimizer( tSerial, 200, 10 );
+    setup( tSerialOptimizer );
+    tSerialOptimizer.run( 6 );
+
+    Cell< GeneticObjective< 2 > * > tParallel ;
+    create_objectives( tParallel, 4 );
+
+    GeneticOptimizer< 2 > tParallelOptimizer( tParallel, 200, 10 );
+    setup( tParallelOptimizer );
+    tParallelOptimizer.run( 6 );
+
+    std::cout << "  penalty: " << tSerialOptimizer.best_fitness()
+              << " and " << tParallelOptimizer.best_fitness() << std::endl ;
+
+    BELFEM_ERROR( tSerialOptimizer.best_fitness() == tParallelOptimizer.best_fitness()
+               && tSerialOptimizer.best_values()( 0 ) == tParallelOptimizer.best_values()( 0 )
+               && tSerialOptimizer.best_values()( 1 ) == tParallelOptimizer.best_values()( 1 ),
+                  "result depends on the number of objectives" );
+
+    BELFEM_ERROR( tSerialOptimizer.number_of_evaluations() == tParallelOptimizer.number_of_evaluations(),
+                  "number of evaluations depends on the number of objectives" );
+
+    delete_objectives( tSerial );
+    delete_objectives( tParallel );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm = Communicator( &argc, &argv );
+
+    test_cache() ;
+    test_target() ;
+    test_stagnation() ;
+    test_threads() ;
+
+    std::cout << "All tests PASSED!" << std::endl;
+
+    // close communicator
+    return gComm.finalize();
+}
@@ -2,6 +2,9 @@
 // Created by Christian Messe on 03.05.21.
 //
 
+#include <ctime>
+#include <thread>
+
 #include "typedefs.hpp"
 #include "constants.hpp"
 #include "random.hpp"
@@ -16,8 +19,8 @@
 #include "cl_EN_State.hpp"
 #include "cl_EN_Turbine.hpp"
 #include "cl_TensorMeshFactory.hpp"
-#include "cl_Progressbar.hpp"
-#include "cl_EN_Gene.hpp"
+#include "cl_EN_GeneticOptimizer.hpp"
+#include "cl_EN_TurbineObjective.hpp"
 
 #include "cl_Cell.hpp"
 
@@ -105,114 +108,69 @@ int main( int    argc,
 
 //------------------------------------------------------------------------------
 
-    // create original population
-    Cell< Gene * > tGenes( tNumIndividuals, nullptr );
-    for( uint k=0; k<tNumIndividuals; ++k )
+    // one objective per thread, each with its own gas
+    uint tNumberOfThreads = std::max( std::thread::hardware_concurrency(), ( uint ) 1 );
+
+    Cell< GeneticObjective< 3 > * > tObjectives( tNumberOfThreads, nullptr );
+    for( uint t=0; t<tNumberOfThreads; ++t )
     {
-        tGenes( k ) = new Gene( tTurbine );
+        tObjectives( t ) = new TurbineObjective( tGasGenerator, tTurbine );
     }
 
-//------------------------------------------------------------------------------
+    Vector< real > tLowerBounds( 3 );
+    tLowerBounds( 0 ) = tPhiMin ;
+    tLowerBounds( 1 ) = tPsiMin ;
+    tLowerBounds( 2 ) = tBdMin ;
 
-    // set values to initial data
-    random_seed();
-    for( Gene * tGene : tGenes )
-    {
-        real tPhi = tPhiMin + ( tPhiMax - tPhiMin ) * belfem::rand() * belfem::rand() * 2.0 ;
-        real tPsi = tPsiMin + ( tPsiMax - tPsiMin ) * belfem::rand() * belfem::rand() * 2.0 ;
-        real tBd  = tBdMin  + ( tBdMax - tBdMin ) * belfem::rand() * belfem::rand() * 2.0 ;
+    Vector< real > tUpperBounds( 3 );
+    tUpperBounds( 0 ) = tPhiMax ;
+    tUpperBounds( 1 ) = tPsiMax ;
+    tUpperBounds( 2 ) = tBdMax ;
 
-        tGene->set_values( tPhi, tPsi, tBd );
-    }
+    // the objective rejects designs outside of this region
+    Vector< real > tFeasibleLowerBounds( 3 );
+    tFeasibleLowerBounds( 0 ) = 0.2 ;
+    tFeasibleLowerBounds( 1 ) = 1.75 ;
+    tFeasibleLowerBounds( 2 ) = 0.04 ;
+
+    Vector< real > tFeasibleUpperBounds( 3 );
+    tFeasibleUpperBounds( 0 ) = 1.3 ;
+    tFeasibleUpperBounds( 1 ) = 3.25 ;
+    tFeasibleUpperBounds( 2 ) = 0.4 ;
 
 //------------------------------------------------------------------------------
 
+    GeneticOptimizer< 3 > tOptimizer( tObjectives, tNumIndividuals, tNumKeep );
+    tOptimizer.set_seed( ( uint ) std::time( nullptr ) );
+    tOptimizer.set_bounds( tLowerBounds, tUpperBounds );
+    tOptimizer.set_feasible_region( tFeasibleLowerBounds, tFeasibleUpperBounds );
 
-    for( index_t k=0; k<tNumGenerations; ++k )
-    {
-        Progressbar tProgress( tNumIndividuals );
-
-        tProgress.reset();
-
-        index_t tCount = 0;
-        std::cout << "computing generation " << k << std::endl;
-        for ( Gene * tGene : tGenes )
-        {
-            if ( tGene->alive() )
-            {
-                tGene->compute();
-
-                if ( tGene->alive())
-                {
-                    ++tCount;
-                }
-            }
-            tProgress.step();
-        }
-        tProgress.finish();
-
-
-
-        sort( tGenes, opCompareFitness );
-
-        std::cout << "alive individuals: " << tCount << " min. penalty: " << tGenes( 0 )->fitness() << std::endl;
-        std::cout << " phi=" << tGenes( 0 )->phi() << " psi=" << tGenes( 0 )->psi() << " b/Dm=" << tGenes( 0 )->bd() << std::endl ;
-
-        // number of parents
-        index_t tNumParents = std::min( tCount, tNumKeep );
-
-        tCount = tNumParents;
-
-        // create next generation
-        for ( index_t j = 0; j < tNumParents; ++j )
-        {
-            for ( index_t i = j; i < tNumParents; ++i )
-            {
-                // check limit
-                if ( tCount == tNumIndividuals )
-                {
-                    break;
-                }
-
-                // create next generation
-                tGenes( tCount++ )->inherit( tGenes( j ), tGenes( i ));
-            }
-
-            // check limit
-            if ( tCount == tNumIndividuals )
-            {
-                break;
-            }
-        }
-
-        // randomize rest
-        tCount = std::min( tCount, index_t( 0.75 * ( real ) tNumIndividuals ) ) ;
-
-        real tPhiBest = tGenes( 0 )->phi() ;
-        real tPsiBest = tGenes( 0 )->psi() ;
-        real tBdBest  = tGenes( 0 )->bd() ;
-
-        for( index_t i=tCount; i<tNumIndividuals; ++i )
-        {
-            Gene * tGene = tGenes(  i  );
-
-            real tPhi =  tPhiBest * ( 1.0 + 0.25 * ( belfem::rand() * belfem::rand() * 4.0  - 1.0 ) );
-            real tPsi =  tPsiBest * ( 1.0 + 0.25 * ( belfem::rand() * belfem::rand() * 4.0  - 1.0 ) );
-            real tBd  =  tBdBest  * ( 1.0 + 0.25 * ( belfem::rand() * belfem::rand() * 4.0  - 1.0 ) );
-
-            tGene->set_values( tPhi, tPsi, tBd );
-        }
-    }
+    // early stopping changes the result, it is therefore switched off.
+    // to stop if three generations bring no improvement, use
+    // tOptimizer.set_stagnation_limit( 3, 1e-6 );
+
+    std::cout << "computing " << tNumGenerations << " generations on "
+              << tNumberOfThreads << " threads" << std::endl;
+
+    const Vector< real > & tBest = tOptimizer.run( tNumGenerations );
+
+    std::cout << "generations: " << tOptimizer.number_of_generations()
+              << " evaluations: " << tOptimizer.number_of_evaluations()
+              << " cache hits: " << tOptimizer.number_of_cache_hits() << std::endl ;
+
+    std::cout << "min. penalty: " << tOptimizer.best_fitness() << std::endl;
+    std::cout << " phi=" << tBest( 0 ) << " psi=" << tBest( 1 ) << " b/Dm=" << tBest( 2 ) << std::endl ;
 
-    tGenes( 0 )->compute() ;
+    real tFitness ;
+    TurbineObjective::compute_fitness( tTurbine, tBest( 0 ), tBest( 1 ), tBest( 2 ), tFitness );
     tTurbine.print();
 
 //------------------------------------------------------------------------------
 
     // tidy up
-    for( Gene * tGene : tGenes )
+    for( GeneticObjective< 3 > * tObjective : tObjectives )
     {
-        delete tGene ;
+        delete tObjective ;
     }
 
 //------------------------------------------------------------------------------
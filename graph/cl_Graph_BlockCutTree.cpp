@@ -0,0 +1,218 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+
+#include "assert.hpp"
+#include "cl_Graph_BlockCutTree.hpp"
+
+namespace belfem
+{
+    namespace graph
+    {
+//------------------------------------------------------------------------------
+
+        BlockCutTree::BlockCutTree( const CSRGraph & aGraph )
+        {
+            this->build( aGraph );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        BlockCutTree::build( const CSRGraph & aGraph )
+        {
+            index_t tNumberOfVertices = aGraph.number_of_vertices() ;
+            mNumberOfVertices = tNumberOfVertices ;
+
+            mPreorder.set_size( tNumberOfVertices, gNoIndex );
+            mOrder.set_size( tNumberOfVertices, gNoIndex );
+            mSubtreeSize.set_size( tNumberOfVertices, 1 );
+            mSubtreeEdges.set_size( tNumberOfVertices, 0 );
+            mSubtreeBackEdges.set_size( tNumberOfVertices, 0 );
+            mSubtreeCycleLength.set_size( tNumberOfVertices, 0 );
+            mVertexBlock.set_size( tNumberOfVertices, gNoIndex );
+
+            // the number of child blocks is counted in the entry
+            // after the vertex and summed up at the end
+            mChildOffsets.set_size( tNumberOfVertices + 1, 0 );
+
+            mBlockOffsets.clear() ;
+            mBlockVertices.clear() ;
+            mBlockEdges.clear() ;
+            mBlockChild.clear() ;
+            mCutVertices.clear() ;
+
+            mBlockOffsets.push( 0 );
+
+            // work vectors
+            Vector< index_t > tLow( tNumberOfVertices, gNoIndex );
+            Vector< index_t > tParent( tNumberOfVertices, gNoIndex );
+            Vector< index_t > tDepth( tNumberOfVertices, 0 );
+
+            // next position in the adjacency of each vertex
+            Vector< index_t > tNext( tNumberOfVertices, 0 );
+
+            // number of edges to vertices that were found earlier
+            Vector< index_t > tUp( tNumberOfVertices, 0 );
+
+            // the path from the root to the current vertex
+            Vector< index_t > tStack( tNumberOfVertices, 0 );
+
+            // vertices that are not yet assigned to a block
+            Vector< index_t > tComponent( tNumberOfVertices, 0 );
+
+            index_t tTime = 0 ;
+
+            for( index_t tRoot=0; tRoot<tNumberOfVertices; ++tRoot )
+            {
+                if( mPreorder( tRoot ) != gNoIndex )
+                {
+                    continue ;
+                }
+
+                mPreorder( tRoot ) = tTime ;
+                tLow( tRoot ) = tTime ;
+                mOrder( tTime++ ) = tRoot ;
+                tNext( tRoot ) = aGraph.begin( tRoot );
+
+                index_t tTop = 0 ;
+                index_t tCount = 0 ;
+                tStack( tTop++ ) = tRoot ;
+                tComponent( tCount++ ) = tRoot ;
+
+                while( tTop > 0 )
+                {
+                    index_t tV = tStack( tTop - 1 );
+
+                    if( tNext( tV ) < aGraph.end( tV ) )
+                    {
+                        index_t tW = aGraph.neighbor( tNext( tV )++ );
+
+                        if( mPreorder( tW ) == gNoIndex )
+                        {
+                            // tree edge, descend
+                            tParent( tW ) = tV ;
+                            tDepth( tW ) = tDepth( tV ) + 1 ;
+                            mPreorder( tW ) = tTime ;
+                            tLow( tW ) = tTime ;
+                            mOrder( tTime++ ) = tW ;
+                            tNext( tW ) = aGraph.begin( tW );
+
+                            tStack( tTop++ ) = tW ;
+                            tComponent( tCount++ ) = tW ;
+                        }
+                        else if( mPreorder( tW ) < mPreorder( tV ) )
+                        {
+                            // edge to an ancestor, it is seen from the lower
+                            // end and belongs to the subtree of the upper one
+                            ++tUp( tV );
+                            ++mSubtreeEdges( tW );
+
+                            if( tW != tParent( tV ) )
+                            {
+                                tLow( tV ) = std::min( tLow( tV ), mPreorder( tW ) );
+                                ++mSubtreeBackEdges( tW );
+                                mSubtreeCycleLength( tW ) += tDepth( tV ) - tDepth( tW ) + 1 ;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        // all neighbors are visited, go back up
+                        --tTop ;
+
+                        index_t tP = tParent( tV );
+
+                        // all blocks below tV are known now,
+                        // a root must separate at least two of them
+                        if( mChildOffsets( tV + 1 ) > ( tP == gNoIndex ? 1 : 0 ) )
+                        {
+                            mCutVertices.push( tV );
+                        }
+
+                        if( tP == gNoIndex )
+                        {
+                            continue ;
+                        }
+
+                        tLow( tP ) = std::min( tLow( tP ), tLow( tV ) );
+                        mSubtreeSize( tP )        += mSubtreeSize( tV );
+                        mSubtreeEdges( tP )       += mSubtreeEdges( tV );
+                        mSubtreeBackEdges( tP )   += mSubtreeBackEdges( tV );
+                        mSubtreeCycleLength( tP ) += mSubtreeCycleLength( tV );
+
+                        if( tLow( tV ) >= mPreorder( tP ) )
+                        {
+                            // nothing below tV reaches above tP, so the
+                            // vertices down to tV on the component stack
+                            // form a block together with tP
+                            index_t tBlock = mBlockChild.size() ;
+                            index_t tEdges = 0 ;
+
+                            mBlockVertices.push( tP );
+
+                            index_t tU ;
+                            do
+                            {
+                                tU = tComponent( --tCount );
+                                mBlockVertices.push( tU );
+                                mVertexBlock( tU ) = tBlock ;
+                                tEdges += tUp( tU );
+                            }
+                            while( tU != tV );
+
+                            mBlockOffsets.push( mBlockVertices.size() );
+                            mBlockEdges.push( tEdges );
+                            mBlockChild.push( tV );
+
+                            ++mChildOffsets( tP + 1 );
+                        }
+                    }
+                }
+
+                // only the root is left on the component stack
+                BELFEM_ASSERT( tCount == 1, "component stack is not empty" );
+            }
+
+            // sort the blocks by their tops
+            for( index_t k=0; k<tNumberOfVertices; ++k )
+            {
+                mChildOffsets( k + 1 ) += mChildOffsets( k );
+            }
+
+            index_t tNumberOfBlocks = mBlockChild.size() ;
+            mChildBlocks.set_size( tNumberOfBlocks, gNoIndex );
+
+            // tNext is reused as fill counter
+            for( index_t k=0; k<tNumberOfVertices; ++k )
+            {
+                tNext( k ) = mChildOffsets( k );
+            }
+
+            for( index_t b=0; b<tNumberOfBlocks; ++b )
+            {
+                mChildBlocks( tNext( this->block_top( b ) )++ ) = b ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        BlockCutTree::branch( const index_t aBlock, Cell< index_t > & aVertices ) const
+        {
+            index_t tBegin = this->branch_begin( aBlock );
+            index_t tEnd   = this->branch_end( aBlock );
+
+            aVertices.set_size( tEnd - tBegin, gNoIndex );
+
+            for( index_t k=tBegin; k<tEnd; ++k )
+            {
+                aVertices( k - tBegin ) = mOrder( k );
+            }
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
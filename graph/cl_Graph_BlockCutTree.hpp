@@ -0,0 +1,408 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_GRAPH_BLOCKCUTTREE_HPP
+#define BELFEM_CL_GRAPH_BLOCKCUTTREE_HPP
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Graph_CSRGraph.hpp"
+
+namespace belfem
+{
+    namespace graph
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Biconnected components and articulation points of an undirected
+         * graph, computed by one iterative depth first search (Tarjan).
+         *
+         * The DFS uses an explicit stack, so that long chains do not
+         * overflow the call stack. Each block hangs below the vertex where
+         * the search entered it, which is the top of the block, so that
+         * blocks and cut vertices form a rooted tree.
+         *
+         * The branch of a block is the part of the graph that is cut off
+         * if the top of the block is removed, which is the DFS subtree
+         * of the child of the top within that block. Since the subtree
+         * is contiguous in the preorder, size, edge count and cycle
+         * length of each branch are known without another search.
+         */
+        class BlockCutTree
+        {
+            index_t mNumberOfVertices = 0 ;
+
+            // position of each vertex in the DFS preorder
+            Vector< index_t > mPreorder ;
+
+            // vertex at each position of the preorder
+            Vector< index_t > mOrder ;
+
+            // number of vertices in the DFS subtree of each vertex
+            Vector< index_t > mSubtreeSize ;
+
+            // number of edges with both ends in the subtree
+            Vector< index_t > mSubtreeEdges ;
+
+            // number of back edges in the subtree
+            Vector< index_t > mSubtreeBackEdges ;
+
+            // sum of the cycle lengths closed by these back edges
+            Vector< index_t > mSubtreeCycleLength ;
+
+            // first entry of each block in mBlockVertices, size B+1
+            Cell< index_t > mBlockOffsets ;
+
+            // vertices of the blocks, the top of each block comes first
+            Cell< index_t > mBlockVertices ;
+
+            // number of edges in each block
+            Cell< index_t > mBlockEdges ;
+
+            // DFS child of the top in each block
+            Cell< index_t > mBlockChild ;
+
+            // block that contains a vertex below its top,
+            // gNoIndex for the roots of the search
+            Vector< index_t > mVertexBlock ;
+
+            // blocks that hang below each vertex, size V+1 and B
+            Vector< index_t > mChildOffsets ;
+            Vector< index_t > mChildBlocks ;
+
+            // articulation points in the order they were found
+            Cell< index_t > mCutVertices ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            BlockCutTree() = default ;
+
+//------------------------------------------------------------------------------
+
+            BlockCutTree( const CSRGraph & aGraph );
+
+//------------------------------------------------------------------------------
+
+            ~BlockCutTree() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * run the search, time O(V+E)
+             */
+            void
+            build( const CSRGraph & aGraph );
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_vertices() const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_blocks() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * number of vertices in a block, including its top
+             */
+            inline index_t
+            block_size( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            block_edge_count( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * k-th vertex of a block, the top is k=0
+             */
+            inline index_t
+            block_vertex( const index_t aBlock, const index_t aK ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * the vertex where the search entered the block
+             */
+            inline index_t
+            block_top( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * the block that contains the vertex below its top,
+             * gNoIndex for the roots of the search and isolated vertices
+             */
+            inline index_t
+            vertex_block( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline bool
+            is_cut_vertex( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline const Cell< index_t > &
+            cut_vertices() const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * number of blocks that hang below a vertex
+             */
+            inline index_t
+            number_of_child_blocks( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            child_block( const index_t aVertex, const index_t aK ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * true if removing the top of the block cuts off its branch
+             */
+            inline bool
+            is_separating( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * number of vertices in the branch of a block, without its top
+             */
+            inline index_t
+            branch_size( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * number of edges between the vertices of the branch
+             */
+            inline index_t
+            branch_edge_count( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * true if the branch contains exactly one cycle
+             */
+            inline bool
+            branch_is_unicyclic( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * length of the cycle if the branch is unicyclic, otherwise zero
+             */
+            inline index_t
+            branch_cycle_length( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * first preorder position of the branch
+             */
+            inline index_t
+            branch_begin( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * preorder position after the branch
+             */
+            inline index_t
+            branch_end( const index_t aBlock ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * vertex at a position of the preorder
+             */
+            inline index_t
+            ordered_vertex( const index_t aPosition ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * collect the vertices of the branch of a block
+             */
+            void
+            branch( const index_t aBlock, Cell< index_t > & aVertices ) const ;
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::number_of_vertices() const
+        {
+            return mNumberOfVertices ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::number_of_blocks() const
+        {
+            return mBlockChild.size() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::block_size( const index_t aBlock ) const
+        {
+            return mBlockOffsets( aBlock + 1 ) - mBlockOffsets( aBlock );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::block_edge_count( const index_t aBlock ) const
+        {
+            return mBlockEdges( aBlock );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::block_vertex( const index_t aBlock, const index_t aK ) const
+        {
+            return mBlockVertices( mBlockOffsets( aBlock ) + aK );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::block_top( const index_t aBlock ) const
+        {
+            return mBlockVertices( mBlockOffsets( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::vertex_block( const index_t aVertex ) const
+        {
+            return mVertexBlock( aVertex );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline bool
+        BlockCutTree::is_cut_vertex( const index_t aVertex ) const
+        {
+            // a root must separate at least two blocks
+            return this->number_of_child_blocks( aVertex ) >
+                ( mVertexBlock( aVertex ) == gNoIndex ? 1 : 0 );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Cell< index_t > &
+        BlockCutTree::cut_vertices() const
+        {
+            return mCutVertices ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::number_of_child_blocks( const index_t aVertex ) const
+        {
+            return mChildOffsets( aVertex + 1 ) - mChildOffsets( aVertex );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::child_block( const index_t aVertex, const index_t aK ) const
+        {
+            return mChildBlocks( mChildOffsets( aVertex ) + aK );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline bool
+        BlockCutTree::is_separating( const index_t aBlock ) const
+        {
+            return this->is_cut_vertex( this->block_top( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::branch_size( const index_t aBlock ) const
+        {
+            return mSubtreeSize( mBlockChild( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::branch_edge_count( const index_t aBlock ) const
+        {
+            return mSubtreeEdges( mBlockChild( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline bool
+        BlockCutTree::branch_is_unicyclic( const index_t aBlock ) const
+        {
+            // the tree edges connect the branch, so each further edge
+            // closes one cycle
+            return mSubtreeBackEdges( mBlockChild( aBlock ) ) == 1 ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::branch_cycle_length( const index_t aBlock ) const
+        {
+            return this->branch_is_unicyclic( aBlock ) ?
+                mSubtreeCycleLength( mBlockChild( aBlock ) ) : 0 ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::branch_begin( const index_t aBlock ) const
+        {
+            return mPreorder( mBlockChild( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::branch_end( const index_t aBlock ) const
+        {
+            return mPreorder( mBlockChild( aBlock ) )
+                + mSubtreeSize( mBlockChild( aBlock ) );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        BlockCutTree::ordered_vertex( const index_t aPosition ) const
+        {
+            return mOrder( aPosition );
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_GRAPH_BLOCKCUTTREE_HPP
@@ -0,0 +1,197 @@
+//
+// Created on 16.10.26.
+//
+
+#include <algorithm>
+
+#include "assert.hpp"
+#include "cl_Graph_CSRGraph.hpp"
+
+namespace belfem
+{
+    namespace graph
+    {
+//------------------------------------------------------------------------------
+
+        CSRGraph::CSRGraph( Graph & aGraph )
+        {
+            this->build( aGraph );
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CSRGraph::build( Graph & aGraph )
+        {
+            mNumberOfVertices = aGraph.size() ;
+
+            // the position of each vertex is needed for the neighbors
+            for( index_t k=0; k<mNumberOfVertices; ++k )
+            {
+                aGraph( k )->set_index( k );
+            }
+
+            mOffsets.set_size( mNumberOfVertices + 1, 0 );
+            mIds.set_size( mNumberOfVertices );
+
+            for( index_t k=0; k<mNumberOfVertices; ++k )
+            {
+                mOffsets( k + 1 ) = mOffsets( k ) + aGraph( k )->number_of_vertices() ;
+                mIds( k ) = aGraph( k )->id() ;
+            }
+
+            mAdjacency.set_size( mOffsets( mNumberOfVertices ) );
+
+            for( index_t k=0; k<mNumberOfVertices; ++k )
+            {
+                Vertex * tVertex = aGraph( k );
+                index_t tStart = mOffsets( k );
+
+                for( uint j=0; j<tVertex->number_of_vertices(); ++j )
+                {
+                    mAdjacency( tStart + j ) = tVertex->vertex( j )->index() ;
+                }
+            }
+
+            this->finalize() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CSRGraph::induced_subgraph(
+                const Cell< index_t > & aVertices,
+                CSRGraph & aSubgraph,
+                Vector< index_t > & aWork ) const
+        {
+            BELFEM_ASSERT( aWork.length() == mNumberOfVertices,
+                          "work vector has wrong size" );
+
+            index_t tNumberOfVertices = aVertices.size() ;
+
+            aSubgraph.mNumberOfVertices = tNumberOfVertices ;
+            aSubgraph.mOffsets.set_size( tNumberOfVertices + 1, 0 );
+            aSubgraph.mIds.set_size( tNumberOfVertices );
+
+            // global to local
+            for( index_t k=0; k<tNumberOfVertices; ++k )
+            {
+                aWork( aVertices( k ) ) = k ;
+                aSubgraph.mIds( k ) = mIds( aVertices( k ) );
+            }
+
+            // count the edges within the subgraph
+            for( index_t k=0; k<tNumberOfVertices; ++k )
+            {
+                index_t tCount = 0 ;
+                index_t tVertex = aVertices( k );
+                for( index_t j=mOffsets( tVertex ); j<mOffsets( tVertex + 1 ); ++j )
+                {
+                    if( aWork( mAdjacency( j ) ) != gNoIndex )
+                    {
+                        ++tCount ;
+                    }
+                }
+                aSubgraph.mOffsets( k + 1 ) = aSubgraph.mOffsets( k ) + tCount ;
+            }
+
+            aSubgraph.mAdjacency.set_size( aSubgraph.mOffsets( tNumberOfVertices ) );
+
+            for( index_t k=0; k<tNumberOfVertices; ++k )
+            {
+                index_t tCount = aSubgraph.mOffsets( k );
+                index_t tVertex = aVertices( k );
+                for( index_t j=mOffsets( tVertex ); j<mOffsets( tVertex + 1 ); ++j )
+                {
+                    index_t tLocal = aWork( mAdjacency( j ) );
+                    if( tLocal != gNoIndex )
+                    {
+                        aSubgraph.mAdjacency( tCount++ ) = tLocal ;
+                    }
+                }
+            }
+
+            // restore the work vector
+            for( index_t k : aVertices )
+            {
+                aWork( k ) = gNoIndex ;
+            }
+
+            aSubgraph.finalize() ;
+        }
+
+//------------------------------------------------------------------------------
+
+        index_t
+        CSRGraph::find( const index_t aU, const index_t aV ) const
+        {
+            // bisection in the sorted row
+            const index_t * tBegin = mAdjacency.ptr() + mOffsets( aU );
+            const index_t * tEnd   = mAdjacency.ptr() + mOffsets( aU + 1 );
+
+            const index_t * tEntry = std::lower_bound( tBegin, tEnd, aV );
+
+            if( tEntry != tEnd && *tEntry == aV )
+            {
+                return tEntry - mAdjacency.ptr() ;
+            }
+            else
+            {
+                return gNoIndex ;
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        void
+        CSRGraph::finalize()
+        {
+            // sort each row
+            for( index_t k=0; k<mNumberOfVertices; ++k )
+            {
+                std::sort( mAdjacency.ptr() + mOffsets( k ),
+                           mAdjacency.ptr() + mOffsets( k + 1 ) );
+            }
+
+            BELFEM_ERROR( mAdjacency.length() % 2 == 0,
+                         "the graph is not undirected" );
+
+            mNumberOfEdges = mAdjacency.length() / 2 ;
+
+            mEdges.set_size( mAdjacency.length() );
+
+            // the lower vertex creates the edge, the higher one looks it up
+            index_t tCount = 0 ;
+            for( index_t k=0; k<mNumberOfVertices; ++k )
+            {
+                for( index_t j=mOffsets( k ); j<mOffsets( k + 1 ); ++j )
+                {
+                    index_t tNeighbor = mAdjacency( j );
+
+                    // find( k, k ) would return this entry itself
+                    BELFEM_ERROR( tNeighbor != k, "vertex %lu has a self-loop",
+                                  ( long unsigned int ) k );
+
+                    if( k < tNeighbor )
+                    {
+                        mEdges( j ) = tCount++ ;
+                    }
+                    else
+                    {
+                        index_t tPosition = this->find( tNeighbor, k );
+
+                        BELFEM_ERROR( tPosition != gNoIndex,
+                                     "the graph is not undirected, edge %lu - %lu has no twin",
+                                     ( long unsigned int ) k, ( long unsigned int ) tNeighbor );
+
+                        mEdges( j ) = mEdges( tPosition );
+                    }
+                }
+            }
+
+            BELFEM_ERROR( tCount == mNumberOfEdges, "the graph is not undirected" );
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,277 @@
+//
+// Created on 16.10.26.
+//
+
+#ifndef BELFEM_CL_GRAPH_CSRGRAPH_HPP
+#define BELFEM_CL_GRAPH_CSRGRAPH_HPP
+
+#include "typedefs.hpp"
+#include "cl_Cell.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Graph_Vertex.hpp"
+
+namespace belfem
+{
+    namespace graph
+    {
+//------------------------------------------------------------------------------
+
+        /**
+         * Immutable adjacency of an undirected graph in compressed
+         * sparse row format.
+         *
+         * Vertex k of the CSRGraph is vertex k of the Graph it was built
+         * from. The neighbors of each vertex are stored in ascending order,
+         * so that an edge can be found by bisection. Each undirected edge
+         * has an index, which is the same for both directions, so that
+         * algorithms can store edge data in one flat array.
+         *
+         * The graph is built once and can be shared by the matching,
+         * the articulation point search and the level reordering.
+         *
+         * Note: building a CSRGraph from a Graph overwrites the indices of
+         * its vertices with their position in the graph. The adapters for
+         * Graph rely on this. Callers that need the old indices, for example
+         * the indices of mesh nodes, must save and restore them.
+         *
+         * Self-loops are not allowed.
+         */
+        class CSRGraph
+        {
+            index_t mNumberOfVertices = 0 ;
+            index_t mNumberOfEdges = 0 ;
+
+            // first entry of each vertex in mAdjacency, size V+1
+            Vector< index_t > mOffsets ;
+
+            // neighbors, sorted per vertex, size 2E
+            Vector< index_t > mAdjacency ;
+
+            // undirected edge index of each entry, size 2E
+            Vector< index_t > mEdges ;
+
+            // ids of the vertices
+            Vector< id_t > mIds ;
+
+//------------------------------------------------------------------------------
+        public:
+//------------------------------------------------------------------------------
+
+            CSRGraph() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * build the adjacency from a graph.
+             * Overwrites the indices of the vertices, see build()
+             */
+            CSRGraph( Graph & aGraph );
+
+//------------------------------------------------------------------------------
+
+            ~CSRGraph() = default ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * build the adjacency from a graph.
+             * Overwrites the index of each vertex with its position
+             * in aGraph, so that vertex k of this graph is aGraph( k ).
+             */
+            void
+            build( Graph & aGraph );
+
+//------------------------------------------------------------------------------
+
+            /**
+             * the subgraph of the given vertices and the edges between them.
+             * aWork must have the size of this graph and be filled with
+             * gNoIndex, it is restored on exit.
+             */
+            void
+            induced_subgraph( const Cell< index_t > & aVertices,
+                              CSRGraph & aSubgraph,
+                              Vector< index_t > & aWork ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_vertices() const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            number_of_edges() const ;
+
+//------------------------------------------------------------------------------
+
+            inline index_t
+            degree( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * position of the first neighbor of a vertex
+             */
+            inline index_t
+            begin( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * position after the last neighbor of a vertex
+             */
+            inline index_t
+            end( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * neighbor at a position between begin() and end()
+             */
+            inline index_t
+            neighbor( const index_t aPosition ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * undirected edge at a position between begin() and end()
+             */
+            inline index_t
+            edge( const index_t aPosition ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline id_t
+            id( const index_t aVertex ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * position of aV in the row of aU, gNoIndex if there is no edge
+             */
+            index_t
+            find( const index_t aU, const index_t aV ) const ;
+
+//------------------------------------------------------------------------------
+
+            /**
+             * index of the edge between aU and aV, gNoIndex if there is none
+             */
+            inline index_t
+            edge( const index_t aU, const index_t aV ) const ;
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< index_t > &
+            offsets() const ;
+
+//------------------------------------------------------------------------------
+
+            inline const Vector< index_t > &
+            adjacency() const ;
+
+//------------------------------------------------------------------------------
+        private:
+//------------------------------------------------------------------------------
+
+            // sort the rows and number the edges
+            void
+            finalize();
+
+//------------------------------------------------------------------------------
+        };
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::number_of_vertices() const
+        {
+            return mNumberOfVertices ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::number_of_edges() const
+        {
+            return mNumberOfEdges ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::degree( const index_t aVertex ) const
+        {
+            return mOffsets( aVertex + 1 ) - mOffsets( aVertex );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::begin( const index_t aVertex ) const
+        {
+            return mOffsets( aVertex );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::end( const index_t aVertex ) const
+        {
+            return mOffsets( aVertex + 1 );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::neighbor( const index_t aPosition ) const
+        {
+            return mAdjacency( aPosition );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::edge( const index_t aPosition ) const
+        {
+            return mEdges( aPosition );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline id_t
+        CSRGraph::id( const index_t aVertex ) const
+        {
+            return mIds( aVertex );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline index_t
+        CSRGraph::edge( const index_t aU, const index_t aV ) const
+        {
+            index_t tPosition = this->find( aU, aV );
+            return tPosition == gNoIndex ? gNoIndex : mEdges( tPosition );
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< index_t > &
+        CSRGraph::offsets() const
+        {
+            return mOffsets ;
+        }
+
+//------------------------------------------------------------------------------
+
+        inline const Vector< index_t > &
+        CSRGraph::adjacency() const
+        {
+            return mAdjacency ;
+        }
+
+//------------------------------------------------------------------------------
+    }
+}
+#endif //BELFEM_CL_GRAPH_CSRGRAPH_HPP
@@ -16,7 +16,7 @@
  * and handling odd-length cycles (blossoms) through contraction.
  *
  * KEY DATA STRUCTURES:
- * - CSR (Compressed Sparse Row) format for cache-efficient adjacency access
+ * - CSR (Compressed Sparse Row) adjacency from CSRGraph, shared with the caller
  * - Edge status array aligned with CSR for O(1) lookups
  * - Level arrays (mEvenLevel, mOddLevel) for alternating forest structure
  * - Free-list based stacks to avoid dynamic allocation in inner loops
@@ -37,7 +37,6 @@
 #include "fn_Graph_max_cardinality_matching.hpp"
 #include "cl_DynamicBitset.hpp"
 #include "cl_Cell.hpp"
-#include "cl_Map.hpp"
 #include "cl_Queue.hpp"
 #include "cl_Vector.hpp"
 
@@ -45,9 +44,6 @@ namespace belfem
 {
     namespace graph
     {
-        // Graph typedef for cleaner signatures
-        typedef Cell< Vertex * > Graph;
-
 //------------------------------------------------------------------------------
 
         /**
@@ -64,13 +60,7 @@ namespace belfem
             index_t mInfinity;           // Sentinel value for "infinity" (max(V,E)+1)
             index_t mSearchLevelLimit;   // Maximum search depth (V/2 + 1)
 
-            Graph & mGraph;              // Reference to input graph
-
-            // CSR (Compressed Sparse Row) adjacency storage
-            // Provides O(1) neighbor access with better cache locality than adjacency lists
-            Vector< index_t > mAdjStart;   // Start index in mAdjList for each vertex
-            Vector< index_t > mAdjList;    // Flattened array of all neighbors
-            Map< key_t, index_t > mEdgeMap ;
+            const CSRGraph & mGraph;     // Adjacency of the input graph
 
             // Edge status tracking (aligned with CSR for O(1) access)
             // Stores usage flags for each edge during path search
@@ -110,9 +100,9 @@ namespace belfem
         public:
             /**
              * @brief Constructs the algorithm with a graph reference
-             * @param aGraph Reference to graph (will set vertex indices internally)
+             * @param aGraph Adjacency of the graph
              */
-            MicaliVazirani( Graph & aGraph );
+            MicaliVazirani( const CSRGraph & aGraph );
 
             /**
              * @brief Runs the matching algorithm and returns the result
@@ -122,9 +112,7 @@ namespace belfem
             index_t run( Cell< index_t > & aMatch );
 
         private:
-            // CSR construction and edge status management
-            void build_csr();
-
+            // edge status management
             inline index_t find_edge_index( index_t aU, index_t aV ) const;
             inline index_t get_edge_status( index_t aU, index_t aV ) const;
             inline void add_edge_status( index_t aU, index_t aV, index_t aCode );
@@ -158,32 +146,21 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
-        MicaliVazirani::MicaliVazirani( Graph & aGraph )
+        MicaliVazirani::MicaliVazirani( const CSRGraph & aGraph )
             : mGraph( aGraph ),
-              mMark( aGraph.size() > 0 ? aGraph.size() : 1 ),
-              mVisited( aGraph.size() > 0 ? aGraph.size() : 1 )
+              mMark( aGraph.number_of_vertices() > 0 ? aGraph.number_of_vertices() : 1 ),
+              mVisited( aGraph.number_of_vertices() > 0 ? aGraph.number_of_vertices() : 1 )
         {
-            mNumVertices = aGraph.size();
+            mNumVertices = aGraph.number_of_vertices();
             if ( mNumVertices == 0 ) return;
 
-            // Set consecutive 0-based indices and cache degree in level()
-            mNumEdges = 0;
-            for ( index_t k = 0; k < mNumVertices; ++k )
-            {
-                mGraph( k )->set_index( k );
-                mGraph( k )->set_level( mGraph( k )->number_of_vertices() );
-                mNumEdges += mGraph( k )->number_of_vertices();
-            }
-            mNumEdges /= 2;
+            mNumEdges = aGraph.number_of_edges();
 
             mInfinity = std::max( mNumVertices, mNumEdges ) + 1;
             mSearchLevelLimit = mNumVertices / 2 + 1;
 
-            // Build CSR adjacency structure
-            build_csr();
-
             // Allocate edge status array (aligned with CSR)
-            mEdgeStatus.set_size( mNumEdges * 2, 0 );
+            mEdgeStatus.set_size( mNumEdges > 0 ? mNumEdges * 2 : 1, 0 );
 
             // Allocate core arrays
             mMatch.set_size( mNumVertices, gNoIndex );
@@ -218,92 +195,29 @@ namespace belfem
             mBridge2.set_size( mNumEdges + 1, 0 );
         }
 
-//------------------------------------------------------------------------------
-
-        /**
-         * @brief Builds CSR (Compressed Sparse Row) adjacency structure
-         *
-         * Converts the adjacency list representation into CSR format for cache-
-         * efficient neighbor access. The CSR format stores all neighbors in a
-         * contiguous array with an offset array for each vertex.
-         *
-         * Time: O(V + E)
-         * Space: O(V + E)
-         */
-        void
-        MicaliVazirani::build_csr()
-        {
-            // Build offset array using prefix sum of degrees
-            mAdjStart.set_size( mNumVertices + 1, 0 );
-
-            for ( index_t k = 0; k < mNumVertices; ++k )
-            {
-                mAdjStart( k + 1 ) = mAdjStart( k ) + mGraph( k )->level();
-            }
-
-            // Flatten all adjacency lists into a single contiguous array
-            mAdjList.set_size( mNumEdges * 2, 0 );
-
-            for ( index_t k = 0; k < mNumVertices; ++k )
-            {
-                Vertex * tVertex = mGraph( k );
-                index_t tStart = mAdjStart( k );
-                uint tDegree = tVertex->level();
-
-                for ( uint j = 0; j < tDegree; ++j )
-                {
-                    mAdjList( tStart + j ) = tVertex->vertex( j )->index();
-                }
-            }
-
-            for ( index_t u = 0; u < mNumVertices; ++u )
-            {
-
-                for ( index_t k = mAdjStart( u ); k < mAdjStart( u+1 ); ++k )
-                {
-                    index_t v = mAdjList( k );
-
-                    key_t tKey = u > v ? u * mNumVertices + v : v * mNumVertices + u;
-                    mEdgeMap[ tKey ] = k;
-                }
-            }
-        }
-
 //------------------------------------------------------------------------------
 
         /**
          * @brief Finds the CSR index for an edge (u,v)
          *
-         * Searches the adjacency list of the lower-indexed vertex to find the
-         * position of the edge in the CSR structure. This index can be used to
-         * access both the neighbor in mAdjList and the edge status in mEdgeStatus.
+         * Bisection in the sorted row of the vertex with the larger index,
+         * so that (u,v) and (v,u) share one entry in mEdgeStatus.
          *
          * @param aU First vertex
          * @param aV Second vertex
-         * @return Index into mAdjList and mEdgeStatus arrays
+         * @return Index into mEdgeStatus
          *
-         * Time: O(degree(min(u,v)))
+         * Time: O(log(degree(max(u,v))))
          */
         inline index_t
         MicaliVazirani::find_edge_index( index_t aU, index_t aV ) const
         {
-            key_t tMin = std::min( aU, aV );
-            key_t tMax = std::max( aU, aV );
+            index_t tIndex = mGraph.find( std::max( aU, aV ), std::min( aU, aV ) );
 
-            // not sure if this is faster. Maybe?
-            return mEdgeMap( tMax * mNumVertices + tMin );
-            // Search in adjacency list of vertex with smaller index
-            /*for ( index_t k = mAdjStart( tMin ); k < mAdjStart( tMin + 1 ); ++k )
-            {
-                if ( mAdjList( k ) == tMax )
-                {
-                    return k;
-                }
-            }*/
-
-            BELFEM_ERROR( false, "Edge not found: %lu - %lu",
+            BELFEM_ASSERT( tIndex != gNoIndex, "Edge not found: %lu - %lu",
                         (long unsigned int) aU, (long unsigned int) aV );
-            return 0;
+
+            return tIndex;
         }
 
 //------------------------------------------------------------------------------
@@ -1151,7 +1065,7 @@ namespace belfem
 
             for ( index_t k = 0; k < mNumVertices; ++k )
             {
-                tDegreeOrder.push( { mGraph( k )->level(), k } );
+                tDegreeOrder.push( { ( uint ) mGraph.degree( k ), k } );
             }
 
             std::sort( tDegreeOrder.begin(), tDegreeOrder.end() );
@@ -1170,9 +1084,9 @@ namespace belfem
                 if ( !tUnmatched.test( tV ) ) continue;
 
                 // Find first unmatched neighbor
-                for ( index_t j = mAdjStart( tV ); j < mAdjStart( tV + 1 ); ++j )
+                for ( index_t j = mGraph.begin( tV ); j < mGraph.end( tV ); ++j )
                 {
-                    index_t tU = mAdjList( j );
+                    index_t tU = mGraph.neighbor( j );
                     if ( tUnmatched.test( tU ) )
                     {
                         mMatch( tU ) = tV;
@@ -1291,9 +1205,9 @@ namespace belfem
                 if ( aSearchLevel != 0 || mMatch( tV ) == gNoIndex )
                 {
                     // Examine all neighbors
-                    for ( index_t j = mAdjStart( tV ); j < mAdjStart( tV + 1 ); ++j )
+                    for ( index_t j = mGraph.begin( tV ); j < mGraph.end( tV ); ++j )
                     {
-                        index_t tU = mAdjList( j );
+                        index_t tU = mGraph.neighbor( j );
                         index_t tCode = mEdgeStatus( j );
 
                         // Skip matched edges and used edges
@@ -1570,7 +1484,7 @@ namespace belfem
          * Public API function for computing maximum cardinality matching using the
          * Micali-Vazirani algorithm.
          *
-         * @param aGraph Input graph (vertex indices will be set automatically)
+         * @param aGraph Adjacency of the input graph
          * @param aMatch Output: aMatch[v] = matched vertex or gNoIndex if unmatched
          * @return Cardinality of the maximum matching found
          *
@@ -1578,12 +1492,26 @@ namespace belfem
          * Space: O(V + E)
          */
         index_t
-        max_cardinality_matching( Graph & aGraph, Cell< index_t > & aMatch )
+        max_cardinality_matching( const CSRGraph & aGraph, Cell< index_t > & aMatch )
         {
             MicaliVazirani tAlgorithm( aGraph );
             return tAlgorithm.run( aMatch );
         }
 
+//------------------------------------------------------------------------------
+
+        /**
+         * @brief Adapter for graphs of vertices, builds the CSRGraph first
+         *
+         * @param aGraph Input graph (vertex indices will be set automatically)
+         */
+        index_t
+        max_cardinality_matching( Graph & aGraph, Cell< index_t > & aMatch )
+        {
+            CSRGraph tGraph( aGraph );
+            return max_cardinality_matching( tGraph, aMatch );
+        }
+
 //------------------------------------------------------------------------------
     }
 }
@@ -17,6 +17,7 @@
 #include "cl_Cell.hpp"
 #include "cl_DynamicBitset.hpp"
 #include "cl_Graph_Vertex.hpp"
+#include "cl_Graph_CSRGraph.hpp"
 
 namespace belfem
 {
@@ -45,8 +46,8 @@ namespace belfem
          *                     is a neighbor of vertex B, then B must also be a neighbor
          *                     of A.
          *
-         * @note               The vertex level() field is used internally to store
-         *                     degree information during computation.
+         * @note               The vertex indices are set to the position in aGraph,
+         *                     the matching works on a CSRGraph built from it.
          *
          * Example usage:
          * @code
@@ -65,6 +66,17 @@ namespace belfem
                 Graph & aGraph,
                 Cell< index_t >  & aMatch );
 
+//------------------------------------------------------------------------------
+
+        /**
+         * Same as above, but on a graph that is already in CSR format.
+         * aMatch refers to the vertex numbering of aGraph.
+         */
+        index_t
+        max_cardinality_matching(
+                const CSRGraph & aGraph,
+                Cell< index_t >  & aMatch );
+
 //------------------------------------------------------------------------------
     }
 }
@@ -1,12 +1,18 @@
 // fn_Graph_reorder_by_levels.cpp
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "typedefs.hpp"
 #include "cl_Vector.hpp"
-#include "cl_Queue.hpp"
-#include "cl_DynamicBitset.hpp"
 #include "op_Graph_Vertex_Index.hpp"
 #include "fn_Graph_symrcm.hpp"
+#include "fn_Graph_reorder_by_levels.hpp"
+#include "fn_Graph_max_cardinality_matching.hpp"
 
 namespace belfem
 {
@@ -14,50 +20,49 @@ namespace belfem
     {
 //------------------------------------------------------------------------------
 
-        // BFS to compute distances from a set of source vertices
+        // BFS to compute distances from a set of source vertices,
+        // unreachable vertices are NaN
         real
         compute_distances(
-            Graph & aGraph,
-            Graph & aSources,
-            Vector< real > & aDistance )
+            const CSRGraph & aGraph,
+            const Cell< index_t > & aSources,
+            Vector< real > & aDistance,
+            Vector< index_t > & aQueue )
         {
-            index_t tNumVertices = aGraph.size();
+            index_t tNumVertices = aGraph.number_of_vertices();
             aDistance.set_size( tNumVertices, BELFEM_QUIET_NAN );
+            aQueue.set_size( tNumVertices );
 
-            for ( Vertex * tVertex : aSources )
-            {
-                tVertex->unflag() ;
-            }
-
-            Queue< Vertex * > tQueue;
+            index_t tHead = 0;
+            index_t tTail = 0;
 
             // Initialize sources at distance 0
-            for ( Vertex * tVertex : aSources )
+            for ( index_t tVertex : aSources )
             {
-                aDistance( tVertex->index() ) = 0.0;
-                tQueue.push( tVertex );
-                tVertex->flag();
+                if ( std::isnan( aDistance( tVertex ) ) )
+                {
+                    aDistance( tVertex ) = 0.0;
+                    aQueue( tTail++ ) = tVertex;
+                }
             }
 
             // BFS
             real aMaxDistance = 0.0 ;
 
-            while ( !tQueue.empty() )
+            while ( tHead < tTail )
             {
-                Vertex * tVertex = tQueue.pop();
-                real tCurrentDist = aDistance( tVertex->index() );
+                index_t tVertex = aQueue( tHead++ );
+                real tNextDist = aDistance( tVertex ) + 1.0;
 
                 // Visit all neighbors
-                for ( uint k = 0; k < tVertex->number_of_vertices(); ++k )
+                for ( index_t k = aGraph.begin( tVertex ); k < aGraph.end( tVertex ); ++k )
                 {
-                    Vertex * tNeighbor = tVertex->vertex( k );
-                    if ( ! tNeighbor->is_flagged() )
+                    index_t tNeighbor = aGraph.neighbor( k );
+                    if ( std::isnan( aDistance( tNeighbor ) ) )
                     {
-                        real tNextDist = tCurrentDist + 1.0;
                         aMaxDistance = std::max( aMaxDistance, tNextDist );
-                        aDistance( tNeighbor->index() ) = tNextDist;
-                        tNeighbor->flag();
-                        tQueue.push( tNeighbor );
+                        aDistance( tNeighbor ) = tNextDist;
+                        aQueue( tTail++ ) = tNeighbor;
                     }
                 }
             }
@@ -65,6 +70,128 @@ namespace belfem
             return aMaxDistance;
         }
 
+//------------------------------------------------------------------------------
+
+        // Level-synchronous BFS, the vertices of each front are split
+        // among the threads, and each neighbor is claimed by the first
+        // thread that reaches it. The distances are the same as in the
+        // serial version.
+        real
+        compute_distances(
+            const CSRGraph & aGraph,
+            const Cell< index_t > & aSources,
+            Vector< real > & aDistance,
+            const uint aNumberOfThreads )
+        {
+            // small fronts are expanded by the calling thread,
+            // since starting threads would cost more than the visit
+            const index_t tMinFrontPerThread = 1024;
+
+            index_t tNumVertices = aGraph.number_of_vertices();
+
+            std::vector< std::atomic< index_t > > tLevel( tNumVertices );
+            for ( std::atomic< index_t > & tValue : tLevel )
+            {
+                tValue.store( gNoIndex, std::memory_order_relaxed );
+            }
+
+            Cell< index_t > tFront;
+            for ( index_t tVertex : aSources )
+            {
+                if ( tLevel[ tVertex ].load( std::memory_order_relaxed ) == gNoIndex )
+                {
+                    tLevel[ tVertex ].store( 0, std::memory_order_relaxed );
+                    tFront.push( tVertex );
+                }
+            }
+
+            // the next front, collected separately by each thread
+            Cell< Cell< index_t > > tNextFronts( aNumberOfThreads, {} );
+
+            index_t tMaxLevel = 0;
+
+            while ( tFront.size() > 0 )
+            {
+                index_t tFrontSize = tFront.size();
+                index_t tNextLevel = tMaxLevel + 1;
+
+                uint tNumThreads = std::min( aNumberOfThreads,
+                                             static_cast< uint >( tFrontSize / tMinFrontPerThread ) );
+                tNumThreads = std::max( tNumThreads, ( uint ) 1 );
+
+                auto tExpand = [ & ]( const uint aThread )
+                {
+                    Cell< index_t > & tNext = tNextFronts( aThread );
+                    tNext.clear();
+
+                    index_t tBegin = ( tFrontSize * aThread ) / tNumThreads;
+                    index_t tEnd   = ( tFrontSize * ( aThread + 1 ) ) / tNumThreads;
+
+                    for ( index_t i = tBegin; i < tEnd; ++i )
+                    {
+                        index_t tVertex = tFront( i );
+
+                        for ( index_t k = aGraph.begin( tVertex ); k < aGraph.end( tVertex ); ++k )
+                        {
+                            index_t tNeighbor = aGraph.neighbor( k );
+                            index_t tExpected = gNoIndex;
+
+                            if ( tLevel[ tNeighbor ].load( std::memory_order_relaxed ) == gNoIndex
+                                && tLevel[ tNeighbor ].compare_exchange_strong(
+                                        tExpected, tNextLevel, std::memory_order_relaxed ) )
+                            {
+                                tNext.push( tNeighbor );
+                            }
+                        }
+                    }
+                };
+
+                if ( tNumThreads < 2 )
+                {
+                    tExpand( 0 );
+                }
+                else
+                {
+                    std::vector< std::thread > tThreads;
+                    tThreads.reserve( tNumThreads );
+
+                    for ( uint t = 0; t < tNumThreads; ++t )
+                    {
+                        tThreads.emplace_back( tExpand, t );
+                    }
+
+                    for ( std::thread & tThread : tThreads )
+                    {
+                        tThread.join();
+                    }
+                }
+
+                tFront.clear();
+                for ( uint t = 0; t < tNumThreads; ++t )
+                {
+                    append( tFront, tNextFronts( t ) );
+                }
+
+                if ( tFront.size() > 0 )
+                {
+                    tMaxLevel = tNextLevel;
+                }
+            }
+
+            aDistance.set_size( tNumVertices, BELFEM_QUIET_NAN );
+
+            for ( index_t k = 0; k < tNumVertices; ++k )
+            {
+                index_t tValue = tLevel[ k ].load( std::memory_order_relaxed );
+                if ( tValue != gNoIndex )
+                {
+                    aDistance( k ) = static_cast< real >( tValue );
+                }
+            }
+
+            return static_cast< real >( tMaxLevel );
+        }
+
 //------------------------------------------------------------------------------
 
         // Compute pseudo-temperature from distances to both boundaries
@@ -83,17 +210,17 @@ namespace belfem
                 real d0 = aDist0( k );
                 real d1 = aDist1( k );
 
-                if ( d0 == BELFEM_QUIET_NAN && d1 == BELFEM_QUIET_NAN )
+                if ( std::isnan( d0 ) && std::isnan( d1 ) )
                 {
                     // Disconnected vertex - place in middle
                     aPseudoT( k ) = 0.5;
                 }
-                else if ( d0 == BELFEM_QUIET_NAN )
+                else if ( std::isnan( d0 ) )
                 {
                     // Only reachable from Γ₁
                     aPseudoT( k ) = 1.0;
                 }
-                else if ( d1 == BELFEM_QUIET_NAN )
+                else if ( std::isnan( d1 ) )
                 {
                     // Only reachable from Γ₀
                     aPseudoT( k ) = 0.0;
@@ -112,127 +239,241 @@ namespace belfem
 
 //------------------------------------------------------------------------------
 
-        // Build subgraph for vertices in a given index range
+        // Refine ordering within a level using matching
+        // Matched pairs get consecutive indices
         void
-        build_level_subgraph(
-            Graph & aGraph,
-            Cell< index_t > & aLevelIndices,
-            Graph & aSubgraph,
-            Map< index_t, index_t > & aGlobalToLocal )
+        refine_level_with_matching(
+            const CSRGraph & aGraph,
+            const Cell< index_t > & aLevelIndices,
+            Vector< index_t > & aNewIndices,
+            Vector< index_t > & aWork,
+            index_t & aCurrentIndex )
         {
-            index_t tNumLocal = aLevelIndices.size();
-            aSubgraph.set_size( tNumLocal, nullptr );
-            aGlobalToLocal.clear();
+            index_t tNumInLevel = aLevelIndices.size();
 
-            // Create local vertices and mapping
-            for ( index_t k = 0; k < tNumLocal; ++k )
+            if ( tNumInLevel == 0 )
             {
-                index_t tGlobal = aLevelIndices( k );
-                aGlobalToLocal[ tGlobal ] = k;
+                return;
+            }
 
-                aSubgraph( k ) = new Vertex();
-                aSubgraph( k )->set_id( aGraph( tGlobal )->id() );
-                aSubgraph( k )->set_index( k );
+            if ( tNumInLevel == 1 )
+            {
+                aNewIndices( aLevelIndices( 0 ) ) = aCurrentIndex++;
+                return;
             }
 
-            // Build edges (only between vertices in this level)
-            for ( index_t k = 0; k < tNumLocal; ++k )
+            // Build subgraph for this level
+            CSRGraph tSubgraph;
+            aGraph.induced_subgraph( aLevelIndices, tSubgraph, aWork );
+
+            // Find matching
+            Cell< index_t > tMatch;
+            max_cardinality_matching( tSubgraph, tMatch );
+
+            // Assign indices: matched pairs get consecutive indices
+            for ( index_t k = 0; k < tNumInLevel; ++k )
             {
                 index_t tGlobal = aLevelIndices( k );
-                Vertex * tOriginal = aGraph( tGlobal );
 
-                // Count neighbors in this level
-                uint tCount = 0;
-                for ( uint n = 0; n < tOriginal->number_of_vertices(); ++n )
+                if ( aNewIndices( tGlobal ) == gNoIndex )
                 {
-                    index_t tNeighborGlobal = tOriginal->vertex( n )->index();
-                    if ( aGlobalToLocal.key_exists( tNeighborGlobal ) )
+                    aNewIndices( tGlobal ) = aCurrentIndex++;
+
+                    // If matched, assign partner next
+                    if ( tMatch( k ) != gNoIndex )
                     {
-                        ++tCount;
+                        index_t tPartnerGlobal = aLevelIndices( tMatch( k ) );
+
+                        if ( aNewIndices( tPartnerGlobal ) == gNoIndex )
+                        {
+                            aNewIndices( tPartnerGlobal ) = aCurrentIndex++;
+                        }
                     }
                 }
+            }
+        }
+
+//------------------------------------------------------------------------------
+
+        // Refine all levels concurrently. The levels do not share vertices,
+        // so each one gets its range of new indices from the sizes of the
+        // levels before it, and the threads write to different entries.
+        void
+        refine_levels_with_matching(
+            const CSRGraph & aGraph,
+            const Cell< Cell< index_t > > & aLevelBins,
+            Vector< index_t > & aNewIndices,
+            const uint aNumberOfThreads )
+        {
+            index_t tNumLevels = aLevelBins.size();
 
-                aSubgraph( k )->init_vertex_container( tCount );
+            // prefix sum of the level sizes
+            Vector< index_t > tOffsets( tNumLevels + 1, 0 );
+            for ( index_t L = 0; L < tNumLevels; ++L )
+            {
+                tOffsets( L + 1 ) = tOffsets( L ) + aLevelBins( L ).size();
+            }
+
+            // start with the largest levels, so that the threads finish together
+            Cell< index_t > tOrder( tNumLevels, 0 );
+            for ( index_t L = 0; L < tNumLevels; ++L )
+            {
+                tOrder( L ) = L;
+            }
+            std::sort( tOrder.vector_data().begin(),
+                       tOrder.vector_data().end(),
+                       [ & ]( const index_t a, const index_t b )
+                       {
+                           return aLevelBins( a ).size() > aLevelBins( b ).size();
+                       });
+
+            std::atomic< index_t > tNext( 0 );
+            std::exception_ptr tError = nullptr;
+            std::mutex tErrorMutex;
+
+            auto tRefine = [ & ]()
+            {
+                Vector< index_t > tWork( aGraph.number_of_vertices(), gNoIndex );
 
-                for ( uint n = 0; n < tOriginal->number_of_vertices(); ++n )
+                for ( index_t i = tNext++; i < tNumLevels; i = tNext++ )
                 {
-                    index_t tNeighborGlobal = tOriginal->vertex( n )->index();
-                    if ( aGlobalToLocal.key_exists( tNeighborGlobal ) )
+                    index_t L = tOrder( i );
+                    index_t tCurrentIndex = tOffsets( L );
+
+                    // a failing level must not end the other threads
+                    try
                     {
-                        index_t tNeighborLocal = aGlobalToLocal( tNeighborGlobal );
-                        aSubgraph( k )->insert_vertex( aSubgraph( tNeighborLocal ) );
+                        refine_level_with_matching( aGraph, aLevelBins( L ), aNewIndices, tWork, tCurrentIndex );
+                    }
+                    catch ( ... )
+                    {
+                        std::lock_guard< std::mutex > tLock( tErrorMutex );
+                        if ( tError == nullptr )
+                        {
+                            tError = std::current_exception();
+                        }
                     }
                 }
+            };
+
+            uint tNumThreads = std::min( aNumberOfThreads, static_cast< uint >( tNumLevels ) );
+
+            std::vector< std::thread > tThreads;
+            tThreads.reserve( tNumThreads );
+
+            for ( uint t = 0; t < tNumThreads; ++t )
+            {
+                tThreads.emplace_back( tRefine );
             }
-        }
 
-//------------------------------------------------------------------------------
+            for ( std::thread & tThread : tThreads )
+            {
+                tThread.join();
+            }
 
-        void
-        delete_subgraph( Graph & aSubgraph )
-        {
-            for ( Vertex * tVertex : aSubgraph )
+            if ( tError != nullptr )
             {
-                delete tVertex;
+                std::rethrow_exception( tError );
             }
-            aSubgraph.clear();
         }
 
 //------------------------------------------------------------------------------
 
-        // Refine ordering within a level using matching
-        // Matched pairs get consecutive indices
         void
-        refine_level_with_matching(
-            Graph & aGraph,
-            Cell< index_t > & aLevelIndices,
-            index_t & aCurrentIndex )
+        reorder_by_levels(
+            const CSRGraph & aGraph,
+            const Cell< index_t > & aSinks,
+            const Cell< index_t > & aSources,
+            Vector< index_t > & aNewIndices,
+            Vector< real > * aPseudoTemperature,
+            const uint aNumberOfThreads,
+            const bool aMatching )
         {
-            index_t tNumInLevel = aLevelIndices.size();
+            index_t tNumVertices = aGraph.number_of_vertices();
 
-            if ( tNumInLevel == 0 )
+            uint tNumThreads = aNumberOfThreads == 0 ?
+                    std::thread::hardware_concurrency() : aNumberOfThreads ;
+
+            tNumThreads = std::max( tNumThreads, ( uint ) 1 );
+
+            aNewIndices.set_size( tNumVertices, gNoIndex );
+
+            if ( tNumVertices == 0 )
             {
                 return;
             }
 
-            if ( tNumInLevel == 1 )
+            // Step 1: Compute distances from both boundaries
+            Vector< real > tDist0;
+            Vector< real > tDist1;
+            Vector< index_t > tWork;
+            real tMaxA ;
+            real tMaxB ;
+
+            if ( tNumThreads < 2 )
             {
-                aGraph( aLevelIndices( 0 ) )->set_index( aCurrentIndex++ );
-                return;
+                tMaxA = compute_distances( aGraph, aSinks, tDist0, tWork );
+                tMaxB = compute_distances( aGraph, aSources, tDist1, tWork );
+            }
+            else
+            {
+                tMaxA = compute_distances( aGraph, aSinks, tDist0, tNumThreads );
+                tMaxB = compute_distances( aGraph, aSources, tDist1, tNumThreads );
             }
 
-            // Build subgraph for this level
-            Graph tSubgraph;
-            Map< index_t, index_t > tGlobalToLocal;
-            build_level_subgraph( aGraph, aLevelIndices, tSubgraph, tGlobalToLocal );
+            real tMaxDist = tMaxA > tMaxB ? tMaxA : tMaxB;
 
-            // Find matching
-            Cell< index_t > tMatch;
-            max_cardinality_matching( tSubgraph, tMatch );
+            // Step 2: Compute pseudo-temperature T ∈ [0, 1]
+            Vector< real > tPseudoT;
+            compute_pseudo_temperature( tDist0, tDist1, tPseudoT );
 
-            // Assign indices: matched pairs get consecutive indices
-            DynamicBitset tAssigned( tNumInLevel );
+            // Use finer binning for smoother result
+            index_t tNumLevels = std::max( static_cast< index_t>(tMaxDist + 1.),  static_cast< index_t>(10) );
 
-            for ( index_t k = 0; k < tNumInLevel; ++k )
+            // Step 4: Bin vertices by pseudo-temperature
+            Cell< Cell< index_t > > tLevelBins( tNumLevels, {} );
+
+            for ( index_t k = 0; k < tNumVertices; ++k )
             {
-                if ( !tAssigned.test( k ) )
-                {
-                    index_t tGlobal = aLevelIndices( k );
-                    aGraph( tGlobal )->set_index( aCurrentIndex++ );
-                    tAssigned.set( k );
+                // Map T ∈ [0,1] to level ∈ [0, tNumLevels-1]
+                index_t tLevel = static_cast< index_t >( tPseudoT( k ) * ( tNumLevels - 1 ) + 0.5 );
+                tLevel = std::min( tLevel, tNumLevels - 1 );
+                tLevelBins( tLevel ).push( k );
+            }
 
-                    // If matched, assign partner next
-                    if ( tMatch( k ) != gNoIndex && !tAssigned.test( tMatch( k ) ) )
+            // Step 5: Process each level with matching refinement
+            if ( ! aMatching )
+            {
+                // number each level in the order of the old indices
+                index_t tCurrentIndex = 0;
+
+                for ( index_t L = 0; L < tNumLevels; ++L )
+                {
+                    for ( index_t tVertex : tLevelBins( L ) )
                     {
-                        index_t tPartnerGlobal = aLevelIndices( tMatch( k ) );
-                        aGraph( tPartnerGlobal )->set_index( aCurrentIndex++ );
-                        tAssigned.set( tMatch( k ) );
+                        aNewIndices( tVertex ) = tCurrentIndex++;
                     }
                 }
             }
+            else if ( tNumThreads < 2 )
+            {
+                index_t tCurrentIndex = 0;
+                tWork.set_size( tNumVertices, gNoIndex );
 
-            // Cleanup
-            delete_subgraph( tSubgraph );
+                for ( index_t L = 0; L < tNumLevels; ++L )
+                {
+                    refine_level_with_matching( aGraph, tLevelBins( L ), aNewIndices, tWork, tCurrentIndex );
+                }
+            }
+            else
+            {
+                refine_levels_with_matching( aGraph, tLevelBins, aNewIndices, tNumThreads );
+            }
+
+            if ( aPseudoTemperature != nullptr )
+            {
+                *aPseudoTemperature = std::move( tPseudoT );
+            }
         }
 
 //------------------------------------------------------------------------------
@@ -243,32 +484,37 @@ namespace belfem
             Graph & aSinks,
             Graph & aSources,
             Map< id_t, real > * aField,
-            const bool aSort )
+            const bool aSort,
+            const uint aNumberOfThreads )
         {
             if ( aGraph.size() == 0 )
             {
                 return;
             }
 
-            index_t tNumVertices = aGraph.size();
+            // also sets the vertex indices to the position in the graph
+            CSRGraph tGraph( aGraph );
 
-            // Ensure consistent indexing
-            for ( index_t k = 0; k < tNumVertices; ++k )
+            Cell< index_t > tSinks( aSinks.size(), gNoIndex );
+            for ( index_t k = 0; k < aSinks.size(); ++k )
             {
-                aGraph( k )->set_index( k );
+                tSinks( k ) = aSinks( k )->index();
             }
 
-            // Step 1: Compute distances from both boundaries
-            Vector< real > tDist0;
-            Vector< real > tDist1;
-            real tMaxA = compute_distances( aGraph, aSinks, tDist0 );
-            real tMaxB = compute_distances( aGraph, aSources, tDist1 );
-
-            real tMaxDist = tMaxA > tMaxB ? tMaxA : tMaxB;
+            Cell< index_t > tSources( aSources.size(), gNoIndex );
+            for ( index_t k = 0; k < aSources.size(); ++k )
+            {
+                tSources( k ) = aSources( k )->index();
+            }
 
-            // Step 2: Compute pseudo-temperature T ∈ [0, 1]
+            Vector< index_t > tNewIndices;
             Vector< real > tPseudoT;
-            compute_pseudo_temperature( tDist0, tDist1, tPseudoT );
+
+            reorder_by_levels( tGraph, tSinks, tSources, tNewIndices,
+                               aField == nullptr ? nullptr : &tPseudoT,
+                               aNumberOfThreads );
+
+            index_t tNumVertices = aGraph.size();
 
             if ( aField != nullptr )
             {
@@ -277,30 +523,13 @@ namespace belfem
 
                 for ( index_t k = 0; k < tNumVertices; ++k )
                 {
-                    tField[ aGraph( k )->id() ] = tPseudoT( k );
+                    tField[ tGraph.id( k ) ] = tPseudoT( k );
                 }
             }
 
-            // Use finer binning for smoother result
-            index_t tNumLevels = std::max( static_cast< index_t>(tMaxDist + 1.),  static_cast< index_t>(10) );
-
-            // Step 4: Bin vertices by pseudo-temperature
-            Cell< Cell< index_t > > tLevelBins( tNumLevels, {} );
-
             for ( index_t k = 0; k < tNumVertices; ++k )
             {
-                // Map T ∈ [0,1] to level ∈ [0, tNumLevels-1]
-                index_t tLevel = static_cast< index_t >( tPseudoT( k ) * ( tNumLevels - 1 ) + 0.5 );
-                tLevel = std::min( tLevel, tNumLevels - 1 );
-                tLevelBins( tLevel ).push( k );
-            }
-
-            // Step 5: Process each level with matching refinement
-            index_t tCurrentIndex = 0;
-
-            for ( index_t L = 0; L < tNumLevels; ++L )
-            {
-                refine_level_with_matching( aGraph, tLevelBins( L ), tCurrentIndex );
+                aGraph( k )->set_index( tNewIndices( k ) );
             }
 
             // Step 6: Sort graph by new indices
@@ -309,4 +538,4 @@ namespace belfem
 
 //------------------------------------------------------------------------------
     }
-}
\ No newline at end of file
+}
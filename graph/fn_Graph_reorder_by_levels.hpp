@@ -15,6 +15,8 @@
 #include "cl_Cell.hpp"
 #include "cl_Graph_Vertex.hpp"
 #include "cl_Map.hpp"
+#include "cl_Vector.hpp"
+#include "cl_Graph_CSRGraph.hpp"
 
 namespace belfem
 {
@@ -33,6 +35,8 @@ namespace belfem
          * @param aGraph     All vertices in the graph (will be reordered)
          * @param aBoundary0 Vertices on Γ₀ boundary (analogous to T=0)
          * @param aBoundary1 Vertices on Γ₁ boundary (analogous to T=1)
+         * @param aNumberOfThreads threads for the search and the refinement,
+         *                         0 uses all cores
          */
         void
         reorder_by_levels(
@@ -40,7 +44,34 @@ namespace belfem
             Graph & aSinks,
             Graph & aSources,
             Map< id_t, real > * aField = nullptr,
-            const bool aSort = true );
+            const bool aSort = true,
+            const uint aNumberOfThreads = 1 );
+
+        /**
+         * Same as above, but on a graph in CSR format. The graph is not
+         * changed, the result is returned as new index for each vertex.
+         *
+         * @param aGraph             adjacency of the graph
+         * @param aSinks             vertices on Γ₀
+         * @param aSources           vertices on Γ₁
+         * @param aNewIndices        new index of each vertex
+         * @param aPseudoTemperature if given, the value in [0, 1] of each vertex
+         * @param aNumberOfThreads   threads for the search and the refinement,
+         *                           0 uses all cores. The result does not
+         *                           depend on the number of threads.
+         * @param aMatching           if false, the vertices of each level keep
+         *                           their relative order instead of being
+         *                           paired by a maximum matching
+         */
+        void
+        reorder_by_levels(
+            const CSRGraph & aGraph,
+            const Cell< index_t > & aSinks,
+            const Cell< index_t > & aSources,
+            Vector< index_t > & aNewIndices,
+            Vector< real > * aPseudoTemperature = nullptr,
+            const uint aNumberOfThreads = 1,
+            const bool aMatching = true );
     }
 }
 
@@ -19,68 +19,41 @@ namespace belfem
     namespace graph
     {
         ArticulationPointInfo::ArticulationPointInfo(
-                Vertex * aVertex,
                 Cell< Vertex * > & aGraph,
-                Cell< Cell< Vertex * > > aSeparatedComponents,
-                ArticulationPointWork & aWork ) :
-                mVertex( aVertex ),
-                mGraph( aGraph ),
-                mIsUnicyclic( new DynamicBitset( aSeparatedComponents.size()) ),
-                mVisited( aWork.mVisited ),
-                mInComponent( aWork.mInComponent ),
-                mParent( aWork.mParent ),
-                mDepth( aWork.mDepth )
+                const BlockCutTree & aTree,
+                const index_t aVertex ) :
+                mVertex( aGraph( aVertex ) ),
+                mIsUnicyclic( new DynamicBitset( aTree.number_of_child_blocks( aVertex ) ) )
             {
-                index_t tSize = aSeparatedComponents.size();
+                index_t tSize = aTree.number_of_child_blocks( aVertex );
                 mComponentSizes.set_size( tSize, 0 );
                 mComponentEdgeCounts.set_size( tSize, 0 );
                 mCycleLength.set_size( tSize, 0 );
-                mSeparatedComponents = std::move( aSeparatedComponents );
-                DynamicBitset * tContains = aWork.mContains;
-
+                mSeparatedComponents.set_size( tSize, {} );
 
                 for ( index_t k=0 ; k<tSize; ++k )
                 {
-                    Cell< Vertex * > & tComp = mSeparatedComponents( k );
+                    // each component is the branch of a block below the vertex
+                    index_t tBlock = aTree.child_block( aVertex, k );
 
-                    // copy the compinent size
-                    mComponentSizes( k ) = tComp.size();
+                    mComponentSizes( k ) = aTree.branch_size( tBlock );
+                    mComponentEdgeCounts( k ) = aTree.branch_edge_count( tBlock );
 
-                    // set contain checks
-                    tContains->reset();
-                    for ( Vertex * tVertex : tComp )
+                    if ( aTree.branch_is_unicyclic( tBlock ) )
                     {
-                        tContains->set( tVertex->index() );
-                    }
-
-                    // count edges
-                    index_t tCount = 0 ;
-                    for ( Vertex * tVertex : tComp )
-                    {
-                        for ( uint v=0; v<tVertex->number_of_vertices(); ++v )
-                        {
-                            if ( tContains->test( tVertex->vertex( v )->index() ) )
-                            {
-                                ++tCount;
-                            }
-                        }
+                        mIsUnicyclic->set( k );
+                        mCycleLength( k ) = aTree.branch_cycle_length( tBlock );
                     }
 
-                    mComponentEdgeCounts( k ) = tCount / 2 ;
-
-                    // Check for unicyclic: exactly one cycle if edges == vertices (connected component)
-                    bool tIsUnicyclic = ( mComponentEdgeCounts( k ) == tComp.size() );
+                    Cell< Vertex * > & tComp = mSeparatedComponents( k );
+                    tComp.set_size( mComponentSizes( k ), nullptr );
 
-                    if ( tIsUnicyclic )
+                    index_t tBegin = aTree.branch_begin( tBlock );
+                    for ( index_t i = tBegin; i < aTree.branch_end( tBlock ); ++i )
                     {
-                        mIsUnicyclic->set( k );
-
-                        auto [ tHasCycle, tLen ] = this->detect_cycle_properties( k );
-                        BELFEM_ASSERT( tHasCycle, "Expected cycle in unicyclic component" );
-                        mCycleLength( k ) = tLen;
+                        tComp( i - tBegin ) = aGraph( aTree.ordered_vertex( i ) );
                     }
                 }
-
             }
 
         /**
@@ -197,173 +170,48 @@ namespace belfem
         Cell< ArticulationPointInfo * >
         find_articulation_points_with_components( Cell< Vertex * > & aGraph )
         {
-            Cell< ArticulationPointInfo * > aAPInfo;
-
-            if ( aGraph.size() == 0 )
-            {
-                return aAPInfo;
-            }
-
-            // Ensure all vertices have proper indices
-            index_t tIndex = 0;
-            for ( Vertex * tVertex : aGraph )
-            {
-                tVertex->set_index( tIndex++ );
-            }
-
-            const index_t tN = aGraph.size();
-
-            // Use DynamicBitset for efficient boolean tracking
-            DynamicBitset tVisited( tN );
-
-            // Tarjan's algorithm data structures
-            Vector< index_t > tDiscoveryTime( tN, gNoIndex );
-            Vector< index_t > tLowLink( tN, gNoIndex );
-            Vector< index_t > tParent( tN, gNoIndex );
-            index_t tTimer = 0;
-
-            // the work object
-            ArticulationPointWork tWork( tN );
-
-            // DFS lambda that returns the subtree vertices
-            auto tDFS = [ & ]( auto&& aSelf, Cell< Vertex * > & aGraph, index_t aV ) -> Cell< Vertex * >
-            {
-                Vertex * tVertex = aGraph( aV );
-                tVisited.set( aV );
-                tDiscoveryTime( aV ) = tLowLink( aV ) = tTimer++;
-
-
-                Cell< Cell< Vertex * > > tChildSubtrees; // Collect all direct child subtrees
-                Cell< Cell< Vertex * > > tSeparated; // Separated components for this vertex
-                index_t tChildren = 0;
-
-                Cell< Vertex * > aSubtree;
-                aSubtree.push( tVertex ); // Start with self
-
-                // Process all adjacent vertices
-                for ( uint k = 0; k < tVertex->number_of_vertices(); ++k )
-                {
-                    Vertex * tNeighbor = tVertex->vertex( k );
-                    index_t tU = tNeighbor->index();
+            // also sets the vertex indices
+            CSRGraph tGraph( aGraph );
 
-                    if ( tU == tParent( aV ) ) continue; // Skip parent
-
-                    if ( !tVisited.test( tU ) )
-                    {
-                        ++tChildren;
-                        tParent( tU ) = aV;
-
-                        // Recursive DFS, get child subtree
-                        Cell< Vertex * > tChildSubtree = aSelf( aSelf, aGraph, tU );
-
-                        // Update low link
-                        tLowLink( aV ) = std::min( tLowLink( aV ), tLowLink( tU ) );
-
-                        // Check for separated component (non-root)
-                        if ( tParent( aV ) != gNoIndex && tLowLink( tU ) >= tDiscoveryTime( aV ) )
-                        {
-                            tSeparated.push( tChildSubtree ); // Copy (cheap for pointers)
-                        }
-
-                        // Always add to full subtree and child subtrees
-                        append( aSubtree, tChildSubtree ); // Append
-                        tChildSubtrees.push( tChildSubtree ); // Copy
-                    }
-                    else
-                    {
-                        // Back edge - update low link
-                        tLowLink( aV ) = std::min( tLowLink( aV ), tDiscoveryTime( tU ) );
-                    }
-                }
-
-                // Handle root case separately after processing all children
-                if ( tParent( aV ) == gNoIndex && tChildren > 1 )
-                {
-                    tSeparated = tChildSubtrees; // Copy all child subtrees as separated
-                }
-
-                if ( !tSeparated.empty() )
-                {
-                    // create a new info point
-                    aAPInfo.push( new ArticulationPointInfo( tVertex, aGraph, tSeparated, tWork ) );
-                }
-
-                return aSubtree ;
-            };
-
-            for ( index_t i = 0; i < tN; ++i )
-            {
-                if ( ! tVisited.test( i ) )
-                {
-                    tDFS( tDFS, aGraph, i );
-                }
-            }
-
-            return aAPInfo;
+            return find_articulation_points_with_components( aGraph, tGraph );
         }
 
-        std::pair< bool, index_t >
-        ArticulationPointInfo::detect_cycle_properties( const index_t aIndex )
+        /**
+         * Same as above, for a graph that has already been converted
+         * @param aGraph The graph to analyze
+         * @param aCSR The adjacency of aGraph, vertex k of aCSR is aGraph( k )
+         * @return Detailed information about each articulation point
+         */
+        Cell< ArticulationPointInfo * >
+        find_articulation_points_with_components(
+                Cell< Vertex * > & aGraph,
+                const CSRGraph & aCSR )
         {
-            const Cell< Vertex * > & tComp = mSeparatedComponents( aIndex );
-            if ( tComp.size() < 3 ) return { false, 0 };
-
-            // Reset work for this component
-            mVisited->reset();
-            mParent.fill( gNoIndex );
-            mDepth.fill( 0 );
-
-            // Set in_component for membership (global)
-            mInComponent->reset();
-            for ( Vertex * tV : tComp )
-            {
-                mInComponent->set( tV->index() );
-            }
+            BlockCutTree tTree( aCSR );
 
-            bool tCycleFound = false;
-            index_t tCycleLength = 0;
+            return find_articulation_points_with_components( aGraph, tTree );
+        }
 
-            auto tDFS = [ & ]( auto&& aSelf, index_t aV, index_t aCurrentDepth ) -> bool
-            {
-                mVisited->set( aV );
-                mDepth( aV ) = aCurrentDepth;
-                Vertex * tVertex = mGraph( aV );  // Global lookup
-                for ( uint k = 0; k < tVertex->number_of_vertices(); ++k )
-                {
-                    Vertex * tNeighbor = tVertex->vertex( k );
-                    index_t tNeighborIdx = tNeighbor->index();
-                    if ( ! mInComponent->test( tNeighborIdx ) ) continue;
-                    if ( ! mVisited->test( tNeighborIdx ) ) {
-                        mParent( tNeighborIdx ) = aV;
-                        if ( aSelf( aSelf, tNeighborIdx, aCurrentDepth + 1 ) )
-                        {
-                            return true;
-                        }
-                    }
-                    else if ( mParent( aV ) != tNeighborIdx && ! tCycleFound )
-                    {
-                        tCycleFound = true;
-                        tCycleLength = mDepth( aV ) - mDepth( tNeighborIdx ) + 1;
-                        return true;
-                    }
-                }
-                return false;
-            };
+        /**
+         * Same as above, for a graph whose block-cut tree is known
+         * @param aGraph The graph to analyze
+         * @param aTree The block-cut tree of aGraph
+         * @return Detailed information about each articulation point
+         */
+        Cell< ArticulationPointInfo * >
+        find_articulation_points_with_components(
+                Cell< Vertex * > & aGraph,
+                const BlockCutTree & aTree )
+        {
+            Cell< ArticulationPointInfo * > aAPInfo;
+            aAPInfo.reserve( aTree.cut_vertices().size() );
 
-            // Start from global indices of component vertices
-            for ( Vertex * tV : tComp )
+            for ( index_t tVertex : aTree.cut_vertices() )
             {
-                index_t g = tV->index();
-                if ( ! mVisited->test( g ) )
-                {
-                    if ( tDFS( tDFS, g, 0 ) )
-                    {
-                        break;
-                    }
-                }
+                aAPInfo.push( new ArticulationPointInfo( aGraph, aTree, tVertex ) );
             }
 
-            return { tCycleFound, tCycleLength };
+            return aAPInfo;
         }
 
         /**
@@ -378,32 +226,60 @@ namespace belfem
                                  const index_t aMaxPocketSize,
                                  const bool aRequireUnicyclic )
         {
-            Cell< PocketInfo > tPockets;
+            // also sets the vertex indices
+            CSRGraph tGraph( aGraph );
 
-            auto tAPInfo = find_articulation_points_with_components( aGraph );
+            return detect_pockets_with_info( aGraph, tGraph, aMaxPocketSize, aRequireUnicyclic );
+        }
 
-            for ( ArticulationPointInfo * tInfo : tAPInfo )
+        /**
+         * Same as above, for a graph that has already been converted
+         */
+        Cell< PocketInfo >
+        detect_pockets_with_info( Cell< Vertex * > & aGraph,
+                                 const CSRGraph & aCSR,
+                                 const index_t aMaxPocketSize,
+                                 const bool aRequireUnicyclic )
+        {
+            BlockCutTree tTree( aCSR );
+
+            return detect_pockets_with_info( aGraph, tTree, aMaxPocketSize, aRequireUnicyclic );
+        }
+
+        /**
+         * Same as above, for a graph whose block-cut tree is known
+         */
+        Cell< PocketInfo >
+        detect_pockets_with_info( Cell< Vertex * > & aGraph,
+                                 const BlockCutTree & aTree,
+                                 const index_t aMaxPocketSize,
+                                 const bool aRequireUnicyclic )
+        {
+            Cell< PocketInfo > tPockets;
+
+            for ( index_t b = 0; b < aTree.number_of_blocks(); ++b )
             {
-                for ( index_t i = 0; i < tInfo->size(); ++i )
+                // Check pocket criteria
+                if ( aTree.is_separating( b ) &&
+                     aTree.branch_size( b ) <= aMaxPocketSize &&
+                     ( !aRequireUnicyclic || aTree.branch_is_unicyclic( b ) ) )
                 {
-                    // Check pocket criteria
-                    if ( tInfo->component_size( i ) <= aMaxPocketSize &&
-                         ( !aRequireUnicyclic || tInfo->unicyclic_test( i ) ) )
+                    PocketInfo tPocket;
+                    tPocket.mNeckVertex = aGraph( aTree.block_top( b ) );
+                    tPocket.mSize = aTree.branch_size( b );
+                    tPocket.mEdgeCount = aTree.branch_edge_count( b );
+                    tPocket.mIsUnicyclic = aTree.branch_is_unicyclic( b );
+                    tPocket.mCycleLength = aTree.branch_cycle_length( b );
+
+                    tPocket.mPocketVertices.set_size( tPocket.mSize, nullptr );
+                    index_t tBegin = aTree.branch_begin( b );
+                    for ( index_t i = tBegin; i < aTree.branch_end( b ); ++i )
                     {
-                        PocketInfo tPocket;
-                        tPocket.mNeckVertex = tInfo->vertex() ;
-                        tPocket.mPocketVertices = tInfo->separated_components( i );
-                        tPocket.mSize = tInfo->component_size( i );
-                        tPocket.mEdgeCount = tInfo->component_edge_count( i );
-                        tPocket.mIsUnicyclic = tInfo->unicyclic_test( i );
-                        tPocket.mCycleLength = tInfo->cycle_length( i );
-
-                        tPockets.push( std::move( tPocket ) );
+                        tPocket.mPocketVertices( i - tBegin ) = aGraph( aTree.ordered_vertex( i ) );
                     }
-                }
 
-                // tidy up
-                delete tInfo;
+                    tPockets.push( std::move( tPocket ) );
+                }
             }
 
             // Sort pockets by quality score for prioritized removal
@@ -417,6 +293,39 @@ namespace belfem
             return tPockets;
         }
 
+        /**
+         * Remove the marked vertices from the graph and re-index the rest
+         * @param aGraph The graph to modify
+         * @param aToRemove Flags of the vertices to remove
+         * @param aRemovedCount Number of set flags
+         */
+        void
+        remove_marked_vertices( Cell< Vertex * > & aGraph,
+                                const DynamicBitset & aToRemove,
+                                const index_t aRemovedCount )
+        {
+            // Create new graph without pocket vertices
+            Cell< Vertex * > tNewGraph;
+            tNewGraph.reserve( aGraph.size() - aRemovedCount );
+
+            for ( index_t i = 0; i < aGraph.size(); ++i )
+            {
+                if ( !aToRemove.test( i ) )
+                {
+                    tNewGraph.push( aGraph( i ) );
+                }
+            }
+
+            // Update the original graph
+            aGraph = std::move( tNewGraph );
+
+            // Re-index vertices
+            for ( index_t i = 0; i < aGraph.size(); ++i )
+            {
+                aGraph( i )->set_index( i );
+            }
+        }
+
         /**
          * Remove detected pockets from the graph
          * @param aGraph The graph to modify
@@ -440,30 +349,65 @@ namespace belfem
             {
                 for ( Vertex * tV : tPocket.mPocketVertices )
                 {
-                    tToRemove.set( tV->index() );
-                    ++tRemovedCount;
+                    // nested pockets share vertices
+                    if ( !tToRemove.test( tV->index() ) )
+                    {
+                        tToRemove.set( tV->index() );
+                        ++tRemovedCount;
+                    }
                 }
             }
 
-            // Create new graph without pocket vertices
-            Cell< Vertex * > tNewGraph;
-            tNewGraph.reserve( aGraph.size() - tRemovedCount );
+            remove_marked_vertices( aGraph, tToRemove, tRemovedCount );
 
-            for ( index_t i = 0; i < aGraph.size(); ++i )
+            return tRemovedCount;
+        }
+
+        /**
+         * Remove all pockets that are found in the block-cut tree,
+         * without collecting them first
+         * @param aGraph The graph to modify
+         * @param aTree The block-cut tree of aGraph
+         * @param aMaxPocketSize Maximum size for a valid pocket
+         * @param aRequireUnicyclic Whether to require exactly one cycle
+         * @return Number of vertices removed
+         */
+        index_t
+        remove_pockets( Cell< Vertex * > & aGraph,
+                       const BlockCutTree & aTree,
+                       const index_t aMaxPocketSize,
+                       const bool aRequireUnicyclic )
+        {
+            BELFEM_ASSERT( aTree.number_of_vertices() == aGraph.size(),
+                          "block-cut tree does not match the graph" );
+
+            index_t tRemovedCount = 0;
+            DynamicBitset tToRemove( aGraph.size() );
+
+            for ( index_t b = 0; b < aTree.number_of_blocks(); ++b )
             {
-                if ( !tToRemove.test( i ) )
+                if ( aTree.is_separating( b ) &&
+                     aTree.branch_size( b ) <= aMaxPocketSize &&
+                     ( !aRequireUnicyclic || aTree.branch_is_unicyclic( b ) ) )
                 {
-                    tNewGraph.push( aGraph( i ) );
+                    // the branch is a contiguous range of the preorder
+                    for ( index_t i = aTree.branch_begin( b ); i < aTree.branch_end( b ); ++i )
+                    {
+                        index_t tV = aTree.ordered_vertex( i );
+
+                        // nested pockets share vertices
+                        if ( !tToRemove.test( tV ) )
+                        {
+                            tToRemove.set( tV );
+                            ++tRemovedCount;
+                        }
+                    }
                 }
             }
 
-            // Update the original graph
-            aGraph = std::move( tNewGraph );
-
-            // Re-index vertices
-            for ( index_t i = 0; i < aGraph.size(); ++i )
+            if ( tRemovedCount > 0 )
             {
-                aGraph( i )->set_index( i );
+                remove_marked_vertices( aGraph, tToRemove, tRemovedCount );
             }
 
             return tRemovedCount;
@@ -13,37 +13,13 @@
 #include "cl_Cell.hpp"
 #include "cl_DynamicBitset.hpp"
 #include "cl_Vector.hpp"
+#include "cl_Graph_CSRGraph.hpp"
+#include "cl_Graph_BlockCutTree.hpp"
 
 namespace belfem
 {
     namespace graph
     {
-        struct ArticulationPointWork
-        {
-            DynamicBitset * mContains = nullptr ;
-            DynamicBitset * mVisited = nullptr ;
-            DynamicBitset * mInComponent = nullptr ;
-            Vector< index_t > mParent ;
-            Vector< index_t > mDepth ;
-
-            ArticulationPointWork( const index_t aSize ) :
-                mContains( new DynamicBitset( aSize ) ),
-                mVisited( new DynamicBitset( aSize ) ),
-                mInComponent( new DynamicBitset( aSize ) ),
-                mParent( aSize, gNoIndex ),
-                mDepth( aSize, gNoIndex )
-            {
-
-            }
-
-            ~ArticulationPointWork()
-            {
-                delete mContains;
-                delete mVisited;
-                delete mInComponent;
-            }
-        };
-
         /**
          * Structure to hold detailed information about articulation points
          * and the components they separate
@@ -51,7 +27,6 @@ namespace belfem
         class ArticulationPointInfo
         {
             Vertex * mVertex ;
-            Cell< Vertex * > & mGraph ;
             DynamicBitset * mIsUnicyclic = nullptr ;
 
             Vector< index_t > mComponentSizes;
@@ -61,19 +36,18 @@ namespace belfem
 
             Cell< Cell< Vertex * > > mSeparatedComponents;
 
-            // work vectors
-            DynamicBitset * mVisited ;
-            DynamicBitset * mInComponent ;
-            Vector< index_t > & mParent ;
-            Vector< index_t > & mDepth ;
-
         public:
 
+            /**
+             * copy the components of a cut vertex from the block-cut tree
+             * @param aGraph The graph the tree was built from
+             * @param aTree The block-cut tree of aGraph
+             * @param aVertex Index of the cut vertex
+             */
             ArticulationPointInfo(
-                Vertex * aVertex,
                 Cell< Vertex * > & aGraph,
-                Cell< Cell< Vertex * > > aSeparatedComponents,
-                ArticulationPointWork & aWork );
+                const BlockCutTree & aTree,
+                const index_t aVertex );
 
             ~ArticulationPointInfo()
             {
@@ -133,11 +107,6 @@ namespace belfem
             {
                 return mSeparatedComponents.size();
             }
-
-        private:
-
-            std::pair< bool, index_t >
-            detect_cycle_properties( const index_t aIndex );
         };
 
         /**
@@ -164,6 +133,28 @@ namespace belfem
         Cell< ArticulationPointInfo * >
         find_articulation_points_with_components( Cell< Vertex * > & aGraph ) ;
 
+        /**
+         * Same as above, for a graph that has already been converted
+         * @param aGraph The graph to analyze
+         * @param aCSR The adjacency of aGraph, vertex k of aCSR is aGraph( k )
+         * @return Detailed information about each articulation point
+         */
+        Cell< ArticulationPointInfo * >
+        find_articulation_points_with_components(
+                Cell< Vertex * > & aGraph,
+                const CSRGraph & aCSR ) ;
+
+        /**
+         * Same as above, for a graph whose block-cut tree is known
+         * @param aGraph The graph to analyze
+         * @param aTree The block-cut tree of aGraph
+         * @return Detailed information about each articulation point
+         */
+        Cell< ArticulationPointInfo * >
+        find_articulation_points_with_components(
+                Cell< Vertex * > & aGraph,
+                const BlockCutTree & aTree ) ;
+
         /**
          * Structure representing a detected pocket
          */
@@ -247,6 +238,28 @@ namespace belfem
                                  const index_t aMaxPocketSize = 20,
                                  const bool aRequireUnicyclic = true );
 
+        /**
+         * Same as above, for a graph that has already been converted
+         * @param aGraph The graph to analyze
+         * @param aCSR The adjacency of aGraph, vertex k of aCSR is aGraph( k )
+         */
+        Cell< PocketInfo >
+        detect_pockets_with_info( Cell< Vertex * > & aGraph,
+                                 const CSRGraph & aCSR,
+                                 const index_t aMaxPocketSize = 20,
+                                 const bool aRequireUnicyclic = true );
+
+        /**
+         * Same as above, for a graph whose block-cut tree is known
+         * @param aGraph The graph to analyze
+         * @param aTree The block-cut tree of aGraph
+         */
+        Cell< PocketInfo >
+        detect_pockets_with_info( Cell< Vertex * > & aGraph,
+                                 const BlockCutTree & aTree,
+                                 const index_t aMaxPocketSize = 20,
+                                 const bool aRequireUnicyclic = true );
+
         /**
          * Remove detected pockets from the graph
          * @param aGraph The graph to modify
@@ -257,6 +270,21 @@ namespace belfem
         remove_pockets( Cell< Vertex * > & aGraph,
                        const Cell< PocketInfo > & aPockets );
 
+        /**
+         * Remove all pockets that are found in the block-cut tree,
+         * without collecting them first
+         * @param aGraph The graph to modify
+         * @param aTree The block-cut tree of aGraph
+         * @param aMaxPocketSize Maximum size for a valid pocket
+         * @param aRequireUnicyclic Whether to require exactly one cycle
+         * @return Number of vertices removed
+         */
+        index_t
+        remove_pockets( Cell< Vertex * > & aGraph,
+                       const BlockCutTree & aTree,
+                       const index_t aMaxPocketSize = 20,
+                       const bool aRequireUnicyclic = true );
+
     } // namespace graph
 } // namespace belfem
 
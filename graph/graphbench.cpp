@@ -0,0 +1,740 @@
+//
+// Created on 16.10.26.
+//
+// Compares orderings of the node graph of a mesh: natural,
+// reverse Cuthill-McKee and reorder_by_levels with and without
+// matching refinement. For each ordering, the time, bandwidth,
+// profile and fill-in of a Cholesky factor are reported, together
+// with the times for factorizing and solving a graph Laplacian with
+// UMFPACK, whose own ordering is switched off, and for a sparse matrix
+// vector product.
+//
+// The boundaries for the level ordering are the nodes with the
+// smallest and the largest coordinate along the given axis.
+//
+// usage: graphbench mesh.exo [axis] [threads]
+//
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+#include <umfpack.h>
+
+#include "typedefs.hpp"
+#include "cl_Communicator.hpp"
+#include "cl_Logger.hpp"
+#include "commtools.hpp"
+#include "cl_Mesh.hpp"
+#include "cl_SpMatrix.hpp"
+#include "cl_Timer.hpp"
+#include "cl_Vector.hpp"
+
+#include "cl_Graph_CSRGraph.hpp"
+#include "fn_Graph_reorder_by_levels.hpp"
+
+using namespace belfem;
+using namespace belfem::graph;
+
+Communicator gComm;
+Logger       gLog( 3 );
+
+//------------------------------------------------------------------------------
+
+/**
+ * Two nodes are connected if they share an element. If aDiagonal
+ * is set, each vertex is also its own neighbor, which is the pattern
+ * of a matrix.
+ */
+void
+create_node_graph( Mesh & aMesh, Graph & aGraph, const bool aDiagonal )
+{
+    Cell< mesh::Node * > & tNodes = aMesh.nodes() ;
+    Cell< mesh::Element * > & tElements = aMesh.elements() ;
+
+    index_t tNumNodes = tNodes.size() ;
+    index_t tNumElements = tElements.size() ;
+
+    for( index_t k=0; k<tNumNodes; ++k )
+    {
+        tNodes( k )->set_index( k );
+    }
+
+    // elements of each node in compressed format
+    Vector< index_t > tOffsets( tNumNodes + 1, 0 );
+
+    for( mesh::Element * tElement : tElements )
+    {
+        for( uint i=0; i<tElement->number_of_nodes(); ++i )
+        {
+            ++tOffsets( tElement->node( i )->index() + 1 );
+        }
+    }
+
+    for( index_t k=0; k<tNumNodes; ++k )
+    {
+        tOffsets( k + 1 ) += tOffsets( k );
+    }
+
+    Vector< index_t > tNodeElements( tOffsets( tNumNodes ), 0 );
+    Vector< index_t > tCounters( tNumNodes, 0 );
+
+    for( index_t e=0; e<tNumElements; ++e )
+    {
+        mesh::Element * tElement = tElements( e );
+
+        for( uint i=0; i<tElement->number_of_nodes(); ++i )
+        {
+            index_t tNode = tElement->node( i )->index() ;
+            tNodeElements( tOffsets( tNode ) + tCounters( tNode )++ ) = e ;
+        }
+    }
+
+    aGraph.set_size( tNumNodes, nullptr );
+
+    for( index_t k=0; k<tNumNodes; ++k )
+    {
+        aGraph( k ) = new Vertex();
+        aGraph( k )->set_index( k );
+    }
+
+    // collect the neighbors of each node only once
+    Vector< index_t > tMark( tNumNodes, gNoIndex );
+    Cell< index_t > tNeighbors ;
+
+    for( index_t k=0; k<tNumNodes; ++k )
+    {
+        tNeighbors.clear() ;
+
+        tMark( k ) = k ;
+        if( aDiagonal )
+        {
+            tNeighbors.push( k );
+        }
+
+        for( index_t l=tOffsets( k ); l<tOffsets( k + 1 ); ++l )
+        {
+            mesh::Element * tElement = tElements( tNodeElements( l ) );
+
+            for( uint i=0; i<tElement->number_of_nodes(); ++i )
+            {
+                index_t tNode = tElement->node( i )->index() ;
+
+                if( tMark( tNode ) != k )
+                {
+                    tMark( tNode ) = k ;
+                    tNeighbors.push( tNode );
+                }
+            }
+        }
+
+        aGraph( k )->init_vertex_container( tNeighbors.size() );
+
+        for( index_t j : tNeighbors )
+        {
+            aGraph( k )->insert_vertex( aGraph( j ) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * nodes with the smallest and the largest coordinate along an axis
+ */
+void
+find_boundaries(
+        Mesh & aMesh,
+        const uint aAxis,
+        Cell< index_t > & aSinks,
+        Cell< index_t > & aSources )
+{
+    BELFEM_ERROR( aAxis < aMesh.number_of_dimensions(),
+                 "axis %u does not exist on a %uD mesh",
+                 ( unsigned int ) aAxis, ( unsigned int ) aMesh.number_of_dimensions() );
+
+    Cell< mesh::Node * > & tNodes = aMesh.nodes() ;
+
+    real tMin = BELFEM_REAL_MAX ;
+    real tMax = -BELFEM_REAL_MAX ;
+
+    for( mesh::Node * tNode : tNodes )
+    {
+        tMin = std::min( tMin, tNode->x( aAxis ) );
+        tMax = std::max( tMax, tNode->x( aAxis ) );
+    }
+
+    real tTolerance = 1e-6 * ( tMax - tMin );
+
+    aSinks.clear() ;
+    aSources.clear() ;
+
+    for( mesh::Node * tNode : tNodes )
+    {
+        if( tNode->x( aAxis ) < tMin + tTolerance )
+        {
+            aSinks.push( tNode->index() );
+        }
+        else if( tNode->x( aAxis ) > tMax - tTolerance )
+        {
+            aSources.push( tNode->index() );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * a vertex of large eccentricity in the component of aStart,
+ * found by repeated BFS ( George and Liu )
+ */
+index_t
+pseudo_peripheral_vertex(
+        const CSRGraph & aGraph,
+        const index_t aStart,
+        Vector< index_t > & aMark,
+        index_t & aStamp,
+        Vector< index_t > & aQueue )
+{
+    index_t tVertex = aStart ;
+    index_t tEccentricity = 0 ;
+
+    while( true )
+    {
+        // BFS, level by level
+        aMark( tVertex ) = ++aStamp ;
+        aQueue( 0 ) = tVertex ;
+
+        index_t tBegin = 0 ;
+        index_t tEnd = 1 ;
+        index_t tDepth = 0 ;
+
+        while( true )
+        {
+            index_t tNext = tEnd ;
+
+            for( index_t i=tBegin; i<tEnd; ++i )
+            {
+                index_t tV = aQueue( i );
+                for( index_t k=aGraph.begin( tV ); k<aGraph.end( tV ); ++k )
+                {
+                    index_t tU = aGraph.neighbor( k );
+                    if( aMark( tU ) != aStamp )
+                    {
+                        aMark( tU ) = aStamp ;
+                        aQueue( tNext++ ) = tU ;
+                    }
+                }
+            }
+
+            if( tNext == tEnd )
+            {
+                break ;
+            }
+
+            tBegin = tEnd ;
+            tEnd = tNext ;
+            ++tDepth ;
+        }
+
+        if( tDepth <= tEccentricity )
+        {
+            return tVertex ;
+        }
+
+        tEccentricity = tDepth ;
+
+        // continue from the vertex of the last level with the smallest degree
+        tVertex = aQueue( tBegin );
+        for( index_t i=tBegin+1; i<tEnd; ++i )
+        {
+            if( aGraph.degree( aQueue( i ) ) < aGraph.degree( tVertex ) )
+            {
+                tVertex = aQueue( i );
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void
+reverse_cuthill_mckee( const CSRGraph & aGraph, Vector< index_t > & aNewIndices )
+{
+    index_t tNumVertices = aGraph.number_of_vertices() ;
+
+    Vector< index_t > tOrder( tNumVertices, 0 );
+    Vector< index_t > tNumbered( tNumVertices, 0 );
+    Vector< index_t > tMark( tNumVertices, 0 );
+    Vector< index_t > tQueue( tNumVertices, 0 );
+    index_t tStamp = 0 ;
+    index_t tCount = 0 ;
+
+    for( index_t s=0; s<tNumVertices; ++s )
+    {
+        if( tNumbered( s ) == 1 )
+        {
+            continue ;
+        }
+
+        index_t tRoot = pseudo_peripheral_vertex( aGraph, s, tMark, tStamp, tQueue );
+
+        tNumbered( tRoot ) = 1 ;
+        tOrder( tCount++ ) = tRoot ;
+
+        for( index_t tHead = tCount - 1; tHead < tCount; ++tHead )
+        {
+            index_t tV = tOrder( tHead );
+            index_t tFirst = tCount ;
+
+            for( index_t k=aGraph.begin( tV ); k<aGraph.end( tV ); ++k )
+            {
+                index_t tU = aGraph.neighbor( k );
+                if( tNumbered( tU ) == 0 )
+                {
+                    tNumbered( tU ) = 1 ;
+                    tOrder( tCount++ ) = tU ;
+                }
+            }
+
+            // neighbors with small degree first
+            std::sort( tOrder.ptr() + tFirst, tOrder.ptr() + tCount,
+                       [ & ]( const index_t a, const index_t b )
+                       {
+                           return aGraph.degree( a ) < aGraph.degree( b );
+                       });
+        }
+    }
+
+    aNewIndices.set_size( tNumVertices, gNoIndex );
+
+    for( index_t k=0; k<tNumVertices; ++k )
+    {
+        aNewIndices( tOrder( k ) ) = tNumVertices - 1 - k ;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * bandwidth and profile of the matrix, lower triangle
+ */
+void
+compute_envelope(
+        const CSRGraph & aGraph,
+        const Vector< index_t > & aNewIndices,
+        index_t & aBandwidth,
+        long unsigned int & aProfile )
+{
+    aBandwidth = 0 ;
+    aProfile = 0 ;
+
+    for( index_t v=0; v<aGraph.number_of_vertices(); ++v )
+    {
+        index_t tRow = aNewIndices( v );
+        index_t tFirst = tRow ;
+
+        for( index_t k=aGraph.begin( v ); k<aGraph.end( v ); ++k )
+        {
+            index_t tCol = aNewIndices( aGraph.neighbor( k ) );
+
+            aBandwidth = std::max( aBandwidth, tRow > tCol ? tRow - tCol : tCol - tRow );
+            tFirst = std::min( tFirst, tCol );
+        }
+
+        aProfile += tRow - tFirst ;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * number of nonzeros of the Cholesky factor L in the new ordering,
+ * from the elimination tree and the row subtrees ( Liu ), time O( nnz(L) )
+ */
+long unsigned int
+compute_cholesky_nonzeros( const CSRGraph & aGraph, const Vector< index_t > & aNewIndices )
+{
+    index_t tNumVertices = aGraph.number_of_vertices() ;
+
+    // vertex of each new index
+    Vector< index_t > tVertices( tNumVertices, 0 );
+    for( index_t v=0; v<tNumVertices; ++v )
+    {
+        tVertices( aNewIndices( v ) ) = v ;
+    }
+
+    // elimination tree with path compression
+    Vector< index_t > tParent( tNumVertices, gNoIndex );
+    Vector< index_t > tAncestor( tNumVertices, gNoIndex );
+
+    for( index_t k=0; k<tNumVertices; ++k )
+    {
+        index_t tV = tVertices( k );
+
+        for( index_t l=aGraph.begin( tV ); l<aGraph.end( tV ); ++l )
+        {
+            index_t i = aNewIndices( aGraph.neighbor( l ) );
+
+            while( i != gNoIndex && i < k )
+            {
+                index_t tNext = tAncestor( i );
+                tAncestor( i ) = k ;
+
+                if( tNext == gNoIndex )
+                {
+                    tParent( i ) = k ;
+                }
+                i = tNext ;
+            }
+        }
+    }
+
+    // row k of L is the union of the paths from the entries of row k
+    // of A to k in the elimination tree
+    Vector< index_t > tFlag( tNumVertices, gNoIndex );
+    long unsigned int aCount = tNumVertices ;
+
+    for( index_t k=0; k<tNumVertices; ++k )
+    {
+        index_t tV = tVertices( k );
+        tFlag( k ) = k ;
+
+        for( index_t l=aGraph.begin( tV ); l<aGraph.end( tV ); ++l )
+        {
+            index_t i = aNewIndices( aGraph.neighbor( l ) );
+
+            if( i > k )
+            {
+                continue ;
+            }
+
+            while( tFlag( i ) != k )
+            {
+                tFlag( i ) = k ;
+                ++aCount ;
+                i = tParent( i );
+            }
+        }
+    }
+
+    return aCount ;
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * factorize and solve the shifted graph Laplacian with UMFPACK.
+ * UMFPACK is called directly, so that its own column ordering can be
+ * switched off and the given ordering is measured. The times of the
+ * symbolic and numeric factorization and of the solve are returned in ms.
+ */
+void
+time_factorization(
+        Graph & aMatrixGraph,
+        const Vector< index_t > & aNewIndices,
+        real & aSymbolicTime,
+        real & aNumericTime,
+        real & aSolveTime )
+{
+    index_t tNumVertices = aMatrixGraph.size() ;
+
+    // the pattern follows the indices of the vertices
+    Cell< index_t > tOldIndices( tNumVertices, 0 );
+    for( index_t k=0; k<tNumVertices; ++k )
+    {
+        tOldIndices( k ) = aMatrixGraph( k )->index() ;
+        aMatrixGraph( k )->set_index( aNewIndices( tOldIndices( k ) ) );
+    }
+
+    SpMatrix tMatrix( aMatrixGraph, SpMatrixType::CSR, tNumVertices, tNumVertices );
+
+    for( Vertex * tVertex : aMatrixGraph )
+    {
+        index_t i = tVertex->index() ;
+
+        for( uint k=0; k<tVertex->number_of_vertices(); ++k )
+        {
+            index_t j = tVertex->vertex( k )->index() ;
+            tMatrix( i, j ) = i == j ? tVertex->number_of_vertices() : -1.0 ;
+        }
+    }
+
+    for( index_t k=0; k<tNumVertices; ++k )
+    {
+        aMatrixGraph( k )->set_index( tOldIndices( k ) );
+    }
+
+    // the matrix is symmetric, so CSR is the same as CSC
+    const Vector< uint > & tRowPointers = tMatrix.row_pointers() ;
+    const Vector< uint > & tColumns     = tMatrix.columns() ;
+
+    std::vector< int > tPointers( tRowPointers.length() );
+    std::vector< int > tIndices( tColumns.length() );
+
+    for( index_t k=0; k<tRowPointers.length(); ++k )
+    {
+        tPointers[ k ] = tRowPointers( k );
+    }
+    for( index_t k=0; k<tColumns.length(); ++k )
+    {
+        tIndices[ k ] = tColumns( k );
+    }
+
+    const real * tValues = tMatrix.values().ptr() ;
+
+    Vector< real > tRHS( tNumVertices, 1.0 );
+    Vector< real > tX( tNumVertices, 0.0 );
+
+    double tControl[ UMFPACK_CONTROL ];
+    umfpack_di_defaults( tControl );
+
+    // keep the given ordering, and prefer pivots on the diagonal
+    tControl[ UMFPACK_ORDERING ] = UMFPACK_ORDERING_NONE ;
+    tControl[ UMFPACK_STRATEGY ] = UMFPACK_STRATEGY_SYMMETRIC ;
+
+    void * tSymbolic = nullptr ;
+    void * tNumeric  = nullptr ;
+
+    int tN = tNumVertices ;
+
+    Timer tSymbolicTimer ;
+    int tStatus = umfpack_di_symbolic( tN, tN, tPointers.data(), tIndices.data(),
+                                       tValues, &tSymbolic, tControl, nullptr );
+    aSymbolicTime = tSymbolicTimer.stop() ;
+
+    BELFEM_ERROR( tStatus == UMFPACK_OK, "symbolic factorization failed ( status %i )", tStatus );
+
+    Timer tNumericTimer ;
+    tStatus = umfpack_di_numeric( tPointers.data(), tIndices.data(), tValues,
+                                  tSymbolic, &tNumeric, tControl, nullptr );
+    aNumericTime = tNumericTimer.stop() ;
+
+    BELFEM_ERROR( tStatus == UMFPACK_OK, "numeric factorization failed ( status %i )", tStatus );
+
+    Timer tSolveTimer ;
+    tStatus = umfpack_di_solve( UMFPACK_A, tPointers.data(), tIndices.data(), tValues,
+                                tX.ptr(), tRHS.ptr(), tNumeric, tControl, nullptr );
+    aSolveTime = tSolveTimer.stop() ;
+
+    BELFEM_ERROR( tStatus == UMFPACK_OK, "solve failed ( status %i )", tStatus );
+
+    umfpack_di_free_symbolic( &tSymbolic );
+    umfpack_di_free_numeric( &tNumeric );
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * time for one product of the shifted graph Laplacian in CSR format
+ * with a vector, in ms
+ */
+real
+time_spmv( const CSRGraph & aGraph, const Vector< index_t > & aNewIndices, const uint aRepeat )
+{
+    index_t tNumVertices = aGraph.number_of_vertices() ;
+
+    Vector< index_t > tVertices( tNumVertices, 0 );
+    for( index_t v=0; v<tNumVertices; ++v )
+    {
+        tVertices( aNewIndices( v ) ) = v ;
+    }
+
+    // permuted matrix, with the diagonal
+    Vector< index_t > tPointers( tNumVertices + 1, 0 );
+    Vector< index_t > tColumns( aGraph.adjacency().length() + tNumVertices, 0 );
+    Vector< real >    tValues( tColumns.length(), 0.0 );
+
+    index_t tCount = 0 ;
+    for( index_t i=0; i<tNumVertices; ++i )
+    {
+        index_t tV = tVertices( i );
+
+        tColumns( tCount++ ) = i ;
+
+        for( index_t k=aGraph.begin( tV ); k<aGraph.end( tV ); ++k )
+        {
+            tColumns( tCount++ ) = aNewIndices( aGraph.neighbor( k ) );
+        }
+
+        // sorted columns, as in an assembled matrix
+        std::sort( tColumns.ptr() + tPointers( i ), tColumns.ptr() + tCount );
+        for( index_t k=tPointers( i ); k<tCount; ++k )
+        {
+            tValues( k ) = tColumns( k ) == i ? aGraph.degree( tV ) + 1.0 : -1.0 ;
+        }
+
+        tPointers( i + 1 ) = tCount ;
+    }
+
+    Vector< real > tX( tNumVertices, 1.0 );
+    Vector< real > tY( tNumVertices, 0.0 );
+
+    Timer tTimer ;
+
+    for( uint r=0; r<aRepeat; ++r )
+    {
+        for( index_t i=0; i<tNumVertices; ++i )
+        {
+            real tSum = 0.0 ;
+            for( index_t k=tPointers( i ); k<tPointers( i + 1 ); ++k )
+            {
+                tSum += tValues( k ) * tX( tColumns( k ) );
+            }
+            tY( i ) = tSum ;
+        }
+
+        // feed the result back, so that the loop can not be skipped
+        tX( r % tNumVertices ) += 1e-12 * tY( r % tNumVertices );
+    }
+
+    return tTimer.stop() / ( real ) aRepeat ;
+}
+
+//------------------------------------------------------------------------------
+
+void
+print_header()
+{
+    std::cout << std::endl
+              << std::setw( 24 ) << std::left << "    ordering"
+              << std::setw( 12 ) << std::right << "time [ms]"
+              << std::setw( 12 ) << "bandwidth"
+              << std::setw( 16 ) << "profile"
+              << std::setw( 16 ) << "nnz(L)"
+              << std::setw( 16 ) << "fill-in"
+              << std::setw( 14 ) << "symbolic [ms]"
+              << std::setw( 14 ) << "numeric [ms]"
+              << std::setw( 12 ) << "solve [ms]"
+              << std::setw( 12 ) << "spmv [ms]" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+void
+print_result(
+        const string & aLabel,
+        const real aTime,
+        const CSRGraph & aGraph,
+        Graph & aMatrixGraph,
+        const Vector< index_t > & aNewIndices )
+{
+    index_t tBandwidth ;
+    long unsigned int tProfile ;
+    compute_envelope( aGraph, aNewIndices, tBandwidth, tProfile );
+
+    long unsigned int tNnzL = compute_cholesky_nonzeros( aGraph, aNewIndices );
+
+    // nonzeros in the lower triangle of A, including the diagonal
+    long unsigned int tNnzA = aGraph.number_of_vertices() + aGraph.number_of_edges() ;
+
+    real tSymbolicTime ;
+    real tNumericTime ;
+    real tSolveTime ;
+    time_factorization( aMatrixGraph, aNewIndices, tSymbolicTime, tNumericTime, tSolveTime );
+    real tSpmvTime = time_spmv( aGraph, aNewIndices, 20 );
+
+    std::cout << std::setw( 24 ) << std::left << "    " + aLabel
+              << std::setw( 12 ) << std::right << aTime
+              << std::setw( 12 ) << tBandwidth
+              << std::setw( 16 ) << tProfile
+              << std::setw( 16 ) << tNnzL
+              << std::setw( 16 ) << tNnzL - tNnzA
+              << std::setw( 14 ) << tSymbolicTime
+              << std::setw( 14 ) << tNumericTime
+              << std::setw( 12 ) << tSolveTime
+              << std::setw( 12 ) << tSpmvTime << std::endl;
+}
+
+//------------------------------------------------------------------------------
+
+int main( int    argc,
+          char * argv[] )
+{
+    // create communicator
+    gComm.init( argc, argv );
+
+    BELFEM_ERROR( argc > 1, "usage: graphbench <mesh.exo|mesh.hdf5> [axis] [threads]" );
+
+    string tPath = argv[ 1 ];
+    uint tAxis = argc > 2 ? std::stoi( argv[ 2 ] ) : 0 ;
+    uint tNumThreads = argc > 3 ? std::stoi( argv[ 3 ] ) : 0 ;
+
+    Timer tReadTimer ;
+
+    // read the mesh
+    Mesh tMesh( tPath, comm_rank(), false );
+
+    std::cout << "    read " << tPath << " with " << tMesh.number_of_nodes() << " nodes and "
+              << tMesh.number_of_elements() << " elements in " << tReadTimer.stop() << " ms" << std::endl;
+
+    Timer tGraphTimer ;
+
+    Graph tGraph ;
+    create_node_graph( tMesh, tGraph, false );
+
+    Graph tMatrixGraph ;
+    create_node_graph( tMesh, tMatrixGraph, true );
+
+    CSRGraph tCSR( tGraph );
+
+    std::cout << "    created node graph with " << tCSR.number_of_edges() << " edges in "
+              << tGraphTimer.stop() << " ms" << std::endl;
+
+    Cell< index_t > tSinks ;
+    Cell< index_t > tSources ;
+    find_boundaries( tMesh, tAxis, tSinks, tSources );
+
+    std::cout << "    " << tSinks.size() << " sinks and " << tSources.size()
+              << " sources along axis " << tAxis << std::endl;
+
+    print_header() ;
+
+    Vector< index_t > tNewIndices ;
+
+    {
+        Timer tTimer ;
+        tNewIndices.set_size( tCSR.number_of_vertices(), 0 );
+        for( index_t k=0; k<tCSR.number_of_vertices(); ++k )
+        {
+            tNewIndices( k ) = k ;
+        }
+        print_result( "natural", tTimer.stop(), tCSR, tMatrixGraph, tNewIndices );
+    }
+
+    {
+        Timer tTimer ;
+        reverse_cuthill_mckee( tCSR, tNewIndices );
+        print_result( "rcm", tTimer.stop(), tCSR, tMatrixGraph, tNewIndices );
+    }
+
+    {
+        Timer tTimer ;
+        reorder_by_levels( tCSR, tSinks, tSources, tNewIndices, nullptr, 1, false );
+        print_result( "levels", tTimer.stop(), tCSR, tMatrixGraph, tNewIndices );
+    }
+
+    {
+        Timer tTimer ;
+        reorder_by_levels( tCSR, tSinks, tSources, tNewIndices, nullptr, 1, true );
+        print_result( "levels+matching", tTimer.stop(), tCSR, tMatrixGraph, tNewIndices );
+    }
+
+    {
+        Timer tTimer ;
+        reorder_by_levels( tCSR, tSinks, tSources, tNewIndices, nullptr, tNumThreads, true );
+        print_result( "levels+matching (mt)", tTimer.stop(), tCSR, tMatrixGraph, tNewIndices );
+    }
+
+    // tidy up
+    for( Vertex * tVertex : tGraph )
+    {
+        delete tVertex ;
+    }
+    for( Vertex * tVertex : tMatrixGraph )
+    {
+        delete tVertex ;
+    }
+
+    return gComm.finalize();
+}
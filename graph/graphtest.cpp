@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 #include "banner.hpp"
 #include "cl_Communicator.hpp"
@@ -22,6 +23,10 @@
 
 
 #include "fn_Graph_max_cardinality_matching.hpp"
+#include "cl_Graph_CSRGraph.hpp"
+#include "cl_Graph_BlockCutTree.hpp"
+#include "fn_Graph_tarjan.hpp"
+#include "fn_Graph_reorder_by_levels.hpp"
 
 using namespace belfem;
 using namespace belfem::graph;
@@ -54,6 +59,47 @@ add_edge( Vertex * aA, Vertex * aB )
     aB->insert_vertex( aA );
 }
 
+/**
+ * Helper function to create a graph from a list of edges.
+ * Edge k connects the vertices aFrom( k ) and aTo( k ).
+ */
+void
+create_graph( Graph & aGraph,
+              const index_t aNumVertices,
+              const Cell< index_t > & aFrom,
+              const Cell< index_t > & aTo )
+{
+    aGraph.set_size( aNumVertices, nullptr );
+
+    for ( index_t k = 0; k < aNumVertices; ++k )
+    {
+        aGraph( k ) = new Vertex();
+        aGraph( k )->set_index( k );
+    }
+
+    for ( index_t k = 0; k < aFrom.size(); ++k )
+    {
+        create_edge( aGraph( aFrom( k ) ), aGraph( aTo( k ) ) );
+    }
+
+    finalize_edges( aGraph );
+
+    for ( index_t k = 0; k < aFrom.size(); ++k )
+    {
+        add_edge( aGraph( aFrom( k ) ), aGraph( aTo( k ) ) );
+    }
+}
+
+void
+delete_graph( Graph & aGraph )
+{
+    for ( Vertex * tV : aGraph )
+    {
+        delete tV;
+    }
+    aGraph.clear();
+}
+
 /**
  * Test 1: Simple path graph with 4 vertices
  *         0 -- 1 -- 2 -- 3
@@ -343,6 +389,500 @@ test_pentagon()
     std::cout << "  PASSED" << std::endl;
 }
 
+/**
+ * Reference for the block-cut tree: the recursive Tarjan search that
+ * was used before. Each cut vertex is stored in aNecks, once for every
+ * component it separates, and the component is stored as sorted
+ * vertex indices in aComponents. The search starts at vertex 0,
+ * like the block-cut tree.
+ */
+void
+find_separated_components_recursive(
+        Graph & aGraph,
+        Cell< index_t > & aNecks,
+        Cell< Cell< index_t > > & aComponents )
+{
+    const index_t tN = aGraph.size();
+
+    Vector< index_t > tDiscoveryTime( tN, gNoIndex );
+    Vector< index_t > tLowLink( tN, gNoIndex );
+    Vector< index_t > tParent( tN, gNoIndex );
+    index_t tTimer = 0;
+
+    aNecks.clear();
+    aComponents.clear();
+
+    // returns the vertices of the DFS subtree below aV
+    auto tDFS = [ & ]( auto && aSelf, const index_t aV ) -> Cell< index_t >
+    {
+        Vertex * tVertex = aGraph( aV );
+        tDiscoveryTime( aV ) = tLowLink( aV ) = tTimer++;
+
+        Cell< Cell< index_t > > tChildSubtrees;
+        Cell< Cell< index_t > > tSeparated;
+
+        Cell< index_t > tSubtree;
+        tSubtree.push( aV );
+
+        for ( uint k = 0; k < tVertex->number_of_vertices(); ++k )
+        {
+            index_t tU = tVertex->vertex( k )->index();
+
+            if ( tU == tParent( aV ) ) continue;
+
+            if ( tDiscoveryTime( tU ) == gNoIndex )
+            {
+                tParent( tU ) = aV;
+
+                Cell< index_t > tChildSubtree = aSelf( aSelf, tU );
+
+                tLowLink( aV ) = std::min( tLowLink( aV ), tLowLink( tU ) );
+
+                // separated component of a non-root vertex
+                if ( tParent( aV ) != gNoIndex && tLowLink( tU ) >= tDiscoveryTime( aV ) )
+                {
+                    tSeparated.push( tChildSubtree );
+                }
+
+                for ( index_t tW : tChildSubtree )
+                {
+                    tSubtree.push( tW );
+                }
+                tChildSubtrees.push( tChildSubtree );
+            }
+            else
+            {
+                // back edge
+                tLowLink( aV ) = std::min( tLowLink( aV ), tDiscoveryTime( tU ) );
+            }
+        }
+
+        // a root separates all of its subtrees if it has more than one
+        if ( tParent( aV ) == gNoIndex && tChildSubtrees.size() > 1 )
+        {
+            tSeparated = tChildSubtrees;
+        }
+
+        for ( Cell< index_t > & tComponent : tSeparated )
+        {
+            std::sort( tComponent.vector_data().begin(), tComponent.vector_data().end() );
+            aNecks.push( aV );
+            aComponents.push( tComponent );
+        }
+
+        return tSubtree;
+    };
+
+    for ( index_t k = 0; k < tN; ++k )
+    {
+        if ( tDiscoveryTime( k ) == gNoIndex )
+        {
+            tDFS( tDFS, k );
+        }
+    }
+}
+
+/**
+ * Count the edges between the vertices of a component. If the component
+ * has exactly one cycle, its length is written into aCycleLength,
+ * which is found by stripping the leaves until only the cycle is left.
+ */
+index_t
+count_component_edges(
+        Graph & aGraph,
+        const Cell< index_t > & aComponent,
+        index_t & aCycleLength )
+{
+    const index_t tN = aGraph.size();
+
+    // degree within the component, gNoIndex for other vertices
+    Vector< index_t > tDegree( tN, gNoIndex );
+    for ( index_t tV : aComponent )
+    {
+        tDegree( tV ) = 0;
+    }
+
+    index_t tCount = 0;
+    for ( index_t tV : aComponent )
+    {
+        for ( uint k = 0; k < aGraph( tV )->number_of_vertices(); ++k )
+        {
+            if ( tDegree( aGraph( tV )->vertex( k )->index() ) != gNoIndex )
+            {
+                ++tDegree( tV );
+                ++tCount;
+            }
+        }
+    }
+    tCount /= 2;
+
+    aCycleLength = 0;
+    if ( tCount != aComponent.size() )
+    {
+        return tCount;
+    }
+
+    // strip the leaves, the cycle is what remains
+    Cell< index_t > tLeaves( aComponent.size(), gNoIndex );
+    index_t tTop = 0;
+    for ( index_t tV : aComponent )
+    {
+        if ( tDegree( tV ) == 1 )
+        {
+            tLeaves( tTop++ ) = tV;
+        }
+    }
+
+    index_t tRemaining = aComponent.size();
+    while ( tTop > 0 )
+    {
+        index_t tV = tLeaves( --tTop );
+        tDegree( tV ) = 0;
+        --tRemaining;
+
+        for ( uint k = 0; k < aGraph( tV )->number_of_vertices(); ++k )
+        {
+            index_t tU = aGraph( tV )->vertex( k )->index();
+            if ( tDegree( tU ) != gNoIndex && tDegree( tU ) > 0 )
+            {
+                if ( --tDegree( tU ) == 1 )
+                {
+                    tLeaves( tTop++ ) = tU;
+                }
+            }
+        }
+    }
+
+    aCycleLength = tRemaining;
+
+    return tCount;
+}
+
+/**
+ * Compare the cut vertices and pockets of the block-cut tree with
+ * the recursive search.
+ * @return number of unicyclic pockets with at most aMaxPocketSize vertices
+ */
+index_t
+check_block_cut_tree( Graph & aGraph, const index_t aMaxPocketSize )
+{
+    const index_t tN = aGraph.size();
+
+    Cell< index_t > tNecks;
+    Cell< Cell< index_t > > tComponents;
+    find_separated_components_recursive( aGraph, tNecks, tComponents );
+
+    CSRGraph tCSR( aGraph );
+    BlockCutTree tTree( tCSR );
+
+    // cut vertices
+    Vector< index_t > tIsCut( tN, 0 );
+    index_t tNumCut = 0;
+    for ( index_t tV : tNecks )
+    {
+        if ( tIsCut( tV ) == 0 )
+        {
+            tIsCut( tV ) = 1;
+            ++tNumCut;
+        }
+    }
+
+    std::cout << "  Cut vertices: " << tTree.cut_vertices().size()
+              << " (expected: " << tNumCut << ")" << std::endl;
+
+    assert( tTree.cut_vertices().size() == tNumCut );
+    for ( index_t tV : tTree.cut_vertices() )
+    {
+        assert( tIsCut( tV ) == 1 );
+    }
+    for ( index_t k = 0; k < tN; ++k )
+    {
+        assert( tTree.is_cut_vertex( k ) == ( tIsCut( k ) == 1 ) );
+    }
+
+    // every separated component is a pocket if size and cycles are not limited
+    Cell< PocketInfo > tPockets = detect_pockets_with_info( aGraph, tTree, tN, false );
+
+    std::cout << "  Separated components: " << tPockets.size()
+              << " (expected: " << tComponents.size() << ")" << std::endl;
+
+    assert( tPockets.size() == tComponents.size() );
+
+    for ( const PocketInfo & tPocket : tPockets )
+    {
+        Cell< index_t > tVertices;
+        for ( Vertex * tV : tPocket.mPocketVertices )
+        {
+            tVertices.push( tV->index() );
+        }
+        std::sort( tVertices.vector_data().begin(), tVertices.vector_data().end() );
+
+        index_t tMatch = gNoIndex;
+        for ( index_t c = 0; c < tComponents.size(); ++c )
+        {
+            if ( tNecks( c ) == tPocket.mNeckVertex->index() &&
+                 tComponents( c ).vector_data() == tVertices.vector_data() )
+            {
+                tMatch = c;
+                break;
+            }
+        }
+        assert( tMatch != gNoIndex );
+
+        index_t tCycleLength;
+        index_t tEdgeCount = count_component_edges( aGraph, tComponents( tMatch ), tCycleLength );
+
+        assert( tPocket.mSize == tComponents( tMatch ).size() );
+        assert( tPocket.mEdgeCount == tEdgeCount );
+        assert( tPocket.mIsUnicyclic == ( tEdgeCount == tPocket.mSize ) );
+        assert( tPocket.mCycleLength == tCycleLength );
+    }
+
+    // the unicyclic pockets up to the given size
+    index_t tNumPockets = 0;
+    for ( const Cell< index_t > & tComponent : tComponents )
+    {
+        index_t tCycleLength;
+        if ( tComponent.size() <= aMaxPocketSize &&
+             count_component_edges( aGraph, tComponent, tCycleLength ) == tComponent.size() )
+        {
+            ++tNumPockets;
+        }
+    }
+
+    assert( detect_pockets_with_info( aGraph, tTree, aMaxPocketSize, true ).size() == tNumPockets );
+
+    return tNumPockets;
+}
+
+/**
+ * Test 8: Block-cut tree of a chain
+ *         0 -- 1 -- 2 -- ... -- 999
+ * Expected: all inner vertices are cut vertices, no unicyclic pockets
+ */
+void
+test_block_cut_tree_chain()
+{
+    std::cout << "Test 8: Block-cut tree of a chain (1000 vertices)..." << std::endl;
+
+    const index_t tN = 1000;
+
+    Cell< index_t > tFrom;
+    Cell< index_t > tTo;
+    for ( index_t k = 0; k + 1 < tN; ++k )
+    {
+        tFrom.push( k );
+        tTo.push( k + 1 );
+    }
+
+    Graph tGraph;
+    create_graph( tGraph, tN, tFrom, tTo );
+
+    index_t tNumPockets = check_block_cut_tree( tGraph, 20 );
+
+    CSRGraph tCSR( tGraph );
+    BlockCutTree tTree( tCSR );
+    assert( tTree.cut_vertices().size() == tN - 2 );
+
+    std::cout << "  Pockets: " << tNumPockets << " (expected: 0)" << std::endl;
+    assert( tNumPockets == 0 );
+
+    delete_graph( tGraph );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+/**
+ * Test 9: Block-cut tree of a graph with pockets
+ *         a 4x4 grid (0-15) with
+ *         - a triangle 16-17-18 on a stem at vertex 15
+ *         - a square 19-20-21-22 on a stem at the root 0,
+ *           with a tail 23 at vertex 21
+ *         - a triangle 5-24-25 that shares vertex 5
+ * Expected: cut vertices 0, 5, 15, 16, 19 and 21,
+ *           unicyclic pockets behind 15 and behind 0
+ */
+void
+test_block_cut_tree_pockets()
+{
+    std::cout << "Test 9: Block-cut tree of a graph with pockets..." << std::endl;
+
+    Cell< index_t > tFrom;
+    Cell< index_t > tTo;
+
+    auto tEdge = [ & ]( const index_t aA, const index_t aB )
+    {
+        tFrom.push( aA );
+        tTo.push( aB );
+    };
+
+    // the grid
+    for ( index_t j = 0; j < 4; ++j )
+    {
+        for ( index_t i = 0; i < 4; ++i )
+        {
+            if ( i < 3 ) tEdge( 4 * j + i, 4 * j + i + 1 );
+            if ( j < 3 ) tEdge( 4 * j + i, 4 * j + i + 4 );
+        }
+    }
+
+    // triangle on a stem
+    tEdge( 15, 16 );
+    tEdge( 16, 17 );
+    tEdge( 17, 18 );
+    tEdge( 18, 16 );
+
+    // square on a stem, with a tail
+    tEdge( 0, 19 );
+    tEdge( 19, 20 );
+    tEdge( 20, 21 );
+    tEdge( 21, 22 );
+    tEdge( 22, 19 );
+    tEdge( 21, 23 );
+
+    // triangle without a stem
+    tEdge( 5, 24 );
+    tEdge( 24, 25 );
+    tEdge( 25, 5 );
+
+    Graph tGraph;
+    create_graph( tGraph, 26, tFrom, tTo );
+
+    index_t tNumPockets = check_block_cut_tree( tGraph, 20 );
+
+    CSRGraph tCSR( tGraph );
+    BlockCutTree tTree( tCSR );
+    assert( tTree.cut_vertices().size() == 6 );
+    assert( tTree.is_cut_vertex( 0 ) );
+    assert( tTree.is_cut_vertex( 5 ) );
+    assert( tTree.is_cut_vertex( 15 ) );
+    assert( tTree.is_cut_vertex( 16 ) );
+    assert( tTree.is_cut_vertex( 19 ) );
+    assert( tTree.is_cut_vertex( 21 ) );
+
+    std::cout << "  Pockets: " << tNumPockets << " (expected: 2)" << std::endl;
+    assert( tNumPockets == 2 );
+
+    // removing them leaves the grid and the triangle at vertex 5,
+    // the removed vertices are not deleted
+    Graph tAllVertices = tGraph;
+    index_t tRemoved = remove_pockets( tGraph, tTree, 20, true );
+
+    std::cout << "  Removed: " << tRemoved << " (expected: 8)" << std::endl;
+    assert( tRemoved == 8 );
+    assert( tGraph.size() == 18 );
+    for ( Vertex * tV : tGraph )
+    {
+        assert( tV != tAllVertices( 16 ) && tV != tAllVertices( 19 ) );
+    }
+
+    delete_graph( tAllVertices );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
+/**
+ * Test 10: reorder_by_levels on a strip of 4096 x 12 quads,
+ *          some of them cut by a diagonal. The boundaries are the
+ *          long edges, so that the fronts of the search are wide
+ *          enough to be split between threads.
+ * Expected: the same indices for any number of threads
+ */
+void
+test_reorder_by_levels_threads()
+{
+    std::cout << "Test 10: reorder_by_levels with 1 and N threads..." << std::endl;
+
+    const index_t tNx = 4097;
+    const index_t tNy = 13;
+    const index_t tN  = tNx * tNy;
+
+    Cell< index_t > tFrom;
+    Cell< index_t > tTo;
+
+    for ( index_t j = 0; j < tNy; ++j )
+    {
+        for ( index_t i = 0; i < tNx; ++i )
+        {
+            index_t tV = j * tNx + i;
+
+            if ( i + 1 < tNx )
+            {
+                tFrom.push( tV );
+                tTo.push( tV + 1 );
+            }
+            if ( j + 1 < tNy )
+            {
+                tFrom.push( tV );
+                tTo.push( tV + tNx );
+            }
+            if ( i + 1 < tNx && j + 1 < tNy && ( i + j ) % 3 == 0 )
+            {
+                tFrom.push( tV );
+                tTo.push( tV + tNx + 1 );
+            }
+        }
+    }
+
+    Graph tGraph;
+    create_graph( tGraph, tN, tFrom, tTo );
+
+    CSRGraph tCSR( tGraph );
+
+    Cell< index_t > tSinks( tNx, gNoIndex );
+    Cell< index_t > tSources( tNx, gNoIndex );
+    for ( index_t i = 0; i < tNx; ++i )
+    {
+        tSinks( i ) = i;
+        tSources( i ) = ( tNy - 1 ) * tNx + i;
+    }
+
+    for ( bool tMatching : { false, true } )
+    {
+        Vector< index_t > tReference;
+        Vector< real > tReferenceT;
+        reorder_by_levels( tCSR, tSinks, tSources, tReference, &tReferenceT, 1, tMatching );
+
+        // the result is a permutation
+        Vector< index_t > tCount( tN, 0 );
+        for ( index_t k = 0; k < tN; ++k )
+        {
+            assert( tReference( k ) < tN );
+            ++tCount( tReference( k ) );
+        }
+        for ( index_t k = 0; k < tN; ++k )
+        {
+            assert( tCount( k ) == 1 );
+        }
+
+        for ( uint tNumThreads : { 2u, 3u, 4u, 8u } )
+        {
+            Vector< index_t > tNewIndices;
+            Vector< real > tT;
+            reorder_by_levels( tCSR, tSinks, tSources, tNewIndices, &tT, tNumThreads, tMatching );
+
+            index_t tDiffer = 0;
+            for ( index_t k = 0; k < tN; ++k )
+            {
+                if ( tNewIndices( k ) != tReference( k ) || tT( k ) != tReferenceT( k ) )
+                {
+                    ++tDiffer;
+                }
+            }
+
+            std::cout << "  Matching: " << ( tMatching ? "yes" : "no " )
+                      << ", threads: " << tNumThreads
+                      << ", differing vertices: " << tDiffer << " (expected: 0)" << std::endl;
+
+            assert( tDiffer == 0 );
+        }
+    }
+
+    delete_graph( tGraph );
+
+    std::cout << "  PASSED" << std::endl;
+}
+
 Communicator gComm;
 Logger       gLog( 5 );
 
@@ -366,6 +906,20 @@ int main( int    argc,
     test_complete_graph_k4();
     test_pentagon();
 
+    std::cout << "========================================" << std::endl;
+    std::cout << "Block-Cut Tree Tests" << std::endl;
+    std::cout << "(compared with the recursive Tarjan search)" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    test_block_cut_tree_chain();
+    test_block_cut_tree_pockets();
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "Level Reordering Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    test_reorder_by_levels_threads();
+
     std::cout << "========================================" << std::endl;
     std::cout << "All tests PASSED!" << std::endl;
     std::cout << "========================================" << std::endl;
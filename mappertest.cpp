@@ -3,20 +3,163 @@
 //
 
 #include <iostream>
+#include <cmath>
 
 #include "typedefs.hpp"
 #include "constants.hpp"
+#include "assert.hpp"
 #include "cl_Communicator.hpp"
 #include "cl_Logger.hpp"
 #include "banner.hpp"
 #include "cl_OneDMapper.hpp"
 #include "fn_linspace.hpp"
+#include "cl_BS_TensorKernel.hpp"
+#include "cl_BS_Mapper.hpp"
 
 using namespace belfem;
 
 Communicator gComm;
 Logger       gLog( 5 );
 
+//------------------------------------------------------------------------------
+
+/**
+ * compares the tensor kernel, which uses AVX2 for cubic tables if
+ * available, with the plain sum over all nodes of the element
+ */
+template< uint D, uint P >
+void
+test_tensor_kernel()
+{
+    const uint tN = P + 1 ;
+
+    uint tNumberOfNodes = 1 ;
+    for( uint i=0; i<D; ++i )
+    {
+        tNumberOfNodes *= tN ;
+    }
+
+    // derivative in each direction for each entry of the result
+    const uint tDerivatives1D[ 3 ][ 3 ] = { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 } };
+
+    const uint tDerivatives2D[ 6 ][ 3 ] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 },
+                                            { 2, 0, 0 }, { 0, 2, 0 }, { 1, 1, 0 } };
+
+    const uint tDerivatives3D[ 10 ][ 3 ] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 },
+                                             { 2, 0, 0 }, { 0, 2, 0 }, { 0, 0, 2 },
+                                             { 0, 1, 1 }, { 1, 0, 1 }, { 1, 1, 0 } };
+
+    const uint tNumberOfResults = D == 1 ? 3 : ( D == 2 ? 6 : 10 );
+
+    const uint ( * tDerivatives )[ 3 ] = D == 1 ? tDerivatives1D :
+                                       ( D == 2 ? tDerivatives2D : tDerivatives3D );
+
+    // arbitrary node values and shape functions
+    real tValues[ 64 ];
+    for( uint k=0; k<tNumberOfNodes; ++k )
+    {
+        tValues[ k ] = std::sin( 1.0 + 0.37 * k );
+    }
+
+    real tShape[ 3 ][ 3 ][ BELFEM_BSPLINE_MAX_ORDER + 1 ] = {};
+    for( uint d=0; d<3; ++d )
+    {
+        for( uint r=0; r<3; ++r )
+        {
+            for( uint i=0; i<tN; ++i )
+            {
+                tShape[ d ][ r ][ i ] = std::cos( 0.5 + 0.71 * i + 1.3 * r + 2.9 * d );
+            }
+        }
+    }
+
+    real tResult[ 10 ];
+    bspline::TensorKernel< D, P >::evaluate( tValues, tShape, tResult );
+
+    for( uint r=0; r<tNumberOfResults; ++r )
+    {
+        real tExpect = 0.0 ;
+
+        for( uint k=0; k<( D > 2 ? tN : 1 ); ++k )
+        {
+            for( uint j=0; j<( D > 1 ? tN : 1 ); ++j )
+            {
+                for( uint i=0; i<tN; ++i )
+                {
+                    real tPhi = tShape[ 0 ][ tDerivatives[ r ][ 0 ] ][ i ];
+
+                    if( D > 1 )
+                    {
+                        tPhi *= tShape[ 1 ][ tDerivatives[ r ][ 1 ] ][ j ];
+                    }
+                    if( D > 2 )
+                    {
+                        tPhi *= tShape[ 2 ][ tDerivatives[ r ][ 2 ] ][ k ];
+                    }
+
+                    tExpect += tPhi * tValues[ i + tN * ( j + tN * k ) ];
+                }
+            }
+        }
+
+        BELFEM_ERROR( std::abs( tResult[ r ] - tExpect ) < 1e-12 * ( 1.0 + std::abs( tExpect ) ),
+                      "tensor kernel D=%u, P=%u, entry %u: %g, expected %g",
+                      ( unsigned int ) D, ( unsigned int ) P, ( unsigned int ) r,
+                      ( double ) tResult[ r ], ( double ) tExpect );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+/**
+ * fits the same field with the Kronecker solver and with UMFPACK,
+ * the node values must be the same
+ */
+void
+test_kronecker_solver( const uint aNumberOfDimensions )
+{
+    Vector< index_t > tNumElems( aNumberOfDimensions, 6 );
+    Vector< real > tMinPoint( aNumberOfDimensions, -1.0 );
+    Vector< real > tMaxPoint( aNumberOfDimensions, 2.0 );
+
+    bspline::Mapper tSparse( aNumberOfDimensions, 3, tNumElems, tMinPoint, tMaxPoint, false );
+    bspline::Mapper tKronecker( aNumberOfDimensions, 3, tNumElems, tMinPoint, tMaxPoint, true );
+
+    const Matrix< real > & tGrid = tSparse.integration_grid();
+
+    Vector< real > & tF0 = tSparse.create_field( "f" );
+    Vector< real > & tF1 = tKronecker.create_field( "f" );
+
+    for( index_t k=0; k<tGrid.n_cols(); ++k )
+    {
+        real tValue = std::sin( tGrid( 0, k ) );
+        for( uint i=1; i<aNumberOfDimensions; ++i )
+        {
+            tValue *= std::cos( ( i + 1 ) * tGrid( i, k ) ) + tGrid( 0, k ) * tGrid( i, k );
+        }
+        tF0( k ) = tValue ;
+        tF1( k ) = tValue ;
+    }
+
+    tSparse.compute_node_values();
+    tKronecker.compute_node_values();
+
+    const Vector< real > & tN0 = tSparse.mesh()->field_data( "f" );
+    const Vector< real > & tN1 = tKronecker.mesh()->field_data( "f" );
+
+    BELFEM_ERROR( tN0.length() == tN1.length(), "number of nodes does not match" );
+
+    for( index_t k=0; k<tN0.length(); ++k )
+    {
+        BELFEM_ERROR( std::abs( tN0( k ) - tN1( k ) ) < 1e-10 * ( 1.0 + std::abs( tN0( k ) ) ),
+                      "%uD Kronecker solver differs from UMFPACK at node %lu: %g vs %g",
+                      ( unsigned int ) aNumberOfDimensions, ( long unsigned int ) k,
+                      ( double ) tN1( k ), ( double ) tN0( k ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+
 int main( int    argc,
           char * argv[] )
 {
@@ -49,5 +192,21 @@ int main( int    argc,
     tTargetNodes.print("X1");
     tTargetValues.print("Y1");
 
+    // the cubic kernels use AVX2 if the build supports it
+    test_tensor_kernel< 1, 2 >();
+    test_tensor_kernel< 2, 2 >();
+    test_tensor_kernel< 3, 2 >();
+    test_tensor_kernel< 1, 3 >();
+    test_tensor_kernel< 2, 3 >();
+    test_tensor_kernel< 3, 3 >();
+
+    std::cout << "tensor kernel: PASSED" << std::endl;
+
+    test_kronecker_solver( 1 );
+    test_kronecker_solver( 2 );
+    test_kronecker_solver( 3 );
+
+    std::cout << "Kronecker solver: PASSED" << std::endl;
+
     return  gComm.finalize();
 }
\ No newline at end of file